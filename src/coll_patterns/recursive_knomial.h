@@ -175,6 +175,14 @@ ucc_knomial_pattern_next_iteration_backward(ucc_knomial_pattern_t *p)
     p->radix_pow /= p->radix;
 }
 
+/* Rewinds the pattern to its first iteration, the rest of the pattern
+   depends only on size, rank and radix and is kept */
+static inline void ucc_knomial_pattern_reset(ucc_knomial_pattern_t *p)
+{
+    p->iteration = 0;
+    p->radix_pow = ucc_kn_pattern_radix_pow_init(p, p->backward);
+}
+
 static inline ucc_kn_radix_t
 ucc_knomial_pattern_get_min_radix(ucc_kn_radix_t cfg_radix,
                                   ucc_rank_t team_size, size_t count)
@@ -0,0 +1,18 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "allgather.h"
+
+ucc_base_coll_alg_info_t
+    ucc_cl_hier_allgather_algs[UCC_CL_HIER_ALLGATHER_ALG_LAST + 1] = {
+        [UCC_CL_HIER_ALLGATHER_ALG_SPLIT_RAIL] =
+            {.id   = UCC_CL_HIER_ALLGATHER_ALG_SPLIT_RAIL,
+             .name = "split_rail",
+             .desc = "PPN concurrent inter-node allgathers among the ranks "
+                     "with the same local rank, followed by intra-node "
+                     "allgather"},
+        [UCC_CL_HIER_ALLGATHER_ALG_LAST] = {
+            .id = 0, .name = NULL, .desc = NULL}};
@@ -0,0 +1,369 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "allgather.h"
+#include "../cl_hier_coll.h"
+#include "core/ucc_team.h"
+
+#define IS_ALLGATHERV(_args) ((_args)->coll_type == UCC_COLL_TYPE_ALLGATHERV)
+
+static inline ucc_datatype_t ag_dt(ucc_coll_args_t *args)
+{
+    return IS_ALLGATHERV(args) ? args->dst.info_v.datatype
+                               : args->dst.info.datatype;
+}
+
+static inline ucc_memory_type_t ag_mem_type(ucc_coll_args_t *args)
+{
+    return IS_ALLGATHERV(args) ? args->dst.info_v.mem_type
+                               : args->dst.info.mem_type;
+}
+
+static ucc_status_t
+ucc_cl_hier_allgather_split_rail_frag_finalize(ucc_coll_task_t *task)
+{
+    ucc_cl_hier_schedule_t *schedule =
+        ucc_derived_of(task, ucc_cl_hier_schedule_t);
+    ucc_status_t status;
+
+    status = ucc_schedule_finalize(task);
+    ucc_mc_free(schedule->scratch);
+    ucc_free(schedule->split_rail.counts);
+    ucc_cl_hier_put_schedule(&schedule->super.super);
+    return status;
+}
+
+static ucc_status_t
+ucc_cl_hier_allgather_split_rail_schedule_finalize(ucc_coll_task_t *task)
+{
+    ucc_cl_hier_schedule_t *schedule =
+        ucc_derived_of(task, ucc_cl_hier_schedule_t);
+    ucc_status_t status;
+
+    UCC_CL_HIER_PROFILE_REQUEST_EVENT(task,
+                                      "cl_hier_allgather_split_rail_finalize",
+                                      0);
+    status = ucc_schedule_pipelined_finalize(&schedule->super.super.super);
+    ucc_free(schedule->split_rail.counts);
+    ucc_cl_hier_put_schedule(&schedule->super.super);
+    return status;
+}
+
+/* Computes the layout of the fragment and returns the source of
+   the own block */
+static void *
+ucc_cl_hier_allgather_split_rail_layout(ucc_schedule_pipelined_t *sp,
+                                        ucc_cl_hier_schedule_t   *frag,
+                                        int frag_num, size_t *total,
+                                        ucc_cl_hier_rail_layout_t *layout)
+{
+    ucc_cl_hier_team_t *cl_team =
+        ucc_derived_of(sp->super.super.team, ucc_cl_hier_team_t);
+    ucc_coll_args_t *args   = &sp->super.super.bargs.args;
+    uint64_t        *counts = ucc_derived_of(sp, ucc_cl_hier_schedule_t)
+                                  ->split_rail.counts;
+    ucc_rank_t       size   = UCC_CL_TEAM_SIZE(cl_team);
+    ucc_rank_t       rank   = UCC_CL_TEAM_RANK(cl_team);
+    size_t           dt_size = ucc_dt_size(ag_dt(args));
+    size_t           offset;
+
+    *total = ucc_cl_hier_rail_layout(cl_team, counts, counts + size,
+                                     sp->super.n_tasks, frag_num,
+                                     frag->split_rail.counts, layout);
+    if (UCC_IS_INPLACE(*args)) {
+        offset = layout->displs[SBGP_RANK(cl_team, NODE) *
+                                    SBGP_SIZE(cl_team, NET) +
+                                SBGP_RANK(cl_team, NET)];
+        return PTR_OFFSET(args->dst.info.buffer, offset * dt_size);
+    }
+    offset = ucc_buffer_block_offset(counts[rank], sp->super.n_tasks,
+                                     frag_num);
+    return PTR_OFFSET(args->src.info.buffer, offset * dt_size);
+}
+
+static ucc_status_t
+ucc_cl_hier_allgather_split_rail_frag_setup(ucc_schedule_pipelined_t *sp,
+                                            ucc_schedule_t *frag,
+                                            int frag_num)
+{
+    ucc_cl_hier_team_t *cl_team =
+        ucc_derived_of(sp->super.super.team, ucc_cl_hier_team_t);
+    ucc_cl_hier_schedule_t   *cl_sp =
+        ucc_derived_of(sp, ucc_cl_hier_schedule_t);
+    ucc_coll_task_t          *task_ag_net = frag->tasks[0];
+    ucc_cl_hier_rail_layout_t layout;
+    size_t                    total;
+    void                     *sbuf;
+
+    sbuf = ucc_cl_hier_allgather_split_rail_layout(
+        sp, ucc_derived_of(frag, ucc_cl_hier_schedule_t), frag_num, &total,
+        &layout);
+    task_ag_net->bargs.args.src.info.buffer = sbuf;
+    task_ag_net->bargs.args.src.info.count =
+        layout.net_counts[SBGP_RANK(cl_team, NET)];
+    ucc_assert(task_ag_net->bargs.args.dst.info_v.counts ==
+               layout.net_counts);
+    if (cl_sp->split_rail.node_shm) {
+        /* 1 seq number per fragment is reserved at start */
+        ucc_assert(frag_num < sp->super.n_tasks);
+        ucc_cl_hier_node_shm_set_seq(frag->tasks[1],
+                                     cl_sp->split_rail.shm_seq + frag_num);
+    }
+    return UCC_OK;
+}
+
+/* The fragment is gathered in the rail-major ordered scratch: first
+   each rail does inter-node allgatherv of the blocks of its ranks, then
+   the rails are exchanged with intra-node allgatherv and finally the
+   blocks are copied to their positions in the user buffer. */
+static ucc_status_t ucc_cl_hier_allgather_split_rail_frag_init(
+    ucc_base_coll_args_t *coll_args, ucc_schedule_pipelined_t *sp,
+    ucc_base_team_t *team, ucc_schedule_t **frag_p)
+{
+    ucc_cl_hier_team_t *cl_team  = ucc_derived_of(team, ucc_cl_hier_team_t);
+    ucc_coll_args_t    *args     = &coll_args->args;
+    ucc_datatype_t      dt       = ag_dt(args);
+    ucc_memory_type_t   mem_type = ag_mem_type(args);
+    ucc_coll_task_t    *tasks[2] = {NULL, NULL};
+    ucc_cl_hier_copy_task_t  *task_copy = NULL;
+    ucc_cl_hier_schedule_t   *cl_schedule;
+    ucc_schedule_t           *schedule;
+    ucc_cl_hier_rail_layout_t layout;
+    ucc_base_coll_args_t      ag_args;
+    ucc_status_t              status;
+    size_t                    total;
+    void                     *sbuf;
+    int                       i;
+
+    cl_schedule = ucc_cl_hier_get_schedule(cl_team);
+    if (ucc_unlikely(!cl_schedule)) {
+        return UCC_ERR_NO_MEMORY;
+    }
+    schedule = &cl_schedule->super.super;
+    cl_schedule->split_rail.counts =
+        ucc_malloc(UCC_CL_HIER_RAIL_LAYOUT_SIZE(cl_team) * sizeof(uint64_t),
+                   "rail_layout");
+    if (ucc_unlikely(!cl_schedule->split_rail.counts)) {
+        cl_error(team->context->lib,
+                 "failed to allocate %zd bytes for rail layout",
+                 UCC_CL_HIER_RAIL_LAYOUT_SIZE(cl_team) * sizeof(uint64_t));
+        ucc_cl_hier_put_schedule(schedule);
+        return UCC_ERR_NO_MEMORY;
+    }
+    /* fragment 0 is the largest one */
+    sbuf = ucc_cl_hier_allgather_split_rail_layout(sp, cl_schedule, 0,
+                                                   &total, &layout);
+    UCC_CHECK_GOTO(ucc_mc_alloc(&cl_schedule->scratch,
+                                ucc_max(total, 1) * ucc_dt_size(dt),
+                                mem_type),
+                   err, status);
+    UCC_CHECK_GOTO(ucc_schedule_init(schedule, coll_args, team), err, status);
+
+    /* inter-node ALLGATHERV among the ranks of the same rail */
+    memcpy(&ag_args, coll_args, sizeof(ag_args));
+    ag_args.args.coll_type = UCC_COLL_TYPE_ALLGATHERV;
+    ag_args.args.mask     |= UCC_COLL_ARGS_FIELD_FLAGS;
+    ag_args.args.flags    &= ~UCC_COLL_ARGS_FLAG_IN_PLACE;
+    ag_args.args.flags    |= (UCC_COLL_ARGS_FLAG_COUNT_64BIT |
+                              UCC_COLL_ARGS_FLAG_DISPLACEMENTS_64BIT);
+    ag_args.args.src.info.buffer          = sbuf;
+    ag_args.args.src.info.count           =
+        layout.net_counts[SBGP_RANK(cl_team, NET)];
+    ag_args.args.src.info.datatype        = dt;
+    ag_args.args.src.info.mem_type        = UCC_IS_INPLACE(*args)
+                                                ? mem_type
+                                                : args->src.info.mem_type;
+    ag_args.args.dst.info_v.buffer        = cl_schedule->scratch->addr;
+    ag_args.args.dst.info_v.counts        = layout.net_counts;
+    ag_args.args.dst.info_v.displacements = layout.net_displs;
+    ag_args.args.dst.info_v.datatype      = dt;
+    ag_args.args.dst.info_v.mem_type      = mem_type;
+    status = ucc_coll_init(SCORE_MAP(cl_team, NET), &ag_args, &tasks[0]);
+    if (ucc_unlikely(UCC_OK != status)) {
+        cl_error(team->context->lib, "failed to init net ag task");
+        goto err;
+    }
+
+    /* intra-node in-place ALLGATHERV of the rails */
+    ag_args.args.flags |= UCC_COLL_ARGS_FLAG_IN_PLACE;
+    ag_args.args.dst.info_v.counts        = layout.node_counts;
+    ag_args.args.dst.info_v.displacements = layout.node_displs;
+    if (ucc_derived_of(sp, ucc_cl_hier_schedule_t)->split_rail.node_shm) {
+        status = ucc_cl_hier_node_shm_task_init(&ag_args, team, &tasks[1]);
+    } else {
+        status = ucc_coll_init(SCORE_MAP(cl_team, NODE), &ag_args, &tasks[1]);
+    }
+    if (ucc_unlikely(UCC_OK != status)) {
+        cl_error(team->context->lib, "failed to init node ag task");
+        goto err;
+    }
+
+    /* copy from the rail-major order to the user buffer */
+    UCC_CHECK_GOTO(ucc_cl_hier_copy_task_init(coll_args, team, &task_copy),
+                   err, status);
+    task_copy->src          = cl_schedule->scratch->addr;
+    task_copy->src_mem_type = mem_type;
+    task_copy->src_displs   = layout.rdispls;
+    task_copy->dst          = args->dst.info.buffer;
+    task_copy->dst_mem_type = mem_type;
+    task_copy->dst_displs   = layout.displs;
+    task_copy->counts       = layout.counts;
+    task_copy->n_blocks     = UCC_CL_TEAM_SIZE(cl_team);
+    task_copy->dt_size      = ucc_dt_size(dt);
+
+    UCC_CHECK_GOTO(ucc_schedule_add_task(schedule, tasks[0]), err, status);
+    UCC_CHECK_GOTO(ucc_task_subscribe_dep(&schedule->super, tasks[0],
+                                          UCC_EVENT_SCHEDULE_STARTED),
+                   err, status);
+    UCC_CHECK_GOTO(ucc_schedule_add_task(schedule, tasks[1]), err, status);
+    UCC_CHECK_GOTO(ucc_task_subscribe_dep(tasks[0], tasks[1],
+                                          UCC_EVENT_COMPLETED),
+                   err, status);
+    UCC_CHECK_GOTO(ucc_schedule_add_task(schedule, &task_copy->super), err,
+                   status);
+    UCC_CHECK_GOTO(ucc_task_subscribe_dep(tasks[1], &task_copy->super,
+                                          UCC_EVENT_COMPLETED),
+                   err, status);
+
+    schedule->super.post     = ucc_schedule_start;
+    schedule->super.progress = NULL;
+    schedule->super.finalize = ucc_cl_hier_allgather_split_rail_frag_finalize;
+    *frag_p                  = schedule;
+    return UCC_OK;
+
+err:
+    for (i = 0; i < 2; i++) {
+        if (tasks[i]) {
+            tasks[i]->finalize(tasks[i]);
+        }
+    }
+    if (task_copy) {
+        task_copy->super.finalize(&task_copy->super);
+    }
+    if (cl_schedule->scratch) {
+        ucc_mc_free(cl_schedule->scratch);
+    }
+    ucc_free(cl_schedule->split_rail.counts);
+    ucc_cl_hier_put_schedule(schedule);
+    return status;
+}
+
+static ucc_status_t
+ucc_cl_hier_allgather_split_rail_start(ucc_coll_task_t *task)
+{
+    ucc_schedule_pipelined_t *schedule =
+        ucc_derived_of(task, ucc_schedule_pipelined_t);
+    ucc_cl_hier_schedule_t   *cl_schedule =
+        ucc_derived_of(task, ucc_cl_hier_schedule_t);
+
+    UCC_CL_HIER_PROFILE_REQUEST_EVENT(task,
+                                      "cl_hier_allgather_split_rail_start", 0);
+    if (cl_schedule->split_rail.node_shm) {
+        cl_schedule->split_rail.shm_seq = ucc_cl_hier_node_shm_reserve(
+            ucc_derived_of(task->team, ucc_cl_hier_team_t),
+            schedule->super.n_tasks);
+    }
+    cl_debug(task->team->context->lib,
+             "posting split_rail %s, sbuf %p, rbuf %p, dt %s, inplace %d, "
+             "pdepth %d, frags_total %d",
+             ucc_coll_type_str(task->bargs.args.coll_type),
+             task->bargs.args.src.info.buffer,
+             task->bargs.args.dst.info.buffer,
+             ucc_datatype_str(ag_dt(&task->bargs.args)),
+             UCC_IS_INPLACE(task->bargs.args), schedule->n_frags,
+             schedule->super.n_tasks);
+    return ucc_schedule_pipelined_post(task);
+}
+
+UCC_CL_HIER_PROFILE_FUNC(ucc_status_t, ucc_cl_hier_allgather_split_rail_init,
+                         (coll_args, team, task),
+                         ucc_base_coll_args_t *coll_args, ucc_base_team_t *team,
+                         ucc_coll_task_t **task)
+{
+    ucc_cl_hier_team_t       *cl_team = ucc_derived_of(team,
+                                                       ucc_cl_hier_team_t);
+    ucc_cl_hier_lib_config_t *cfg     = &UCC_CL_HIER_TEAM_LIB(cl_team)->cfg;
+    ucc_coll_args_t          *args    = &coll_args->args;
+    ucc_rank_t                size    = UCC_CL_TEAM_SIZE(cl_team);
+    ucc_cl_hier_schedule_t   *schedule;
+    ucc_rank_t               *rail_ranks;
+    uint64_t                 *counts, *displs;
+    size_t                    total, frag_total;
+    int                       n_frags, pipeline_depth;
+    ucc_status_t              status;
+    ucc_rank_t                i;
+
+    if (UCC_COLL_ARGS_ACTIVE_SET(&coll_args->args)) {
+        return UCC_ERR_NOT_SUPPORTED;
+    }
+    status = ucc_cl_hier_get_rail_ranks(cl_team, &rail_ranks);
+    if (UCC_OK != status) {
+        cl_debug(team->context->lib, "split_rail allgather is not supported "
+                                     "for the team layout");
+        return status;
+    }
+
+    schedule = ucc_cl_hier_get_schedule(cl_team);
+    if (ucc_unlikely(!schedule)) {
+        return UCC_ERR_NO_MEMORY;
+    }
+    counts = ucc_malloc(2 * size * sizeof(uint64_t), "counts");
+    if (ucc_unlikely(!counts)) {
+        cl_error(team->context->lib,
+                 "failed to allocate %zd bytes for counts array",
+                 2 * size * sizeof(uint64_t));
+        ucc_cl_hier_put_schedule(&schedule->super.super);
+        return UCC_ERR_NO_MEMORY;
+    }
+    displs = counts + size;
+    total  = 0;
+    for (i = 0; i < size; i++) {
+        if (IS_ALLGATHERV(args)) {
+            counts[i] = ucc_coll_args_get_count(args, args->dst.info_v.counts,
+                                                i);
+            displs[i] = ucc_coll_args_get_displacement(
+                args, args->dst.info_v.displacements, i);
+        } else {
+            counts[i] = args->dst.info.count / size;
+            displs[i] = i * counts[i];
+        }
+        total += counts[i];
+    }
+    schedule->split_rail.counts = counts;
+
+    ucc_cl_hier_get_n_frags(total * ucc_dt_size(ag_dt(args)),
+                            cfg->allgather_split_rail_frag_size,
+                            cfg->allgather_split_rail_pipeline_depth,
+                            &n_frags, &pipeline_depth);
+
+    /* fragment 0 is the largest one */
+    frag_total = 0;
+    for (i = 0; i < size; i++) {
+        frag_total += ucc_buffer_block_count(counts[i], n_frags, 0);
+    }
+    schedule->split_rail.node_shm = ucc_cl_hier_node_shm_fits(
+        cl_team, UCC_COLL_TYPE_ALLGATHERV,
+        frag_total * ucc_dt_size(ag_dt(args)), ag_mem_type(args));
+
+    status = ucc_schedule_pipelined_init(
+        coll_args, team, ucc_cl_hier_allgather_split_rail_frag_init,
+        ucc_cl_hier_allgather_split_rail_frag_setup, pipeline_depth, n_frags,
+        UCC_PIPELINE_PARALLEL, &schedule->super);
+    if (ucc_unlikely(status != UCC_OK)) {
+        cl_error(team->context->lib,
+                 "failed to init pipelined split_rail allgather schedule");
+        ucc_free(counts);
+        ucc_cl_hier_put_schedule(&schedule->super.super);
+        return status;
+    }
+
+    schedule->super.super.super.post = ucc_cl_hier_allgather_split_rail_start;
+    schedule->super.super.super.triggered_post = ucc_triggered_post;
+    schedule->super.super.super.finalize =
+        ucc_cl_hier_allgather_split_rail_schedule_finalize;
+    *task = &schedule->super.super.super;
+    return UCC_OK;
+}
@@ -7,7 +7,8 @@
 #include "allreduce.h"
 #include "../cl_hier_coll.h"
 
-#define MAX_AR_RAB_TASKS 3
+/* reduce and bcast per level, allreduce and AVG scaling on the top level */
+#define MAX_AR_RAB_TASKS (2 * UCC_CL_HIER_MAX_LEVELS)
 
 static ucc_status_t ucc_cl_hier_allreduce_rab_start(ucc_coll_task_t *task)
 {
@@ -32,16 +33,26 @@ UCC_CL_HIER_PROFILE_FUNC(ucc_status_t, ucc_cl_hier_allreduce_rab_init,
                          ucc_base_coll_args_t *coll_args, ucc_base_team_t *team,
                          ucc_coll_task_t **task)
 {
-    ucc_cl_hier_team_t  *cl_team = ucc_derived_of(team, ucc_cl_hier_team_t);
-    ucc_coll_task_t     *tasks[MAX_AR_RAB_TASKS] = {NULL};
-    ucc_schedule_t      *schedule;
-    ucc_status_t         status;
-    ucc_base_coll_args_t args;
-    int                  n_tasks, i;
-
-    if (coll_args->args.op == UCC_OP_AVG) {
+    ucc_cl_hier_team_t       *cl_team = ucc_derived_of(team,
+                                                       ucc_cl_hier_team_t);
+    int                       avg     = (coll_args->args.op == UCC_OP_AVG);
+    ucc_coll_task_t          *tasks[MAX_AR_RAB_TASKS] = {NULL};
+    ucc_schedule_t           *schedule;
+    ucc_status_t              status;
+    ucc_base_coll_args_t      args;
+    ucc_hier_sbgp_t          *hs;
+    ucc_cl_hier_scale_task_t *scale;
+    int                       n_tasks, i, l;
+
+    if (UCC_COLL_ARGS_ACTIVE_SET(&coll_args->args)) {
         return UCC_ERR_NOT_SUPPORTED;
     }
+    if (UCC_CL_HIER_ML_ENABLED(cl_team)) {
+        status = ucc_cl_hier_ml_init(coll_args, team, task);
+        if (status != UCC_ERR_NOT_SUPPORTED) {
+            return status;
+        }
+    }
     schedule = &ucc_cl_hier_get_schedule(cl_team)->super.super;
     if (ucc_unlikely(!schedule)) {
         return UCC_ERR_NO_MEMORY;
@@ -52,42 +63,59 @@ UCC_CL_HIER_PROFILE_FUNC(ucc_status_t, ucc_cl_hier_allreduce_rab_init,
     n_tasks        = 0;
     UCC_CHECK_GOTO(ucc_schedule_init(schedule, &args, team), out, status);
 
-    if (SBGP_ENABLED(cl_team, NODE)) {
-        ucc_assert(n_tasks == 0);
-        if (cl_team->top_sbgp == UCC_HIER_SBGP_NODE) {
+    if (avg) {
+        /* levels may have different sizes (non-uniform ppn), so AVG of
+           AVGs is not the AVG: SUM over the levels and scale once */
+        args.args.op = UCC_OP_SUM;
+    }
+    if (UCC_IS_INPLACE(args.args)) {
+        /* non-root ranks of in-place reduce take the data from src */
+        args.args.src.info = args.args.dst.info;
+    }
+
+    /* Reduce up to the top level, allreduce there and bcast the result
+       back down the levels */
+    for (l = 0; l < cl_team->n_levels; l++) {
+        if (!LEVEL_ENABLED(cl_team, l)) {
+            continue;
+        }
+        hs             = LEVEL_SBGP(cl_team, l);
+        args.args.root = hs->leader;
+        if (l == cl_team->n_levels - 1) {
+            ucc_assert(cl_team->top_sbgp == cl_team->levels[l]);
             args.args.coll_type = UCC_COLL_TYPE_ALLREDUCE;
         } else {
             args.args.coll_type = UCC_COLL_TYPE_REDUCE;
-            if (UCC_IS_INPLACE(args.args) &&
-                (SBGP_RANK(cl_team, NODE) != args.args.root)) {
-                args.args.src.info = args.args.dst.info;
-            }
         }
         UCC_CHECK_GOTO(
-            ucc_coll_init(SCORE_MAP(cl_team, NODE), &args, &tasks[n_tasks]),
+            ucc_coll_init(hs->score_map, &args, &tasks[n_tasks]),
             out, status);
         n_tasks++;
-        args.args.mask |= UCC_COLL_ARGS_FIELD_FLAGS;
-        args.args.flags |= UCC_COLL_ARGS_FLAG_IN_PLACE;
-    }
-
-    if (SBGP_ENABLED(cl_team, NODE_LEADERS)) {
-        ucc_assert(cl_team->top_sbgp == UCC_HIER_SBGP_NODE_LEADERS);
-        args.args.coll_type = UCC_COLL_TYPE_ALLREDUCE;
-        UCC_CHECK_GOTO(ucc_coll_init(SCORE_MAP(cl_team, NODE_LEADERS), &args,
-                                     &tasks[n_tasks]),
-                       out, status);
-        n_tasks++;
+        if (avg && l == cl_team->n_levels - 1) {
+            UCC_CHECK_GOTO(ucc_cl_hier_scale_task_init(&args, team, &scale),
+                           out, status);
+            scale->buf     = args.args.dst.info.buffer;
+            scale->count   = args.args.dst.info.count;
+            scale->dt      = args.args.dst.info.datatype;
+            scale->alpha   = 1.0 / (double)UCC_CL_TEAM_SIZE(cl_team);
+            tasks[n_tasks] = &scale->super;
+            n_tasks++;
+        }
+        /* the rest of the levels work in place on dst */
+        args.args.mask    |= UCC_COLL_ARGS_FIELD_FLAGS;
+        args.args.flags   |= UCC_COLL_ARGS_FLAG_IN_PLACE;
+        args.args.src.info = args.args.dst.info;
     }
 
-
-    if (SBGP_ENABLED(cl_team, NODE) &&
-        cl_team->top_sbgp != UCC_HIER_SBGP_NODE) {
-        /* For bcast src should point to origin dst of allreduce */
-        args.args.src.info  = args.args.dst.info;
+    for (l = cl_team->n_levels - 2; l >= 0; l--) {
+        if (!LEVEL_ENABLED(cl_team, l)) {
+            continue;
+        }
+        hs                  = LEVEL_SBGP(cl_team, l);
+        args.args.root      = hs->leader;
         args.args.coll_type = UCC_COLL_TYPE_BCAST;
         UCC_CHECK_GOTO(
-            ucc_coll_init(SCORE_MAP(cl_team, NODE), &args, &tasks[n_tasks]),
+            ucc_coll_init(hs->score_map, &args, &tasks[n_tasks]),
             out, status);
         n_tasks++;
     }
@@ -44,9 +44,10 @@ static ucc_status_t ucc_cl_hier_allreduce_split_rail_frag_setup(
     int              inplace = UCC_IS_INPLACE(*args);
     size_t           frag_count, frag_offset, ar_count, ar_offset;
     ucc_rank_t       node_size, node_rank;
-    ucc_coll_task_t *task_rs, *task_ar, *task_ag;
+    ucc_coll_task_t *task_rs, *task_ar, *task_ag, *task_sc;
     int              i;
     uint64_t *       counts, *displs;
+    uint64_t         shm_seq;
 
     node_size = cl_team->sbgps[UCC_HIER_SBGP_NODE].sbgp->group_size;
     node_rank = cl_team->sbgps[UCC_HIER_SBGP_NODE].sbgp->group_rank;
@@ -68,6 +69,7 @@ static ucc_status_t ucc_cl_hier_allreduce_split_rail_frag_setup(
     task_rs = frag->tasks[0];
     task_ar = frag->tasks[1];
     task_ag = frag->tasks[2];
+    task_sc = (frag->n_tasks > 3) ? frag->tasks[3] : NULL;
 
     ucc_assert(task_rs->bargs.args.dst.info_v.counts == counts);
 
@@ -87,12 +89,28 @@ static ucc_status_t ucc_cl_hier_allreduce_split_rail_frag_setup(
     task_ar->bargs.args.dst.info.buffer = PTR_OFFSET(
         args->dst.info.buffer, (frag_offset + ar_offset) * dt_size);
 
+    if (task_sc) {
+        ucc_derived_of(task_sc, ucc_cl_hier_scale_task_t)->buf =
+            task_ar->bargs.args.dst.info.buffer;
+        ucc_derived_of(task_sc, ucc_cl_hier_scale_task_t)->count = ar_count;
+    }
+
     ucc_assert(UCC_IS_INPLACE(task_ag->bargs.args));
     task_ag->bargs.args.dst.info_v.buffer = PTR_OFFSET(
         args->dst.info.buffer, frag_offset * dt_size); //only dst since inplace
     task_ag->bargs.args.src.info.count = frag_count;
     ucc_assert(task_ag->bargs.args.dst.info_v.counts == counts);
     ucc_assert(task_ag->bargs.args.dst.info_v.displacements == displs);
+
+    if (ucc_derived_of(schedule_p, ucc_cl_hier_schedule_t)
+            ->allreduce_split_rail.node_shm) {
+        /* 2 seq numbers per fragment are reserved at start */
+        ucc_assert(frag_num < n_frags);
+        shm_seq = ucc_derived_of(schedule_p, ucc_cl_hier_schedule_t)
+                      ->allreduce_split_rail.shm_seq + 2 * frag_num;
+        ucc_cl_hier_node_shm_set_seq(task_rs, shm_seq);
+        ucc_cl_hier_node_shm_set_seq(task_ag, shm_seq + 1);
+    }
     return UCC_OK;
 }
 
@@ -104,8 +122,12 @@ static ucc_status_t ucc_cl_hier_allreduce_split_rail_frag_init(
     size_t           dt_size = ucc_dt_size(coll_args->args.dst.info.datatype);
     ucc_status_t     status  = UCC_OK;
     int              inplace = UCC_IS_INPLACE(coll_args->args);
+    int              avg     = (coll_args->args.op == UCC_OP_AVG);
     int              n_frags = sp->super.n_tasks;
+    int              node_shm = ucc_derived_of(sp, ucc_cl_hier_schedule_t)
+                                    ->allreduce_split_rail.node_shm;
     ucc_coll_task_t *task_rs, *task_ag, *task_ar;
+    ucc_cl_hier_scale_task_t *task_sc = NULL;
     ucc_base_coll_args_t    rs_args, ar_args, ag_args;
     ucc_cl_hier_schedule_t *cl_schedule;
     ucc_schedule_t *        schedule;
@@ -147,6 +169,12 @@ static ucc_status_t ucc_cl_hier_allreduce_split_rail_frag_init(
     memcpy(&rs_args, coll_args, sizeof(rs_args));
     memcpy(&ar_args, coll_args, sizeof(ar_args));
     memcpy(&ag_args, coll_args, sizeof(ag_args));
+    if (avg) {
+        /* SUM over node and net, own slice of the result is scaled once
+           before the allgather */
+        rs_args.args.op = UCC_OP_SUM;
+        ar_args.args.op = UCC_OP_SUM;
+    }
 
     rs_args.args.mask |= UCC_COLL_ARGS_FIELD_FLAGS;
     rs_args.args.flags &= (~UCC_COLL_ARGS_FLAG_IN_PLACE);
@@ -176,7 +204,11 @@ static ucc_status_t ucc_cl_hier_allreduce_split_rail_frag_init(
         rs_args.args.src.info.count = coll_args->args.dst.info.count;
     }
 
-    status = ucc_coll_init(SCORE_MAP(cl_team, NODE), &rs_args, &task_rs);
+    if (node_shm) {
+        status = ucc_cl_hier_node_shm_task_init(&rs_args, team, &task_rs);
+    } else {
+        status = ucc_coll_init(SCORE_MAP(cl_team, NODE), &rs_args, &task_rs);
+    }
     if (ucc_unlikely(UCC_OK != status)) {
         cl_error(team->context->lib, "failed to init rs task");
         goto err_rs;
@@ -210,12 +242,26 @@ static ucc_status_t ucc_cl_hier_allreduce_split_rail_frag_init(
     ag_args.args.dst.info_v.counts        = counts;
     ag_args.args.dst.info_v.displacements = displs;
 
-    status = ucc_coll_init(SCORE_MAP(cl_team, NODE), &ag_args, &task_ag);
+    if (node_shm) {
+        status = ucc_cl_hier_node_shm_task_init(&ag_args, team, &task_ag);
+    } else {
+        status = ucc_coll_init(SCORE_MAP(cl_team, NODE), &ag_args, &task_ag);
+    }
     if (ucc_unlikely(UCC_OK != status)) {
         cl_error(team->context->lib, "failed to init ag task");
         goto err_ag;
     }
 
+    if (avg) {
+        status = ucc_cl_hier_scale_task_init(&ar_args, team, &task_sc);
+        if (ucc_unlikely(UCC_OK != status)) {
+            cl_error(team->context->lib, "failed to init scale task");
+            goto err_sc;
+        }
+        task_sc->dt    = coll_args->args.dst.info.datatype;
+        task_sc->alpha = 1.0 / (double)UCC_CL_TEAM_SIZE(cl_team);
+    }
+
     UCC_CHECK_GOTO(ucc_schedule_add_task(schedule, task_rs), err_ag, status);
     UCC_CHECK_GOTO(ucc_task_subscribe_dep(&schedule->super, task_rs,
                                           UCC_EVENT_SCHEDULE_STARTED),
@@ -227,10 +273,18 @@ static ucc_status_t ucc_cl_hier_allreduce_split_rail_frag_init(
                    err_ag, status);
 
     UCC_CHECK_GOTO(ucc_schedule_add_task(schedule, task_ag), err_ag, status);
-    UCC_CHECK_GOTO(ucc_task_subscribe_dep(task_ar, task_ag,
-                                          UCC_EVENT_COMPLETED),
+    UCC_CHECK_GOTO(ucc_task_subscribe_dep(task_sc ? &task_sc->super : task_ar,
+                                          task_ag, UCC_EVENT_COMPLETED),
                    err_ag, status);
 
+    if (task_sc) {
+        UCC_CHECK_GOTO(ucc_schedule_add_task(schedule, &task_sc->super),
+                       err_ag, status);
+        UCC_CHECK_GOTO(ucc_task_subscribe_dep(task_ar, &task_sc->super,
+                                              UCC_EVENT_COMPLETED),
+                       err_ag, status);
+    }
+
     schedule->super.post     = ucc_schedule_start;
     schedule->super.progress = NULL;
     schedule->super.finalize = ucc_cl_hier_allreduce_split_rail_frag_finalize;
@@ -238,6 +292,8 @@ static ucc_status_t ucc_cl_hier_allreduce_split_rail_frag_init(
     *frag_p = schedule;
     return status;
 
+err_sc:
+    ucc_collective_finalize(&task_ag->super);
 err_ag:
     if (task_ar) {
         ucc_collective_finalize(&task_ar->super);
@@ -274,7 +330,16 @@ ucc_cl_hier_split_rail_allreduce_start(ucc_coll_task_t *task)
 {
     ucc_schedule_pipelined_t *schedule =
         ucc_derived_of(task, ucc_schedule_pipelined_t);
+    ucc_cl_hier_schedule_t   *cl_schedule =
+        ucc_derived_of(task, ucc_cl_hier_schedule_t);
 
+    if (cl_schedule->allreduce_split_rail.node_shm) {
+        /* node reduce_scatter and allgather of every fragment */
+        cl_schedule->allreduce_split_rail.shm_seq =
+            ucc_cl_hier_node_shm_reserve(
+                ucc_derived_of(task->team, ucc_cl_hier_team_t),
+                2 * schedule->super.n_tasks);
+    }
     cl_info(task->team->context->lib,
             "posting split_rail ar, sbuf %p, rbuf %p, count %zd, dt %s, op %s, "
             "inplace %d, pdepth %d, frags_total %d",
@@ -296,13 +361,13 @@ UCC_CL_HIER_PROFILE_FUNC(ucc_status_t, ucc_cl_hier_allreduce_split_rail_init,
     ucc_cl_hier_team_t *cl_team = ucc_derived_of(team, ucc_cl_hier_team_t);
     ucc_cl_hier_lib_config_t *cfg   = &UCC_CL_HIER_TEAM_LIB(cl_team)->cfg;
     ucc_cl_hier_schedule_t *schedule;
+    ucc_coll_args_t    *args    = &coll_args->args;
     int                 n_frags, pipeline_depth;
     ucc_status_t status;
 
-    if (coll_args->args.op == UCC_OP_AVG) {
+    if (UCC_COLL_ARGS_ACTIVE_SET(&coll_args->args)) {
         return UCC_ERR_NOT_SUPPORTED;
     }
-
     if (!SBGP_ENABLED(cl_team, NODE) || !SBGP_ENABLED(cl_team, NET)) {
         return UCC_ERR_NOT_SUPPORTED;
     }
@@ -319,6 +384,14 @@ UCC_CL_HIER_PROFILE_FUNC(ucc_status_t, ucc_cl_hier_allreduce_split_rail_init,
     }
 
     get_n_frags(coll_args, cl_team, &n_frags, &pipeline_depth);
+    schedule->allreduce_split_rail.node_shm =
+        (UCC_IS_INPLACE(*args) ||
+         args->src.info.mem_type == UCC_MEMORY_TYPE_HOST) &&
+        ucc_cl_hier_node_shm_fits(
+            cl_team, UCC_COLL_TYPE_REDUCE_SCATTERV,
+            ucc_buffer_block_count(args->dst.info.count, n_frags, 0) *
+                ucc_dt_size(args->dst.info.datatype),
+            args->dst.info.mem_type);
 
     status = ucc_schedule_pipelined_init(
         coll_args, team, ucc_cl_hier_allreduce_split_rail_frag_init,
@@ -6,6 +6,7 @@
 
 #include "alltoall.h"
 #include "../alltoallv/alltoallv.h"
+#include "utils/ucc_malloc.h"
 
 ucc_base_coll_alg_info_t
     ucc_cl_hier_alltoall_algs[UCC_CL_HIER_ALLTOALL_ALG_LAST + 1] = {
@@ -22,13 +23,16 @@ UCC_CL_HIER_PROFILE_FUNC(ucc_status_t, ucc_cl_hier_alltoall_init,
                          ucc_base_coll_args_t *coll_args, ucc_base_team_t *team,
                          ucc_coll_task_t **task)
 {
-    ucc_cl_hier_team_t     *cl_team = ucc_derived_of(team, ucc_cl_hier_team_t);
-    ucc_status_t            status;
-    ucc_base_coll_args_t    args;
-    int                     i, count;
-    ucc_rank_t              team_size;
-    ucc_mc_buffer_header_t *h;
+    ucc_cl_hier_team_t  *cl_team   = ucc_derived_of(team, ucc_cl_hier_team_t);
+    ucc_rank_t           team_size = UCC_CL_TEAM_SIZE(cl_team);
+    ucc_status_t         status;
+    ucc_base_coll_args_t args;
+    uint64_t             count;
+    ucc_rank_t           i;
 
+    if (UCC_COLL_ARGS_ACTIVE_SET(&coll_args->args)) {
+        return UCC_ERR_NOT_SUPPORTED;
+    }
     if (UCC_IS_INPLACE(coll_args->args)) {
         cl_debug(team->context->lib, "inplace alltoall is not supported");
         return UCC_ERR_NOT_SUPPORTED;
@@ -39,6 +43,29 @@ UCC_CL_HIER_PROFILE_FUNC(ucc_status_t, ucc_cl_hier_alltoall_init,
         return UCC_ERR_NOT_SUPPORTED;
     }
 
+    /* counts and displacements of the alltoallv form are kept on the team
+       and rebuilt only when the count per peer changes, the alltoallv
+       counts split is cached by their address and content then */
+    count = coll_args->args.src.info.count / team_size;
+    if (!cl_team->a2a_counts) {
+        cl_team->a2a_counts = ucc_malloc(2 * team_size * sizeof(uint64_t),
+                                         "a2a_counts");
+        if (ucc_unlikely(!cl_team->a2a_counts)) {
+            cl_error(team->context->lib,
+                     "failed to allocate %zd bytes for full counts",
+                     2 * team_size * sizeof(uint64_t));
+            return UCC_ERR_NO_MEMORY;
+        }
+        cl_team->a2a_count = SIZE_MAX;
+    }
+    if (cl_team->a2a_count != count) {
+        for (i = 0; i < team_size; i++) {
+            cl_team->a2a_counts[i]             = count;
+            cl_team->a2a_counts[team_size + i] = count * i;
+        }
+        cl_team->a2a_count = count;
+    }
+
     memcpy(&args, coll_args, sizeof(args));
     args.args.coll_type = UCC_COLL_TYPE_ALLTOALLV;
     if (!(args.args.mask & UCC_COLL_ARGS_FIELD_FLAGS)) {
@@ -46,17 +73,9 @@ UCC_CL_HIER_PROFILE_FUNC(ucc_status_t, ucc_cl_hier_alltoall_init,
         args.args.flags = 0;
     }
     args.args.flags |= UCC_COLL_ARGS_FLAG_CONTIG_SRC_BUFFER |
-                       UCC_COLL_ARGS_FLAG_CONTIG_DST_BUFFER;
-    team_size = UCC_CL_TEAM_SIZE(cl_team);
-
-    status =
-        ucc_mc_alloc(&h, sizeof(int) * team_size * 2, UCC_MEMORY_TYPE_HOST);
-    if (ucc_unlikely(UCC_OK != status)) {
-        cl_error(team->context->lib,
-                 "failed to allocate %zd bytes for full counts",
-                 sizeof(int) * team_size * 2);
-        return status;
-    }
+                       UCC_COLL_ARGS_FLAG_CONTIG_DST_BUFFER |
+                       UCC_COLL_ARGS_FLAG_COUNT_64BIT |
+                       UCC_COLL_ARGS_FLAG_DISPLACEMENTS_64BIT;
 
     args.args.src.info_v.buffer   = coll_args->args.src.info.buffer;
     args.args.dst.info_v.buffer   = coll_args->args.dst.info.buffer;
@@ -65,27 +84,15 @@ UCC_CL_HIER_PROFILE_FUNC(ucc_status_t, ucc_cl_hier_alltoall_init,
     args.args.src.info_v.mem_type = coll_args->args.src.info.mem_type;
     args.args.dst.info_v.mem_type = coll_args->args.dst.info.mem_type;
 
-    args.args.src.info_v.counts = h->addr;
+    args.args.src.info_v.counts        = (ucc_count_t *)cl_team->a2a_counts;
     args.args.src.info_v.displacements =
-        PTR_OFFSET(h->addr, sizeof(int) * team_size);
-
+        (ucc_aint_t *)(cl_team->a2a_counts + team_size);
     args.args.dst.info_v.counts        = args.args.src.info_v.counts;
     args.args.dst.info_v.displacements = args.args.src.info_v.displacements;
 
-    count = (int)coll_args->args.src.info.count / team_size;
-    ((int *)args.args.src.info_v.counts)[0]        = count;
-    ((int *)args.args.src.info_v.displacements)[0] = 0;
-
-    for (i = 1; i < team_size; i++) {
-        ((int *)args.args.src.info_v.counts)[i] = count;
-        ((int *)args.args.src.info_v.displacements)[i] =
-            ((int *)args.args.src.info_v.displacements)[i - 1] + count;
-    }
     status = ucc_cl_hier_alltoallv_init(&args, team, task);
     if (UCC_OK != status) {
         cl_error(team->context->lib, "failed to init split node a2av task");
     }
-
-    ucc_mc_free(h);
     return status;
 }
@@ -16,6 +16,11 @@ ucc_base_coll_alg_info_t
              .name = "node_split",
              .desc = "splitting alltoallv into two concurrent a2av calls"
                      " withing the node and outside of it"},
+        [UCC_CL_HIER_ALLTOALLV_ALG_NODE_AGGR] =
+            {.id   = UCC_CL_HIER_ALLTOALLV_ALG_NODE_AGGR,
+             .name = "node_aggr",
+             .desc = "aggregation of the inter-node traffic on node leaders,"
+                     " one message per node pair, for small messages"},
         [UCC_CL_HIER_ALLTOALLV_ALG_LAST] = {
             .id = 0, .name = NULL, .desc = NULL}};
 
@@ -33,7 +38,11 @@ static ucc_status_t ucc_cl_hier_alltoallv_finalize(ucc_coll_task_t *task)
 
     UCC_CL_HIER_PROFILE_REQUEST_EVENT(task, "cl_hier_alltoallv_finalize", 0);
     ucc_assert(schedule->super.super.n_tasks == 2);
-    ucc_mc_free(schedule->scratch);
+    if (schedule->alltoallv.counts) {
+        schedule->alltoallv.counts->refcount--;
+    } else {
+        ucc_mc_free(schedule->scratch);
+    }
     status = ucc_schedule_finalize(task);
     ucc_cl_hier_put_schedule(&schedule->super.super);
     return status;
@@ -97,6 +106,73 @@ static ucc_status_t ucc_cl_hier_alltoallv_finalize(ucc_coll_task_t *task)
         }                                                                      \
     } while (0)
 
+/* Looks up the counts split of @args in the team cache. On a miss takes
+   an unused entry and sets *filled to 0, the caller computes the split
+   of split_size bytes at the start of the entry storage then. Returns NULL
+   if all the entries are in use. */
+static ucc_cl_hier_a2av_counts_t *
+ucc_cl_hier_a2av_counts_get(ucc_cl_hier_team_t *team, ucc_coll_args_t *args,
+                            size_t split_size, int *filled)
+{
+    ucc_rank_t                 size   = UCC_CL_TEAM_SIZE(team);
+    int                        c64    = UCC_COLL_ARGS_COUNT64(args);
+    size_t                     len    = size * (c64 ? 8 : 4);
+    ucc_cl_hier_a2av_counts_t  key    = {
+        .arrays   = {args->src.info_v.counts, args->src.info_v.displacements,
+                     args->dst.info_v.counts, args->dst.info_v.displacements},
+        .sdt_size = ucc_dt_size(args->src.info_v.datatype),
+        .rdt_size = ucc_dt_size(args->dst.info_v.datatype),
+        .c64      = c64};
+    ucc_cl_hier_a2av_counts_t *free_e = NULL;
+    ucc_cl_hier_a2av_counts_t *e;
+    void                      *keys;
+    int                        i, j;
+
+    for (i = 0; i < UCC_CL_HIER_A2AV_CACHE_SIZE; i++) {
+        e = &team->a2av_cache[i];
+        if (e->storage && !memcmp(e->arrays, key.arrays, sizeof(key.arrays)) &&
+            e->sdt_size == key.sdt_size && e->rdt_size == key.rdt_size &&
+            e->c64 == key.c64) {
+            /* the arrays may have been changed in place by the user */
+            keys = PTR_OFFSET(e->storage, split_size);
+            for (j = 0; j < 4; j++) {
+                if (memcmp(PTR_OFFSET(keys, j * len), key.arrays[j], len)) {
+                    break;
+                }
+            }
+            if (j == 4) {
+                e->refcount++;
+                *filled = 1;
+                return e;
+            }
+        }
+        if (e->refcount == 0 && (!free_e || !e->storage)) {
+            free_e = e;
+        }
+    }
+    if (!free_e) {
+        return NULL;
+    }
+    if (!free_e->storage) {
+        /* all the entries of the team have the same max size: the split
+           and the copy of the 4 arrays of 64 bit values */
+        free_e->storage = ucc_malloc(split_size + 4 * 8 * size,
+                                     "a2av_counts");
+        if (ucc_unlikely(!free_e->storage)) {
+            return NULL;
+        }
+    }
+    keys = PTR_OFFSET(free_e->storage, split_size);
+    for (j = 0; j < 4; j++) {
+        memcpy(PTR_OFFSET(keys, j * len), key.arrays[j], len);
+    }
+    key.storage   = free_e->storage;
+    key.refcount  = 1;
+    *free_e       = key;
+    *filled       = 0;
+    return free_e;
+}
+
 ucc_status_t ucc_cl_hier_alltoallv_triggered_post_setup(ucc_coll_task_t *task)
 {
     ucc_cl_hier_schedule_t *schedule =
@@ -120,21 +196,26 @@ UCC_CL_HIER_PROFILE_FUNC(ucc_status_t, ucc_cl_hier_alltoallv_init,
                          ucc_base_coll_args_t *coll_args, ucc_base_team_t *team,
                          ucc_coll_task_t **task)
 {
-    ucc_cl_hier_team_t     *cl_team = ucc_derived_of(team, ucc_cl_hier_team_t);
-    ucc_cl_hier_lib_t      *cl_lib  = UCC_CL_HIER_TEAM_LIB(cl_team);
-    ucc_cl_hier_schedule_t *cl_schedule;
-    ucc_schedule_t         *schedule;
-    ucc_status_t            status;
-    ucc_base_coll_args_t    args;
-    ucc_coll_task_t        *task_node, *task_full;
-    int                     c64, d64;
-    void                   *sc_full, *sd_full, *rc_full, *rd_full;
-    void                   *sc_node, *sd_node, *rc_node, *rd_node;
-    ucc_rank_t              full_size, node_size;
-    size_t                  sdt_size, rdt_size;
-    ucc_sbgp_t             *sbgp;
-    size_t                  elem_size;
+    ucc_cl_hier_team_t        *cl_team = ucc_derived_of(team,
+                                                        ucc_cl_hier_team_t);
+    ucc_cl_hier_lib_t         *cl_lib  = UCC_CL_HIER_TEAM_LIB(cl_team);
+    ucc_cl_hier_a2av_counts_t *cached  = NULL;
+    ucc_cl_hier_schedule_t    *cl_schedule;
+    ucc_schedule_t            *schedule;
+    ucc_status_t               status;
+    ucc_base_coll_args_t       args;
+    ucc_coll_task_t           *task_node, *task_full;
+    int                        c64, d64, filled;
+    void                      *sc_full, *sd_full, *rc_full, *rd_full;
+    void                      *sc_node, *sd_node, *rc_node, *rd_node;
+    ucc_rank_t                 full_size, node_size;
+    size_t                     sdt_size, rdt_size;
+    ucc_sbgp_t                *sbgp;
+    size_t                     elem_size;
 
+    if (UCC_COLL_ARGS_ACTIVE_SET(&coll_args->args)) {
+        return UCC_ERR_NOT_SUPPORTED;
+    }
     if (UCC_IS_INPLACE(coll_args->args)) {
         cl_debug(team->context->lib, "inplace alltoallv is not supported");
         return UCC_ERR_NOT_SUPPORTED;
@@ -164,19 +245,30 @@ UCC_CL_HIER_PROFILE_FUNC(ucc_status_t, ucc_cl_hier_alltoallv_init,
 
     full_size = cl_team->sbgps[UCC_HIER_SBGP_FULL].sbgp->group_size;
     node_size = cl_team->sbgps[UCC_HIER_SBGP_NODE].sbgp->group_size;
-
     elem_size = c64 ? 8 : 4;
-    status    = ucc_mc_alloc(&cl_schedule->scratch,
-                             elem_size * (full_size + node_size) * 4,
-                             UCC_MEMORY_TYPE_HOST);
-    if (ucc_unlikely(UCC_OK != status)) {
-        cl_error(team->context->lib,
-                 "failed to allocate %zd bytes for full counts",
-                 elem_size * (full_size + node_size) * 4);
-        goto error;
+
+    /* the split depends only on the counts, reuse it if the same counts
+       were already used with the team */
+    cached = ucc_cl_hier_a2av_counts_get(cl_team, &coll_args->args,
+                                         8 * (full_size + node_size) * 4,
+                                         &filled);
+    cl_schedule->alltoallv.counts = cached;
+    if (cached) {
+        sc_full = cached->storage;
+    } else {
+        filled = 0;
+        status = ucc_mc_alloc(&cl_schedule->scratch,
+                              elem_size * (full_size + node_size) * 4,
+                              UCC_MEMORY_TYPE_HOST);
+        if (ucc_unlikely(UCC_OK != status)) {
+            cl_error(team->context->lib,
+                     "failed to allocate %zd bytes for full counts",
+                     elem_size * (full_size + node_size) * 4);
+            goto error;
+        }
+        sc_full = cl_schedule->scratch->addr;
     }
 
-    sc_full = cl_schedule->scratch->addr;
     sd_full = PTR_OFFSET(sc_full, full_size * elem_size);
     rc_full = PTR_OFFSET(sc_full, full_size * elem_size * 2);
     rd_full = PTR_OFFSET(sc_full, full_size * elem_size * 3);
@@ -186,21 +278,35 @@ UCC_CL_HIER_PROFILE_FUNC(ucc_status_t, ucc_cl_hier_alltoallv_init,
     rc_node = PTR_OFFSET(sc_node, node_size * elem_size * 2);
     rd_node = PTR_OFFSET(sc_node, node_size * elem_size * 3);
 
-    /* Duplicate FULL a2av info and alloc task */
-    sbgp = cl_team->sbgps[UCC_HIER_SBGP_FULL].sbgp;
-    ucc_assert(sbgp->group_size == team->params.size);
     sdt_size = ucc_dt_size(coll_args->args.src.info_v.datatype);
     rdt_size = ucc_dt_size(coll_args->args.dst.info_v.datatype);
+    if (!filled) {
+        /* Duplicate FULL a2av info */
+        sbgp = cl_team->sbgps[UCC_HIER_SBGP_FULL].sbgp;
+        ucc_assert(sbgp->group_size == team->params.size);
+        if (c64) {
+            SET_FULL_COUNTS(uint64_t, sbgp, coll_args, team,
+                            cl_lib->cfg.a2av_node_thresh, sdt_size, rdt_size,
+                            sc_full, sd_full, rc_full, rd_full);
+        } else {
+            SET_FULL_COUNTS(uint32_t, sbgp, coll_args, team,
+                            cl_lib->cfg.a2av_node_thresh, sdt_size, rdt_size,
+                            sc_full, sd_full, rc_full, rd_full);
+        }
 
-    if (c64) {
-        SET_FULL_COUNTS(uint64_t, sbgp, coll_args, team,
-                        cl_lib->cfg.a2av_node_thresh, sdt_size, rdt_size,
-                        sc_full, sd_full, rc_full, rd_full);
-    } else {
-        SET_FULL_COUNTS(uint32_t, sbgp, coll_args, team,
-                        cl_lib->cfg.a2av_node_thresh, sdt_size, rdt_size,
-                        sc_full, sd_full, rc_full, rd_full);
+        /* Setup NODE a2av */
+        sbgp = cl_team->sbgps[UCC_HIER_SBGP_NODE].sbgp;
+        if (c64) {
+            SET_NODE_COUNTS(uint64_t, sbgp, coll_args,
+                            cl_lib->cfg.a2av_node_thresh, sdt_size, rdt_size,
+                            sc_node, sd_node, rc_node, rd_node);
+        } else {
+            SET_NODE_COUNTS(uint32_t, sbgp, coll_args,
+                            cl_lib->cfg.a2av_node_thresh, sdt_size, rdt_size,
+                            sc_node, sd_node, rc_node, rd_node);
+        }
     }
+
     args.args.src.info_v.counts        = (ucc_aint_t *)sc_full;
     args.args.dst.info_v.counts        = (ucc_aint_t *)rc_full;
     args.args.src.info_v.displacements = (ucc_aint_t *)sd_full;
@@ -210,18 +316,6 @@ UCC_CL_HIER_PROFILE_FUNC(ucc_status_t, ucc_cl_hier_alltoallv_init,
                                  &args, &task_full),
                    err_init_1, status);
 
-    /* Setup NODE a2av */
-    sbgp = cl_team->sbgps[UCC_HIER_SBGP_NODE].sbgp;
-
-    if (c64) {
-        SET_NODE_COUNTS(uint64_t, sbgp, coll_args, cl_lib->cfg.a2av_node_thresh,
-                        sdt_size, rdt_size, sc_node, sd_node, rc_node, rd_node);
-
-    } else {
-        SET_NODE_COUNTS(uint32_t, sbgp, coll_args, cl_lib->cfg.a2av_node_thresh,
-                        sdt_size, rdt_size, sc_node, sd_node, rc_node, rd_node);
-    }
-
     args.args.src.info_v.counts        = (ucc_aint_t *)sc_node;
     args.args.dst.info_v.counts        = (ucc_aint_t *)rc_node;
     args.args.src.info_v.displacements = (ucc_aint_t *)sd_node;
@@ -253,7 +347,11 @@ UCC_CL_HIER_PROFILE_FUNC(ucc_status_t, ucc_cl_hier_alltoallv_init,
 err_init_2:
     ucc_collective_finalize(&task_full->super);
 err_init_1:
-    ucc_mc_free(cl_schedule->scratch);
+    if (cached) {
+        cached->refcount--;
+    } else {
+        ucc_mc_free(cl_schedule->scratch);
+    }
 error:
     ucc_cl_hier_put_schedule(schedule);
     return status;
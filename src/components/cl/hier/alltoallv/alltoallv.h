@@ -11,6 +11,7 @@
 enum
 {
     UCC_CL_HIER_ALLTOALLV_ALG_NODE_SPLIT,
+    UCC_CL_HIER_ALLTOALLV_ALG_NODE_AGGR,
     UCC_CL_HIER_ALLTOALLV_ALG_LAST,
 };
 
@@ -21,6 +22,13 @@ ucc_status_t ucc_cl_hier_alltoallv_init(ucc_base_coll_args_t *coll_args,
                                         ucc_base_team_t      *team,
                                         ucc_coll_task_t     **task);
 
+ucc_status_t
+ucc_cl_hier_alltoallv_node_aggr_init(ucc_base_coll_args_t *coll_args,
+                                     ucc_base_team_t      *team,
+                                     ucc_coll_task_t     **task);
+
+ucc_status_t ucc_cl_hier_alltoallv_triggered_post_setup(ucc_coll_task_t *task);
+
 static inline int ucc_cl_hier_alltoallv_alg_from_str(const char *str)
 {
     int i;
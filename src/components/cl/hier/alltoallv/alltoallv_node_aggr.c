@@ -0,0 +1,709 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "alltoallv.h"
+#include "../cl_hier_coll.h"
+#include "core/ucc_team.h"
+#include "core/ucc_progress_queue.h"
+#include "utils/ucc_coll_utils.h"
+#include "utils/ucc_malloc.h"
+
+/* Node aggregation alltoallv for small per-peer messages at scale.
+   The traffic between nodes A and B goes through a single pair of
+   leaders: the processes with local rank (A + B) % n_leaders on both
+   nodes, which are on the same NET sbgp (rail). Every process sends
+   ppn * nnodes / n_leaders times fewer messages over the network:
+   1. each rank packs its blocks ordered by leader, node and local rank
+      of the destination and sends its send/recv counts of the node pairs
+      of every leader to that leader (metadata, NODE alltoallv)
+   2. leaders compute the layout of the exchange (plan task)
+   3. the packed data is gathered on the leaders (NODE alltoallv) and
+      regrouped by the destination node
+   4. leaders exchange one coalesced message per node pair (NET alltoallv)
+      and regroup the received data by the destination local rank
+   5. the data is scattered from the leaders (NODE alltoallv) and unpacked
+      into the user buffer.
+   All the exchanges are done in bytes with 64 bit counts. The counts of
+   the leader exchanges are only known after step 1, so these exchanges
+   are initialized again by the plan task once the counts are set. */
+
+enum {
+    AGGR_A2AV_META,
+    AGGR_A2AV_GATHER,
+    AGGR_A2AV_SCATTER,
+    AGGR_A2AV_LAST
+};
+
+/* The gather, net and scatter exchanges of the collective number seq on
+   the team use the tags 3 * seq, 3 * seq + 1 and 3 * seq + 2, wrapped to
+   the node_aggr range of the CL/HIER user tags */
+#define AGGR_N_TAGS UCC_CL_HIER_A2AV_AGGR_N_TAGS
+
+/* Alltoallv exchange over a sbgp, the TL task of which can be initialized
+   again with the final args. It uses an explicit tag: a TL task initialized
+   at post time would otherwise take a tag from the TL team sequence, which
+   depends on the order of init and post of the collectives on each rank. */
+typedef struct ucc_cl_hier_a2av_aggr_xchg_task {
+    ucc_coll_task_t      super;
+    ucc_score_map_t     *map;
+    ucc_base_coll_args_t args;
+    ucc_coll_task_t     *xchg;
+} ucc_cl_hier_a2av_aggr_xchg_task_t;
+
+typedef struct ucc_cl_hier_a2av_aggr_plan_task {
+    ucc_coll_task_t                    super;
+    ucc_cl_hier_schedule_t            *schedule;
+    ucc_rank_t                         n_leaders;
+    ucc_rank_t                         n_nodes;  /*< node pairs served */
+    uint64_t                          *meta;     /*< local ranks metadata */
+    uint64_t                          *a_gather; /*< subtasks counts */
+    uint64_t                          *a_net;
+    uint64_t                          *a_scatter;
+    ucc_cl_hier_a2av_aggr_xchg_task_t *gather;
+    ucc_cl_hier_copy_task_t           *repack_net;
+    ucc_cl_hier_a2av_aggr_xchg_task_t *net;
+    ucc_cl_hier_copy_task_t           *repack_node;
+    ucc_cl_hier_a2av_aggr_xchg_task_t *scatter;
+} ucc_cl_hier_a2av_aggr_plan_task_t;
+
+#define AGGR_MAX_TASKS 9
+
+/* Local rank of the leader serving the pair of own node and @node */
+static inline ucc_rank_t aggr_leader(ucc_cl_hier_team_t *team,
+                                     ucc_rank_t n_leaders, ucc_rank_t node)
+{
+    return (SBGP_RANK(team, NET) + node) % n_leaders;
+}
+
+static inline ucc_rank_t aggr_n_nodes(ucc_cl_hier_team_t *team,
+                                      ucc_rank_t n_leaders, ucc_rank_t leader)
+{
+    ucc_rank_t n = 0;
+    ucc_rank_t b;
+
+    for (b = 0; b < SBGP_SIZE(team, NET); b++) {
+        if (aggr_leader(team, n_leaders, b) == leader) {
+            n++;
+        }
+    }
+    return n;
+}
+
+static void aggr_set_args(ucc_base_coll_args_t *args, void *sbuf, void *rbuf,
+                          uint64_t *a2av, ucc_rank_t n, ucc_datatype_t dt,
+                          ucc_memory_type_t mem_type)
+{
+    args->args.coll_type  = UCC_COLL_TYPE_ALLTOALLV;
+    args->args.mask      |= UCC_COLL_ARGS_FIELD_FLAGS;
+    args->args.flags     &= ~UCC_COLL_ARGS_FLAG_IN_PLACE;
+    args->args.flags     |= (UCC_COLL_ARGS_FLAG_COUNT_64BIT |
+                             UCC_COLL_ARGS_FLAG_DISPLACEMENTS_64BIT);
+    args->args.src.info_v.buffer        = sbuf;
+    args->args.src.info_v.counts        = (ucc_count_t *)a2av;
+    args->args.src.info_v.displacements = (ucc_aint_t *)(a2av + n);
+    args->args.src.info_v.datatype      = dt;
+    args->args.src.info_v.mem_type      = mem_type;
+    args->args.dst.info_v.buffer        = rbuf;
+    args->args.dst.info_v.counts        = (ucc_count_t *)(a2av + 2 * n);
+    args->args.dst.info_v.displacements = (ucc_aint_t *)(a2av + 3 * n);
+    args->args.dst.info_v.datatype      = dt;
+    args->args.dst.info_v.mem_type      = mem_type;
+}
+
+static ucc_status_t
+ucc_cl_hier_a2av_aggr_xchg_post(ucc_coll_task_t *coll_task)
+{
+    ucc_cl_hier_a2av_aggr_xchg_task_t *task =
+        ucc_derived_of(coll_task, ucc_cl_hier_a2av_aggr_xchg_task_t);
+    ucc_status_t status;
+
+    if (task->xchg->flags & UCC_COLL_TASK_FLAG_EXECUTOR) {
+        status = ucc_coll_task_get_executor(coll_task,
+                                            &task->xchg->executor);
+        if (ucc_unlikely(UCC_OK != status)) {
+            return status;
+        }
+    }
+    status = task->xchg->post(task->xchg);
+    if (ucc_unlikely(status < 0)) {
+        coll_task->status = status;
+        return ucc_task_complete(coll_task);
+    }
+    coll_task->status = UCC_INPROGRESS;
+    return ucc_progress_queue_enqueue(coll_task->team->context->ucc_context->pq,
+                                      coll_task);
+}
+
+static void ucc_cl_hier_a2av_aggr_xchg_progress(ucc_coll_task_t *coll_task)
+{
+    ucc_cl_hier_a2av_aggr_xchg_task_t *task =
+        ucc_derived_of(coll_task, ucc_cl_hier_a2av_aggr_xchg_task_t);
+
+    coll_task->status = task->xchg->super.status;
+}
+
+static ucc_status_t
+ucc_cl_hier_a2av_aggr_xchg_finalize(ucc_coll_task_t *coll_task)
+{
+    ucc_cl_hier_a2av_aggr_xchg_task_t *task =
+        ucc_derived_of(coll_task, ucc_cl_hier_a2av_aggr_xchg_task_t);
+    ucc_status_t status = UCC_OK;
+
+    if (task->xchg) {
+        status = task->xchg->finalize(task->xchg);
+    }
+    ucc_coll_task_destruct(coll_task);
+    ucc_free(task);
+    return status;
+}
+
+/* Replaces the TL task with one initialized with the current args */
+static ucc_status_t
+ucc_cl_hier_a2av_aggr_xchg_reinit(ucc_cl_hier_a2av_aggr_xchg_task_t *task)
+{
+    ucc_coll_task_t *xchg = task->xchg;
+    ucc_status_t     status;
+
+    if (xchg) {
+        task->xchg = NULL;
+        status     = xchg->finalize(xchg);
+        if (ucc_unlikely(UCC_OK != status)) {
+            return status;
+        }
+    }
+    status = ucc_coll_init(task->map, &task->args, &task->xchg);
+    if (ucc_unlikely(UCC_OK != status)) {
+        task->xchg = NULL;
+        return status;
+    }
+    task->super.flags |= task->xchg->flags & UCC_COLL_TASK_FLAG_EXECUTOR;
+    return UCC_OK;
+}
+
+static ucc_status_t
+ucc_cl_hier_a2av_aggr_xchg_init(ucc_base_coll_args_t               *coll_args,
+                                ucc_base_team_t                    *team,
+                                ucc_score_map_t                    *map,
+                                ucc_base_coll_args_t               *xchg_args,
+                                uint64_t                            tag,
+                                ucc_cl_hier_a2av_aggr_xchg_task_t **task_p)
+{
+    ucc_cl_hier_a2av_aggr_xchg_task_t *task;
+    ucc_status_t                       status;
+
+    task = ucc_calloc(1, sizeof(*task), "cl_hier_a2av_aggr_xchg");
+    if (ucc_unlikely(!task)) {
+        cl_error(team->context->lib, "failed to allocate %zd bytes for task",
+                 sizeof(*task));
+        return UCC_ERR_NO_MEMORY;
+    }
+    ucc_coll_task_construct(&task->super);
+    status = ucc_coll_task_init(&task->super, coll_args, team);
+    if (ucc_unlikely(UCC_OK != status)) {
+        ucc_cl_hier_a2av_aggr_xchg_finalize(&task->super);
+        return status;
+    }
+    memcpy(&task->args, xchg_args, sizeof(task->args));
+    task->args.mask      |= UCC_COLL_ARGS_FIELD_TAG;
+    task->args.args.mask |= UCC_COLL_ARGS_FIELD_TAG;
+    task->args.args.tag   = tag;
+    task->map             = map;
+    status = ucc_coll_init(map, &task->args, &task->xchg);
+    if (ucc_unlikely(UCC_OK != status)) {
+        task->xchg = NULL;
+        ucc_cl_hier_a2av_aggr_xchg_finalize(&task->super);
+        return status;
+    }
+    task->super.flags    |= task->xchg->flags & UCC_COLL_TASK_FLAG_EXECUTOR;
+    task->super.post      = ucc_cl_hier_a2av_aggr_xchg_post;
+    task->super.progress  = ucc_cl_hier_a2av_aggr_xchg_progress;
+    task->super.finalize  = ucc_cl_hier_a2av_aggr_xchg_finalize;
+    *task_p               = task;
+    return UCC_OK;
+}
+
+/* Runs on the leaders once the metadata is received. Metadata of local
+   rank i holds, for every node b served by the leader and every local
+   rank j: S_i[b][j] - bytes i sends to rank j of node b, followed by
+   R_i[b][j] - bytes i receives from rank j of node b. */
+static ucc_status_t ucc_cl_hier_a2av_aggr_plan_post(ucc_coll_task_t *coll_task)
+{
+    ucc_cl_hier_a2av_aggr_plan_task_t *task =
+        ucc_derived_of(coll_task, ucc_cl_hier_a2av_aggr_plan_task_t);
+    ucc_cl_hier_team_t *cl_team =
+        ucc_derived_of(coll_task->team, ucc_cl_hier_team_t);
+    ucc_cl_hier_schedule_t  *schedule    = task->schedule;
+    ucc_cl_hier_copy_task_t *repack_net  = task->repack_net;
+    ucc_cl_hier_copy_task_t *repack_node = task->repack_node;
+    ucc_rank_t               ppn         = SBGP_SIZE(cl_team, NODE);
+    ucc_rank_t               nn          = SBGP_SIZE(cl_team, NET);
+    ucc_rank_t               lrank       = SBGP_RANK(cl_team, NODE);
+    ucc_rank_t               nbl         = task->n_nodes;
+    size_t                   meta_size   = 2 * ppn * nbl;
+    ucc_memory_type_t        mem_type    = repack_net->src_mem_type;
+    uint64_t                 gtotal, xtotal, off, c, *s_meta, *r_meta;
+    ucc_rank_t               i, j, b, bi, t;
+    ucc_status_t             status;
+    void                    *gbuf, *nbuf, *xbuf, *obuf;
+
+    /* gather: rank i sends its S_i ordered by (node, j), regrouped
+       into (node, i) order for the exchange over the rail */
+    gtotal = 0;
+    for (i = 0; i < ppn; i++) {
+        s_meta = task->meta + i * meta_size;
+        off    = gtotal;
+        for (bi = 0; bi < nbl; bi++) {
+            for (j = 0, c = 0; j < ppn; j++) {
+                c += s_meta[bi * ppn + j];
+            }
+            t                         = bi * ppn + i;
+            repack_net->counts[t]     = c;
+            repack_net->src_displs[t] = off;
+            off                      += c;
+        }
+        task->a_gather[2 * ppn + i] = off - gtotal;
+        task->a_gather[3 * ppn + i] = gtotal;
+        gtotal                      = off;
+    }
+    for (b = 0, bi = 0, off = 0; b < nn; b++) {
+        if (aggr_leader(cl_team, task->n_leaders, b) != lrank) {
+            continue;
+        }
+        task->a_net[nn + b] = off;
+        for (i = 0; i < ppn; i++) {
+            t                         = bi * ppn + i;
+            repack_net->dst_displs[t] = off;
+            off                      += repack_net->counts[t];
+        }
+        task->a_net[b] = off - task->a_net[nn + b];
+        bi++;
+    }
+
+    /* exchange: the message from node b is ordered by (i, j), where i is
+       the source rank on node b and j is the local destination, the size
+       of each block is known from R_j */
+    xtotal = 0;
+    for (b = 0, bi = 0; b < nn; b++) {
+        if (aggr_leader(cl_team, task->n_leaders, b) != lrank) {
+            continue;
+        }
+        task->a_net[3 * nn + b] = xtotal;
+        for (i = 0; i < ppn; i++) {
+            for (j = 0; j < ppn; j++) {
+                r_meta = task->meta + j * meta_size + ppn * nbl;
+                t      = (bi * ppn + i) * ppn + j;
+                repack_node->counts[t]     = r_meta[bi * ppn + i];
+                repack_node->src_displs[t] = xtotal;
+                xtotal                    += repack_node->counts[t];
+            }
+        }
+        task->a_net[2 * nn + b] = xtotal - task->a_net[3 * nn + b];
+        bi++;
+    }
+
+    /* scatter: rank j receives its blocks ordered by (node, i) */
+    for (j = 0, off = 0; j < ppn; j++) {
+        task->a_scatter[ppn + j] = off;
+        for (bi = 0; bi < nbl; bi++) {
+            for (i = 0; i < ppn; i++) {
+                t                          = (bi * ppn + i) * ppn + j;
+                repack_node->dst_displs[t] = off;
+                off                       += repack_node->counts[t];
+            }
+        }
+        task->a_scatter[j] = off - task->a_scatter[ppn + j];
+    }
+
+    /* counts are the same for every post of the collective, the leader
+       buffers and the exchanges are set up on the first one */
+    if (schedule->alltoallv_node_aggr.lscratch) {
+        coll_task->status = UCC_OK;
+        return ucc_task_complete(coll_task);
+    }
+    status = ucc_mc_alloc(&schedule->alltoallv_node_aggr.lscratch,
+                          ucc_max(2 * (gtotal + xtotal), 1), mem_type);
+    if (ucc_unlikely(UCC_OK != status)) {
+        cl_error(coll_task->team->context->lib,
+                 "failed to allocate %zd bytes for leader scratch",
+                 (size_t)(2 * (gtotal + xtotal)));
+        schedule->alltoallv_node_aggr.lscratch = NULL;
+        coll_task->status = status;
+        return ucc_task_complete(coll_task);
+    }
+    gbuf = schedule->alltoallv_node_aggr.lscratch->addr;
+    nbuf = PTR_OFFSET(gbuf, gtotal);
+    xbuf = PTR_OFFSET(nbuf, gtotal);
+    obuf = PTR_OFFSET(xbuf, xtotal);
+
+    task->gather->args.args.dst.info_v.buffer  = gbuf;
+    repack_net->src                            = gbuf;
+    repack_net->dst                            = nbuf;
+    task->net->args.args.src.info_v.buffer     = nbuf;
+    task->net->args.args.dst.info_v.buffer     = xbuf;
+    repack_node->src                           = xbuf;
+    repack_node->dst                           = obuf;
+    task->scatter->args.args.src.info_v.buffer = obuf;
+
+    UCC_CHECK_GOTO(ucc_cl_hier_a2av_aggr_xchg_reinit(task->gather), out,
+                   status);
+    UCC_CHECK_GOTO(ucc_cl_hier_a2av_aggr_xchg_reinit(task->net), out, status);
+    UCC_CHECK_GOTO(ucc_cl_hier_a2av_aggr_xchg_reinit(task->scatter), out,
+                   status);
+out:
+    if (ucc_unlikely(UCC_OK != status)) {
+        cl_error(coll_task->team->context->lib,
+                 "failed to set up node_aggr alltoallv exchanges");
+        if (schedule->alltoallv_node_aggr.lscratch) {
+            ucc_mc_free(schedule->alltoallv_node_aggr.lscratch);
+            schedule->alltoallv_node_aggr.lscratch = NULL;
+        }
+    }
+    coll_task->status = status;
+    return ucc_task_complete(coll_task);
+}
+
+static ucc_status_t
+ucc_cl_hier_a2av_aggr_plan_finalize(ucc_coll_task_t *coll_task)
+{
+    ucc_coll_task_destruct(coll_task);
+    ucc_free(coll_task);
+    return UCC_OK;
+}
+
+static ucc_status_t
+ucc_cl_hier_a2av_aggr_plan_init(ucc_base_coll_args_t               *coll_args,
+                                ucc_base_team_t                    *team,
+                                ucc_cl_hier_a2av_aggr_plan_task_t **task_p)
+{
+    ucc_cl_hier_a2av_aggr_plan_task_t *task;
+    ucc_status_t                       status;
+
+    task = ucc_calloc(1, sizeof(*task), "cl_hier_a2av_aggr_plan");
+    if (ucc_unlikely(!task)) {
+        cl_error(team->context->lib, "failed to allocate %zd bytes for task",
+                 sizeof(*task));
+        return UCC_ERR_NO_MEMORY;
+    }
+    ucc_coll_task_construct(&task->super);
+    status = ucc_coll_task_init(&task->super, coll_args, team);
+    if (ucc_unlikely(UCC_OK != status)) {
+        ucc_cl_hier_a2av_aggr_plan_finalize(&task->super);
+        return status;
+    }
+    task->super.post     = ucc_cl_hier_a2av_aggr_plan_post;
+    task->super.progress = NULL;
+    task->super.finalize = ucc_cl_hier_a2av_aggr_plan_finalize;
+    *task_p              = task;
+    return UCC_OK;
+}
+
+static ucc_status_t
+ucc_cl_hier_alltoallv_node_aggr_start(ucc_coll_task_t *task)
+{
+    UCC_CL_HIER_PROFILE_REQUEST_EVENT(task,
+                                      "cl_hier_alltoallv_node_aggr_start", 0);
+    cl_debug(task->team->context->lib,
+             "posting node_aggr alltoallv, sbuf %p, rbuf %p",
+             task->bargs.args.src.info_v.buffer,
+             task->bargs.args.dst.info_v.buffer);
+    return ucc_schedule_start(task);
+}
+
+static ucc_status_t
+ucc_cl_hier_alltoallv_node_aggr_finalize(ucc_coll_task_t *task)
+{
+    ucc_cl_hier_schedule_t *schedule =
+        ucc_derived_of(task, ucc_cl_hier_schedule_t);
+    ucc_status_t status;
+
+    UCC_CL_HIER_PROFILE_REQUEST_EVENT(task,
+                                      "cl_hier_alltoallv_node_aggr_finalize",
+                                      0);
+    status = ucc_schedule_finalize(task);
+    ucc_mc_free(schedule->scratch);
+    if (schedule->alltoallv_node_aggr.lscratch) {
+        ucc_mc_free(schedule->alltoallv_node_aggr.lscratch);
+    }
+    ucc_free(schedule->alltoallv_node_aggr.counts);
+    ucc_cl_hier_put_schedule(&schedule->super.super);
+    return status;
+}
+
+static inline void aggr_set_copy(ucc_cl_hier_copy_task_t *task,
+                                 uint64_t *storage, ucc_rank_t n_blocks,
+                                 ucc_memory_type_t mem_type)
+{
+    task->counts       = storage;
+    task->src_displs   = storage + n_blocks;
+    task->dst_displs   = storage + 2 * n_blocks;
+    task->n_blocks     = n_blocks;
+    task->dt_size      = 1;
+    task->src_mem_type = mem_type;
+    task->dst_mem_type = mem_type;
+}
+
+UCC_CL_HIER_PROFILE_FUNC(ucc_status_t, ucc_cl_hier_alltoallv_node_aggr_init,
+                         (coll_args, team, task),
+                         ucc_base_coll_args_t *coll_args, ucc_base_team_t *team,
+                         ucc_coll_task_t **task)
+{
+    ucc_cl_hier_team_t       *cl_team  = ucc_derived_of(team,
+                                                        ucc_cl_hier_team_t);
+    ucc_cl_hier_lib_config_t *cfg      = &UCC_CL_HIER_TEAM_LIB(cl_team)->cfg;
+    ucc_coll_args_t          *args     = &coll_args->args;
+    ucc_rank_t                size     = UCC_CL_TEAM_SIZE(cl_team);
+    ucc_memory_type_t         mem_type = args->src.info_v.mem_type;
+    ucc_coll_task_t          *tasks[AGGR_MAX_TASKS] = {NULL};
+    ucc_cl_hier_copy_task_t  *unpack      = NULL;
+    ucc_cl_hier_copy_task_t  *pack        = NULL;
+    ucc_cl_hier_copy_task_t  *repack_net  = NULL;
+    ucc_cl_hier_copy_task_t  *repack_node = NULL;
+    ucc_cl_hier_a2av_aggr_plan_task_t *plan = NULL;
+    ucc_cl_hier_a2av_aggr_xchg_task_t *xchg;
+    ucc_cl_hier_schedule_t   *cl_schedule;
+    ucc_schedule_t           *schedule;
+    ucc_base_coll_args_t      a2av_args;
+    ucc_rank_t               *rail_ranks;
+    ucc_rank_t                nn, ppn, lrank, n_leaders, nbl, n_l, l, b, j,
+                              r, t, k;
+    uint64_t                 *storage, *meta_s, *meta_r, *a2av[AGGR_A2AV_LAST],
+                             *a_net, *copy;
+    size_t                    sdt_size, rdt_size, n_storage, soff, roff, moff,
+                              sc, rc;
+    uint64_t                  tag;
+    ucc_status_t              status;
+    void                     *pbuf, *ubuf;
+    int                       n_tasks, is_leader, i;
+
+    if (UCC_COLL_ARGS_ACTIVE_SET(&coll_args->args)) {
+        return UCC_ERR_NOT_SUPPORTED;
+    }
+    if (UCC_IS_INPLACE(*args)) {
+        cl_debug(team->context->lib, "inplace alltoallv is not supported");
+        return UCC_ERR_NOT_SUPPORTED;
+    }
+    if (mem_type != args->dst.info_v.mem_type) {
+        cl_debug(team->context->lib,
+                 "node_aggr alltoallv requires same src and dst mem type");
+        return UCC_ERR_NOT_SUPPORTED;
+    }
+    status = ucc_cl_hier_get_rail_ranks(cl_team, &rail_ranks);
+    if (UCC_OK != status) {
+        cl_debug(team->context->lib, "node_aggr alltoallv is not supported "
+                                     "for the team layout");
+        return status;
+    }
+
+    nn        = SBGP_SIZE(cl_team, NET);
+    ppn       = SBGP_SIZE(cl_team, NODE);
+    lrank     = SBGP_RANK(cl_team, NODE);
+    n_leaders = ucc_min(ucc_max(cfg->a2av_node_aggr_n_leaders, 1),
+                        ucc_min(ppn, nn));
+    is_leader = lrank < n_leaders;
+    nbl       = is_leader ? aggr_n_nodes(cl_team, n_leaders, lrank) : 0;
+    tag       = (3 * (uint64_t)cl_team->a2av_aggr_seq++) % AGGR_N_TAGS;
+
+    cl_schedule = ucc_cl_hier_get_schedule(cl_team);
+    if (ucc_unlikely(!cl_schedule)) {
+        return UCC_ERR_NO_MEMORY;
+    }
+    schedule = &cl_schedule->super.super;
+    cl_schedule->alltoallv_node_aggr.lscratch = NULL;
+
+    /* metadata to and from the leaders, counts/displs of 3 NODE and
+       1 NET alltoallv, pack and unpack blocks, blocks of 2 leader
+       repacks */
+    n_storage = 2 * size + 2 * ppn * ppn * nbl + 4 * ppn * AGGR_A2AV_LAST +
+                4 * nn + 6 * size + 3 * ppn * nbl + 3 * ppn * ppn * nbl;
+    storage   = ucc_calloc(n_storage, sizeof(uint64_t), "a2av_aggr_counts");
+    if (ucc_unlikely(!storage)) {
+        cl_error(team->context->lib,
+                 "failed to allocate %zd bytes for counts",
+                 n_storage * sizeof(uint64_t));
+        ucc_cl_hier_put_schedule(schedule);
+        return UCC_ERR_NO_MEMORY;
+    }
+    cl_schedule->alltoallv_node_aggr.counts = storage;
+    meta_s = storage;
+    meta_r = meta_s + 2 * size;
+    for (i = 0; i < AGGR_A2AV_LAST; i++) {
+        a2av[i] = meta_r + 2 * ppn * ppn * nbl + 4 * ppn * i;
+    }
+    a_net = a2av[AGGR_A2AV_LAST - 1] + 4 * ppn;
+    copy  = a_net + 4 * nn;
+
+    n_tasks = 0;
+    UCC_CHECK_GOTO(ucc_cl_hier_copy_task_init(coll_args, team, &pack), err,
+                   status);
+    tasks[n_tasks++] = &pack->super;
+    aggr_set_copy(pack, copy, size, mem_type);
+    UCC_CHECK_GOTO(ucc_cl_hier_copy_task_init(coll_args, team, &unpack), err,
+                   status);
+    aggr_set_copy(unpack, copy + 3 * size, size, mem_type);
+
+    sdt_size = ucc_dt_size(args->src.info_v.datatype);
+    rdt_size = ucc_dt_size(args->dst.info_v.datatype);
+    soff = roff = moff = 0;
+    for (l = 0, t = 0; l < n_leaders; l++) {
+        n_l                                  = aggr_n_nodes(cl_team,
+                                                            n_leaders, l);
+        a2av[AGGR_A2AV_META][l]              = 2 * ppn * n_l;
+        a2av[AGGR_A2AV_META][ppn + l]        = moff;
+        a2av[AGGR_A2AV_GATHER][ppn + l]      = soff;
+        a2av[AGGR_A2AV_SCATTER][3 * ppn + l] = roff;
+        for (b = 0, k = 0; b < nn; b++) {
+            if (aggr_leader(cl_team, n_leaders, b) != l) {
+                continue;
+            }
+            for (j = 0; j < ppn; j++, k++, t++) {
+                r  = rail_ranks[j * nn + b];
+                sc = ucc_coll_args_get_count(args, args->src.info_v.counts,
+                                             r) * sdt_size;
+                rc = ucc_coll_args_get_count(args, args->dst.info_v.counts,
+                                             r) * rdt_size;
+                pack->counts[t]       = sc;
+                pack->src_displs[t]   = ucc_coll_args_get_displacement(
+                    args, args->src.info_v.displacements, r) * sdt_size;
+                pack->dst_displs[t]   = soff;
+                unpack->counts[t]     = rc;
+                unpack->src_displs[t] = roff;
+                unpack->dst_displs[t] = ucc_coll_args_get_displacement(
+                    args, args->dst.info_v.displacements, r) * rdt_size;
+                meta_s[moff + k]             = sc;
+                meta_s[moff + ppn * n_l + k] = rc;
+                soff                        += sc;
+                roff                        += rc;
+            }
+        }
+        a2av[AGGR_A2AV_GATHER][l] = soff - a2av[AGGR_A2AV_GATHER][ppn + l];
+        a2av[AGGR_A2AV_SCATTER][2 * ppn + l] =
+            roff - a2av[AGGR_A2AV_SCATTER][3 * ppn + l];
+        moff += 2 * ppn * n_l;
+    }
+    ucc_assert(t == size);
+    for (i = 0; i < ppn && is_leader; i++) {
+        a2av[AGGR_A2AV_META][2 * ppn + i] = 2 * ppn * nbl;
+        a2av[AGGR_A2AV_META][3 * ppn + i] = 2 * ppn * nbl * i;
+    }
+
+    UCC_CHECK_GOTO(ucc_mc_alloc(&cl_schedule->scratch,
+                                ucc_max(soff + roff, 1), mem_type),
+                   err, status);
+    pbuf         = cl_schedule->scratch->addr;
+    ubuf         = PTR_OFFSET(pbuf, soff);
+    pack->src    = args->src.info_v.buffer;
+    pack->dst    = pbuf;
+    unpack->src  = ubuf;
+    unpack->dst  = args->dst.info_v.buffer;
+
+    memcpy(&a2av_args, coll_args, sizeof(a2av_args));
+    aggr_set_args(&a2av_args, meta_s, meta_r, a2av[AGGR_A2AV_META], ppn,
+                  UCC_DT_UINT64, UCC_MEMORY_TYPE_HOST);
+    UCC_CHECK_GOTO(ucc_coll_init(SCORE_MAP(cl_team, NODE), &a2av_args,
+                                 &tasks[n_tasks++]),
+                   err, status);
+
+    if (is_leader) {
+        UCC_CHECK_GOTO(ucc_cl_hier_a2av_aggr_plan_init(coll_args, team,
+                                                       &plan),
+                       err, status);
+        tasks[n_tasks++] = &plan->super;
+    }
+
+    /* leader counts and buffers are set by the plan task */
+    aggr_set_args(&a2av_args, pbuf, ubuf, a2av[AGGR_A2AV_GATHER], ppn,
+                  UCC_DT_UINT8, mem_type);
+    UCC_CHECK_GOTO(ucc_cl_hier_a2av_aggr_xchg_init(
+                       coll_args, team, SCORE_MAP(cl_team, NODE), &a2av_args,
+                       tag, &xchg),
+                   err, status);
+    tasks[n_tasks++] = &xchg->super;
+
+    if (is_leader) {
+        plan->schedule  = cl_schedule;
+        plan->n_leaders = n_leaders;
+        plan->n_nodes   = nbl;
+        plan->meta      = meta_r;
+        plan->a_gather  = a2av[AGGR_A2AV_GATHER];
+        plan->a_net     = a_net;
+        plan->a_scatter = a2av[AGGR_A2AV_SCATTER];
+        plan->gather    = xchg;
+
+        UCC_CHECK_GOTO(ucc_cl_hier_copy_task_init(coll_args, team,
+                                                  &repack_net),
+                       err, status);
+        tasks[n_tasks++] = &repack_net->super;
+        aggr_set_copy(repack_net, copy + 6 * size, ppn * nbl, mem_type);
+        plan->repack_net = repack_net;
+
+        aggr_set_args(&a2av_args, pbuf, ubuf, a_net, nn, UCC_DT_UINT8,
+                      mem_type);
+        UCC_CHECK_GOTO(ucc_cl_hier_a2av_aggr_xchg_init(
+                           coll_args, team, SCORE_MAP(cl_team, NET),
+                           &a2av_args, tag + 1, &xchg),
+                       err, status);
+        tasks[n_tasks++] = &xchg->super;
+        plan->net        = xchg;
+
+        UCC_CHECK_GOTO(ucc_cl_hier_copy_task_init(coll_args, team,
+                                                  &repack_node),
+                       err, status);
+        tasks[n_tasks++] = &repack_node->super;
+        aggr_set_copy(repack_node, copy + 6 * size + 3 * ppn * nbl,
+                      ppn * ppn * nbl, mem_type);
+        plan->repack_node = repack_node;
+    }
+
+    aggr_set_args(&a2av_args, pbuf, ubuf, a2av[AGGR_A2AV_SCATTER], ppn,
+                  UCC_DT_UINT8, mem_type);
+    UCC_CHECK_GOTO(ucc_cl_hier_a2av_aggr_xchg_init(
+                       coll_args, team, SCORE_MAP(cl_team, NODE), &a2av_args,
+                       tag + 2, &xchg),
+                   err, status);
+    tasks[n_tasks++] = &xchg->super;
+    if (is_leader) {
+        plan->scatter = xchg;
+    }
+    tasks[n_tasks++] = &unpack->super;
+    unpack           = NULL;
+
+    UCC_CHECK_GOTO(ucc_schedule_init(schedule, coll_args, team), err, status);
+    UCC_CHECK_GOTO(ucc_schedule_add_task(schedule, tasks[0]), err, status);
+    UCC_CHECK_GOTO(ucc_task_subscribe_dep(&schedule->super, tasks[0],
+                                          UCC_EVENT_SCHEDULE_STARTED),
+                   err, status);
+    for (i = 1; i < n_tasks; i++) {
+        UCC_CHECK_GOTO(ucc_schedule_add_task(schedule, tasks[i]), err, status);
+        UCC_CHECK_GOTO(ucc_task_subscribe_dep(tasks[i - 1], tasks[i],
+                                              UCC_EVENT_COMPLETED),
+                       err, status);
+    }
+
+    schedule->super.post           = ucc_cl_hier_alltoallv_node_aggr_start;
+    schedule->super.progress       = NULL;
+    schedule->super.finalize       = ucc_cl_hier_alltoallv_node_aggr_finalize;
+    schedule->super.triggered_post = ucc_triggered_post;
+    schedule->super.triggered_post_setup =
+        ucc_cl_hier_alltoallv_triggered_post_setup;
+    *task = &schedule->super;
+    return UCC_OK;
+
+err:
+    for (i = 0; i < n_tasks; i++) {
+        if (tasks[i]) {
+            tasks[i]->finalize(tasks[i]);
+        }
+    }
+    if (unpack) {
+        unpack->super.finalize(&unpack->super);
+    }
+    if (cl_schedule->scratch) {
+        ucc_mc_free(cl_schedule->scratch);
+    }
+    ucc_free(storage);
+    ucc_cl_hier_put_schedule(schedule);
+    return status;
+}
@@ -7,7 +7,7 @@
 #include "barrier.h"
 #include "../cl_hier_coll.h"
 
-#define MAX_BARRIER_TASKS 3
+#define MAX_BARRIER_TASKS (2 * UCC_CL_HIER_MAX_LEVELS - 1)
 
 static ucc_status_t ucc_cl_hier_barrier_start(ucc_coll_task_t *task)
 {
@@ -37,8 +37,12 @@ UCC_CL_HIER_PROFILE_FUNC(ucc_status_t, ucc_cl_hier_barrier_init,
     ucc_schedule_t      *schedule;
     ucc_status_t         status;
     ucc_base_coll_args_t args;
-    int                  n_tasks, i;
+    ucc_hier_sbgp_t     *hs;
+    int                  n_tasks, i, l;
 
+    if (UCC_COLL_ARGS_ACTIVE_SET(&coll_args->args)) {
+        return UCC_ERR_NOT_SUPPORTED;
+    }
     schedule = &ucc_cl_hier_get_schedule(cl_team)->super.super;
     if (ucc_unlikely(!schedule)) {
         return UCC_ERR_NO_MEMORY;
@@ -49,34 +53,32 @@ UCC_CL_HIER_PROFILE_FUNC(ucc_status_t, ucc_cl_hier_barrier_init,
     n_tasks        = 0;
     UCC_CHECK_GOTO(ucc_schedule_init(schedule, &args, team), out, status);
 
-    if (SBGP_ENABLED(cl_team, NODE)) {
-        ucc_assert(n_tasks == 0);
-        if (cl_team->top_sbgp == UCC_HIER_SBGP_NODE) {
+    for (l = 0; l < cl_team->n_levels; l++) {
+        if (!LEVEL_ENABLED(cl_team, l)) {
+            continue;
+        }
+        hs             = LEVEL_SBGP(cl_team, l);
+        args.args.root = hs->leader;
+        if (l == cl_team->n_levels - 1) {
             args.args.coll_type = UCC_COLL_TYPE_BARRIER;
         } else {
             args.args.coll_type = UCC_COLL_TYPE_FANIN;
         }
         UCC_CHECK_GOTO(
-            ucc_coll_init(SCORE_MAP(cl_team, NODE), &args, &tasks[n_tasks]),
+            ucc_coll_init(hs->score_map, &args, &tasks[n_tasks]),
             out, status);
         n_tasks++;
     }
 
-    if (SBGP_ENABLED(cl_team, NODE_LEADERS)) {
-        ucc_assert(cl_team->top_sbgp == UCC_HIER_SBGP_NODE_LEADERS);
-        args.args.coll_type = UCC_COLL_TYPE_BARRIER;
-        UCC_CHECK_GOTO(ucc_coll_init(SCORE_MAP(cl_team, NODE_LEADERS), &args,
-                                     &tasks[n_tasks]),
-                       out, status);
-        n_tasks++;
-    }
-
-
-    if (SBGP_ENABLED(cl_team, NODE) &&
-        cl_team->top_sbgp != UCC_HIER_SBGP_NODE) {
+    for (l = cl_team->n_levels - 2; l >= 0; l--) {
+        if (!LEVEL_ENABLED(cl_team, l)) {
+            continue;
+        }
+        hs                  = LEVEL_SBGP(cl_team, l);
+        args.args.root      = hs->leader;
         args.args.coll_type = UCC_COLL_TYPE_FANOUT;
         UCC_CHECK_GOTO(
-            ucc_coll_init(SCORE_MAP(cl_team, NODE), &args, &tasks[n_tasks]),
+            ucc_coll_init(hs->score_map, &args, &tasks[n_tasks]),
             out, status);
         n_tasks++;
     }
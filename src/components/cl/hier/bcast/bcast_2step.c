@@ -0,0 +1,213 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "bcast.h"
+#include "../cl_hier_coll.h"
+#include "core/ucc_team.h"
+
+static ucc_status_t
+ucc_cl_hier_bcast_2step_frag_finalize(ucc_coll_task_t *task)
+{
+    ucc_schedule_t *schedule = ucc_derived_of(task, ucc_schedule_t);
+    ucc_status_t    status;
+
+    status = ucc_schedule_finalize(task);
+    ucc_cl_hier_put_schedule(schedule);
+    return status;
+}
+
+static ucc_status_t
+ucc_cl_hier_bcast_2step_schedule_finalize(ucc_coll_task_t *task)
+{
+    ucc_cl_hier_schedule_t *schedule =
+        ucc_derived_of(task, ucc_cl_hier_schedule_t);
+    ucc_status_t status;
+
+    UCC_CL_HIER_PROFILE_REQUEST_EVENT(task, "cl_hier_bcast_2step_finalize",
+                                      0);
+    status = ucc_schedule_pipelined_finalize(&schedule->super.super.super);
+    ucc_cl_hier_put_schedule(&schedule->super.super);
+    return status;
+}
+
+static ucc_status_t
+ucc_cl_hier_bcast_2step_frag_setup(ucc_schedule_pipelined_t *schedule_p,
+                                   ucc_schedule_t *frag, int frag_num)
+{
+    ucc_coll_args_t *args    = &schedule_p->super.super.bargs.args;
+    size_t           dt_size = ucc_dt_size(args->src.info.datatype);
+    int              n_frags = schedule_p->super.n_tasks;
+    size_t           frag_count, frag_offset;
+    int              i;
+
+    frag_count =
+        ucc_buffer_block_count(args->src.info.count, n_frags, frag_num);
+    frag_offset =
+        ucc_buffer_block_offset(args->src.info.count, n_frags, frag_num);
+
+    for (i = 0; i < frag->n_tasks; i++) {
+        frag->tasks[i]->bargs.args.src.info.buffer =
+            PTR_OFFSET(args->src.info.buffer, frag_offset * dt_size);
+        frag->tasks[i]->bargs.args.src.info.count = frag_count;
+    }
+    return UCC_OK;
+}
+
+/* The data of root goes up the hier levels: at each level the sbgp holding
+   the data bcasts it unless it is already on the sbgp leader. At the top
+   level the data is bcasted from the process representing the root,
+   then it goes down the levels from the leaders to the sbgps which have
+   not got it on the way up. */
+static ucc_status_t
+ucc_cl_hier_bcast_2step_frag_init(ucc_base_coll_args_t     *coll_args,
+                                  ucc_schedule_pipelined_t *sp, //NOLINT
+                                  ucc_base_team_t          *team,
+                                  ucc_schedule_t          **frag_p)
+{
+    ucc_cl_hier_team_t  *cl_team = ucc_derived_of(team, ucc_cl_hier_team_t);
+    ucc_coll_task_t     *tasks[UCC_CL_HIER_MAX_LEVEL_TASKS] = {NULL};
+    ucc_rank_t           root    = coll_args->args.root;
+    ucc_cl_hier_schedule_t *cl_schedule;
+    ucc_schedule_t      *schedule;
+    ucc_status_t         status;
+    ucc_base_coll_args_t args;
+    ucc_hier_sbgp_t     *hs;
+    ucc_rank_t           level_root;
+    int                  n_tasks, i, l;
+
+    cl_schedule = ucc_cl_hier_get_schedule(cl_team);
+    if (ucc_unlikely(!cl_schedule)) {
+        return UCC_ERR_NO_MEMORY;
+    }
+    schedule = &cl_schedule->super.super;
+    memcpy(&args, coll_args, sizeof(args));
+    n_tasks = 0;
+    UCC_CHECK_GOTO(ucc_schedule_init(schedule, &args, team), out, status);
+
+    for (l = 0; l < cl_team->n_levels; l++) {
+        if (!LEVEL_ENABLED(cl_team, l)) {
+            continue;
+        }
+        hs         = LEVEL_SBGP(cl_team, l);
+        level_root = ucc_cl_hier_level_root(cl_team, l, root);
+        if (level_root == UCC_RANK_INVALID ||
+            (level_root == hs->leader && l < cl_team->n_levels - 1)) {
+            continue;
+        }
+        args.args.root = level_root;
+        UCC_CHECK_GOTO(ucc_coll_init(hs->score_map, &args, &tasks[n_tasks]),
+                       out, status);
+        n_tasks++;
+    }
+
+    for (l = cl_team->n_levels - 2; l >= 0; l--) {
+        if (!LEVEL_ENABLED(cl_team, l)) {
+            continue;
+        }
+        hs         = LEVEL_SBGP(cl_team, l);
+        level_root = ucc_cl_hier_level_root(cl_team, l, root);
+        if (level_root != UCC_RANK_INVALID && level_root != hs->leader) {
+            /* got the data on the way up */
+            continue;
+        }
+        args.args.root = hs->leader;
+        UCC_CHECK_GOTO(ucc_coll_init(hs->score_map, &args, &tasks[n_tasks]),
+                       out, status);
+        n_tasks++;
+    }
+    ucc_assert(n_tasks > 0);
+
+    UCC_CHECK_GOTO(ucc_schedule_add_task(schedule, tasks[0]), out, status);
+    UCC_CHECK_GOTO(ucc_task_subscribe_dep(&schedule->super, tasks[0],
+                                          UCC_EVENT_SCHEDULE_STARTED),
+                   out, status);
+    for (i = 1; i < n_tasks; i++) {
+        UCC_CHECK_GOTO(ucc_schedule_add_task(schedule, tasks[i]), out, status);
+        UCC_CHECK_GOTO(ucc_task_subscribe_dep(tasks[i - 1], tasks[i],
+                                              UCC_EVENT_COMPLETED),
+                       out, status);
+    }
+
+    schedule->super.post     = ucc_schedule_start;
+    schedule->super.progress = NULL;
+    schedule->super.finalize = ucc_cl_hier_bcast_2step_frag_finalize;
+    *frag_p                  = schedule;
+    return UCC_OK;
+
+out:
+    for (i = 0; i < n_tasks; i++) {
+        tasks[i]->finalize(tasks[i]);
+    }
+    ucc_cl_hier_put_schedule(schedule);
+    return status;
+}
+
+static ucc_status_t ucc_cl_hier_bcast_2step_start(ucc_coll_task_t *task)
+{
+    ucc_schedule_pipelined_t *schedule =
+        ucc_derived_of(task, ucc_schedule_pipelined_t);
+
+    UCC_CL_HIER_PROFILE_REQUEST_EVENT(task, "cl_hier_bcast_2step_start", 0);
+    cl_debug(task->team->context->lib,
+             "posting 2step bcast, buf %p, count %zd, dt %s, root %u, "
+             "pdepth %d, frags_total %d",
+             task->bargs.args.src.info.buffer, task->bargs.args.src.info.count,
+             ucc_datatype_str(task->bargs.args.src.info.datatype),
+             task->bargs.args.root, schedule->n_frags,
+             schedule->super.n_tasks);
+    return ucc_schedule_pipelined_post(task);
+}
+
+UCC_CL_HIER_PROFILE_FUNC(ucc_status_t, ucc_cl_hier_bcast_2step_init,
+                         (coll_args, team, task),
+                         ucc_base_coll_args_t *coll_args, ucc_base_team_t *team,
+                         ucc_coll_task_t **task)
+{
+    ucc_cl_hier_team_t       *cl_team = ucc_derived_of(team,
+                                                       ucc_cl_hier_team_t);
+    ucc_cl_hier_lib_config_t *cfg     = &UCC_CL_HIER_TEAM_LIB(cl_team)->cfg;
+    ucc_cl_hier_schedule_t   *schedule;
+    int                       n_frags, pipeline_depth;
+    ucc_status_t              status;
+
+    if (UCC_COLL_ARGS_ACTIVE_SET(&coll_args->args)) {
+        return UCC_ERR_NOT_SUPPORTED;
+    }
+    if (UCC_CL_HIER_ML_ENABLED(cl_team)) {
+        status = ucc_cl_hier_ml_init(coll_args, team, task);
+        if (status != UCC_ERR_NOT_SUPPORTED) {
+            return status;
+        }
+    }
+    schedule = ucc_cl_hier_get_schedule(cl_team);
+    if (ucc_unlikely(!schedule)) {
+        return UCC_ERR_NO_MEMORY;
+    }
+
+    ucc_cl_hier_get_n_frags(coll_args->args.src.info.count *
+                                ucc_dt_size(coll_args->args.src.info.datatype),
+                            cfg->bcast_2step_frag_size,
+                            cfg->bcast_2step_pipeline_depth, &n_frags,
+                            &pipeline_depth);
+
+    status = ucc_schedule_pipelined_init(
+        coll_args, team, ucc_cl_hier_bcast_2step_frag_init,
+        ucc_cl_hier_bcast_2step_frag_setup, pipeline_depth, n_frags,
+        UCC_PIPELINE_PARALLEL, &schedule->super);
+    if (ucc_unlikely(status != UCC_OK)) {
+        cl_error(team->context->lib,
+                 "failed to init pipelined 2step bcast schedule");
+        ucc_cl_hier_put_schedule(&schedule->super.super);
+        return status;
+    }
+
+    schedule->super.super.super.post           = ucc_cl_hier_bcast_2step_start;
+    schedule->super.super.super.triggered_post = ucc_triggered_post;
+    schedule->super.super.super.finalize =
+        ucc_cl_hier_bcast_2step_schedule_finalize;
+    *task = &schedule->super.super.super;
+    return UCC_OK;
+}
@@ -9,17 +9,28 @@
 #include "allreduce/allreduce.h"
 #include "alltoall/alltoall.h"
 #include "alltoallv/alltoallv.h"
+#include "bcast/bcast.h"
+#include "reduce/reduce.h"
+#include "allgather/allgather.h"
+#include "reduce_scatter/reduce_scatter.h"
 
 ucc_status_t ucc_cl_hier_get_lib_attr(const ucc_base_lib_t *lib,
                                       ucc_base_lib_attr_t  *base_attr);
 ucc_status_t ucc_cl_hier_get_context_attr(const ucc_base_context_t *context,
                                           ucc_base_ctx_attr_t      *base_attr);
 
+const char *ucc_cl_hier_node_split_names[] = {
+    [UCC_CL_HIER_NODE_SPLIT_NONE]   = "none",
+    [UCC_CL_HIER_NODE_SPLIT_SOCKET] = "socket",
+    [UCC_CL_HIER_NODE_SPLIT_NUMA]   = "numa",
+    [UCC_CL_HIER_NODE_SPLIT_LAST]   = NULL
+};
+
 static ucc_config_field_t ucc_cl_hier_lib_config_table[] = {
     {"", "", NULL, ucc_offsetof(ucc_cl_hier_lib_config_t, super),
      UCC_CONFIG_TYPE_TABLE(ucc_cl_lib_config_table)},
 
-    {"NODE_SBGP_TLS", "ucp",
+    {"NODE_SBGP_TLS", "ucp,shm",
      "TLS to be used for NODE subgroup.\n"
      "NODE subgroup contains processes of a team located on the same node",
      ucc_offsetof(ucc_cl_hier_lib_config_t, sbgp_tls[UCC_HIER_SBGP_NODE]),
@@ -48,11 +59,74 @@ static ucc_config_field_t ucc_cl_hier_lib_config_table[] = {
      ucc_offsetof(ucc_cl_hier_lib_config_t, sbgp_tls[UCC_HIER_SBGP_FULL]),
      UCC_CONFIG_TYPE_ALLOW_LIST},
 
+    {"SOCKET_SBGP_TLS", "ucp",
+     "TLS to be used for SOCKET subgroup.\n"
+     "SOCKET subgroup contains processes of a team located on the same "
+     "socket. Used when NODE_SPLIT=socket",
+     ucc_offsetof(ucc_cl_hier_lib_config_t, sbgp_tls[UCC_HIER_SBGP_SOCKET]),
+     UCC_CONFIG_TYPE_ALLOW_LIST},
+
+    {"SOCKET_LEADERS_SBGP_TLS", "ucp",
+     "TLS to be used for SOCKET_LEADERS subgroup.\n"
+     "SOCKET_LEADERS subgroup contains one process per socket of a node. "
+     "Used when NODE_SPLIT=socket",
+     ucc_offsetof(ucc_cl_hier_lib_config_t,
+                  sbgp_tls[UCC_HIER_SBGP_SOCKET_LEADERS]),
+     UCC_CONFIG_TYPE_ALLOW_LIST},
+
+    {"NUMA_SBGP_TLS", "ucp",
+     "TLS to be used for NUMA subgroup.\n"
+     "NUMA subgroup contains processes of a team located on the same NUMA "
+     "domain. Used when NODE_SPLIT=numa",
+     ucc_offsetof(ucc_cl_hier_lib_config_t, sbgp_tls[UCC_HIER_SBGP_NUMA]),
+     UCC_CONFIG_TYPE_ALLOW_LIST},
+
+    {"NUMA_LEADERS_SBGP_TLS", "ucp",
+     "TLS to be used for NUMA_LEADERS subgroup.\n"
+     "NUMA_LEADERS subgroup contains one process per NUMA domain of a node. "
+     "Used when NODE_SPLIT=numa",
+     ucc_offsetof(ucc_cl_hier_lib_config_t,
+                  sbgp_tls[UCC_HIER_SBGP_NUMA_LEADERS]),
+     UCC_CONFIG_TYPE_ALLOW_LIST},
+
+    {"NODE_SPLIT", "none",
+     "Topology level used to split the intra-node phase of hierarchical "
+     "algorithms (none/socket/numa).\n"
+     "none   - single NODE level\n"
+     "socket - SOCKET level followed by SOCKET_LEADERS level\n"
+     "numa   - NUMA level followed by NUMA_LEADERS level\n"
+     "Falls back to none if processes are not bound or a node has a "
+     "single socket/NUMA domain",
+     ucc_offsetof(ucc_cl_hier_lib_config_t, node_split),
+     UCC_CONFIG_TYPE_ENUM(ucc_cl_hier_node_split_names)},
+
+    {"N_LEADERS", "1",
+     "Number of leader processes per node used by allreduce, bcast and "
+     "reduce. With more than one leader the buffer is split into slices, "
+     "each slice goes over the network through its own leader and its NET "
+     "subgroup (rail). Capped by the number of processes per node",
+     ucc_offsetof(ucc_cl_hier_lib_config_t, n_leaders),
+     UCC_CONFIG_TYPE_UINT},
+
+    {"LEADERS_ROTATE", "n",
+     "Rotate the local ranks acting as node leaders with every collective "
+     "to balance NIC and CPU load. Used with N_LEADERS",
+     ucc_offsetof(ucc_cl_hier_lib_config_t, leaders_rotate),
+     UCC_CONFIG_TYPE_BOOL},
+
     {"ALLTOALLV_SPLIT_NODE_THRESH", "0",
      "Messages larger than that threshold will be sent via node sbgp tl",
      ucc_offsetof(ucc_cl_hier_lib_config_t, a2av_node_thresh),
      UCC_CONFIG_TYPE_MEMUNITS},
 
+    {"ALLTOALLV_NODE_AGGR_N_LEADERS", "1",
+     "Number of leader processes per node used by node_aggr alltoallv. "
+     "The traffic between nodes A and B goes through the leader with local "
+     "rank (A + B) % N_LEADERS. Capped by the number of processes per node "
+     "and the number of nodes",
+     ucc_offsetof(ucc_cl_hier_lib_config_t, a2av_node_aggr_n_leaders),
+     UCC_CONFIG_TYPE_UINT},
+
     {"ALLREDUCE_SPLIT_RAIL_FRAG_THRESH", "inf",
      "Threshold to enable fragmentation and pipelining of Split_Rail "
      "allreduce alg",
@@ -83,6 +157,64 @@ static ucc_config_field_t ucc_cl_hier_lib_config_table[] = {
      ucc_offsetof(ucc_cl_hier_lib_config_t, allreduce_split_rail_pipeline_order),
      UCC_CONFIG_TYPE_ENUM(ucc_pipeline_order_names)},
 
+    {"BCAST_2STEP_FRAG_SIZE", "inf",
+     "Maximum fragment size of 2step bcast alg, larger messages are "
+     "pipelined",
+     ucc_offsetof(ucc_cl_hier_lib_config_t, bcast_2step_frag_size),
+     UCC_CONFIG_TYPE_MEMUNITS},
+
+    {"BCAST_2STEP_PIPELINE_DEPTH", "2",
+     "Number of fragments simultaneously progressed by the 2step bcast alg",
+     ucc_offsetof(ucc_cl_hier_lib_config_t, bcast_2step_pipeline_depth),
+     UCC_CONFIG_TYPE_UINT},
+
+    {"REDUCE_2STEP_FRAG_SIZE", "inf",
+     "Maximum fragment size of 2step reduce alg, larger messages are "
+     "pipelined",
+     ucc_offsetof(ucc_cl_hier_lib_config_t, reduce_2step_frag_size),
+     UCC_CONFIG_TYPE_MEMUNITS},
+
+    {"REDUCE_2STEP_PIPELINE_DEPTH", "2",
+     "Number of fragments simultaneously progressed by the 2step reduce alg",
+     ucc_offsetof(ucc_cl_hier_lib_config_t, reduce_2step_pipeline_depth),
+     UCC_CONFIG_TYPE_UINT},
+
+    {"ALLGATHER_SPLIT_RAIL_FRAG_SIZE", "inf",
+     "Maximum fragment size of split_rail allgather(v) alg, larger messages "
+     "are pipelined",
+     ucc_offsetof(ucc_cl_hier_lib_config_t, allgather_split_rail_frag_size),
+     UCC_CONFIG_TYPE_MEMUNITS},
+
+    {"ALLGATHER_SPLIT_RAIL_PIPELINE_DEPTH", "2",
+     "Number of fragments simultaneously progressed by the split_rail "
+     "allgather(v) alg",
+     ucc_offsetof(ucc_cl_hier_lib_config_t,
+                  allgather_split_rail_pipeline_depth),
+     UCC_CONFIG_TYPE_UINT},
+
+    {"REDUCE_SCATTER_SPLIT_RAIL_FRAG_SIZE", "inf",
+     "Maximum fragment size of split_rail reduce_scatter(v) alg, larger "
+     "messages are pipelined",
+     ucc_offsetof(ucc_cl_hier_lib_config_t,
+                  reduce_scatter_split_rail_frag_size),
+     UCC_CONFIG_TYPE_MEMUNITS},
+
+    {"REDUCE_SCATTER_SPLIT_RAIL_PIPELINE_DEPTH", "2",
+     "Number of fragments simultaneously progressed by the split_rail "
+     "reduce_scatter(v) alg",
+     ucc_offsetof(ucc_cl_hier_lib_config_t,
+                  reduce_scatter_split_rail_pipeline_depth),
+     UCC_CONFIG_TYPE_UINT},
+
+    {"NODE_SHM_SIZE", "0",
+     "Size of the per process slot of the node shared memory segment. When "
+     "set, intra-node reduce_scatter and allgather phases of split_rail "
+     "algorithms whose fragment fits the slot are done by the local "
+     "processes directly on the segment instead of the NODE subgroup TL. "
+     "0 - disabled",
+     ucc_offsetof(ucc_cl_hier_lib_config_t, node_shm_size),
+     UCC_CONFIG_TYPE_MEMUNITS},
+
     {NULL}};
 
 static ucs_config_field_t ucc_cl_hier_context_config_table[] = {
@@ -122,4 +254,16 @@ __attribute__((constructor)) static void cl_hier_iface_init(void)
         ucc_cl_hier_alltoall_algs;
     ucc_cl_hier.super.alg_info[ucc_ilog2(UCC_COLL_TYPE_ALLTOALLV)] =
         ucc_cl_hier_alltoallv_algs;
+    ucc_cl_hier.super.alg_info[ucc_ilog2(UCC_COLL_TYPE_BCAST)] =
+        ucc_cl_hier_bcast_algs;
+    ucc_cl_hier.super.alg_info[ucc_ilog2(UCC_COLL_TYPE_REDUCE)] =
+        ucc_cl_hier_reduce_algs;
+    ucc_cl_hier.super.alg_info[ucc_ilog2(UCC_COLL_TYPE_ALLGATHER)] =
+        ucc_cl_hier_allgather_algs;
+    ucc_cl_hier.super.alg_info[ucc_ilog2(UCC_COLL_TYPE_ALLGATHERV)] =
+        ucc_cl_hier_allgather_algs;
+    ucc_cl_hier.super.alg_info[ucc_ilog2(UCC_COLL_TYPE_REDUCE_SCATTER)] =
+        ucc_cl_hier_reduce_scatter_algs;
+    ucc_cl_hier.super.alg_info[ucc_ilog2(UCC_COLL_TYPE_REDUCE_SCATTERV)] =
+        ucc_cl_hier_reduce_scatter_algs;
 }
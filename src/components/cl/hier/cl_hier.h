@@ -40,22 +40,48 @@ typedef enum {
     UCC_HIER_SBGP_NODE_LEADERS,
     UCC_HIER_SBGP_NET,
     UCC_HIER_SBGP_FULL,
+    UCC_HIER_SBGP_SOCKET,
+    UCC_HIER_SBGP_SOCKET_LEADERS,
+    UCC_HIER_SBGP_NUMA,
+    UCC_HIER_SBGP_NUMA_LEADERS,
     UCC_HIER_SBGP_LAST,
 } ucc_hier_sbgp_type_t;
 //DO we need it? Potential use case: different hier sbgps over same sbgp
 
+/* Topology level used to split the intra-node part of the hierarchy */
+typedef enum {
+    UCC_CL_HIER_NODE_SPLIT_NONE,   /*< NODE */
+    UCC_CL_HIER_NODE_SPLIT_SOCKET, /*< SOCKET -> SOCKET_LEADERS */
+    UCC_CL_HIER_NODE_SPLIT_NUMA,   /*< NUMA -> NUMA_LEADERS */
+    UCC_CL_HIER_NODE_SPLIT_LAST
+} ucc_cl_hier_node_split_t;
+
+extern const char *ucc_cl_hier_node_split_names[];
+
 typedef struct ucc_cl_hier_lib_config {
     ucc_cl_lib_config_t super;
     /* List of TLs corresponding to the sbgp team,
        which are selected based on the TL scores */
     ucc_config_names_list_t sbgp_tls[UCC_HIER_SBGP_LAST];
+    ucc_cl_hier_node_split_t node_split;
+    uint32_t                n_leaders;
+    int                     leaders_rotate;
     size_t                  a2av_node_thresh;
+    uint32_t                a2av_node_aggr_n_leaders;
     uint32_t                allreduce_split_rail_n_frags;
     uint32_t                allreduce_split_rail_pipeline_depth;
     ucc_pipeline_order_t    allreduce_split_rail_pipeline_order;
     size_t                  allreduce_split_rail_frag_thresh;
     size_t                  allreduce_split_rail_frag_size;
-
+    size_t                  bcast_2step_frag_size;
+    uint32_t                bcast_2step_pipeline_depth;
+    size_t                  reduce_2step_frag_size;
+    uint32_t                reduce_2step_pipeline_depth;
+    size_t                  allgather_split_rail_frag_size;
+    uint32_t                allgather_split_rail_pipeline_depth;
+    size_t                  reduce_scatter_split_rail_frag_size;
+    uint32_t                reduce_scatter_split_rail_pipeline_depth;
+    size_t                  node_shm_size;
 } ucc_cl_hier_lib_config_t;
 
 typedef struct ucc_cl_hier_context_config {
@@ -101,8 +127,59 @@ typedef struct ucc_hier_sbgp {
     ucc_tl_team_t        *tl_teams[CL_HIER_MAX_SBGP_TLS];
     ucc_tl_context_t     *tl_ctxs[CL_HIER_MAX_SBGP_TLS];
     int                   n_tls;
+    ucc_rank_t            leader; /*< sbgp rank of the process representing
+                                      this sbgp at the next hier level */
 } ucc_hier_sbgp_t;
 
+/* Max length of the chain of hier levels: intra-node split level,
+   its leaders and NODE_LEADERS */
+#define UCC_CL_HIER_MAX_LEVELS 3
+
+#define UCC_CL_HIER_A2AV_CACHE_SIZE 4
+
+/* User tags of the sbgp TL tasks initialized with explicit tags, which
+   must fit the 15 bit message tag of TL/UCP: the node_aggr alltoallv
+   exchanges take the first 3 * 8192 tags, the multi-leader reduce result
+   sends the remaining ones */
+#define UCC_CL_HIER_A2AV_AGGR_N_TAGS   (3 * 8192)
+#define UCC_CL_HIER_ML_REDUCE_TAG_BASE UCC_CL_HIER_A2AV_AGGR_N_TAGS
+#define UCC_CL_HIER_ML_REDUCE_N_TAGS   8192
+
+/* NODE/FULL split of the alltoallv counts and displacements cached on the
+   team. The key is the user count and displacement arrays, their type and
+   their content, a copy of which follows the split in storage. Entry in
+   use by a collective has refcount > 0 and is never replaced. */
+typedef struct ucc_cl_hier_a2av_counts {
+    const void *arrays[4]; /*< src counts/displs, dst counts/displs */
+    size_t      sdt_size;
+    size_t      rdt_size;
+    int         c64;
+    int         refcount;
+    void       *storage;   /*< NULL if the entry was never used */
+} ucc_cl_hier_a2av_counts_t;
+
+typedef enum {
+    UCC_CL_HIER_NODE_SHM_STATE_INIT,
+    UCC_CL_HIER_NODE_SHM_STATE_BCAST, /*< leader bcasts shm id */
+    UCC_CL_HIER_NODE_SHM_STATE_AGREE, /*< all local ranks attached? */
+    UCC_CL_HIER_NODE_SHM_STATE_DONE
+} ucc_cl_hier_node_shm_state_t;
+
+/* Node-wide shared memory segment used by the intra-node phases, see
+   NODE_SHM_SIZE. The segment holds a cache line of control flags per local
+   rank followed by a slot of slot_size bytes per local rank. */
+typedef struct ucc_cl_hier_node_shm {
+    void                        *seg;   /*< NULL if not available */
+    void                        *slots;
+    size_t                       slot_size;
+    uint64_t                     seq;   /*< last seq number reserved by the
+                                            shm operations */
+    int                          shm_id;
+    int32_t                      attached[2];
+    ucc_cl_hier_node_shm_state_t state;
+    struct ucc_service_coll_req *req;
+} ucc_cl_hier_node_shm_t;
+
 typedef struct ucc_cl_hier_team {
     ucc_cl_team_t            super;
     ucc_team_multiple_req_t *team_create_req;
@@ -110,6 +187,29 @@ typedef struct ucc_cl_hier_team {
     ucc_coll_score_t        *score;
     ucc_hier_sbgp_t          sbgps[UCC_HIER_SBGP_LAST];
     ucc_hier_sbgp_type_t     top_sbgp;
+    /* Chain of hier sbgps used by the reduction and rooted algorithms,
+       from the lowest level to top_sbgp. The leader of the sbgp at
+       level i is a member of the sbgp at level i + 1. */
+    ucc_hier_sbgp_type_t     levels[UCC_CL_HIER_MAX_LEVELS];
+    int                      n_levels;
+    /* Team ranks in the rail-major order: rail_ranks[l * n_nodes + k] is
+       the rank with NODE sbgp rank l on the node with NET sbgp rank k.
+       It is followed by the inverse map: rail_ranks[size + rank] is the
+       rail-major position of the rank. Built on the first use by the
+       split_rail and multi-leader algorithms. */
+    ucc_rank_t              *rail_ranks;
+    /* alltoall counts and displacements in the alltoallv form, rebuilt
+       when the count per peer changes */
+    uint64_t                *a2a_counts;
+    size_t                   a2a_count;
+    ucc_cl_hier_a2av_counts_t a2av_cache[UCC_CL_HIER_A2AV_CACHE_SIZE];
+    ucc_cl_hier_node_shm_t    node_shm;
+    /* number of node_aggr alltoallv initialized on the team, gives the
+       tags of the exchanges initialized once the counts are known */
+    uint32_t                  a2av_aggr_seq;
+    /* number of multi-leader reduce initialized on the team, gives the
+       tags of the slice result sends */
+    uint32_t                  ml_reduce_seq;
 } ucc_cl_hier_team_t;
 UCC_CLASS_DECLARE(ucc_cl_hier_team_t, ucc_base_context_t *,
                   const ucc_base_team_params_t *);
@@ -133,6 +233,9 @@ ucc_status_t ucc_cl_hier_coll_init(ucc_base_coll_args_t *coll_args,
 #define SBGP_RANK(_team, _sbgp)                                                \
     ((_team)->sbgps[UCC_HIER_SBGP_##_sbgp].sbgp->group_rank)
 
+#define SBGP_SIZE(_team, _sbgp)                                                \
+    ((_team)->sbgps[UCC_HIER_SBGP_##_sbgp].sbgp->group_size)
+
 #define SBGP_EXISTS(_team, _sbgp)                                              \
     ((NULL != (_team)->sbgps[UCC_HIER_SBGP_##_sbgp].sbgp) &&                   \
      ((_team)->sbgps[UCC_HIER_SBGP_##_sbgp].sbgp->status !=                    \
@@ -140,4 +243,29 @@ ucc_status_t ucc_cl_hier_coll_init(ucc_base_coll_args_t *coll_args,
 
 #define SCORE_MAP(_team, _sbgp) (_team)->sbgps[UCC_HIER_SBGP_##_sbgp].score_map
 
+#define LEVEL_SBGP(_team, _level) (&(_team)->sbgps[(_team)->levels[_level]])
+
+#define LEVEL_ENABLED(_team, _level)                                           \
+    (LEVEL_SBGP(_team, _level)->state == UCC_HIER_SBGP_ENABLED)
+
+/* Returns the sbgp rank of the process at hier level @level which
+   represents the part of the hierarchy below that level containing @root.
+   Returns UCC_RANK_INVALID if @root is not below the sbgp of the calling
+   process at @level. */
+ucc_rank_t ucc_cl_hier_level_root(ucc_cl_hier_team_t *team, int level,
+                                  ucc_rank_t root);
+
+/* Returns team->rail_ranks, building it if needed. Fails with
+   UCC_ERR_NOT_SUPPORTED if the team does not have uniform ppn or NODE and
+   NET sbgps are not consistent with the rail-major order. */
+ucc_status_t ucc_cl_hier_get_rail_ranks(ucc_cl_hier_team_t *team,
+                                        ucc_rank_t        **rail_ranks);
+
+/* Sets up team->node_shm, called by team create_test once the sbgp teams
+   are created. Returns UCC_INPROGRESS until the NODE sbgp agrees on
+   whether the segment is usable. */
+ucc_status_t ucc_cl_hier_node_shm_setup(ucc_cl_hier_team_t *team);
+
+void ucc_cl_hier_node_shm_cleanup(ucc_cl_hier_team_t *team);
+
 #endif
@@ -6,8 +6,11 @@
 
 #include "cl_hier.h"
 #include "components/mc/ucc_mc.h"
+#include "utils/ucc_malloc.h"
 #include "core/ucc_team.h"
 #include "utils/ucc_coll_utils.h"
+#include "components/ec/ucc_ec.h"
+#include "core/ucc_progress_queue.h"
 #include "cl_hier_coll.h"
 
 const char *
@@ -27,6 +30,17 @@ ucc_status_t ucc_cl_hier_coll_init(ucc_base_coll_args_t *coll_args,
         return ucc_cl_hier_alltoall_init(coll_args, team, task);
     case UCC_COLL_TYPE_ALLTOALLV:
         return ucc_cl_hier_alltoallv_init(coll_args, team, task);
+    case UCC_COLL_TYPE_BCAST:
+        return ucc_cl_hier_bcast_2step_init(coll_args, team, task);
+    case UCC_COLL_TYPE_REDUCE:
+        return ucc_cl_hier_reduce_2step_init(coll_args, team, task);
+    case UCC_COLL_TYPE_ALLGATHER:
+    case UCC_COLL_TYPE_ALLGATHERV:
+        return ucc_cl_hier_allgather_split_rail_init(coll_args, team, task);
+    case UCC_COLL_TYPE_REDUCE_SCATTER:
+    case UCC_COLL_TYPE_REDUCE_SCATTERV:
+        return ucc_cl_hier_reduce_scatter_split_rail_init(coll_args, team,
+                                                          task);
     default:
         cl_error(team->context->lib, "coll_type %s is not supported",
                  ucc_coll_type_str(coll_args->args.coll_type));
@@ -44,6 +58,16 @@ static inline int alg_id_from_str(ucc_coll_type_t coll_type, const char *str)
         return ucc_cl_hier_alltoall_alg_from_str(str);
     case UCC_COLL_TYPE_ALLREDUCE:
         return ucc_cl_hier_allreduce_alg_from_str(str);
+    case UCC_COLL_TYPE_BCAST:
+        return ucc_cl_hier_bcast_alg_from_str(str);
+    case UCC_COLL_TYPE_REDUCE:
+        return ucc_cl_hier_reduce_alg_from_str(str);
+    case UCC_COLL_TYPE_ALLGATHER:
+    case UCC_COLL_TYPE_ALLGATHERV:
+        return ucc_cl_hier_allgather_alg_from_str(str);
+    case UCC_COLL_TYPE_REDUCE_SCATTER:
+    case UCC_COLL_TYPE_REDUCE_SCATTERV:
+        return ucc_cl_hier_reduce_scatter_alg_from_str(str);
     default:
         break;
     }
@@ -66,6 +90,9 @@ ucc_status_t ucc_cl_hier_alg_id_to_init(int alg_id, const char *alg_id_str,
         case UCC_CL_HIER_ALLTOALLV_ALG_NODE_SPLIT:
             *init = ucc_cl_hier_alltoallv_init;
             break;
+        case UCC_CL_HIER_ALLTOALLV_ALG_NODE_AGGR:
+            *init = ucc_cl_hier_alltoallv_node_aggr_init;
+            break;
         default:
             status = UCC_ERR_INVALID_PARAM;
             break;
@@ -94,9 +121,249 @@ ucc_status_t ucc_cl_hier_alg_id_to_init(int alg_id, const char *alg_id_str,
             break;
         };
         break;
+    case UCC_COLL_TYPE_BCAST:
+        switch (alg_id) {
+        case UCC_CL_HIER_BCAST_ALG_2STEP:
+            *init = ucc_cl_hier_bcast_2step_init;
+            break;
+        default:
+            status = UCC_ERR_INVALID_PARAM;
+            break;
+        };
+        break;
+    case UCC_COLL_TYPE_REDUCE:
+        switch (alg_id) {
+        case UCC_CL_HIER_REDUCE_ALG_2STEP:
+            *init = ucc_cl_hier_reduce_2step_init;
+            break;
+        default:
+            status = UCC_ERR_INVALID_PARAM;
+            break;
+        };
+        break;
+    case UCC_COLL_TYPE_ALLGATHER:
+    case UCC_COLL_TYPE_ALLGATHERV:
+        switch (alg_id) {
+        case UCC_CL_HIER_ALLGATHER_ALG_SPLIT_RAIL:
+            *init = ucc_cl_hier_allgather_split_rail_init;
+            break;
+        default:
+            status = UCC_ERR_INVALID_PARAM;
+            break;
+        };
+        break;
+    case UCC_COLL_TYPE_REDUCE_SCATTER:
+    case UCC_COLL_TYPE_REDUCE_SCATTERV:
+        switch (alg_id) {
+        case UCC_CL_HIER_REDUCE_SCATTER_ALG_SPLIT_RAIL:
+            *init = ucc_cl_hier_reduce_scatter_split_rail_init;
+            break;
+        default:
+            status = UCC_ERR_INVALID_PARAM;
+            break;
+        };
+        break;
     default:
         status = UCC_ERR_NOT_SUPPORTED;
         break;
     }
     return status;
 }
+
+static ucc_status_t ucc_cl_hier_copy_task_post(ucc_coll_task_t *coll_task)
+{
+    ucc_cl_hier_copy_task_t *task =
+        ucc_derived_of(coll_task, ucc_cl_hier_copy_task_t);
+    ucc_status_t status = UCC_OK;
+    ucc_rank_t   i;
+
+    for (i = 0; i < task->n_blocks; i++) {
+        if (task->counts[i] == 0) {
+            continue;
+        }
+        status = ucc_mc_memcpy(
+            PTR_OFFSET(task->dst, task->dst_displs[i] * task->dt_size),
+            PTR_OFFSET(task->src, task->src_displs[i] * task->dt_size),
+            task->counts[i] * task->dt_size, task->dst_mem_type,
+            task->src_mem_type);
+        if (ucc_unlikely(UCC_OK != status)) {
+            cl_error(coll_task->team->context->lib,
+                     "failed to copy block %u", i);
+            break;
+        }
+    }
+    coll_task->status = status;
+    return ucc_task_complete(coll_task);
+}
+
+static ucc_status_t ucc_cl_hier_copy_task_finalize(ucc_coll_task_t *coll_task)
+{
+    ucc_coll_task_destruct(coll_task);
+    ucc_free(coll_task);
+    return UCC_OK;
+}
+
+ucc_status_t ucc_cl_hier_copy_task_init(ucc_base_coll_args_t     *coll_args,
+                                        ucc_base_team_t          *team,
+                                        ucc_cl_hier_copy_task_t **task_p)
+{
+    ucc_cl_hier_copy_task_t *task;
+    ucc_status_t             status;
+
+    task = ucc_malloc(sizeof(*task), "cl_hier_copy_task");
+    if (ucc_unlikely(!task)) {
+        cl_error(team->context->lib, "failed to allocate %zd bytes for task",
+                 sizeof(*task));
+        return UCC_ERR_NO_MEMORY;
+    }
+    ucc_coll_task_construct(&task->super);
+    status = ucc_coll_task_init(&task->super, coll_args, team);
+    if (ucc_unlikely(UCC_OK != status)) {
+        ucc_cl_hier_copy_task_finalize(&task->super);
+        return status;
+    }
+    task->super.post     = ucc_cl_hier_copy_task_post;
+    task->super.progress = NULL;
+    task->super.finalize = ucc_cl_hier_copy_task_finalize;
+    *task_p              = task;
+    return UCC_OK;
+}
+
+static void ucc_cl_hier_scale_task_progress(ucc_coll_task_t *coll_task)
+{
+    ucc_cl_hier_scale_task_t *task =
+        ucc_derived_of(coll_task, ucc_cl_hier_scale_task_t);
+    ucc_status_t status = UCC_OK;
+
+    if (task->etask) {
+        status = ucc_ee_executor_task_test(task->etask);
+        if (status > 0) {
+            coll_task->status = UCC_INPROGRESS;
+            return;
+        }
+        ucc_ee_executor_task_finalize(task->etask);
+        task->etask = NULL;
+        if (ucc_unlikely(status < 0)) {
+            cl_error(coll_task->team->context->lib,
+                     "failure in scale executor task");
+        }
+    }
+    coll_task->status = status;
+}
+
+static ucc_status_t ucc_cl_hier_scale_task_post(ucc_coll_task_t *coll_task)
+{
+    ucc_cl_hier_scale_task_t *task =
+        ucc_derived_of(coll_task, ucc_cl_hier_scale_task_t);
+    ucc_ee_executor_task_args_t eargs;
+    ucc_ee_executor_t          *exec;
+    ucc_status_t                status;
+
+    if (task->count == 0) {
+        coll_task->status = UCC_OK;
+        return ucc_task_complete(coll_task);
+    }
+    status = ucc_coll_task_get_executor(coll_task, &exec);
+    if (ucc_unlikely(UCC_OK != status)) {
+        return status;
+    }
+    /* single source reduction with alpha: buf = buf * alpha */
+    eargs.task_type      = UCC_EE_EXECUTOR_TASK_REDUCE;
+    eargs.flags          = UCC_EEE_TASK_FLAG_REDUCE_WITH_ALPHA;
+    eargs.reduce.dst     = task->buf;
+    eargs.reduce.srcs[0] = task->buf;
+    eargs.reduce.n_srcs  = 1;
+    eargs.reduce.count   = task->count;
+    eargs.reduce.dt      = task->dt;
+    eargs.reduce.op      = UCC_OP_SUM;
+    eargs.reduce.alpha   = task->alpha;
+    status = ucc_ee_executor_task_post(exec, &eargs, &task->etask);
+    if (ucc_unlikely(UCC_OK != status)) {
+        cl_error(coll_task->team->context->lib,
+                 "failed to post scale executor task");
+        coll_task->status = status;
+        return ucc_task_complete(coll_task);
+    }
+    coll_task->status = UCC_INPROGRESS;
+    return ucc_progress_queue_enqueue(coll_task->team->context->ucc_context->pq,
+                                      coll_task);
+}
+
+static ucc_status_t ucc_cl_hier_scale_task_finalize(ucc_coll_task_t *coll_task)
+{
+    ucc_coll_task_destruct(coll_task);
+    ucc_free(coll_task);
+    return UCC_OK;
+}
+
+ucc_status_t ucc_cl_hier_scale_task_init(ucc_base_coll_args_t      *coll_args,
+                                         ucc_base_team_t           *team,
+                                         ucc_cl_hier_scale_task_t **task_p)
+{
+    ucc_cl_hier_scale_task_t *task;
+    ucc_status_t              status;
+
+    task = ucc_malloc(sizeof(*task), "cl_hier_scale_task");
+    if (ucc_unlikely(!task)) {
+        cl_error(team->context->lib, "failed to allocate %zd bytes for task",
+                 sizeof(*task));
+        return UCC_ERR_NO_MEMORY;
+    }
+    ucc_coll_task_construct(&task->super);
+    status = ucc_coll_task_init(&task->super, coll_args, team);
+    if (ucc_unlikely(UCC_OK != status)) {
+        ucc_cl_hier_scale_task_finalize(&task->super);
+        return status;
+    }
+    task->super.flags        |= UCC_COLL_TASK_FLAG_EXECUTOR;
+    task->super.post          = ucc_cl_hier_scale_task_post;
+    task->super.progress      = ucc_cl_hier_scale_task_progress;
+    task->super.finalize      = ucc_cl_hier_scale_task_finalize;
+    task->etask               = NULL;
+    *task_p                   = task;
+    return UCC_OK;
+}
+
+size_t ucc_cl_hier_rail_layout(ucc_cl_hier_team_t *team, const uint64_t *counts,
+                               const uint64_t *displs, int n_frags, int frag,
+                               uint64_t *storage,
+                               ucc_cl_hier_rail_layout_t *layout)
+{
+    ucc_rank_t  size       = UCC_CL_TEAM_SIZE(team);
+    ucc_rank_t  n_nodes    = SBGP_SIZE(team, NET);
+    ucc_rank_t  ppn        = SBGP_SIZE(team, NODE);
+    ucc_rank_t  node_rank  = SBGP_RANK(team, NODE);
+    ucc_rank_t *rail_ranks = team->rail_ranks;
+    size_t      offset     = 0;
+    ucc_rank_t  i, k, l, t;
+
+    layout->counts      = storage;
+    layout->displs      = layout->counts + size;
+    layout->rdispls     = layout->displs + size;
+    layout->net_counts  = layout->rdispls + size;
+    layout->net_displs  = layout->net_counts + n_nodes;
+    layout->node_counts = layout->net_displs + n_nodes;
+    layout->node_displs = layout->node_counts + ppn;
+
+    for (l = 0; l < ppn; l++) {
+        layout->node_displs[l] = offset;
+        for (k = 0; k < n_nodes; k++) {
+            i = l * n_nodes + k;
+            t = rail_ranks[i];
+            layout->counts[i] =
+                ucc_buffer_block_count(counts[t], n_frags, frag);
+            layout->displs[i] =
+                displs[t] + ucc_buffer_block_offset(counts[t], n_frags, frag);
+            layout->rdispls[i] = offset;
+            offset += layout->counts[i];
+        }
+        layout->node_counts[l] = offset - layout->node_displs[l];
+    }
+
+    for (k = 0; k < n_nodes; k++) {
+        i = node_rank * n_nodes + k;
+        layout->net_counts[k] = layout->counts[i];
+        layout->net_displs[k] = layout->rdispls[i];
+    }
+    return offset;
+}
@@ -13,9 +13,17 @@
 #include "alltoallv/alltoallv.h"
 #include "alltoall/alltoall.h"
 #include "barrier/barrier.h"
+#include "bcast/bcast.h"
+#include "reduce/reduce.h"
+#include "allgather/allgather.h"
+#include "reduce_scatter/reduce_scatter.h"
 
 #define UCC_CL_HIER_N_DEFAULT_ALG_SELECT_STR 1
 
+/* Max number of tasks of the algorithms walking up and down the
+   hier levels */
+#define UCC_CL_HIER_MAX_LEVEL_TASKS (2 * UCC_CL_HIER_MAX_LEVELS - 1)
+
 extern const char
     *ucc_cl_hier_default_alg_select_str[UCC_CL_HIER_N_DEFAULT_ALG_SELECT_STR];
 
@@ -25,10 +33,95 @@ typedef struct ucc_cl_hier_schedule_t {
     union {
         struct {
             uint64_t *counts;
+            /* node shm is used by the intra-node phases, the first
+               seq number reserved by the collective */
+            int       node_shm;
+            uint64_t  shm_seq;
         } allreduce_split_rail;
+        struct {
+            /* ucc_cl_hier_reduce_buf_t of src and dst of every task,
+               used to set up the buffers of each fragment */
+            uint8_t src[UCC_CL_HIER_MAX_LEVEL_TASKS];
+            uint8_t dst[UCC_CL_HIER_MAX_LEVEL_TASKS];
+        } reduce_2step;
+        struct {
+            /* team order counts and displacements of the whole message
+               for the pipelined schedule, ucc_cl_hier_rail_layout_t
+               storage for the fragments */
+            uint64_t *counts;
+            int       node_shm;
+            uint64_t  shm_seq;
+        } split_rail;
+        struct {
+            /* counts and displacements of all the subtasks, data buffers
+               of the leaders allocated once the counts are known */
+            uint64_t               *counts;
+            ucc_mc_buffer_header_t *lscratch;
+        } alltoallv_node_aggr;
+        struct {
+            /* cached counts split, NULL if the schedule owns the
+               scratch with the counts */
+            ucc_cl_hier_a2av_counts_t *counts;
+        } alltoallv;
     };
 } ucc_cl_hier_schedule_t;
 
+/* Task copying a set of blocks between two buffers, used to move the data
+   between the user buffers and rail-major ordered scratch */
+typedef struct ucc_cl_hier_copy_task {
+    ucc_coll_task_t   super;
+    void             *src;
+    void             *dst;
+    ucc_memory_type_t src_mem_type;
+    ucc_memory_type_t dst_mem_type;
+    size_t            dt_size;
+    ucc_rank_t        n_blocks;
+    uint64_t         *counts;
+    uint64_t         *src_displs;
+    uint64_t         *dst_displs;
+} ucc_cl_hier_copy_task_t;
+
+/* Task multiplying count elements of buf by alpha using the executor, used
+   to turn the SUM computed over the hier levels into AVG */
+typedef struct ucc_cl_hier_scale_task {
+    ucc_coll_task_t         super;
+    void                   *buf;
+    size_t                  count;
+    ucc_datatype_t          dt;
+    double                  alpha;
+    ucc_ee_executor_task_t *etask;
+} ucc_cl_hier_scale_task_t;
+
+/* Intra-node REDUCE_SCATTERV or ALLGATHERV done on the node shm segment
+   (see NODE_SHM_SIZE) instead of the NODE sbgp TL. The shm operations of
+   the team are serialized by seq numbers: the task with seq N waits until
+   all the local ranks are done with N - 1, puts its data into the segment,
+   waits until all the local ranks have put theirs and reads the result.
+   REDUCE_SCATTERV: each rank copies the whole vector into its slot and
+   reduces its own block from all the slots.
+   ALLGATHERV: blocks are put at their displacements in the slots area and
+   the whole buffer is copied out, so the blocks must be packed. */
+typedef struct ucc_cl_hier_node_shm_task {
+    ucc_coll_task_t         super;
+    uint64_t                seq;
+    int                     phase;
+    ucc_ee_executor_task_t *etask;
+} ucc_cl_hier_node_shm_task_t;
+
+/* Layout of one fragment of a split_rail allgather(v) or reduce_scatter(v).
+   Blocks of all the team ranks are stored in the rail-major order (see
+   team->rail_ranks), so that the blocks exchanged over one rail are
+   contiguous. All values are in elements. */
+typedef struct ucc_cl_hier_rail_layout {
+    uint64_t *counts;      /*< [team size] fragment count of each block */
+    uint64_t *displs;      /*< [team size] displacement in the user buffer */
+    uint64_t *rdispls;     /*< [team size] displacement in the scratch */
+    uint64_t *net_counts;  /*< [n_nodes] blocks of own rail */
+    uint64_t *net_displs;  /*< [n_nodes] displacement in the scratch */
+    uint64_t *node_counts; /*< [ppn] total count of each rail */
+    uint64_t *node_displs; /*< [ppn] start of each rail in the scratch */
+} ucc_cl_hier_rail_layout_t;
+
 static inline ucc_cl_hier_schedule_t *
 ucc_cl_hier_get_schedule(ucc_cl_hier_team_t *team)
 {
@@ -46,6 +139,95 @@ static inline void ucc_cl_hier_put_schedule(ucc_schedule_t *schedule)
     ucc_mpool_put(schedule);
 }
 
+/* Splits the message into fragments of at most frag_size for the
+   pipelined schedules */
+static inline void ucc_cl_hier_get_n_frags(size_t msgsize, size_t frag_size,
+                                           uint32_t cfg_depth, int *n_frags,
+                                           int *pipeline_depth)
+{
+    *n_frags = 1;
+    if (msgsize > frag_size) {
+        *n_frags = ucc_div_round_up(msgsize, frag_size);
+    }
+    *pipeline_depth = ucc_min(*n_frags, ucc_max(1, (int)cfg_depth));
+    *pipeline_depth = ucc_min(*pipeline_depth,
+                              UCC_SCHEDULE_PIPELINED_MAX_FRAGS);
+}
+
+ucc_status_t ucc_cl_hier_copy_task_init(ucc_base_coll_args_t     *coll_args,
+                                        ucc_base_team_t          *team,
+                                        ucc_cl_hier_copy_task_t **task_p);
+
+ucc_status_t ucc_cl_hier_scale_task_init(ucc_base_coll_args_t      *coll_args,
+                                         ucc_base_team_t           *team,
+                                         ucc_cl_hier_scale_task_t **task_p);
+
+ucc_status_t ucc_cl_hier_node_shm_task_init(ucc_base_coll_args_t *coll_args,
+                                            ucc_base_team_t      *team,
+                                            ucc_coll_task_t     **task_p);
+
+/* Checks if the intra-node phase of @coll_type (REDUCE_SCATTERV or
+   ALLGATHERV) over @msgsize bytes of host memory can use node shm. The
+   answer is the same on all the local ranks. */
+static inline int ucc_cl_hier_node_shm_fits(ucc_cl_hier_team_t *team,
+                                            ucc_coll_type_t     coll_type,
+                                            size_t              msgsize,
+                                            ucc_memory_type_t   mem_type)
+{
+    size_t max_size = team->node_shm.slot_size;
+
+    if (!team->node_shm.seg || mem_type != UCC_MEMORY_TYPE_HOST) {
+        return 0;
+    }
+    if (coll_type == UCC_COLL_TYPE_ALLGATHERV) {
+        max_size *= SBGP_SIZE(team, NODE);
+    }
+    return msgsize <= max_size;
+}
+
+/* Reserves @n seq numbers for the node shm tasks of the collective being
+   posted, returns the first one. Collectives are posted in the same order
+   on all the local ranks, so are the seq numbers. */
+static inline uint64_t ucc_cl_hier_node_shm_reserve(ucc_cl_hier_team_t *team,
+                                                    int                 n)
+{
+    uint64_t seq = team->node_shm.seq + 1;
+
+    team->node_shm.seq += n;
+    return seq;
+}
+
+static inline void ucc_cl_hier_node_shm_set_seq(ucc_coll_task_t *task,
+                                                uint64_t         seq)
+{
+    ucc_derived_of(task, ucc_cl_hier_node_shm_task_t)->seq = seq;
+}
+
+/* Multi-leader path is requested, see N_LEADERS and LEADERS_ROTATE */
+#define UCC_CL_HIER_ML_ENABLED(_team)                                          \
+    (UCC_CL_HIER_TEAM_LIB(_team)->cfg.n_leaders > 1 ||                         \
+     UCC_CL_HIER_TEAM_LIB(_team)->cfg.leaders_rotate)
+
+/* Multi-leader path of allreduce, bcast and reduce. Returns
+   UCC_ERR_NOT_SUPPORTED if the team layout does not allow it, the caller
+   falls back to its single-leader schedule then. */
+ucc_status_t ucc_cl_hier_ml_init(ucc_base_coll_args_t *coll_args,
+                                 ucc_base_team_t      *team,
+                                 ucc_coll_task_t     **task);
+
+/* Number of uint64_t needed to store ucc_cl_hier_rail_layout_t */
+#define UCC_CL_HIER_RAIL_LAYOUT_SIZE(_team)                                    \
+    (3 * UCC_CL_TEAM_SIZE(_team) +                                             \
+     2 * (SBGP_SIZE(_team, NET) + SBGP_SIZE(_team, NODE)))
+
+/* Computes the layout of fragment @frag out of @n_frags. @counts and
+   @displs define the blocks of the whole message in the team order.
+   Returns the total count of the fragment. */
+size_t ucc_cl_hier_rail_layout(ucc_cl_hier_team_t *team, const uint64_t *counts,
+                               const uint64_t *displs, int n_frags, int frag,
+                               uint64_t *storage,
+                               ucc_cl_hier_rail_layout_t *layout);
+
 ucc_status_t ucc_cl_hier_alg_id_to_init(int alg_id, const char *alg_id_str,
                                         ucc_coll_type_t   coll_type,
                                         ucc_memory_type_t mem_type, //NOLINT
@@ -0,0 +1,383 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "cl_hier.h"
+#include "cl_hier_coll.h"
+#include "core/ucc_team.h"
+#include "utils/ucc_coll_utils.h"
+
+/* Multi-leader schedules of allreduce, bcast and reduce.
+   The buffer is split into n_leaders slices. Slice j is handled by the
+   processes with local rank L_j = (j + shift) % ppn: it is reduced to
+   (bcasted from) L_j inside the node while the inter-node part goes over
+   the NET sbgp (rail) of L_j. All the slices progress concurrently, so the
+   inter-node traffic is spread over n_leaders NICs and cores instead of
+   funneling through the single node leader. With LEADERS_ROTATE the shift
+   is the sequence number of the collective, which is the same on all the
+   ranks of the team.
+   The result of a reduce slice is sent from its leader to root with a bcast
+   over the active set of the two processes. Slices of several outstanding
+   reduces may complete in a different order on the leader and on root, so
+   every reduce uses its own tag for these sends. */
+
+typedef struct ucc_cl_hier_ml_slice {
+    ucc_rank_t leader; /*< NODE sbgp rank of the slice leader */
+    size_t     count;
+    size_t     offset; /*< in bytes */
+} ucc_cl_hier_ml_slice_t;
+
+static ucc_status_t ucc_cl_hier_ml_finalize(ucc_coll_task_t *task)
+{
+    ucc_cl_hier_schedule_t *schedule =
+        ucc_derived_of(task, ucc_cl_hier_schedule_t);
+    ucc_status_t status;
+
+    UCC_CL_HIER_PROFILE_REQUEST_EVENT(task, "cl_hier_ml_finalize", 0);
+    status = ucc_schedule_finalize(task);
+    if (schedule->scratch) {
+        ucc_mc_free(schedule->scratch);
+    }
+    ucc_cl_hier_put_schedule(&schedule->super.super);
+    return status;
+}
+
+static ucc_status_t ucc_cl_hier_ml_start(ucc_coll_task_t *task)
+{
+    UCC_CL_HIER_PROFILE_REQUEST_EVENT(task, "cl_hier_ml_start", 0);
+    cl_debug(task->team->context->lib,
+             "posting multi-leader %s, sbuf %p, rbuf %p, root %u, inplace %d",
+             ucc_coll_type_str(task->bargs.args.coll_type),
+             task->bargs.args.src.info.buffer,
+             task->bargs.args.dst.info.buffer, task->bargs.args.root,
+             UCC_IS_INPLACE(task->bargs.args));
+    return ucc_schedule_start(task);
+}
+
+static inline void ucc_cl_hier_ml_set_info(ucc_coll_buffer_info_t *info,
+                                           const ucc_coll_buffer_info_t *orig,
+                                           void *buffer,
+                                           ucc_cl_hier_ml_slice_t *slice)
+{
+    *info        = *orig;
+    info->buffer = PTR_OFFSET(buffer, slice->offset);
+    info->count  = slice->count;
+}
+
+/* Appends a task to the chain of the slice: the first task of the chain
+   starts with the schedule, next ones wait for the previous task */
+static ucc_status_t ucc_cl_hier_ml_add_task(ucc_schedule_t       *schedule,
+                                            ucc_score_map_t      *map,
+                                            ucc_base_coll_args_t *args,
+                                            ucc_coll_task_t     **prev)
+{
+    ucc_coll_task_t *task;
+    ucc_status_t     status;
+
+    status = ucc_coll_init(map, args, &task);
+    if (ucc_unlikely(UCC_OK != status)) {
+        return status;
+    }
+    status = ucc_schedule_add_task(schedule, task);
+    if (ucc_unlikely(UCC_OK != status)) {
+        task->finalize(task);
+        return status;
+    }
+    if (*prev) {
+        status = ucc_task_subscribe_dep(*prev, task, UCC_EVENT_COMPLETED);
+    } else {
+        status = ucc_task_subscribe_dep(&schedule->super, task,
+                                        UCC_EVENT_SCHEDULE_STARTED);
+    }
+    *prev = task;
+    return status;
+}
+
+static ucc_status_t
+ucc_cl_hier_ml_allreduce_slice(ucc_cl_hier_team_t     *cl_team,
+                               ucc_schedule_t         *schedule,
+                               ucc_base_coll_args_t   *coll_args,
+                               ucc_cl_hier_ml_slice_t *slice)
+{
+    ucc_coll_args_t     *args    = &coll_args->args;
+    int                  inplace = UCC_IS_INPLACE(*args);
+    int                  leader  = (SBGP_RANK(cl_team, NODE) == slice->leader);
+    ucc_coll_task_t     *prev    = NULL;
+    ucc_base_coll_args_t sargs;
+    ucc_status_t         status;
+
+    memcpy(&sargs, coll_args, sizeof(sargs));
+    sargs.args.coll_type = UCC_COLL_TYPE_REDUCE;
+    sargs.args.root      = slice->leader;
+    ucc_cl_hier_ml_set_info(&sargs.args.src.info,
+                            inplace ? &args->dst.info : &args->src.info,
+                            inplace ? args->dst.info.buffer
+                                    : args->src.info.buffer,
+                            slice);
+    ucc_cl_hier_ml_set_info(&sargs.args.dst.info, &args->dst.info,
+                            args->dst.info.buffer, slice);
+    status = ucc_cl_hier_ml_add_task(schedule, SCORE_MAP(cl_team, NODE),
+                                     &sargs, &prev);
+    if (ucc_unlikely(UCC_OK != status)) {
+        return status;
+    }
+
+    if (leader) {
+        sargs.args.coll_type = UCC_COLL_TYPE_ALLREDUCE;
+        sargs.args.mask     |= UCC_COLL_ARGS_FIELD_FLAGS;
+        sargs.args.flags    |= UCC_COLL_ARGS_FLAG_IN_PLACE;
+        status = ucc_cl_hier_ml_add_task(schedule, SCORE_MAP(cl_team, NET),
+                                         &sargs, &prev);
+        if (ucc_unlikely(UCC_OK != status)) {
+            return status;
+        }
+    }
+
+    sargs.args.coll_type = UCC_COLL_TYPE_BCAST;
+    sargs.args.root      = slice->leader;
+    sargs.args.src.info  = sargs.args.dst.info;
+    return ucc_cl_hier_ml_add_task(schedule, SCORE_MAP(cl_team, NODE), &sargs,
+                                   &prev);
+}
+
+static ucc_status_t
+ucc_cl_hier_ml_bcast_slice(ucc_cl_hier_team_t     *cl_team,
+                           ucc_schedule_t         *schedule,
+                           ucc_base_coll_args_t   *coll_args,
+                           ucc_cl_hier_ml_slice_t *slice,
+                           ucc_rank_t root_node, ucc_rank_t root_local)
+{
+    ucc_coll_args_t     *args   = &coll_args->args;
+    int                  leader = (SBGP_RANK(cl_team, NODE) == slice->leader);
+    ucc_coll_task_t     *prev   = NULL;
+    ucc_base_coll_args_t sargs;
+    ucc_status_t         status;
+
+    memcpy(&sargs, coll_args, sizeof(sargs));
+    ucc_cl_hier_ml_set_info(&sargs.args.src.info, &args->src.info,
+                            args->src.info.buffer, slice);
+    if (SBGP_RANK(cl_team, NET) == root_node) {
+        /* root node: deliver the slice to the node, the slice leader
+           forwards it over its rail */
+        sargs.args.root = root_local;
+        status = ucc_cl_hier_ml_add_task(schedule, SCORE_MAP(cl_team, NODE),
+                                         &sargs, &prev);
+        if (ucc_unlikely(UCC_OK != status) || !leader) {
+            return status;
+        }
+        sargs.args.root = root_node;
+        return ucc_cl_hier_ml_add_task(schedule, SCORE_MAP(cl_team, NET),
+                                       &sargs, &prev);
+    }
+
+    if (leader) {
+        sargs.args.root = root_node;
+        status = ucc_cl_hier_ml_add_task(schedule, SCORE_MAP(cl_team, NET),
+                                         &sargs, &prev);
+        if (ucc_unlikely(UCC_OK != status)) {
+            return status;
+        }
+    }
+    sargs.args.root = slice->leader;
+    return ucc_cl_hier_ml_add_task(schedule, SCORE_MAP(cl_team, NODE), &sargs,
+                                   &prev);
+}
+
+static ucc_status_t
+ucc_cl_hier_ml_reduce_slice(ucc_cl_hier_team_t     *cl_team,
+                            ucc_schedule_t         *schedule,
+                            ucc_base_coll_args_t   *coll_args,
+                            ucc_cl_hier_ml_slice_t *slice,
+                            ucc_rank_t root_node, ucc_rank_t root_local,
+                            ucc_coll_id_t tag)
+{
+    ucc_cl_hier_schedule_t *cl_schedule =
+        ucc_derived_of(schedule, ucc_cl_hier_schedule_t);
+    ucc_coll_args_t        *args    = &coll_args->args;
+    int                     is_root = (UCC_CL_TEAM_RANK(cl_team) ==
+                                       args->root);
+    int                     on_root_node = (SBGP_RANK(cl_team, NET) ==
+                                            root_node);
+    int                     leader  = (SBGP_RANK(cl_team, NODE) ==
+                                       slice->leader);
+    ucc_coll_buffer_info_t *info    = is_root ? &args->dst.info
+                                              : &args->src.info;
+    void                   *result  = is_root ? args->dst.info.buffer
+                                              : cl_schedule->scratch->addr;
+    ucc_coll_task_t        *prev    = NULL;
+    ucc_base_coll_args_t    sargs;
+    ucc_status_t            status;
+
+    memcpy(&sargs, coll_args, sizeof(sargs));
+    sargs.args.mask |= UCC_COLL_ARGS_FIELD_FLAGS;
+
+    /* intra-node reduce of the slice to the slice leader */
+    sargs.args.root = slice->leader;
+    ucc_cl_hier_ml_set_info(&sargs.args.src.info, info,
+                            (is_root && UCC_IS_INPLACE(*args))
+                                ? args->dst.info.buffer
+                                : args->src.info.buffer,
+                            slice);
+    ucc_cl_hier_ml_set_info(&sargs.args.dst.info, info, result, slice);
+    if (!(is_root && leader && UCC_IS_INPLACE(*args))) {
+        sargs.args.flags &= ~UCC_COLL_ARGS_FLAG_IN_PLACE;
+    }
+    status = ucc_cl_hier_ml_add_task(schedule, SCORE_MAP(cl_team, NODE),
+                                     &sargs, &prev);
+    if (ucc_unlikely(UCC_OK != status)) {
+        return status;
+    }
+
+    /* inter-node reduce of the slice to the leader of the root node */
+    if (leader) {
+        sargs.args.root     = root_node;
+        sargs.args.src.info = sargs.args.dst.info;
+        if (on_root_node) {
+            sargs.args.flags |= UCC_COLL_ARGS_FLAG_IN_PLACE;
+        } else {
+            sargs.args.flags &= ~UCC_COLL_ARGS_FLAG_IN_PLACE;
+        }
+        status = ucc_cl_hier_ml_add_task(schedule, SCORE_MAP(cl_team, NET),
+                                         &sargs, &prev);
+        if (ucc_unlikely(UCC_OK != status)) {
+            return status;
+        }
+    }
+
+    /* the result of the slice is on its leader, send it to root: bcast
+       over the active set of the two processes */
+    if (on_root_node && slice->leader != root_local && (leader || is_root)) {
+        sargs.args.coll_type         = UCC_COLL_TYPE_BCAST;
+        sargs.args.mask             |= UCC_COLL_ARGS_FIELD_ACTIVE_SET;
+        sargs.args.root              = slice->leader;
+        sargs.args.active_set.start  = slice->leader;
+        sargs.args.active_set.stride = (int64_t)root_local -
+                                       (int64_t)slice->leader;
+        sargs.args.active_set.size   = 2;
+        sargs.mask                  |= UCC_COLL_ARGS_FIELD_TAG;
+        sargs.args.mask             |= UCC_COLL_ARGS_FIELD_TAG;
+        sargs.args.tag               = tag;
+        ucc_cl_hier_ml_set_info(&sargs.args.src.info, info, result, slice);
+        status = ucc_cl_hier_ml_add_task(schedule, SCORE_MAP(cl_team, NODE),
+                                         &sargs, &prev);
+    }
+    return status;
+}
+
+ucc_status_t ucc_cl_hier_ml_init(ucc_base_coll_args_t *coll_args,
+                                 ucc_base_team_t      *team,
+                                 ucc_coll_task_t     **task)
+{
+    ucc_cl_hier_team_t       *cl_team = ucc_derived_of(team,
+                                                       ucc_cl_hier_team_t);
+    ucc_cl_hier_lib_config_t *cfg     = &UCC_CL_HIER_TEAM_LIB(cl_team)->cfg;
+    ucc_coll_args_t          *args    = &coll_args->args;
+    ucc_rank_t                size    = UCC_CL_TEAM_SIZE(cl_team);
+    ucc_rank_t                root_node = 0, root_local = 0;
+    ucc_cl_hier_schedule_t   *cl_schedule;
+    ucc_schedule_t           *schedule;
+    ucc_coll_buffer_info_t   *info;
+    ucc_cl_hier_ml_slice_t    slice;
+    ucc_rank_t               *rail_ranks;
+    ucc_rank_t                ppn, n_leaders, shift, pos, j;
+    ucc_coll_id_t             tag = 0;
+    size_t                    dt_size;
+    ucc_status_t              status;
+
+    status = ucc_cl_hier_get_rail_ranks(cl_team, &rail_ranks);
+    if (UCC_OK != status) {
+        cl_debug(team->context->lib, "multi-leader %s is not supported for "
+                 "the team layout", ucc_coll_type_str(args->coll_type));
+        return status;
+    }
+
+    switch (args->coll_type) {
+    case UCC_COLL_TYPE_ALLREDUCE:
+        info = &args->dst.info;
+        break;
+    case UCC_COLL_TYPE_BCAST:
+        info = &args->src.info;
+        break;
+    case UCC_COLL_TYPE_REDUCE:
+        info = (UCC_CL_TEAM_RANK(cl_team) == args->root) ? &args->dst.info
+                                                          : &args->src.info;
+        break;
+    default:
+        return UCC_ERR_NOT_SUPPORTED;
+    }
+    if (args->coll_type != UCC_COLL_TYPE_ALLREDUCE) {
+        pos        = rail_ranks[size + args->root];
+        root_node  = pos % SBGP_SIZE(cl_team, NET);
+        root_local = pos / SBGP_SIZE(cl_team, NET);
+    }
+    if (args->coll_type == UCC_COLL_TYPE_REDUCE) {
+        /* taken on all the ranks, so the tags match */
+        tag = UCC_CL_HIER_ML_REDUCE_TAG_BASE +
+              cl_team->ml_reduce_seq++ % UCC_CL_HIER_ML_REDUCE_N_TAGS;
+    }
+
+    ppn       = SBGP_SIZE(cl_team, NODE);
+    n_leaders = ucc_min(ucc_max(cfg->n_leaders, 1), ppn);
+    n_leaders = ucc_min(n_leaders, ucc_max(info->count, 1));
+    shift     = cfg->leaders_rotate
+                    ? (cl_team->super.super.params.team->seq_num % ppn)
+                    : 0;
+    dt_size   = ucc_dt_size(info->datatype);
+
+    cl_schedule = ucc_cl_hier_get_schedule(cl_team);
+    if (ucc_unlikely(!cl_schedule)) {
+        return UCC_ERR_NO_MEMORY;
+    }
+    schedule = &cl_schedule->super.super;
+    UCC_CHECK_GOTO(ucc_schedule_init(schedule, coll_args, team), out, status);
+
+    if (args->coll_type == UCC_COLL_TYPE_REDUCE &&
+        UCC_CL_TEAM_RANK(cl_team) != args->root) {
+        /* partial results of the non-root slice leaders */
+        UCC_CHECK_GOTO(ucc_mc_alloc(&cl_schedule->scratch,
+                                    ucc_max(info->count, 1) * dt_size,
+                                    info->mem_type),
+                       out, status);
+    }
+
+    for (j = 0; j < n_leaders; j++) {
+        slice.leader = (j + shift) % ppn;
+        slice.count  = ucc_buffer_block_count(info->count, n_leaders, j);
+        slice.offset =
+            ucc_buffer_block_offset(info->count, n_leaders, j) * dt_size;
+        switch (args->coll_type) {
+        case UCC_COLL_TYPE_ALLREDUCE:
+            status = ucc_cl_hier_ml_allreduce_slice(cl_team, schedule,
+                                                    coll_args, &slice);
+            break;
+        case UCC_COLL_TYPE_BCAST:
+            status = ucc_cl_hier_ml_bcast_slice(cl_team, schedule, coll_args,
+                                                &slice, root_node, root_local);
+            break;
+        default:
+            status = ucc_cl_hier_ml_reduce_slice(cl_team, schedule, coll_args,
+                                                 &slice, root_node,
+                                                 root_local, tag);
+            break;
+        }
+        if (ucc_unlikely(UCC_OK != status)) {
+            cl_error(team->context->lib,
+                     "failed to init multi-leader %s slice %u",
+                     ucc_coll_type_str(args->coll_type), j);
+            goto out;
+        }
+    }
+
+    schedule->super.post           = ucc_cl_hier_ml_start;
+    schedule->super.progress       = NULL;
+    schedule->super.finalize       = ucc_cl_hier_ml_finalize;
+    schedule->super.triggered_post = ucc_triggered_post;
+    *task                          = &schedule->super;
+    return UCC_OK;
+
+out:
+    ucc_cl_hier_ml_finalize(&schedule->super);
+    return status;
+}
@@ -0,0 +1,391 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "cl_hier.h"
+#include "cl_hier_coll.h"
+#include "core/ucc_team.h"
+#include "core/ucc_service_coll.h"
+#include "core/ucc_progress_queue.h"
+#include "utils/ucc_malloc.h"
+#include "utils/ucc_sys.h"
+#include "utils/ucc_coll_utils.h"
+#include "utils/ucc_dt_reduce.h"
+#include "utils/arch/cpu.h"
+#include <sys/shm.h>
+#include <errno.h>
+#include <string.h>
+
+enum {
+    NODE_SHM_FLAG_ARRIVED,
+    NODE_SHM_FLAG_DONE,
+};
+
+enum {
+    NODE_SHM_PHASE_WAIT_DONE,
+    NODE_SHM_PHASE_WAIT_ARRIVED,
+    NODE_SHM_PHASE_COPY_OUT,
+};
+
+/* Each local rank owns one cache line of flags at the start of the
+   segment, the slots start at the next page */
+#define NODE_SHM_FLAGS(_seg, _lrank)                                           \
+    ((volatile uint64_t *)PTR_OFFSET(_seg, (_lrank) * UCC_CACHE_LINE_SIZE))
+
+#define NODE_SHM_CTRL_SIZE(_ppn)                                               \
+    ucc_align_up((_ppn) * UCC_CACHE_LINE_SIZE, ucc_get_page_size())
+
+static inline ucc_subset_t ucc_cl_hier_node_subset(ucc_cl_hier_team_t *team)
+{
+    ucc_subset_t subset;
+
+    subset.map    = team->sbgps[UCC_HIER_SBGP_NODE].sbgp->map;
+    subset.myrank = SBGP_RANK(team, NODE);
+    return subset;
+}
+
+ucc_status_t ucc_cl_hier_node_shm_setup(ucc_cl_hier_team_t *team)
+{
+    ucc_cl_hier_lib_t      *lib  = UCC_CL_HIER_TEAM_LIB(team);
+    ucc_team_t             *core = team->super.super.params.team;
+    ucc_cl_hier_node_shm_t *shm  = &team->node_shm;
+    ucc_subset_t            subset;
+    ucc_rank_t              ppn;
+    size_t                  size;
+    ucc_status_t            status;
+
+    switch (shm->state) {
+    case UCC_CL_HIER_NODE_SHM_STATE_INIT:
+        if (lib->cfg.node_shm_size == 0 || !SBGP_ENABLED(team, NODE) ||
+            SBGP_SIZE(team, NODE) < 2) {
+            shm->state = UCC_CL_HIER_NODE_SHM_STATE_DONE;
+            return UCC_OK;
+        }
+        ppn            = SBGP_SIZE(team, NODE);
+        shm->slot_size = ucc_align_up(lib->cfg.node_shm_size,
+                                      UCC_CACHE_LINE_SIZE);
+        shm->shm_id    = -1;
+        if (SBGP_RANK(team, NODE) == 0) {
+            size = NODE_SHM_CTRL_SIZE(ppn) + ppn * shm->slot_size;
+            if (UCC_OK != ucc_sysv_alloc(&size, &shm->seg, &shm->shm_id)) {
+                cl_debug(UCC_CL_TEAM_LIB(team),
+                         "failed to allocate %zd bytes of node shm", size);
+                shm->seg    = NULL;
+                shm->shm_id = -1;
+            }
+        }
+        status = ucc_service_bcast(core, &shm->shm_id, sizeof(shm->shm_id),
+                                   0, ucc_cl_hier_node_subset(team),
+                                   &shm->req);
+        if (UCC_OK != status) {
+            cl_error(UCC_CL_TEAM_LIB(team), "failed to post node shm bcast");
+            return status;
+        }
+        shm->state = UCC_CL_HIER_NODE_SHM_STATE_BCAST;
+        /* fall through */
+    case UCC_CL_HIER_NODE_SHM_STATE_BCAST:
+        status = ucc_service_coll_test(shm->req);
+        if (status != UCC_OK) {
+            return status;
+        }
+        ucc_service_coll_finalize(shm->req);
+        shm->req = NULL;
+        if (SBGP_RANK(team, NODE) != 0 && shm->shm_id >= 0) {
+            shm->seg = shmat(shm->shm_id, NULL, 0);
+            if (shm->seg == (void *)-1) {
+                cl_debug(UCC_CL_TEAM_LIB(team),
+                         "failed to attach node shm, errno %d (%s)", errno,
+                         strerror(errno));
+                shm->seg = NULL;
+            }
+        }
+        /* the segment is used only if all the local ranks attached it */
+        shm->attached[0] = (shm->seg != NULL);
+        subset           = ucc_cl_hier_node_subset(team);
+        status = ucc_service_allreduce(core, &shm->attached[0],
+                                       &shm->attached[1], UCC_DT_INT32, 1,
+                                       UCC_OP_MIN, subset, &shm->req);
+        if (UCC_OK != status) {
+            cl_error(UCC_CL_TEAM_LIB(team),
+                     "failed to post node shm allreduce");
+            return status;
+        }
+        shm->state = UCC_CL_HIER_NODE_SHM_STATE_AGREE;
+        /* fall through */
+    case UCC_CL_HIER_NODE_SHM_STATE_AGREE:
+        status = ucc_service_coll_test(shm->req);
+        if (status != UCC_OK) {
+            return status;
+        }
+        ucc_service_coll_finalize(shm->req);
+        shm->req = NULL;
+        if (!shm->attached[1]) {
+            cl_debug(UCC_CL_TEAM_LIB(team), "node shm is not available");
+            ucc_cl_hier_node_shm_cleanup(team);
+        } else {
+            shm->slots = PTR_OFFSET(shm->seg,
+                                    NODE_SHM_CTRL_SIZE(SBGP_SIZE(team, NODE)));
+            cl_debug(UCC_CL_TEAM_LIB(team),
+                     "node shm %p, slot size %zd, shm_id %d", shm->seg,
+                     shm->slot_size, shm->shm_id);
+        }
+        shm->state = UCC_CL_HIER_NODE_SHM_STATE_DONE;
+        /* fall through */
+    case UCC_CL_HIER_NODE_SHM_STATE_DONE:
+        break;
+    }
+    return UCC_OK;
+}
+
+void ucc_cl_hier_node_shm_cleanup(ucc_cl_hier_team_t *team)
+{
+    ucc_cl_hier_node_shm_t *shm = &team->node_shm;
+
+    if (shm->req) {
+        ucc_service_coll_finalize(shm->req);
+        shm->req = NULL;
+    }
+    if (shm->seg) {
+        ucc_sysv_free(shm->seg);
+        shm->seg   = NULL;
+        shm->slots = NULL;
+    }
+}
+
+/* Checks if flag @flag of all the local ranks reached @seq */
+static inline int ucc_cl_hier_node_shm_reached(ucc_cl_hier_team_t *team,
+                                               int flag, uint64_t seq)
+{
+    ucc_rank_t ppn = SBGP_SIZE(team, NODE);
+    ucc_rank_t i;
+
+    for (i = 0; i < ppn; i++) {
+        if (NODE_SHM_FLAGS(team->node_shm.seg, i)[flag] < seq) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static inline size_t node_shm_block_offset(ucc_coll_args_t *args,
+                                           ucc_rank_t       lrank)
+{
+    size_t     offset = 0;
+    ucc_rank_t i;
+
+    if (args->coll_type == UCC_COLL_TYPE_ALLGATHERV) {
+        return ucc_coll_args_get_displacement(args,
+                                              args->dst.info_v.displacements,
+                                              lrank);
+    }
+    for (i = 0; i < lrank; i++) {
+        offset += ucc_coll_args_get_count(args, args->dst.info_v.counts, i);
+    }
+    return offset;
+}
+
+/* Puts the data of the calling rank into the segment */
+static ucc_status_t node_shm_copy_in(ucc_cl_hier_node_shm_task_t *task)
+{
+    ucc_coll_args_t    *args = &task->super.bargs.args;
+    ucc_cl_hier_team_t *team =
+        ucc_derived_of(task->super.team, ucc_cl_hier_team_t);
+    ucc_rank_t          ppn     = SBGP_SIZE(team, NODE);
+    ucc_rank_t          lrank   = SBGP_RANK(team, NODE);
+    size_t              dt_size = ucc_dt_size(args->dst.info_v.datatype);
+    size_t              count, offset;
+    ucc_rank_t          i;
+    void               *src, *dst;
+
+    if (args->coll_type == UCC_COLL_TYPE_ALLGATHERV) {
+        count  = ucc_coll_args_get_count(args, args->dst.info_v.counts, lrank);
+        offset = node_shm_block_offset(args, lrank) * dt_size;
+        src    = UCC_IS_INPLACE(*args)
+                     ? PTR_OFFSET(args->dst.info_v.buffer, offset)
+                     : args->src.info.buffer;
+        dst    = PTR_OFFSET(team->node_shm.slots, offset);
+    } else {
+        count = 0;
+        for (i = 0; i < ppn; i++) {
+            count += ucc_coll_args_get_count(args, args->dst.info_v.counts, i);
+        }
+        src = UCC_IS_INPLACE(*args) ? args->dst.info_v.buffer
+                                    : args->src.info.buffer;
+        dst = PTR_OFFSET(team->node_shm.slots,
+                         lrank * team->node_shm.slot_size);
+    }
+    if (count == 0) {
+        return UCC_OK;
+    }
+    return ucc_mc_memcpy(dst, src, count * dt_size, UCC_MEMORY_TYPE_HOST,
+                         UCC_MEMORY_TYPE_HOST);
+}
+
+/* REDUCE_SCATTERV: reduces the own block from all the slots,
+   ALLGATHERV: copies the blocks of the other ranks from the segment */
+static ucc_status_t node_shm_copy_out(ucc_cl_hier_node_shm_task_t *task)
+{
+    ucc_coll_args_t    *args = &task->super.bargs.args;
+    ucc_cl_hier_team_t *team =
+        ucc_derived_of(task->super.team, ucc_cl_hier_team_t);
+    ucc_rank_t          ppn     = SBGP_SIZE(team, NODE);
+    ucc_rank_t          lrank   = SBGP_RANK(team, NODE);
+    ucc_datatype_t      dt      = args->dst.info_v.datatype;
+    size_t              dt_size = ucc_dt_size(dt);
+    void               *slots   = team->node_shm.slots;
+    ucc_ee_executor_t  *exec;
+    size_t              count, offset;
+    ucc_status_t        status;
+    ucc_rank_t          i;
+    void               *dst;
+
+    if (args->coll_type == UCC_COLL_TYPE_ALLGATHERV) {
+        for (i = 0; i < ppn; i++) {
+            count = ucc_coll_args_get_count(args, args->dst.info_v.counts, i);
+            if (count == 0 || (i == lrank && UCC_IS_INPLACE(*args))) {
+                continue;
+            }
+            offset = node_shm_block_offset(args, i) * dt_size;
+            status = ucc_mc_memcpy(PTR_OFFSET(args->dst.info_v.buffer, offset),
+                                   PTR_OFFSET(slots, offset), count * dt_size,
+                                   UCC_MEMORY_TYPE_HOST, UCC_MEMORY_TYPE_HOST);
+            if (ucc_unlikely(UCC_OK != status)) {
+                return status;
+            }
+        }
+        return UCC_OK;
+    }
+
+    status = ucc_coll_task_get_executor(&task->super, &exec);
+    if (ucc_unlikely(UCC_OK != status)) {
+        return status;
+    }
+    count  = ucc_coll_args_get_count(args, args->dst.info_v.counts, lrank);
+    offset = node_shm_block_offset(args, lrank) * dt_size;
+    dst    = UCC_IS_INPLACE(*args) ? PTR_OFFSET(args->dst.info_v.buffer, offset)
+                                   : args->dst.info_v.buffer;
+    return ucc_dt_reduce_strided(
+        PTR_OFFSET(slots, offset),
+        PTR_OFFSET(slots, offset + team->node_shm.slot_size), dst, ppn - 1,
+        count, team->node_shm.slot_size, dt, args,
+        args->op == UCC_OP_AVG ? UCC_EEE_TASK_FLAG_REDUCE_WITH_ALPHA : 0,
+        1.0 / (double)ppn, exec, &task->etask);
+}
+
+static void ucc_cl_hier_node_shm_task_progress(ucc_coll_task_t *coll_task)
+{
+    ucc_cl_hier_node_shm_task_t *task =
+        ucc_derived_of(coll_task, ucc_cl_hier_node_shm_task_t);
+    ucc_cl_hier_team_t *team =
+        ucc_derived_of(coll_task->team, ucc_cl_hier_team_t);
+    volatile uint64_t  *flags =
+        NODE_SHM_FLAGS(team->node_shm.seg, SBGP_RANK(team, NODE));
+    ucc_status_t        status;
+
+    switch (task->phase) {
+    case NODE_SHM_PHASE_WAIT_DONE:
+        if (!ucc_cl_hier_node_shm_reached(team, NODE_SHM_FLAG_DONE,
+                                          task->seq - 1)) {
+            return;
+        }
+        ucc_memory_cpu_load_fence();
+        status = node_shm_copy_in(task);
+        if (ucc_unlikely(UCC_OK != status)) {
+            cl_error(UCC_TASK_LIB(task), "failed to copy to node shm");
+            coll_task->status = status;
+            return;
+        }
+        ucc_memory_cpu_store_fence();
+        flags[NODE_SHM_FLAG_ARRIVED] = task->seq;
+        task->phase                  = NODE_SHM_PHASE_WAIT_ARRIVED;
+        /* fall through */
+    case NODE_SHM_PHASE_WAIT_ARRIVED:
+        if (!ucc_cl_hier_node_shm_reached(team, NODE_SHM_FLAG_ARRIVED,
+                                          task->seq)) {
+            return;
+        }
+        ucc_memory_cpu_load_fence();
+        status = node_shm_copy_out(task);
+        if (ucc_unlikely(UCC_OK != status)) {
+            cl_error(UCC_TASK_LIB(task), "failed to copy from node shm");
+            coll_task->status = status;
+            return;
+        }
+        task->phase = NODE_SHM_PHASE_COPY_OUT;
+        /* fall through */
+    case NODE_SHM_PHASE_COPY_OUT:
+        if (task->etask) {
+            status = ucc_ee_executor_task_test(task->etask);
+            if (status > 0) {
+                return;
+            }
+            ucc_ee_executor_task_finalize(task->etask);
+            task->etask = NULL;
+            if (ucc_unlikely(status < 0)) {
+                cl_error(UCC_TASK_LIB(task), "failure in node shm reduction");
+                coll_task->status = status;
+                return;
+            }
+        }
+        ucc_memory_cpu_store_fence();
+        flags[NODE_SHM_FLAG_DONE] = task->seq;
+        break;
+    }
+    coll_task->status = UCC_OK;
+}
+
+static ucc_status_t ucc_cl_hier_node_shm_task_post(ucc_coll_task_t *coll_task)
+{
+    ucc_cl_hier_node_shm_task_t *task =
+        ucc_derived_of(coll_task, ucc_cl_hier_node_shm_task_t);
+
+    ucc_assert(task->seq > 0);
+    task->phase       = NODE_SHM_PHASE_WAIT_DONE;
+    task->etask       = NULL;
+    coll_task->status = UCC_INPROGRESS;
+    return ucc_progress_queue_enqueue(coll_task->team->context->ucc_context->pq,
+                                      coll_task);
+}
+
+static ucc_status_t
+ucc_cl_hier_node_shm_task_finalize(ucc_coll_task_t *coll_task)
+{
+    ucc_coll_task_destruct(coll_task);
+    ucc_free(coll_task);
+    return UCC_OK;
+}
+
+ucc_status_t ucc_cl_hier_node_shm_task_init(ucc_base_coll_args_t *coll_args,
+                                            ucc_base_team_t      *team,
+                                            ucc_coll_task_t     **task_p)
+{
+    ucc_cl_hier_node_shm_task_t *task;
+    ucc_status_t                 status;
+
+    ucc_assert(coll_args->args.coll_type == UCC_COLL_TYPE_REDUCE_SCATTERV ||
+               coll_args->args.coll_type == UCC_COLL_TYPE_ALLGATHERV);
+    task = ucc_malloc(sizeof(*task), "cl_hier_node_shm_task");
+    if (ucc_unlikely(!task)) {
+        cl_error(team->context->lib, "failed to allocate %zd bytes for task",
+                 sizeof(*task));
+        return UCC_ERR_NO_MEMORY;
+    }
+    ucc_coll_task_construct(&task->super);
+    status = ucc_coll_task_init(&task->super, coll_args, team);
+    if (ucc_unlikely(UCC_OK != status)) {
+        ucc_cl_hier_node_shm_task_finalize(&task->super);
+        return status;
+    }
+    if (coll_args->args.coll_type == UCC_COLL_TYPE_REDUCE_SCATTERV) {
+        task->super.flags |= UCC_COLL_TASK_FLAG_EXECUTOR;
+    }
+    task->super.post     = ucc_cl_hier_node_shm_task_post;
+    task->super.progress = ucc_cl_hier_node_shm_task_progress;
+    task->super.finalize = ucc_cl_hier_node_shm_task_finalize;
+    task->seq            = 0;
+    task->etask          = NULL;
+    *task_p              = &task->super;
+    return UCC_OK;
+}
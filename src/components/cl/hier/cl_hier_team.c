@@ -14,16 +14,178 @@
     _team->sbgps[UCC_HIER_SBGP_##_sbgp].sbgp_type = UCC_SBGP_##_sbgp;          \
     _team->sbgps[UCC_HIER_SBGP_##_sbgp].state     = UCC_HIER_SBGP_##_enable;
 
+#define LEVEL_ADD(_team, _sbgp)                                                \
+    _team->levels[_team->n_levels++] = UCC_HIER_SBGP_##_sbgp;
+
 /* The function below must enable/disable those hier sbgps that will be
    used to construct hierarchical schedules.
    Currently just enable two sbgps as example and for testing purposes.
    Next step is to enable sbgps based on the requested hierarchical algs. */
-static void ucc_cl_hier_enable_sbgps(ucc_cl_hier_team_t *team)
+static void ucc_cl_hier_enable_sbgps(ucc_cl_hier_team_t *team,
+                                     ucc_topo_t         *topo)
 {
+    ucc_cl_hier_lib_t *lib = UCC_CL_HIER_TEAM_LIB(team);
+
     SBGP_SET(team, NET, ENABLED);
     SBGP_SET(team, NODE, ENABLED);
     SBGP_SET(team, NODE_LEADERS, ENABLED);
     SBGP_SET(team, FULL, ENABLED); //todo parse score if a2av is enabled
+
+    /* The split level is used only if there are at least 2 sockets (numas)
+       on the node: the decision is the same for all the processes of
+       the node */
+    team->n_levels = 0;
+    switch (lib->cfg.node_split) {
+    case UCC_CL_HIER_NODE_SPLIT_SOCKET:
+        if (ucc_topo_n_sockets(topo) > 1) {
+            SBGP_SET(team, SOCKET, ENABLED);
+            SBGP_SET(team, SOCKET_LEADERS, ENABLED);
+            LEVEL_ADD(team, SOCKET);
+            LEVEL_ADD(team, SOCKET_LEADERS);
+        }
+        break;
+    case UCC_CL_HIER_NODE_SPLIT_NUMA:
+        if (ucc_topo_n_numas(topo) > 1) {
+            SBGP_SET(team, NUMA, ENABLED);
+            SBGP_SET(team, NUMA_LEADERS, ENABLED);
+            LEVEL_ADD(team, NUMA);
+            LEVEL_ADD(team, NUMA_LEADERS);
+        }
+        break;
+    default:
+        break;
+    }
+    if (team->n_levels == 0) {
+        LEVEL_ADD(team, NODE);
+    }
+    LEVEL_ADD(team, NODE_LEADERS);
+}
+
+/* Leader of SOCKET, NUMA and NODE sbgps is always rank 0 of sbgp, while
+   SOCKET_LEADERS and NUMA_LEADERS are ordered by socket (numa) id and
+   their leader is the node leader. */
+static ucc_rank_t ucc_cl_hier_sbgp_leader(ucc_hier_sbgp_t *hs,
+                                          ucc_topo_t      *topo)
+{
+    switch (hs->sbgp_type) {
+    case UCC_SBGP_SOCKET_LEADERS:
+    case UCC_SBGP_NUMA_LEADERS:
+        return ucc_ep_map_local_rank(hs->sbgp->map, topo->node_leader_rank);
+    default:
+        return 0;
+    }
+}
+
+/* Checks if team ranks r1 and r2 belong to the same sbgp of type @type */
+static inline int ucc_cl_hier_same_sbgp(ucc_topo_t *topo,
+                                        ucc_hier_sbgp_type_t type,
+                                        ucc_rank_t r1, ucc_rank_t r2)
+{
+    ucc_proc_info_t *p1 =
+        &topo->topo->procs[ucc_ep_map_eval(topo->set.map, r1)];
+    ucc_proc_info_t *p2 =
+        &topo->topo->procs[ucc_ep_map_eval(topo->set.map, r2)];
+
+    if (p1->host_hash != p2->host_hash) {
+        return 0;
+    }
+    switch (type) {
+    case UCC_HIER_SBGP_SOCKET:
+        return p1->socket_id == p2->socket_id;
+    case UCC_HIER_SBGP_NUMA:
+        return p1->numa_id == p2->numa_id;
+    default:
+        /* NODE, SOCKET_LEADERS and NUMA_LEADERS span the node */
+        return 1;
+    }
+}
+
+ucc_rank_t ucc_cl_hier_level_root(ucc_cl_hier_team_t *team, int level,
+                                  ucc_rank_t root)
+{
+    ucc_topo_t *topo = team->super.super.params.team->topo;
+    ucc_sbgp_t *sbgp = LEVEL_SBGP(team, level)->sbgp;
+    ucc_rank_t  i, r;
+
+    for (i = 0; i < sbgp->group_size; i++) {
+        r = ucc_ep_map_eval(sbgp->map, i);
+        if (r == root ||
+            (level > 0 &&
+             ucc_cl_hier_same_sbgp(topo, team->levels[level - 1], r, root))) {
+            return i;
+        }
+    }
+    return UCC_RANK_INVALID;
+}
+
+ucc_status_t ucc_cl_hier_get_rail_ranks(ucc_cl_hier_team_t *team,
+                                        ucc_rank_t        **rail_ranks)
+{
+    ucc_topo_t *topo  = team->super.super.params.team->topo;
+    ucc_rank_t  size  = UCC_CL_TEAM_SIZE(team);
+    ucc_rank_t  nnodes, ppn, i, k, l;
+    ucc_rank_t *node_idx, *local_size, *ranks;
+    ucc_host_id_t host_id;
+
+    if (team->rail_ranks) {
+        *rail_ranks = team->rail_ranks;
+        return UCC_OK;
+    }
+    if (!SBGP_ENABLED(team, NODE) || !SBGP_ENABLED(team, NET) ||
+        !ucc_topo_isoppn(topo)) {
+        return UCC_ERR_NOT_SUPPORTED;
+    }
+    nnodes = SBGP_SIZE(team, NET);
+    ppn    = SBGP_SIZE(team, NODE);
+    ucc_assert(nnodes * ppn == size);
+
+    ranks = ucc_malloc(2 * size * sizeof(ucc_rank_t), "rail_ranks");
+    if (!ranks) {
+        cl_error(UCC_CL_TEAM_LIB(team),
+                 "failed to allocate %zd bytes for rail_ranks",
+                 2 * size * sizeof(ucc_rank_t));
+        return UCC_ERR_NO_MEMORY;
+    }
+    node_idx = ucc_calloc(2 * topo->topo->nnodes, sizeof(ucc_rank_t),
+                          "node_idx");
+    if (!node_idx) {
+        cl_error(UCC_CL_TEAM_LIB(team),
+                 "failed to allocate %zd bytes for node_idx",
+                 2 * topo->topo->nnodes * sizeof(ucc_rank_t));
+        ucc_free(ranks);
+        return UCC_ERR_NO_MEMORY;
+    }
+    local_size = node_idx + topo->topo->nnodes;
+
+    /* Same ordering as used by the NODE and NET sbgps: local ranks follow
+       the team ranks on the node, nodes are ordered by host_id */
+    for (i = 0; i < size; i++) {
+        host_id = topo->topo->procs[ucc_ep_map_eval(topo->set.map, i)].host_id;
+        node_idx[host_id] = 1;
+    }
+    for (i = 0, k = 0; i < topo->topo->nnodes; i++) {
+        if (node_idx[i]) {
+            node_idx[i] = k++;
+        }
+    }
+    ucc_assert(k == nnodes);
+    for (i = 0; i < size; i++) {
+        host_id = topo->topo->procs[ucc_ep_map_eval(topo->set.map, i)].host_id;
+        l       = local_size[host_id]++;
+        ranks[l * nnodes + node_idx[host_id]] = i;
+        ranks[size + i] = l * nnodes + node_idx[host_id];
+    }
+    ucc_free(node_idx);
+
+    if (ranks[SBGP_RANK(team, NODE) * nnodes + SBGP_RANK(team, NET)] !=
+        UCC_CL_TEAM_RANK(team)) {
+        /* node leader is not the first local rank, NODE and NET sbgps
+           are not aligned with the rail-major order */
+        ucc_free(ranks);
+        return UCC_ERR_NOT_SUPPORTED;
+    }
+    team->rail_ranks = *rail_ranks = ranks;
+    return UCC_OK;
 }
 
 UCC_CLASS_INIT_FUNC(ucc_cl_hier_team_t, ucc_base_context_t *cl_context,
@@ -53,7 +215,13 @@ UCC_CLASS_INIT_FUNC(ucc_cl_hier_team_t, ucc_base_context_t *cl_context,
     UCC_CLASS_CALL_SUPER_INIT(ucc_cl_team_t, &ctx->super, params);
 
     memset(self->sbgps, 0, sizeof(self->sbgps));
-    ucc_cl_hier_enable_sbgps(self);
+    self->rail_ranks = NULL;
+    self->a2a_counts = NULL;
+    memset(self->a2av_cache, 0, sizeof(self->a2av_cache));
+    memset(&self->node_shm, 0, sizeof(self->node_shm));
+    self->a2av_aggr_seq = 0;
+    self->ml_reduce_seq = 0;
+    ucc_cl_hier_enable_sbgps(self, params->team->topo);
     n_sbgp_teams = 0;
     for (i = 0; i < UCC_HIER_SBGP_LAST; i++) {
         hs            = &self->sbgps[i];
@@ -67,7 +235,8 @@ UCC_CLASS_INIT_FUNC(ucc_cl_hier_team_t, ucc_base_context_t *cl_context,
                 hs->state = UCC_HIER_SBGP_DISABLED;
                 continue;
             }
-            hs->n_tls = 0;
+            hs->leader = ucc_cl_hier_sbgp_leader(hs, params->team->topo);
+            hs->n_tls  = 0;
             tls       = &lib->cfg.sbgp_tls[i].array;
             for (j = 0; j < tls->count; j++) {
                 status =
@@ -144,7 +313,16 @@ err:
 
 UCC_CLASS_CLEANUP_FUNC(ucc_cl_hier_team_t)
 {
+    int i;
+
     cl_info(self->super.super.context->lib, "finalizing cl team: %p", self);
+    ucc_free(self->rail_ranks);
+    ucc_free(self->a2a_counts);
+    for (i = 0; i < UCC_CL_HIER_A2AV_CACHE_SIZE; i++) {
+        ucc_assert(self->a2av_cache[i].refcount == 0);
+        ucc_free(self->a2av_cache[i].storage);
+    }
+    ucc_cl_hier_node_shm_cleanup(self);
 }
 
 UCC_CLASS_DEFINE_DELETE_FUNC(ucc_cl_hier_team_t, ucc_base_team_t);
@@ -210,6 +388,11 @@ ucc_status_t ucc_cl_hier_team_create_test(ucc_base_team_t *cl_team)
     struct ucc_team_team_desc *d;
     ucc_hier_sbgp_t           *hs;
 
+    if (!team->team_create_req) {
+        /* sbgp teams are created, node shm setup is in progress */
+        return ucc_cl_hier_node_shm_setup(team);
+    }
+
     status = ucc_tl_team_create_multiple(team->team_create_req);
 
     if (status != UCC_OK) {
@@ -286,14 +469,17 @@ ucc_status_t ucc_cl_hier_team_create_test(ucc_base_team_t *cl_team)
     ucc_team_multiple_req_free(team->team_create_req);
     team->team_create_req = NULL;
 
-    if (SBGP_EXISTS(team, NODE_LEADERS)) {
-        team->top_sbgp = UCC_HIER_SBGP_NODE_LEADERS;
-    } else {
-        ucc_assert(SBGP_EXISTS(team, NODE));
-        team->top_sbgp = UCC_HIER_SBGP_NODE;
+    if (!SBGP_EXISTS(team, NODE_LEADERS)) {
+        ucc_assert(team->levels[team->n_levels - 1] ==
+                   UCC_HIER_SBGP_NODE_LEADERS);
+        team->n_levels--;
     }
-
-    return status;
+    ucc_assert(team->n_levels > 0);
+    team->top_sbgp = team->levels[team->n_levels - 1];
+    if (status != UCC_OK) {
+        return status;
+    }
+    return ucc_cl_hier_node_shm_setup(team);
 }
 
 ucc_status_t ucc_cl_hier_team_get_scores(ucc_base_team_t   *cl_team,
@@ -343,6 +529,66 @@ ucc_status_t ucc_cl_hier_team_get_scores(ucc_base_team_t   *cl_team,
 
     }
 
+    status = ucc_coll_score_add_range(
+        score, UCC_COLL_TYPE_BCAST, UCC_MEMORY_TYPE_HOST,
+        0, UCC_MSG_MAX,
+        /* low priority 1: to be enabled manually */
+        1, ucc_cl_hier_bcast_2step_init, cl_team);
+    if (UCC_OK != status) {
+        cl_error(lib, "faild to add range to score_t");
+        return status;
+    }
+
+    status = ucc_coll_score_add_range(
+        score, UCC_COLL_TYPE_REDUCE, UCC_MEMORY_TYPE_HOST,
+        0, UCC_MSG_MAX,
+        /* low priority 1: to be enabled manually */
+        1, ucc_cl_hier_reduce_2step_init, cl_team);
+    if (UCC_OK != status) {
+        cl_error(lib, "faild to add range to score_t");
+        return status;
+    }
+
+    status = ucc_coll_score_add_range(
+        score, UCC_COLL_TYPE_ALLGATHER, UCC_MEMORY_TYPE_HOST,
+        0, UCC_MSG_MAX,
+        /* low priority 1: to be enabled manually */
+        1, ucc_cl_hier_allgather_split_rail_init, cl_team);
+    if (UCC_OK != status) {
+        cl_error(lib, "faild to add range to score_t");
+        return status;
+    }
+
+    status = ucc_coll_score_add_range(
+        score, UCC_COLL_TYPE_ALLGATHERV, UCC_MEMORY_TYPE_HOST,
+        0, UCC_MSG_MAX,
+        /* low priority 1: to be enabled manually */
+        1, ucc_cl_hier_allgather_split_rail_init, cl_team);
+    if (UCC_OK != status) {
+        cl_error(lib, "faild to add range to score_t");
+        return status;
+    }
+
+    status = ucc_coll_score_add_range(
+        score, UCC_COLL_TYPE_REDUCE_SCATTER, UCC_MEMORY_TYPE_HOST,
+        0, UCC_MSG_MAX,
+        /* low priority 1: to be enabled manually */
+        1, ucc_cl_hier_reduce_scatter_split_rail_init, cl_team);
+    if (UCC_OK != status) {
+        cl_error(lib, "faild to add range to score_t");
+        return status;
+    }
+
+    status = ucc_coll_score_add_range(
+        score, UCC_COLL_TYPE_REDUCE_SCATTERV, UCC_MEMORY_TYPE_HOST,
+        0, UCC_MSG_MAX,
+        /* low priority 1: to be enabled manually */
+        1, ucc_cl_hier_reduce_scatter_split_rail_init, cl_team);
+    if (UCC_OK != status) {
+        cl_error(lib, "faild to add range to score_t");
+        return status;
+    }
+
     for (i = 0; i < UCC_CL_HIER_N_DEFAULT_ALG_SELECT_STR; i++) {
         status = ucc_coll_score_update_from_str(
             ucc_cl_hier_default_alg_select_str[i], score,
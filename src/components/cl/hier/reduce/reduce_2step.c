@@ -0,0 +1,311 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "reduce.h"
+#include "../cl_hier_coll.h"
+#include "core/ucc_team.h"
+
+static ucc_status_t
+ucc_cl_hier_reduce_2step_frag_finalize(ucc_coll_task_t *task)
+{
+    ucc_cl_hier_schedule_t *schedule =
+        ucc_derived_of(task, ucc_cl_hier_schedule_t);
+    ucc_status_t status;
+
+    status = ucc_schedule_finalize(task);
+    if (schedule->scratch) {
+        ucc_mc_free(schedule->scratch);
+    }
+    ucc_cl_hier_put_schedule(&schedule->super.super);
+    return status;
+}
+
+static ucc_status_t
+ucc_cl_hier_reduce_2step_schedule_finalize(ucc_coll_task_t *task)
+{
+    ucc_cl_hier_schedule_t *schedule =
+        ucc_derived_of(task, ucc_cl_hier_schedule_t);
+    ucc_status_t status;
+
+    UCC_CL_HIER_PROFILE_REQUEST_EVENT(task, "cl_hier_reduce_2step_finalize",
+                                      0);
+    status = ucc_schedule_pipelined_finalize(&schedule->super.super.super);
+    ucc_cl_hier_put_schedule(&schedule->super.super);
+    return status;
+}
+
+static inline void *
+ucc_cl_hier_reduce_2step_buf(ucc_cl_hier_schedule_t *frag,
+                             ucc_coll_args_t *args, uint8_t buf,
+                             size_t offset)
+{
+    switch (buf) {
+    case UCC_CL_HIER_REDUCE_BUF_SRC:
+        return PTR_OFFSET(args->src.info.buffer, offset);
+    case UCC_CL_HIER_REDUCE_BUF_DST:
+        return PTR_OFFSET(args->dst.info.buffer, offset);
+    default:
+        /* scratch is allocated per fragment */
+        return frag->scratch->addr;
+    }
+}
+
+static ucc_status_t
+ucc_cl_hier_reduce_2step_frag_setup(ucc_schedule_pipelined_t *schedule_p,
+                                    ucc_schedule_t *frag, int frag_num)
+{
+    ucc_cl_hier_team_t *cl_team =
+        ucc_derived_of(schedule_p->super.super.team, ucc_cl_hier_team_t);
+    ucc_cl_hier_schedule_t *cl_frag =
+        ucc_derived_of(frag, ucc_cl_hier_schedule_t);
+    ucc_coll_args_t *args = &schedule_p->super.super.bargs.args;
+    ucc_coll_buffer_info_t *info =
+        (UCC_CL_TEAM_RANK(cl_team) == args->root) ? &args->dst.info
+                                                  : &args->src.info;
+    size_t           dt_size = ucc_dt_size(info->datatype);
+    int              n_frags = schedule_p->super.n_tasks;
+    size_t           frag_count, frag_offset;
+    ucc_coll_args_t *targs;
+    int              i;
+
+    frag_count  = ucc_buffer_block_count(info->count, n_frags, frag_num);
+    frag_offset = ucc_buffer_block_offset(info->count, n_frags, frag_num);
+
+    for (i = 0; i < frag->n_tasks; i++) {
+        targs                  = &frag->tasks[i]->bargs.args;
+        targs->src.info.buffer = ucc_cl_hier_reduce_2step_buf(
+            cl_frag, args, cl_frag->reduce_2step.src[i],
+            frag_offset * dt_size);
+        targs->dst.info.buffer = ucc_cl_hier_reduce_2step_buf(
+            cl_frag, args, cl_frag->reduce_2step.dst[i],
+            frag_offset * dt_size);
+        targs->src.info.count  = frag_count;
+        targs->dst.info.count  = frag_count;
+    }
+    return UCC_OK;
+}
+
+/* Ranks whose sbgp at a given level does not contain the root reduce to
+   the sbgp leader going up the levels, the partial results are kept in
+   scratch. Then, starting from the top level, the data is reduced down
+   to the root along the sbgps containing it: at each level the result
+   goes to the process representing the root at that level, which
+   contributes it to the next level below. */
+static ucc_status_t
+ucc_cl_hier_reduce_2step_frag_init(ucc_base_coll_args_t     *coll_args,
+                                   ucc_schedule_pipelined_t *sp,
+                                   ucc_base_team_t          *team,
+                                   ucc_schedule_t          **frag_p)
+{
+    ucc_cl_hier_team_t  *cl_team = ucc_derived_of(team, ucc_cl_hier_team_t);
+    ucc_coll_task_t     *tasks[UCC_CL_HIER_MAX_LEVEL_TASKS] = {NULL};
+    int                  levels[UCC_CL_HIER_MAX_LEVEL_TASKS];
+    ucc_rank_t           roots[UCC_CL_HIER_MAX_LEVEL_TASKS];
+    ucc_rank_t           root    = coll_args->args.root;
+    int                  is_root = (UCC_CL_TEAM_RANK(cl_team) == root);
+    int                  n_frags = sp->super.n_tasks;
+    int                  scratch = 0;
+    ucc_cl_hier_schedule_t *cl_schedule;
+    ucc_coll_buffer_info_t *info;
+    ucc_schedule_t      *schedule;
+    ucc_status_t         status;
+    ucc_base_coll_args_t args;
+    ucc_hier_sbgp_t     *hs;
+    ucc_rank_t           level_root;
+    uint8_t             *src, *dst, cur;
+    int                  n_tasks, n_inited, i, l;
+
+    cl_schedule = ucc_cl_hier_get_schedule(cl_team);
+    if (ucc_unlikely(!cl_schedule)) {
+        return UCC_ERR_NO_MEMORY;
+    }
+    schedule = &cl_schedule->super.super;
+    src      = cl_schedule->reduce_2step.src;
+    dst      = cl_schedule->reduce_2step.dst;
+    info     = is_root ? &coll_args->args.dst.info : &coll_args->args.src.info;
+    memcpy(&args, coll_args, sizeof(args));
+    n_inited = 0;
+    UCC_CHECK_GOTO(ucc_schedule_init(schedule, &args, team), out, status);
+
+    n_tasks = 0;
+    cur     = (is_root && UCC_IS_INPLACE(coll_args->args))
+                  ? UCC_CL_HIER_REDUCE_BUF_DST
+                  : UCC_CL_HIER_REDUCE_BUF_SRC;
+    for (l = 0; l < cl_team->n_levels; l++) {
+        if (!LEVEL_ENABLED(cl_team, l) ||
+            ucc_cl_hier_level_root(cl_team, l, root) != UCC_RANK_INVALID) {
+            continue;
+        }
+        hs              = LEVEL_SBGP(cl_team, l);
+        levels[n_tasks] = l;
+        roots[n_tasks]  = hs->leader;
+        src[n_tasks]    = cur;
+        if (hs->sbgp->group_rank == hs->leader) {
+            cur     = UCC_CL_HIER_REDUCE_BUF_SCRATCH;
+            scratch = 1;
+        }
+        dst[n_tasks++] = cur;
+    }
+
+    for (l = cl_team->n_levels - 1; l >= 0; l--) {
+        if (!LEVEL_ENABLED(cl_team, l)) {
+            continue;
+        }
+        level_root = ucc_cl_hier_level_root(cl_team, l, root);
+        if (level_root == UCC_RANK_INVALID) {
+            continue;
+        }
+        hs              = LEVEL_SBGP(cl_team, l);
+        levels[n_tasks] = l;
+        roots[n_tasks]  = level_root;
+        src[n_tasks]    = cur;
+        if (hs->sbgp->group_rank == level_root) {
+            if (is_root) {
+                cur = UCC_CL_HIER_REDUCE_BUF_DST;
+            } else {
+                cur     = UCC_CL_HIER_REDUCE_BUF_SCRATCH;
+                scratch = 1;
+            }
+        }
+        dst[n_tasks++] = cur;
+    }
+    ucc_assert(n_tasks > 0 && n_tasks <= UCC_CL_HIER_MAX_LEVEL_TASKS);
+
+    args.mask          |= UCC_BASE_CARGS_MAX_FRAG_COUNT;
+    args.max_frag_count = ucc_buffer_block_count(info->count, n_frags, 0);
+    if (scratch) {
+        UCC_CHECK_GOTO(ucc_mc_alloc(&cl_schedule->scratch,
+                                    args.max_frag_count *
+                                        ucc_dt_size(info->datatype),
+                                    info->mem_type),
+                       out, status);
+    }
+
+    args.args.mask |= UCC_COLL_ARGS_FIELD_FLAGS;
+    for (i = 0; i < n_tasks; i++) {
+        hs             = LEVEL_SBGP(cl_team, levels[i]);
+        args.args.root = roots[i];
+        args.args.src.info          = *info;
+        args.args.dst.info          = *info;
+        args.args.src.info.buffer   = ucc_cl_hier_reduce_2step_buf(
+            cl_schedule, &coll_args->args, src[i], 0);
+        args.args.dst.info.buffer   = ucc_cl_hier_reduce_2step_buf(
+            cl_schedule, &coll_args->args, dst[i], 0);
+        args.args.src.info.mem_type = (src[i] == UCC_CL_HIER_REDUCE_BUF_SRC)
+            ? coll_args->args.src.info.mem_type : info->mem_type;
+        args.args.dst.info.mem_type = (dst[i] == UCC_CL_HIER_REDUCE_BUF_DST)
+            ? coll_args->args.dst.info.mem_type : info->mem_type;
+        if (hs->sbgp->group_rank == roots[i] && src[i] == dst[i]) {
+            args.args.flags |= UCC_COLL_ARGS_FLAG_IN_PLACE;
+        } else {
+            args.args.flags &= ~UCC_COLL_ARGS_FLAG_IN_PLACE;
+        }
+        UCC_CHECK_GOTO(ucc_coll_init(hs->score_map, &args, &tasks[i]), out,
+                       status);
+        n_inited++;
+    }
+
+    UCC_CHECK_GOTO(ucc_schedule_add_task(schedule, tasks[0]), out, status);
+    UCC_CHECK_GOTO(ucc_task_subscribe_dep(&schedule->super, tasks[0],
+                                          UCC_EVENT_SCHEDULE_STARTED),
+                   out, status);
+    for (i = 1; i < n_tasks; i++) {
+        UCC_CHECK_GOTO(ucc_schedule_add_task(schedule, tasks[i]), out, status);
+        UCC_CHECK_GOTO(ucc_task_subscribe_dep(tasks[i - 1], tasks[i],
+                                              UCC_EVENT_COMPLETED),
+                       out, status);
+    }
+
+    schedule->super.post     = ucc_schedule_start;
+    schedule->super.progress = NULL;
+    schedule->super.finalize = ucc_cl_hier_reduce_2step_frag_finalize;
+    *frag_p                  = schedule;
+    return UCC_OK;
+
+out:
+    for (i = 0; i < n_inited; i++) {
+        tasks[i]->finalize(tasks[i]);
+    }
+    if (cl_schedule->scratch) {
+        ucc_mc_free(cl_schedule->scratch);
+    }
+    ucc_cl_hier_put_schedule(schedule);
+    return status;
+}
+
+static ucc_status_t ucc_cl_hier_reduce_2step_start(ucc_coll_task_t *task)
+{
+    ucc_schedule_pipelined_t *schedule =
+        ucc_derived_of(task, ucc_schedule_pipelined_t);
+
+    UCC_CL_HIER_PROFILE_REQUEST_EVENT(task, "cl_hier_reduce_2step_start", 0);
+    cl_debug(task->team->context->lib,
+             "posting 2step reduce, sbuf %p, rbuf %p, root %u, op %s, "
+             "inplace %d, pdepth %d, frags_total %d",
+             task->bargs.args.src.info.buffer,
+             task->bargs.args.dst.info.buffer, task->bargs.args.root,
+             ucc_reduction_op_str(task->bargs.args.op),
+             UCC_IS_INPLACE(task->bargs.args), schedule->n_frags,
+             schedule->super.n_tasks);
+    return ucc_schedule_pipelined_post(task);
+}
+
+UCC_CL_HIER_PROFILE_FUNC(ucc_status_t, ucc_cl_hier_reduce_2step_init,
+                         (coll_args, team, task),
+                         ucc_base_coll_args_t *coll_args, ucc_base_team_t *team,
+                         ucc_coll_task_t **task)
+{
+    ucc_cl_hier_team_t       *cl_team = ucc_derived_of(team,
+                                                       ucc_cl_hier_team_t);
+    ucc_cl_hier_lib_config_t *cfg     = &UCC_CL_HIER_TEAM_LIB(cl_team)->cfg;
+    ucc_coll_buffer_info_t   *info;
+    ucc_cl_hier_schedule_t   *schedule;
+    int                       n_frags, pipeline_depth;
+    ucc_status_t              status;
+
+    if (UCC_COLL_ARGS_ACTIVE_SET(&coll_args->args)) {
+        return UCC_ERR_NOT_SUPPORTED;
+    }
+    if (UCC_CL_HIER_ML_ENABLED(cl_team)) {
+        status = ucc_cl_hier_ml_init(coll_args, team, task);
+        if (status != UCC_ERR_NOT_SUPPORTED) {
+            return status;
+        }
+    }
+    if (coll_args->args.op == UCC_OP_AVG) {
+        return UCC_ERR_NOT_SUPPORTED;
+    }
+    schedule = ucc_cl_hier_get_schedule(cl_team);
+    if (ucc_unlikely(!schedule)) {
+        return UCC_ERR_NO_MEMORY;
+    }
+
+    info = (UCC_CL_TEAM_RANK(cl_team) == coll_args->args.root)
+               ? &coll_args->args.dst.info
+               : &coll_args->args.src.info;
+    ucc_cl_hier_get_n_frags(info->count * ucc_dt_size(info->datatype),
+                            cfg->reduce_2step_frag_size,
+                            cfg->reduce_2step_pipeline_depth, &n_frags,
+                            &pipeline_depth);
+
+    status = ucc_schedule_pipelined_init(
+        coll_args, team, ucc_cl_hier_reduce_2step_frag_init,
+        ucc_cl_hier_reduce_2step_frag_setup, pipeline_depth, n_frags,
+        UCC_PIPELINE_PARALLEL, &schedule->super);
+    if (ucc_unlikely(status != UCC_OK)) {
+        cl_error(team->context->lib,
+                 "failed to init pipelined 2step reduce schedule");
+        ucc_cl_hier_put_schedule(&schedule->super.super);
+        return status;
+    }
+
+    schedule->super.super.super.post = ucc_cl_hier_reduce_2step_start;
+    schedule->super.super.super.triggered_post = ucc_triggered_post;
+    schedule->super.super.super.finalize =
+        ucc_cl_hier_reduce_2step_schedule_finalize;
+    *task = &schedule->super.super.super;
+    return UCC_OK;
+}
@@ -0,0 +1,18 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "reduce_scatter.h"
+
+ucc_base_coll_alg_info_t
+    ucc_cl_hier_reduce_scatter_algs[UCC_CL_HIER_REDUCE_SCATTER_ALG_LAST + 1] = {
+        [UCC_CL_HIER_REDUCE_SCATTER_ALG_SPLIT_RAIL] =
+            {.id   = UCC_CL_HIER_REDUCE_SCATTER_ALG_SPLIT_RAIL,
+             .name = "split_rail",
+             .desc = "intra-node reduce_scatter, followed by PPN concurrent "
+                     "inter-node reduce_scatters among the ranks with the "
+                     "same local rank"},
+        [UCC_CL_HIER_REDUCE_SCATTER_ALG_LAST] = {
+            .id = 0, .name = NULL, .desc = NULL}};
@@ -94,7 +94,8 @@ typedef struct ucc_ee_executor_params {
    is complete.
 
    If UCC_EEE_TASK_FLAG_REDUCE_WITH_ALPHA flag is set on task_args
-   each element of the result of reduction is multiplied by "alpha" */
+   each element of the result of reduction is multiplied by "alpha".
+   With n_srcs == 1 this gives a scaled copy of srcs[0] into "dst" */
 typedef struct ucc_eee_task_reduce {
     void *             dst;
     union {
@@ -13,6 +13,13 @@ static ucc_config_field_t ucc_ec_cpu_config_table[] = {
     {"", "", NULL, ucc_offsetof(ucc_ec_cpu_config_t, super),
      UCC_CONFIG_TYPE_TABLE(ucc_ec_config_table)},
 
+    {"REDUCE_USERDEFINED_CHUNK", "32k",
+     "Number of bytes of every source given to one call of a user-defined "
+     "reduction callback. The reduction is split so that the sources and "
+     "the destination of one call stay in cache, 0 - no splitting",
+     ucc_offsetof(ucc_ec_cpu_config_t, reduce_userdefined_chunk),
+     UCC_CONFIG_TYPE_MEMUNITS},
+
     {NULL}
 
 };
@@ -129,6 +136,13 @@ ucc_status_t ucc_cpu_executor_task_post(ucc_ee_executor_t *executor,
         ucc_eee_task_reduce_t tr;
         int                   i;
 
+        if (!UCC_DT_IS_PREDEFINED(trs->dt)) {
+            status = ucc_ec_cpu_reduce_userdefined(trs);
+            if (ucc_unlikely(UCC_OK != status)) {
+                goto free_task;
+            }
+            break;
+        }
         if (n_srcs <= UCC_EE_EXECUTOR_NUM_BUFS) {
             srcs = &tr.srcs[0];
         } else {
@@ -13,6 +13,7 @@
 
 typedef struct ucc_ec_cpu_config {
     ucc_ec_config_t super;
+    size_t          reduce_userdefined_chunk;
 } ucc_ec_cpu_config_t;
 
 typedef struct ucc_ec_cpu {
@@ -25,5 +26,11 @@ typedef struct ucc_ec_cpu {
 
 extern ucc_ec_cpu_t ucc_ec_cpu;
 
+#define EC_CPU_CONFIG                                                          \
+    (ucc_derived_of(ucc_ec_cpu.super.config, ucc_ec_cpu_config_t))
+
 ucc_status_t ucc_ec_cpu_reduce(ucc_eee_task_reduce_t *task, uint16_t flags);
+
+ucc_status_t
+ucc_ec_cpu_reduce_userdefined(ucc_eee_task_reduce_strided_t *task);
 #endif
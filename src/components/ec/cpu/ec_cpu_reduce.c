@@ -5,6 +5,7 @@
  */
 
 #include "utils/ucc_math_op.h"
+#include "utils/ucc_dt_reduce.h"
 #include "ec_cpu.h"
 #include <complex.h>
 
@@ -12,6 +13,11 @@
     do {                                                                       \
         size_t _i, _j;                                                         \
         switch (_n_srcs) {                                                     \
+        case 1:                                                                \
+            for (_i = 0; _i < _count; _i++) {                                  \
+                d[_i] = s[0][_i];                                              \
+            }                                                                  \
+            break;                                                             \
         case 2:                                                                \
             for (_i = 0; _i < _count; _i++) {                                  \
                 d[_i] = OP##_2(s[0][_i], s[1][_i]);                            \
@@ -129,9 +135,8 @@
         int16_t **_s = (int16_t **)_srcs;                                      \
         int16_t * _d = (int16_t *)_dst;                                        \
         for (_i = 0; _i < _count; _i++) {                                      \
-            _tmp = _OP(bfloat16tofloat32(&_s[0][_i]),                          \
-                       bfloat16tofloat32(&_s[1][_i]));                         \
-            for (_j = 2; _j < _n_srcs; _j++) {                                 \
+            _tmp = bfloat16tofloat32(&_s[0][_i]);                              \
+            for (_j = 1; _j < _n_srcs; _j++) {                                 \
                 _tmp = _OP(_tmp, bfloat16tofloat32(&_s[_j][_i]));              \
             }                                                                  \
             float32tobfloat16(_tmp *_alpha, &_d[_i]);                          \
@@ -321,3 +326,42 @@ ucc_status_t ucc_ec_cpu_reduce(ucc_eee_task_reduce_t *task, uint16_t flags)
 
     return UCC_OK;
 }
+
+/* All the sources are given to the user callback at once, so it can reduce
+   them in a single pass over dst. Large vectors are split in chunks of
+   REDUCE_USERDEFINED_CHUNK bytes, so that a callback reducing the sources
+   one after another still finds dst in cache. */
+ucc_status_t ucc_ec_cpu_reduce_userdefined(ucc_eee_task_reduce_strided_t *task)
+{
+    ucc_dt_generic_t *dt    = ucc_dt_to_generic(task->dt);
+    size_t            chunk = EC_CPU_CONFIG->reduce_userdefined_chunk;
+    size_t            dt_size, offset, count;
+    ucc_status_t      status;
+
+    if (!UCC_DT_HAS_REDUCE(task->dt)) {
+        ec_error(&ucc_ec_cpu.super, "datatype %s has no reduction",
+                 ucc_datatype_str(task->dt));
+        return UCC_ERR_NOT_SUPPORTED;
+    }
+
+    if (chunk == 0 || !UCC_DT_IS_CONTIG(task->dt)) {
+        return ucc_dt_reduce_userdefined(task->src1, task->src2, task->dst,
+                                         task->n_src2, task->count,
+                                         task->stride, dt);
+    }
+    dt_size = ucc_dt_size(task->dt);
+    chunk   = ucc_max(chunk / dt_size, 1);
+    for (offset = 0; offset < task->count; offset += count) {
+        count  = ucc_min(chunk, task->count - offset);
+        status = ucc_dt_reduce_userdefined(
+            PTR_OFFSET(task->src1, offset * dt_size),
+            PTR_OFFSET(task->src2, offset * dt_size),
+            PTR_OFFSET(task->dst, offset * dt_size), task->n_src2, count,
+            task->stride, dt);
+        if (ucc_unlikely(UCC_OK != status)) {
+            return status;
+        }
+    }
+
+    return UCC_OK;
+}
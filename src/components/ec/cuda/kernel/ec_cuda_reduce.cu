@@ -32,6 +32,11 @@ extern "C" {
         size_t        i;                                                        \
                                                                                 \
         switch (n_srcs) {                                                       \
+        case 1:                                                                 \
+            for (i = start; i < count; i += step) {                             \
+                d[i] = s[0][i];                                                 \
+            }                                                                   \
+            break;                                                              \
         case 2:                                                                 \
             for (i = start; i < count; i += step) {                             \
                 d[i] = _OP##_2(s[0][i], s[1][i]);                               \
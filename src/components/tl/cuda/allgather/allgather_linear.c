@@ -12,7 +12,12 @@ ucc_status_t ucc_tl_cuda_allgather_linear_init(ucc_base_coll_args_t *coll_args,
                                                ucc_coll_task_t **    task_p)
 {
     ucc_tl_cuda_team_t *team = ucc_derived_of(tl_team, ucc_tl_cuda_team_t);
-    ucc_tl_cuda_task_t *task = ucc_tl_cuda_task_init(coll_args, team);
+    ucc_tl_cuda_task_t *task;
+
+    if (UCC_COLL_ARGS_ACTIVE_SET(&coll_args->args)) {
+        return UCC_ERR_NOT_SUPPORTED;
+    }
+    task = ucc_tl_cuda_task_init(coll_args, team);
 
     task->allgatherv_linear.get_count  = ucc_tl_cuda_allgather_get_count;
     task->allgatherv_linear.get_offset = ucc_tl_cuda_allgather_get_offset;
@@ -69,6 +69,9 @@ ucc_status_t ucc_tl_cuda_coll_init(ucc_base_coll_args_t *coll_args,
                                    ucc_coll_task_t     **task_h)
 {
     UCC_TL_CUDA_CHECK_DEVICE_MATCH(ucc_derived_of(team, ucc_tl_cuda_team_t));
+    if (UCC_COLL_ARGS_ACTIVE_SET(&coll_args->args)) {
+        return UCC_ERR_NOT_SUPPORTED;
+    }
     switch (coll_args->args.coll_type) {
     case UCC_COLL_TYPE_ALLTOALL:
         return ucc_tl_cuda_alltoall_init(coll_args, team, task_h);
@@ -95,6 +95,9 @@ ucc_status_t ucc_tl_sharp_coll_init(ucc_base_coll_args_t *coll_args,
     ucc_tl_sharp_task_t *task;
     ucc_status_t         status;
 
+    if (UCC_COLL_ARGS_ACTIVE_SET(&coll_args->args)) {
+        return UCC_ERR_NOT_SUPPORTED;
+    }
     task = ucc_mpool_get(&sharp_ctx->req_mp);
     ucc_coll_task_init(&task->super, coll_args, team);
     UCC_TL_SHARP_PROFILE_REQUEST_NEW(task, "tl_sharp_task", 0);
@@ -0,0 +1,135 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCC_TL_SHM_H_
+#define UCC_TL_SHM_H_
+#include "components/tl/ucc_tl.h"
+#include "components/tl/ucc_tl_log.h"
+#include "core/ucc_ee.h"
+#include "utils/ucc_mpool.h"
+#include "utils/arch/cpu.h"
+
+#ifndef UCC_TL_SHM_DEFAULT_SCORE
+#define UCC_TL_SHM_DEFAULT_SCORE 20
+#endif
+
+#ifdef HAVE_PROFILING_TL_SHM
+#include "utils/profile/ucc_profile.h"
+#else
+#include "utils/profile/ucc_profile_off.h"
+#endif
+
+#define UCC_TL_SHM_PROFILE_FUNC          UCC_PROFILE_FUNC
+#define UCC_TL_SHM_PROFILE_FUNC_VOID     UCC_PROFILE_FUNC_VOID
+#define UCC_TL_SHM_PROFILE_REQUEST_NEW   UCC_PROFILE_REQUEST_NEW
+#define UCC_TL_SHM_PROFILE_REQUEST_EVENT UCC_PROFILE_REQUEST_EVENT
+#define UCC_TL_SHM_PROFILE_REQUEST_FREE  UCC_PROFILE_REQUEST_FREE
+
+typedef struct ucc_tl_shm_iface {
+    ucc_tl_iface_t super;
+} ucc_tl_shm_iface_t;
+/* Extern iface should follow the pattern: ucc_tl_<tl_name> */
+extern ucc_tl_shm_iface_t ucc_tl_shm;
+
+typedef struct ucc_tl_shm_lib_config {
+    ucc_tl_lib_config_t super;
+    uint32_t            max_concurrent;
+    size_t              data_size;
+    uint32_t            tree_radix;
+} ucc_tl_shm_lib_config_t;
+
+typedef struct ucc_tl_shm_context_config {
+    ucc_tl_context_config_t super;
+} ucc_tl_shm_context_config_t;
+
+typedef struct ucc_tl_shm_lib {
+    ucc_tl_lib_t            super;
+    ucc_tl_shm_lib_config_t cfg;
+} ucc_tl_shm_lib_t;
+UCC_CLASS_DECLARE(ucc_tl_shm_lib_t, const ucc_base_lib_params_t *,
+                  const ucc_base_config_t *);
+
+typedef struct ucc_tl_shm_context {
+    ucc_tl_context_t            super;
+    ucc_tl_shm_context_config_t cfg;
+    ucc_mpool_t                 req_mp;
+} ucc_tl_shm_context_t;
+UCC_CLASS_DECLARE(ucc_tl_shm_context_t, const ucc_base_context_params_t *,
+                  const ucc_base_config_t *);
+
+/* Flags of a rank in a collective slot of the team segment. Every flag
+   holds the stamp of the last collective that set it. */
+typedef struct ucc_tl_shm_ctrl {
+    volatile uint64_t arrive;
+    volatile uint64_t release;
+    volatile uint64_t done;
+} ucc_tl_shm_ctrl_t;
+
+typedef struct ucc_tl_shm_task {
+    ucc_coll_task_t         super;
+    uint32_t                seq_num;
+    uint32_t                coll_id;
+    uint32_t                n_posts;
+    uint64_t                stamp;
+    int                     stage;
+    ucc_rank_t              vrank;
+    ucc_rank_t              parent;
+    ucc_rank_t              first_child;
+    ucc_rank_t              n_children;
+    ucc_ee_executor_task_t *etask;
+} ucc_tl_shm_task_t;
+
+typedef struct ucc_tl_shm_team {
+    ucc_tl_team_t       super;
+    ucc_team_oob_coll_t oob;
+    void               *oob_req;
+    int                *shm_ids;
+    void               *seg;
+    size_t              ctrl_offset;
+    size_t              data_offset;
+    size_t              data_size;
+    uint32_t            max_concurrent;
+    uint32_t            seq_num;
+} ucc_tl_shm_team_t;
+UCC_CLASS_DECLARE(ucc_tl_shm_team_t, ucc_base_context_t *,
+                  const ucc_base_team_params_t *);
+
+#define UCC_TL_SHM_SUPPORTED_COLLS                                             \
+    (UCC_COLL_TYPE_BARRIER | UCC_COLL_TYPE_FANIN | UCC_COLL_TYPE_FANOUT |      \
+     UCC_COLL_TYPE_BCAST | UCC_COLL_TYPE_REDUCE | UCC_COLL_TYPE_ALLREDUCE)
+
+#define UCC_TL_SHM_TEAM_LIB(_team)                                             \
+    (ucc_derived_of((_team)->super.super.context->lib, ucc_tl_shm_lib_t))
+
+#define UCC_TL_SHM_TEAM_CTX(_team)                                             \
+    (ucc_derived_of((_team)->super.super.context, ucc_tl_shm_context_t))
+
+/* Segment layout: one cache line of slot state per concurrent collective,
+   then one cache line of ucc_tl_shm_ctrl_t per rank and slot, then one
+   data buffer per rank and slot starting at a page boundary */
+#define UCC_TL_SHM_STATE(_team, _coll_id)                                      \
+    ((volatile uint64_t *)PTR_OFFSET((_team)->seg,                             \
+                                     (_coll_id) * UCC_CACHE_LINE_SIZE))
+
+#define UCC_TL_SHM_CTRL(_team, _coll_id, _vrank)                               \
+    ((ucc_tl_shm_ctrl_t *)PTR_OFFSET(                                          \
+        (_team)->seg,                                                          \
+        (_team)->ctrl_offset +                                                 \
+            ((_coll_id) * UCC_TL_TEAM_SIZE(_team) + (_vrank)) *                \
+                UCC_CACHE_LINE_SIZE))
+
+#define UCC_TL_SHM_DATA(_team, _coll_id, _vrank)                               \
+    PTR_OFFSET((_team)->seg,                                                   \
+               (_team)->data_offset +                                          \
+                   ((_coll_id) * UCC_TL_TEAM_SIZE(_team) + (_vrank)) *         \
+                       (_team)->data_size)
+
+ucc_status_t ucc_tl_shm_coll_init(ucc_base_coll_args_t *coll_args,
+                                  ucc_base_team_t      *team,
+                                  ucc_coll_task_t     **task_h);
+ucc_status_t ucc_tl_shm_coll_finalize(ucc_coll_task_t *coll_task);
+
+#endif
@@ -0,0 +1,57 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "tl_shm.h"
+#include "tl_shm_coll.h"
+
+/* Barrier is a fanin to team rank 0 followed by a fanout from it,
+   fanin and fanout use the tree rooted at args root */
+static void ucc_tl_shm_barrier_progress(ucc_coll_task_t *coll_task)
+{
+    ucc_tl_shm_task_t *task = ucc_derived_of(coll_task, ucc_tl_shm_task_t);
+    ucc_coll_type_t    ct   = TASK_ARGS(task).coll_type;
+
+    switch (task->stage) {
+    case UCC_TL_SHM_STAGE_ACQUIRE:
+        if (UCC_OK != ucc_tl_shm_slot_acquire(task)) {
+            return;
+        }
+        task->stage = UCC_TL_SHM_STAGE_FANIN;
+        /* fall through */
+    case UCC_TL_SHM_STAGE_FANIN:
+        if (ct != UCC_COLL_TYPE_FANOUT) {
+            if (UCC_OK != ucc_tl_shm_fanin_test(task)) {
+                return;
+            }
+            if (task->vrank != 0) {
+                ucc_tl_shm_signal_arrive(task);
+            }
+            if (ct == UCC_COLL_TYPE_FANIN) {
+                break;
+            }
+        }
+        task->stage = UCC_TL_SHM_STAGE_FANOUT;
+        /* fall through */
+    case UCC_TL_SHM_STAGE_FANOUT:
+        if (UCC_OK != ucc_tl_shm_fanout_test(task)) {
+            return;
+        }
+        break;
+    }
+    ucc_tl_shm_slot_release(task);
+    coll_task->status = UCC_OK;
+}
+
+ucc_status_t ucc_tl_shm_barrier_init(ucc_tl_shm_task_t *task)
+{
+    ucc_coll_args_t *args = &TASK_ARGS(task);
+
+    ucc_tl_shm_task_tree_init(task, args->coll_type == UCC_COLL_TYPE_BARRIER
+                                        ? 0 : args->root);
+    task->super.post     = ucc_tl_shm_coll_start;
+    task->super.progress = ucc_tl_shm_barrier_progress;
+    return UCC_OK;
+}
@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "tl_shm.h"
+#include "tl_shm_coll.h"
+#include "components/mc/ucc_mc.h"
+
+/* Root puts the data into its buffer in the segment and releases the tree,
+   every other rank copies the data out of the root buffer once released
+   by its parent. The tree only spreads the release flags. */
+static void ucc_tl_shm_bcast_progress(ucc_coll_task_t *coll_task)
+{
+    ucc_tl_shm_task_t *task = ucc_derived_of(coll_task, ucc_tl_shm_task_t);
+    ucc_coll_args_t   *args = &TASK_ARGS(task);
+    size_t             size =
+        args->src.info.count * ucc_dt_size(args->src.info.datatype);
+    ucc_status_t       status;
+
+    switch (task->stage) {
+    case UCC_TL_SHM_STAGE_ACQUIRE:
+        if (UCC_OK != ucc_tl_shm_slot_acquire(task)) {
+            return;
+        }
+        if (task->vrank == 0 && size > 0) {
+            status = ucc_mc_memcpy(TASK_DATA(task, 0), args->src.info.buffer,
+                                   size, UCC_MEMORY_TYPE_HOST,
+                                   UCC_MEMORY_TYPE_HOST);
+            if (ucc_unlikely(UCC_OK != status)) {
+                tl_error(UCC_TASK_LIB(task), "failed to copy bcast data");
+                coll_task->status = status;
+                return;
+            }
+        }
+        task->stage = UCC_TL_SHM_STAGE_FANOUT;
+        /* fall through */
+    case UCC_TL_SHM_STAGE_FANOUT:
+        if (UCC_OK != ucc_tl_shm_fanout_test(task)) {
+            return;
+        }
+        if (task->vrank != 0 && size > 0) {
+            status = ucc_mc_memcpy(args->src.info.buffer, TASK_DATA(task, 0),
+                                   size, UCC_MEMORY_TYPE_HOST,
+                                   UCC_MEMORY_TYPE_HOST);
+            if (ucc_unlikely(UCC_OK != status)) {
+                tl_error(UCC_TASK_LIB(task), "failed to copy bcast data");
+                coll_task->status = status;
+                return;
+            }
+        }
+        break;
+    }
+    ucc_tl_shm_slot_release(task);
+    coll_task->status = UCC_OK;
+}
+
+ucc_status_t ucc_tl_shm_bcast_init(ucc_tl_shm_task_t *task)
+{
+    ucc_tl_shm_task_tree_init(task, TASK_ARGS(task).root);
+    task->super.post     = ucc_tl_shm_coll_start;
+    task->super.progress = ucc_tl_shm_bcast_progress;
+    return UCC_OK;
+}
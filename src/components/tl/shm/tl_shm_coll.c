@@ -0,0 +1,149 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "tl_shm.h"
+#include "tl_shm_coll.h"
+#include "core/ucc_progress_queue.h"
+#include "utils/ucc_coll_utils.h"
+
+static inline ucc_tl_shm_task_t *
+ucc_tl_shm_coll_init_task(ucc_base_coll_args_t *coll_args,
+                          ucc_base_team_t      *team)
+{
+    ucc_tl_shm_team_t    *tl_team = ucc_derived_of(team, ucc_tl_shm_team_t);
+    ucc_tl_shm_context_t *ctx     = UCC_TL_SHM_TEAM_CTX(tl_team);
+    ucc_tl_shm_task_t    *task    = ucc_mpool_get(&ctx->req_mp);
+
+    if (ucc_unlikely(!task)) {
+        return NULL;
+    }
+
+    ucc_coll_task_init(&task->super, coll_args, team);
+    UCC_TL_SHM_PROFILE_REQUEST_NEW(task, "tl_shm_task", 0);
+    task->super.finalize       = ucc_tl_shm_coll_finalize;
+    task->super.triggered_post = ucc_triggered_post;
+    task->seq_num              = tl_team->seq_num++;
+    task->coll_id              = task->seq_num % tl_team->max_concurrent;
+    task->n_posts              = 0;
+    task->stamp                = 0;
+    task->etask                = NULL;
+    return task;
+}
+
+static inline void ucc_tl_shm_put_task(ucc_tl_shm_task_t *task)
+{
+    UCC_TL_SHM_PROFILE_REQUEST_FREE(task);
+    ucc_mpool_put(task);
+}
+
+ucc_status_t ucc_tl_shm_coll_finalize(ucc_coll_task_t *coll_task)
+{
+    ucc_tl_shm_task_t *task = ucc_derived_of(coll_task, ucc_tl_shm_task_t);
+
+    tl_trace(UCC_TASK_LIB(task), "finalizing task %p", task);
+    ucc_tl_shm_put_task(task);
+    return UCC_OK;
+}
+
+/* The stamp identifies the post of the collective in the shared flags:
+   the sequence number assigned at init is the same on all the ranks and
+   the number of posts distinguishes the reposts of persistent tasks */
+ucc_status_t ucc_tl_shm_coll_start(ucc_coll_task_t *coll_task)
+{
+    ucc_tl_shm_task_t *task = ucc_derived_of(coll_task, ucc_tl_shm_task_t);
+
+    task->n_posts++;
+    task->stamp       = ((uint64_t)task->seq_num << 32) | task->n_posts;
+    task->stage       = UCC_TL_SHM_STAGE_ACQUIRE;
+    task->etask       = NULL;
+    coll_task->status = UCC_INPROGRESS;
+    return ucc_progress_queue_enqueue(UCC_TASK_CORE_CTX(coll_task)->pq,
+                                      coll_task);
+}
+
+/* Only host buffers and predefined datatypes are supported. The check
+   runs before the task gets a sequence number, so that the ranks never
+   disagree on the numbering. */
+static inline int ucc_tl_shm_args_supported(ucc_coll_args_t *args,
+                                            ucc_rank_t       rank)
+{
+    int is_root = (args->root == rank);
+
+    switch (args->coll_type) {
+    case UCC_COLL_TYPE_BCAST:
+        return args->src.info.mem_type == UCC_MEMORY_TYPE_HOST &&
+               UCC_DT_IS_PREDEFINED(args->src.info.datatype);
+    case UCC_COLL_TYPE_REDUCE:
+        if (is_root) {
+            return args->dst.info.mem_type == UCC_MEMORY_TYPE_HOST &&
+                   UCC_DT_IS_PREDEFINED(args->dst.info.datatype) &&
+                   (UCC_IS_INPLACE(*args) ||
+                    args->src.info.mem_type == UCC_MEMORY_TYPE_HOST);
+        }
+        return args->src.info.mem_type == UCC_MEMORY_TYPE_HOST &&
+               UCC_DT_IS_PREDEFINED(args->src.info.datatype);
+    case UCC_COLL_TYPE_ALLREDUCE:
+        return args->dst.info.mem_type == UCC_MEMORY_TYPE_HOST &&
+               UCC_DT_IS_PREDEFINED(args->dst.info.datatype) &&
+               (UCC_IS_INPLACE(*args) ||
+                args->src.info.mem_type == UCC_MEMORY_TYPE_HOST);
+    default:
+        return 1;
+    }
+}
+
+ucc_status_t ucc_tl_shm_coll_init(ucc_base_coll_args_t *coll_args,
+                                  ucc_base_team_t      *team,
+                                  ucc_coll_task_t     **task_h)
+{
+    ucc_tl_shm_team_t *tl_team = ucc_derived_of(team, ucc_tl_shm_team_t);
+    ucc_coll_args_t   *args    = &coll_args->args;
+    ucc_tl_shm_task_t *task;
+    ucc_status_t       status;
+
+    if (UCC_COLL_ARGS_ACTIVE_SET(args) ||
+        !ucc_tl_shm_args_supported(args, UCC_TL_TEAM_RANK(tl_team))) {
+        return UCC_ERR_NOT_SUPPORTED;
+    }
+    if ((args->coll_type & (UCC_COLL_TYPE_BCAST | UCC_COLL_TYPE_REDUCE |
+                            UCC_COLL_TYPE_ALLREDUCE)) &&
+        ucc_coll_args_msgsize(args, UCC_TL_TEAM_RANK(tl_team),
+                              UCC_TL_TEAM_SIZE(tl_team)) >
+            tl_team->data_size) {
+        tl_debug(team->context->lib, "msg size is larger than data size %zd",
+                 tl_team->data_size);
+        return UCC_ERR_NOT_SUPPORTED;
+    }
+
+    task = ucc_tl_shm_coll_init_task(coll_args, team);
+    if (ucc_unlikely(!task)) {
+        return UCC_ERR_NO_MEMORY;
+    }
+
+    switch (args->coll_type) {
+    case UCC_COLL_TYPE_BARRIER:
+    case UCC_COLL_TYPE_FANIN:
+    case UCC_COLL_TYPE_FANOUT:
+        status = ucc_tl_shm_barrier_init(task);
+        break;
+    case UCC_COLL_TYPE_BCAST:
+        status = ucc_tl_shm_bcast_init(task);
+        break;
+    case UCC_COLL_TYPE_REDUCE:
+    case UCC_COLL_TYPE_ALLREDUCE:
+        status = ucc_tl_shm_reduce_init(task);
+        break;
+    default:
+        status = UCC_ERR_NOT_SUPPORTED;
+    }
+    if (ucc_unlikely(status != UCC_OK)) {
+        ucc_tl_shm_put_task(task);
+        return status;
+    }
+    tl_trace(team->context->lib, "init coll req %p", task);
+    *task_h = &task->super;
+    return status;
+}
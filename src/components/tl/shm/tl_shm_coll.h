@@ -0,0 +1,129 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCC_TL_SHM_COLL_H_
+#define UCC_TL_SHM_COLL_H_
+
+#include "tl_shm.h"
+#include "schedule/ucc_schedule.h"
+#include "utils/ucc_math.h"
+
+#define TASK_TEAM(_task)                                                       \
+    (ucc_derived_of((_task)->super.team, ucc_tl_shm_team_t))
+#define TASK_ARGS(_task) (_task)->super.bargs.args
+#define TASK_CTRL(_task, _vrank)                                               \
+    UCC_TL_SHM_CTRL(TASK_TEAM(_task), (_task)->coll_id, (_vrank))
+#define TASK_DATA(_task, _vrank)                                               \
+    UCC_TL_SHM_DATA(TASK_TEAM(_task), (_task)->coll_id, (_vrank))
+
+enum {
+    UCC_TL_SHM_STAGE_ACQUIRE,
+    UCC_TL_SHM_STAGE_FANIN,
+    UCC_TL_SHM_STAGE_REDUCE,
+    UCC_TL_SHM_STAGE_REDUCE_WAIT,
+    UCC_TL_SHM_STAGE_FANOUT,
+};
+
+/* Ranks of a collective are arranged in a k-ary tree rooted at vrank 0,
+   the ctrl and data buffers of the collective slot are indexed by vrank,
+   so the children of a rank always own contiguous buffers */
+static inline void ucc_tl_shm_task_tree_init(ucc_tl_shm_task_t *task,
+                                             ucc_rank_t         root)
+{
+    ucc_tl_shm_team_t *team  = TASK_TEAM(task);
+    ucc_rank_t         size  = UCC_TL_TEAM_SIZE(team);
+    ucc_rank_t         radix = UCC_TL_SHM_TEAM_LIB(team)->cfg.tree_radix;
+    ucc_rank_t         first;
+
+    task->vrank       = (UCC_TL_TEAM_RANK(team) - root + size) % size;
+    task->parent      = task->vrank == 0 ? UCC_RANK_INVALID
+                                         : (task->vrank - 1) / radix;
+    first             = task->vrank * radix + 1;
+    task->first_child = first;
+    task->n_children  = first >= size ? 0 : ucc_min(radix, size - first);
+}
+
+/* Rank 0 of the team hands the collective slot over to the next owner
+   once all the ranks are done with the previous one. Other ranks wait
+   until the slot is given to their collective. */
+static inline ucc_status_t ucc_tl_shm_slot_acquire(ucc_tl_shm_task_t *task)
+{
+    ucc_tl_shm_team_t *team  = TASK_TEAM(task);
+    volatile uint64_t *state = UCC_TL_SHM_STATE(team, task->coll_id);
+    uint64_t           owner;
+    ucc_rank_t         i;
+
+    if (UCC_TL_TEAM_RANK(team) == 0 && *state != task->stamp) {
+        owner = *state;
+        if (owner != 0) {
+            for (i = 0; i < UCC_TL_TEAM_SIZE(team); i++) {
+                if (TASK_CTRL(task, i)->done != owner) {
+                    return UCC_INPROGRESS;
+                }
+            }
+        }
+        ucc_memory_cpu_load_fence();
+        *state = task->stamp;
+    }
+    if (*state != task->stamp) {
+        return UCC_INPROGRESS;
+    }
+    ucc_memory_cpu_load_fence();
+    return UCC_OK;
+}
+
+static inline void ucc_tl_shm_slot_release(ucc_tl_shm_task_t *task)
+{
+    ucc_memory_cpu_store_fence();
+    TASK_CTRL(task, task->vrank)->done = task->stamp;
+}
+
+/* Waits for the children subtrees, then signals the parent */
+static inline ucc_status_t ucc_tl_shm_fanin_test(ucc_tl_shm_task_t *task)
+{
+    ucc_rank_t i;
+
+    for (i = 0; i < task->n_children; i++) {
+        if (TASK_CTRL(task, task->first_child + i)->arrive != task->stamp) {
+            return UCC_INPROGRESS;
+        }
+    }
+    ucc_memory_cpu_load_fence();
+    return UCC_OK;
+}
+
+static inline void ucc_tl_shm_signal_arrive(ucc_tl_shm_task_t *task)
+{
+    ucc_memory_cpu_store_fence();
+    TASK_CTRL(task, task->vrank)->arrive = task->stamp;
+}
+
+/* Waits for the parent release (root does not wait), then releases
+   the children */
+static inline ucc_status_t ucc_tl_shm_fanout_test(ucc_tl_shm_task_t *task)
+{
+    if (task->vrank != 0) {
+        if (TASK_CTRL(task, task->parent)->release != task->stamp) {
+            return UCC_INPROGRESS;
+        }
+        ucc_memory_cpu_load_fence();
+    }
+    if (task->n_children > 0) {
+        ucc_memory_cpu_store_fence();
+        TASK_CTRL(task, task->vrank)->release = task->stamp;
+    }
+    return UCC_OK;
+}
+
+ucc_status_t ucc_tl_shm_coll_start(ucc_coll_task_t *coll_task);
+
+ucc_status_t ucc_tl_shm_barrier_init(ucc_tl_shm_task_t *task);
+
+ucc_status_t ucc_tl_shm_bcast_init(ucc_tl_shm_task_t *task);
+
+ucc_status_t ucc_tl_shm_reduce_init(ucc_tl_shm_task_t *task);
+
+#endif
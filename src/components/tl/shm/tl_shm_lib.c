@@ -0,0 +1,47 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "tl_shm.h"
+
+/* NOLINTNEXTLINE  params is not used*/
+UCC_CLASS_INIT_FUNC(ucc_tl_shm_lib_t, const ucc_base_lib_params_t *params,
+                    const ucc_base_config_t *config)
+{
+    const ucc_tl_shm_lib_config_t *tl_config =
+        ucc_derived_of(config, ucc_tl_shm_lib_config_t);
+
+    UCC_CLASS_CALL_SUPER_INIT(ucc_tl_lib_t, &ucc_tl_shm.super,
+                              &tl_config->super);
+    memcpy(&self->cfg, tl_config, sizeof(*tl_config));
+    if (self->cfg.max_concurrent == 0) {
+        tl_warn(&self->super, "MAX_CONCURRENT must be positive, using 1");
+        self->cfg.max_concurrent = 1;
+    }
+    if (self->cfg.tree_radix < 2) {
+        tl_warn(&self->super, "TREE_RADIX must be at least 2, using 2");
+        self->cfg.tree_radix = 2;
+    }
+    tl_info(&self->super, "initialized lib object: %p", self);
+    return UCC_OK;
+}
+
+UCC_CLASS_CLEANUP_FUNC(ucc_tl_shm_lib_t)
+{
+    tl_info(&self->super, "finalizing lib object: %p", self);
+}
+
+UCC_CLASS_DEFINE(ucc_tl_shm_lib_t, ucc_tl_lib_t);
+
+ucc_status_t ucc_tl_shm_get_lib_attr(const ucc_base_lib_t *lib, /* NOLINT */
+                                     ucc_base_lib_attr_t  *base_attr)
+{
+    ucc_tl_lib_attr_t *attr      = ucc_derived_of(base_attr, ucc_tl_lib_attr_t);
+
+    attr->super.flags            = 0;
+    attr->super.attr.thread_mode = UCC_THREAD_MULTIPLE;
+    attr->super.attr.coll_types  = UCC_TL_SHM_SUPPORTED_COLLS;
+    return UCC_OK;
+}
@@ -0,0 +1,141 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "tl_shm.h"
+#include "tl_shm_coll.h"
+#include "components/mc/ucc_mc.h"
+#include "utils/ucc_dt_reduce.h"
+
+/* Every rank reduces its own data with the buffers of its children into
+   its buffer in the segment and signals the parent, the root reduces into
+   dst. Allreduce reduces to team rank 0 into its segment buffer and then
+   every rank copies the result out of it once released. */
+static ucc_status_t ucc_tl_shm_reduce_post_step(ucc_tl_shm_task_t *task)
+{
+    ucc_tl_shm_team_t *team    = TASK_TEAM(task);
+    ucc_coll_args_t   *args    = &TASK_ARGS(task);
+    int                is_ar   = args->coll_type == UCC_COLL_TYPE_ALLREDUCE;
+    int                use_dst = is_ar || task->vrank == 0;
+    size_t             count   = use_dst ? args->dst.info.count
+                                         : args->src.info.count;
+    ucc_datatype_t     dt      = use_dst ? args->dst.info.datatype
+                                         : args->src.info.datatype;
+    void              *src     = (UCC_IS_INPLACE(*args) && use_dst)
+                                     ? args->dst.info.buffer
+                                     : args->src.info.buffer;
+    ucc_ee_executor_t *exec;
+    ucc_status_t       status;
+    void              *dst;
+
+    if (task->n_children == 0) {
+        if (count == 0) {
+            return UCC_OK;
+        }
+        return ucc_mc_memcpy(TASK_DATA(task, task->vrank), src,
+                             count * ucc_dt_size(dt), UCC_MEMORY_TYPE_HOST,
+                             UCC_MEMORY_TYPE_HOST);
+    }
+
+    status = ucc_coll_task_get_executor(&task->super, &exec);
+    if (ucc_unlikely(UCC_OK != status)) {
+        return status;
+    }
+    if (task->vrank != 0 || is_ar) {
+        dst = TASK_DATA(task, task->vrank);
+    } else {
+        dst = args->dst.info.buffer;
+    }
+    return ucc_dt_reduce_strided(
+        src, TASK_DATA(task, task->first_child), dst, task->n_children, count,
+        team->data_size, dt, args,
+        (task->vrank == 0 && args->op == UCC_OP_AVG)
+            ? UCC_EEE_TASK_FLAG_REDUCE_WITH_ALPHA
+            : 0,
+        1.0 / (double)UCC_TL_TEAM_SIZE(team), exec, &task->etask);
+}
+
+static void ucc_tl_shm_reduce_progress(ucc_coll_task_t *coll_task)
+{
+    ucc_tl_shm_task_t *task = ucc_derived_of(coll_task, ucc_tl_shm_task_t);
+    ucc_coll_args_t   *args = &TASK_ARGS(task);
+    ucc_status_t       status;
+
+    switch (task->stage) {
+    case UCC_TL_SHM_STAGE_ACQUIRE:
+        if (UCC_OK != ucc_tl_shm_slot_acquire(task)) {
+            return;
+        }
+        task->stage = UCC_TL_SHM_STAGE_FANIN;
+        /* fall through */
+    case UCC_TL_SHM_STAGE_FANIN:
+        if (UCC_OK != ucc_tl_shm_fanin_test(task)) {
+            return;
+        }
+        task->stage = UCC_TL_SHM_STAGE_REDUCE;
+        /* fall through */
+    case UCC_TL_SHM_STAGE_REDUCE:
+        status = ucc_tl_shm_reduce_post_step(task);
+        if (ucc_unlikely(UCC_OK != status)) {
+            tl_error(UCC_TASK_LIB(task), "failed to reduce into segment");
+            coll_task->status = status;
+            return;
+        }
+        task->stage = UCC_TL_SHM_STAGE_REDUCE_WAIT;
+        /* fall through */
+    case UCC_TL_SHM_STAGE_REDUCE_WAIT:
+        if (task->etask) {
+            status = ucc_ee_executor_task_test(task->etask);
+            if (status > 0) {
+                return;
+            }
+            ucc_ee_executor_task_finalize(task->etask);
+            task->etask = NULL;
+            if (ucc_unlikely(status < 0)) {
+                tl_error(UCC_TASK_LIB(task), "failure in shm reduction");
+                coll_task->status = status;
+                return;
+            }
+        }
+        if (task->vrank != 0) {
+            ucc_tl_shm_signal_arrive(task);
+        }
+        if (args->coll_type == UCC_COLL_TYPE_REDUCE) {
+            break;
+        }
+        task->stage = UCC_TL_SHM_STAGE_FANOUT;
+        /* fall through */
+    case UCC_TL_SHM_STAGE_FANOUT:
+        if (UCC_OK != ucc_tl_shm_fanout_test(task)) {
+            return;
+        }
+        if (args->dst.info.count > 0) {
+            status = ucc_mc_memcpy(
+                args->dst.info.buffer, TASK_DATA(task, 0),
+                args->dst.info.count * ucc_dt_size(args->dst.info.datatype),
+                UCC_MEMORY_TYPE_HOST, UCC_MEMORY_TYPE_HOST);
+            if (ucc_unlikely(UCC_OK != status)) {
+                tl_error(UCC_TASK_LIB(task), "failed to copy allreduce data");
+                coll_task->status = status;
+                return;
+            }
+        }
+        break;
+    }
+    ucc_tl_shm_slot_release(task);
+    coll_task->status = UCC_OK;
+}
+
+ucc_status_t ucc_tl_shm_reduce_init(ucc_tl_shm_task_t *task)
+{
+    ucc_coll_args_t *args = &TASK_ARGS(task);
+
+    ucc_tl_shm_task_tree_init(task, args->coll_type == UCC_COLL_TYPE_REDUCE
+                                        ? args->root : 0);
+    task->super.flags   |= UCC_COLL_TASK_FLAG_EXECUTOR;
+    task->super.post     = ucc_tl_shm_coll_start;
+    task->super.progress = ucc_tl_shm_reduce_progress;
+    return UCC_OK;
+}
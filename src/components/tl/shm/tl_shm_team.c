@@ -0,0 +1,208 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "tl_shm.h"
+#include "tl_shm_coll.h"
+#include "core/ucc_team.h"
+#include "coll_score/ucc_coll_score.h"
+#include "utils/ucc_malloc.h"
+#include "utils/ucc_math.h"
+#include "utils/ucc_sys.h"
+#include <sys/shm.h>
+#include <errno.h>
+#include <string.h>
+
+UCC_CLASS_INIT_FUNC(ucc_tl_shm_team_t, ucc_base_context_t *tl_context,
+                    const ucc_base_team_params_t *params)
+{
+    ucc_tl_shm_context_t *ctx =
+        ucc_derived_of(tl_context, ucc_tl_shm_context_t);
+    ucc_tl_shm_lib_t     *lib =
+        ucc_derived_of(tl_context->lib, ucc_tl_shm_lib_t);
+    ucc_rank_t            size;
+    size_t                seg_size;
+    ucc_status_t          status;
+
+    UCC_CLASS_CALL_SUPER_INIT(ucc_tl_team_t, &ctx->super, params);
+
+    self->oob     = params->params.oob;
+    self->oob_req = NULL;
+    self->shm_ids = NULL;
+    self->seg     = NULL;
+    size          = UCC_TL_TEAM_SIZE(self);
+    if (size < 2) {
+        tl_trace(tl_context->lib, "team size is too small, min supported 2");
+        return UCC_ERR_NOT_SUPPORTED;
+    }
+
+    if (!ucc_team_map_is_single_node(params->team, params->map)) {
+        tl_trace(tl_context->lib, "multinode team is not supported");
+        return UCC_ERR_NOT_SUPPORTED;
+    }
+
+    self->max_concurrent = lib->cfg.max_concurrent;
+    self->data_size      = ucc_align_up(lib->cfg.data_size,
+                                        UCC_CACHE_LINE_SIZE);
+    self->ctrl_offset    = self->max_concurrent * UCC_CACHE_LINE_SIZE;
+    self->data_offset    = ucc_align_up(self->ctrl_offset +
+                                        (size_t)self->max_concurrent * size *
+                                        UCC_CACHE_LINE_SIZE,
+                                        ucc_get_page_size());
+    self->seq_num        = 1;
+
+    /* one extra element holds the id contributed by this rank */
+    self->shm_ids = ucc_malloc((size + 1) * sizeof(int), "shm_ids");
+    if (!self->shm_ids) {
+        tl_error(tl_context->lib, "failed to alloc shm ids");
+        return UCC_ERR_NO_MEMORY;
+    }
+    self->shm_ids[size] = -1;
+    if (UCC_TL_TEAM_RANK(self) == 0) {
+        seg_size = self->data_offset +
+                   (size_t)self->max_concurrent * size * self->data_size;
+        status   = ucc_sysv_alloc(&seg_size, &self->seg, &self->shm_ids[size]);
+        if (status != UCC_OK) {
+            tl_error(tl_context->lib, "failed to alloc sysv segment of %zd "
+                     "bytes", seg_size);
+            /* proceed and notify other ranks about error */
+            self->seg           = NULL;
+            self->shm_ids[size] = -1;
+        }
+    }
+
+    status = self->oob.allgather(&self->shm_ids[size], self->shm_ids,
+                                 sizeof(int), self->oob.coll_info,
+                                 &self->oob_req);
+    if (UCC_OK != status) {
+        tl_error(tl_context->lib, "failed to start oob allgather");
+        goto err;
+    }
+    tl_info(tl_context->lib, "posted tl team: %p", self);
+    return UCC_OK;
+
+err:
+    if (self->seg) {
+        ucc_sysv_free(self->seg);
+    }
+    ucc_free(self->shm_ids);
+    return status;
+}
+
+UCC_CLASS_CLEANUP_FUNC(ucc_tl_shm_team_t)
+{
+    tl_info(self->super.super.context->lib, "finalizing tl team: %p", self);
+    if (self->oob_req) {
+        self->oob.req_free(self->oob_req);
+    }
+    if (self->seg) {
+        ucc_sysv_free(self->seg);
+    }
+    ucc_free(self->shm_ids);
+}
+
+UCC_CLASS_DEFINE_DELETE_FUNC(ucc_tl_shm_team_t, ucc_base_team_t);
+
+UCC_CLASS_DEFINE(ucc_tl_shm_team_t, ucc_tl_team_t);
+
+ucc_status_t ucc_tl_shm_team_destroy(ucc_base_team_t *tl_team)
+{
+    UCC_CLASS_DELETE_FUNC_NAME(ucc_tl_shm_team_t)(tl_team);
+    return UCC_OK;
+}
+
+ucc_status_t ucc_tl_shm_team_create_test(ucc_base_team_t *tl_team)
+{
+    ucc_tl_shm_team_t *team = ucc_derived_of(tl_team, ucc_tl_shm_team_t);
+    ucc_status_t       status;
+    int                shm_id;
+
+    if (team->oob_req == NULL) {
+        return UCC_OK;
+    }
+    status = team->oob.req_test(team->oob_req);
+    if (status == UCC_INPROGRESS) {
+        return UCC_INPROGRESS;
+    } else if (status < 0) {
+        tl_error(tl_team->context->lib, "oob allgather failed");
+        return status;
+    }
+    team->oob.req_free(team->oob_req);
+    team->oob_req = NULL;
+
+    shm_id = team->shm_ids[0];
+    if (shm_id < 0) {
+        tl_error(tl_team->context->lib, "failed to create shmem region");
+        return UCC_ERR_NO_MEMORY;
+    }
+    if (UCC_TL_TEAM_RANK(team) != 0) {
+        team->seg = shmat(shm_id, NULL, 0);
+        if (team->seg == (void *)-1) {
+            tl_error(tl_team->context->lib, "failed to shmat errno: %d (%s)",
+                     errno, strerror(errno));
+            team->seg = NULL;
+            return UCC_ERR_NO_MEMORY;
+        }
+    }
+    tl_info(tl_team->context->lib, "initialized tl team: %p, seg %p, "
+            "shm_id %d", team, team->seg, shm_id);
+    return UCC_OK;
+}
+
+ucc_status_t ucc_tl_shm_team_get_scores(ucc_base_team_t   *tl_team,
+                                        ucc_coll_score_t **score_p)
+{
+    ucc_tl_shm_team_t  *team = ucc_derived_of(tl_team, ucc_tl_shm_team_t);
+    ucc_base_context_t *ctx  = UCC_TL_TEAM_CTX(team);
+    ucc_base_lib_t     *lib  = UCC_TL_TEAM_LIB(team);
+    ucc_coll_score_t   *score;
+    ucc_coll_type_t     ct;
+    ucc_status_t        status;
+    size_t              max_size;
+    int                 i;
+
+    status = ucc_coll_score_alloc(&score);
+    if (UCC_OK != status) {
+        tl_error(lib, "failed to alloc score_t");
+        return status;
+    }
+
+    for (i = 0; i < UCC_COLL_TYPE_NUM; i++) {
+        ct = (ucc_coll_type_t)UCC_BIT(i);
+        if (!(ct & UCC_TL_SHM_SUPPORTED_COLLS)) {
+            continue;
+        }
+        /* data colls are limited by the per rank data buffer */
+        max_size = (ct & (UCC_COLL_TYPE_BARRIER | UCC_COLL_TYPE_FANIN |
+                          UCC_COLL_TYPE_FANOUT))
+                       ? UCC_MSG_MAX
+                       : team->data_size;
+        status   = ucc_coll_score_add_range(score, ct, UCC_MEMORY_TYPE_HOST,
+                                            0, max_size,
+                                            UCC_TL_SHM_DEFAULT_SCORE,
+                                            ucc_tl_shm_coll_init, tl_team);
+        if (UCC_OK != status) {
+            tl_error(lib, "failed to add range to score_t");
+            goto err;
+        }
+    }
+
+    if (strlen(ctx->score_str) > 0) {
+        status = ucc_coll_score_update_from_str(
+            ctx->score_str, score, UCC_TL_TEAM_SIZE(team),
+            ucc_tl_shm_coll_init, &team->super.super,
+            UCC_TL_SHM_DEFAULT_SCORE, NULL);
+        if ((status < 0) && (status != UCC_ERR_INVALID_PARAM) &&
+            (status != UCC_ERR_NOT_SUPPORTED)) {
+            goto err;
+        }
+    }
+
+    *score_p = score;
+    return UCC_OK;
+err:
+    ucc_coll_score_free(score);
+    return status;
+}
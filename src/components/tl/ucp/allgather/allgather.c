@@ -13,11 +13,19 @@ ucc_base_coll_alg_info_t
             {.id   = UCC_TL_UCP_ALLGATHER_ALG_RING,
              .name = "ring",
              .desc = "O(N) Ring"},
+        [UCC_TL_UCP_ALLGATHER_ALG_ONESIDED] =
+            {.id   = UCC_TL_UCP_ALLGATHER_ALG_ONESIDED,
+             .name = "onesided",
+             .desc = "O(N) one-sided puts with completion counter"},
         [UCC_TL_UCP_ALLGATHER_ALG_LAST] = {
             .id = 0, .name = NULL, .desc = NULL}};
 
 ucc_status_t ucc_tl_ucp_allgather_init(ucc_tl_ucp_task_t *task)
 {
+    ucc_tl_ucp_team_t *team = TASK_TEAM(task);
+    ucc_tl_ucp_ring_t *ring;
+    ucc_status_t       status;
+
     if ((!UCC_DT_IS_PREDEFINED((TASK_ARGS(task)).dst.info.datatype)) ||
         (!UCC_IS_INPLACE(TASK_ARGS(task)) &&
          (!UCC_DT_IS_PREDEFINED((TASK_ARGS(task)).src.info.datatype)))) {
@@ -25,7 +33,41 @@ ucc_status_t ucc_tl_ucp_allgather_init(ucc_tl_ucp_task_t *task)
         return UCC_ERR_NOT_SUPPORTED;
     }
 
+    if (UCC_COLL_ARGS_ACTIVE_SET(&TASK_ARGS(task))) {
+        /* ring follows the order of the active set, which is also the order
+           of the data blocks */
+        task->allgather_ring.block_map.type   = UCC_EP_MAP_FULL;
+        task->allgather_ring.block_map.ep_num = task->subset.map.ep_num;
+    } else {
+        status = ucc_tl_ucp_team_get_ring(team, 0, &ring);
+        if (ucc_unlikely(UCC_OK != status)) {
+            return status;
+        }
+        /* subset walks the ring positions, data blocks stay in team rank
+           order */
+        task->subset.map     = ring->inv_map;
+        task->subset.myrank  = ucc_ep_map_eval(ring->map,
+                                               UCC_TL_TEAM_RANK(team));
+        task->allgather_ring.block_map = ring->inv_map;
+    }
     task->super.post     = ucc_tl_ucp_allgather_ring_start;
     task->super.progress = ucc_tl_ucp_allgather_ring_progress;
     return UCC_OK;
 }
+
+ucc_status_t ucc_tl_ucp_allgather_ring_init(ucc_base_coll_args_t *coll_args,
+                                            ucc_base_team_t      *team,
+                                            ucc_coll_task_t     **task_h)
+{
+    ucc_tl_ucp_task_t *task;
+    ucc_status_t       status;
+
+    task   = ucc_tl_ucp_init_task(coll_args, team);
+    status = ucc_tl_ucp_allgather_init(task);
+    if (ucc_unlikely(UCC_OK != status)) {
+        ucc_tl_ucp_put_task(task);
+        return status;
+    }
+    *task_h = &task->super;
+    return UCC_OK;
+}
@@ -33,8 +33,8 @@ void ucc_tl_ucp_allgather_knomial_progress(ucc_coll_task_t *coll_task)
     ucc_datatype_t         dt         = args->dst.info.datatype;
     size_t                 dt_size    = ucc_dt_size(dt);
     size_t                 data_size  = count * dt_size;
-    ucc_rank_t             rank       = UCC_TL_TEAM_RANK(team);
-    ucc_rank_t             size       = UCC_TL_TEAM_SIZE(team);
+    ucc_rank_t             rank       = task->subset.myrank;
+    ucc_rank_t             size       = (ucc_rank_t)task->subset.map.ep_num;
     ucc_rank_t             broot      = 0;
     void                  *sbuf;
     ptrdiff_t              peer_seg_offset, local_seg_offset;
@@ -59,9 +59,9 @@ void ucc_tl_ucp_allgather_knomial_progress(ucc_coll_task_t *coll_task)
     UCC_KN_GOTO_PHASE(task->allgather_kn.phase);
     if (KN_NODE_EXTRA == node_type) {
         peer = ucc_knomial_pattern_get_proxy(p, rank);
+        peer = ucc_ep_map_eval(task->subset.map, INV_VRANK(peer, broot, size));
         UCPCHECK_GOTO(
-            ucc_tl_ucp_recv_nb(rbuf, data_size, mem_type,
-                               INV_VRANK(peer, broot, size), team, task),
+            ucc_tl_ucp_recv_nb(rbuf, data_size, mem_type, peer, team, task),
             task, out);
     }
 UCC_KN_PHASE_EXTRA:
@@ -87,10 +87,10 @@ UCC_KN_PHASE_EXTRA:
             peer = ucc_knomial_pattern_get_loop_peer(p, rank, size, loop_step);
             if (peer == UCC_KN_PEER_NULL)
                 continue;
-
+            peer = ucc_ep_map_eval(task->subset.map,
+                                   INV_VRANK(peer, broot, size));
             UCPCHECK_GOTO(ucc_tl_ucp_send_nb(sbuf, local_seg_count * dt_size,
-                                             mem_type,
-                                             INV_VRANK(peer, broot, size), team, task),
+                                             mem_type, peer, team, task),
                           task, out);
         }
         task->allgather_kn.sbuf = rbuf;
@@ -105,10 +105,11 @@ UCC_KN_PHASE_EXTRA:
                 block_count, step_radix, peer_seg_index);
             peer_seg_offset = ucc_sra_kn_compute_seg_offset(
                 block_count, step_radix, peer_seg_index);
+            peer = ucc_ep_map_eval(task->subset.map,
+                                   INV_VRANK(peer, broot, size));
             UCPCHECK_GOTO(
                 ucc_tl_ucp_recv_nb(PTR_OFFSET(rbuf, peer_seg_offset * dt_size),
-                                   peer_seg_count * dt_size, mem_type,
-                                   INV_VRANK(peer, broot, size),
+                                   peer_seg_count * dt_size, mem_type, peer,
                                    team, task),
                 task, out);
         }
@@ -122,9 +123,9 @@ UCC_KN_PHASE_EXTRA:
 
     if (KN_NODE_PROXY == node_type) {
         peer = ucc_knomial_pattern_get_extra(p, rank);
+        peer = ucc_ep_map_eval(task->subset.map, INV_VRANK(peer, broot, size));
         UCPCHECK_GOTO(ucc_tl_ucp_send_nb(args->dst.info.buffer, data_size,
-                                         mem_type,
-                                         INV_VRANK(peer, broot, size), team, task),
+                                         mem_type, peer, team, task),
                       task, out);
     } else {
         goto out;
@@ -145,8 +146,8 @@ ucc_status_t ucc_tl_ucp_allgather_knomial_start(ucc_coll_task_t *coll_task)
     ucc_tl_ucp_task_t *task  = ucc_derived_of(coll_task, ucc_tl_ucp_task_t);
     ucc_coll_args_t   *args  = &TASK_ARGS(task);
     ucc_tl_ucp_team_t *team  = TASK_TEAM(task);
-    ucc_rank_t         rank  = UCC_TL_TEAM_RANK(team);
-    ucc_rank_t         size  = UCC_TL_TEAM_SIZE(team);
+    ucc_rank_t         rank  = task->subset.myrank;
+    ucc_rank_t         size  = (ucc_rank_t)task->subset.map.ep_num;
     ucc_kn_radix_t     radix = task->allgather_kn.p.radix;
     ucc_rank_t         broot = 0;
     ucc_status_t       status;
@@ -165,7 +166,7 @@ ucc_status_t ucc_tl_ucp_allgather_knomial_start(ucc_coll_task_t *coll_task)
     task->allgather_kn.phase = UCC_KN_PHASE_INIT;
     ucc_assert(args->src.info.mem_type == args->dst.info.mem_type);
 
-    ucc_knomial_pattern_init_backward(size, rank, radix, &task->allgather_kn.p);
+    ucc_knomial_pattern_reset(&task->allgather_kn.p);
     offset = ucc_sra_kn_get_offset(args->dst.info.count,
                                    ucc_dt_size(args->dst.info.datatype), rank,
                                    size, radix);
@@ -195,21 +196,21 @@ ucc_status_t ucc_tl_ucp_allgather_knomial_init_r(
     ucc_base_coll_args_t *coll_args, ucc_base_team_t *team,
     ucc_coll_task_t **task_h, ucc_kn_radix_t radix)
 {
-    ucc_tl_ucp_team_t *tl_team = ucc_derived_of(team, ucc_tl_ucp_team_t);
-    ucc_rank_t         rank    = UCC_TL_TEAM_RANK(tl_team);
-    ucc_rank_t         size    = UCC_TL_TEAM_SIZE(tl_team);
-    ucc_rank_t         broot   = 0;
     ucc_tl_ucp_task_t *task;
+    ucc_rank_t         rank, size;
 
+    task = ucc_tl_ucp_init_task(coll_args, team);
+    rank = task->subset.myrank;
+    size = (ucc_rank_t)task->subset.map.ep_num;
     if (coll_args->args.coll_type == UCC_COLL_TYPE_BCAST) {
-        broot = coll_args->args.root;
-        rank = VRANK(rank, broot, size);
+        /* root of the task args is already local to the active set */
+        rank = VRANK(rank, TASK_ARGS(task).root, size);
     }
-    task = ucc_tl_ucp_init_task(coll_args, team);
     task->super.flags    |= UCC_COLL_TASK_FLAG_EXECUTOR;
     task->super.post     = ucc_tl_ucp_allgather_knomial_start;
     task->super.progress = ucc_tl_ucp_allgather_knomial_progress;
-    ucc_knomial_pattern_init_backward(size, rank, radix, &task->allgather_kn.p);
+    ucc_knomial_pattern_init_backward(size, rank, ucc_min(radix, size),
+                                      &task->allgather_kn.p);
 
     *task_h              = &task->super;
     return UCC_OK;
@@ -220,7 +221,8 @@ ucc_status_t ucc_tl_ucp_allgather_knomial_init(ucc_base_coll_args_t *coll_args,
                                                ucc_coll_task_t     **task_h)
 {
     ucc_tl_ucp_team_t *tl_team = ucc_derived_of(team, ucc_tl_ucp_team_t);
-    ucc_rank_t         size    = UCC_TL_TEAM_SIZE(tl_team);
+    ucc_rank_t         size    = UCC_TL_UCP_COLL_SIZE(tl_team,
+                                                      &coll_args->args);
     ucc_kn_radix_t     radix;
 
     radix = ucc_min(UCC_TL_UCP_TEAM_LIB(tl_team)->cfg.allgather_kn_radix, size);
@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "config.h"
+#include "tl_ucp.h"
+#include "allgather.h"
+#include "core/ucc_progress_queue.h"
+#include "utils/ucc_math.h"
+#include "utils/ucc_coll_utils.h"
+#include "tl_ucp_sendrecv.h"
+
+ucc_status_t ucc_tl_ucp_allgather_onesided_start(ucc_coll_task_t *ctask)
+{
+    ucc_tl_ucp_task_t *task = ucc_derived_of(ctask, ucc_tl_ucp_task_t);
+    ucc_tl_ucp_team_t *team = TASK_TEAM(task);
+
+    ucc_tl_ucp_task_reset(task, UCC_INPROGRESS);
+    return ucc_progress_queue_enqueue(UCC_TL_CORE_CTX(team)->pq, &task->super);
+}
+
+void ucc_tl_ucp_allgather_onesided_progress(ucc_coll_task_t *ctask)
+{
+    ucc_tl_ucp_task_t *task      = ucc_derived_of(ctask, ucc_tl_ucp_task_t);
+    ucc_tl_ucp_team_t *team      = TASK_TEAM(task);
+    ucc_coll_args_t   *args      = &TASK_ARGS(task);
+    ucc_rank_t         grank     = UCC_TL_TEAM_RANK(team);
+    ucc_rank_t         gsize     = UCC_TL_TEAM_SIZE(team);
+    long *             pSync     = args->global_work_buffer;
+    size_t             data_size = (args->dst.info.count / gsize) *
+                                   ucc_dt_size(args->dst.info.datatype);
+    void              *dest      = PTR_OFFSET(args->dst.info.buffer,
+                                              grank * data_size);
+    void              *src       = UCC_IS_INPLACE(*args) ? dest :
+                                   args->src.info.buffer;
+    ucc_rank_t         peer;
+
+    /* Every rank puts its block into the dst buffers of all the peers
+       starting from its right neighbor. Arrival of the blocks is tracked
+       by the sync counter in the global work buffer. */
+    while (task->onesided.put_posted < gsize) {
+        peer = (grank + 1 + task->onesided.put_posted) % gsize;
+        if (peer == grank && UCC_IS_INPLACE(*args)) {
+            /* own block is already in place, only signal */
+            task->onesided.put_posted++;
+            task->onesided.put_completed++;
+            UCPCHECK_GOTO(ucc_tl_ucp_atomic_inc(pSync, peer, team), task, out);
+            continue;
+        }
+        UCPCHECK_GOTO(ucc_tl_ucp_put_signal_nb(src, dest, data_size, pSync,
+                                               peer, team, task),
+                      task, out);
+    }
+
+    if ((*pSync < gsize) ||
+        (task->onesided.put_completed < task->onesided.put_posted)) {
+        ucp_worker_progress(UCC_TL_UCP_ONESIDED_WORKER(team));
+        return;
+    }
+
+    pSync[0]           = 0;
+    task->super.status = UCC_OK;
+out:
+    return;
+}
+
+ucc_status_t ucc_tl_ucp_allgather_onesided_init(ucc_base_coll_args_t *coll_args,
+                                                ucc_base_team_t      *team,
+                                                ucc_coll_task_t     **task_h)
+{
+    ucc_tl_ucp_team_t *tl_team = ucc_derived_of(team, ucc_tl_ucp_team_t);
+    ucc_coll_args_t   *args    = &coll_args->args;
+    ucc_tl_ucp_task_t *task;
+    ucc_status_t       status;
+
+    if ((!UCC_DT_IS_PREDEFINED(args->dst.info.datatype)) ||
+        (!UCC_IS_INPLACE(*args) &&
+         (!UCC_DT_IS_PREDEFINED(args->src.info.datatype)))) {
+        tl_error(UCC_TL_TEAM_LIB(tl_team),
+                 "user defined datatype is not supported");
+        return UCC_ERR_NOT_SUPPORTED;
+    }
+    status = ucc_tl_ucp_onesided_check_args(coll_args, tl_team);
+    if (ucc_unlikely(UCC_OK != status)) {
+        return status;
+    }
+    task                 = ucc_tl_ucp_init_task(coll_args, team);
+    task->super.post     = ucc_tl_ucp_allgather_onesided_start;
+    task->super.progress = ucc_tl_ucp_allgather_onesided_progress;
+    *task_h              = &task->super;
+    return UCC_OK;
+}
@@ -26,6 +26,8 @@ void ucc_tl_ucp_allgather_ring_progress(ucc_coll_task_t *coll_task)
     size_t             data_size  = (count / group_size) * ucc_dt_size(dt);
     ucc_rank_t         sendto     = (group_rank + 1) % group_size;
     ucc_rank_t         recvfrom   = (group_rank - 1 + group_size) % group_size;
+    ucc_ep_map_t       block_map  = task->allgather_ring.block_map;
+    ucc_rank_t         block;
     int                step;
     void              *buf;
 
@@ -37,15 +39,16 @@ void ucc_tl_ucp_allgather_ring_progress(ucc_coll_task_t *coll_task)
 
     while (task->tagged.send_posted < group_size - 1) {
         step = task->tagged.send_posted;
-        buf  = (void *)((ptrdiff_t)rbuf +
-                       ((group_rank - step + group_size) % group_size) *
-                           data_size);
+        /* ring position -> index of the data block in rbuf */
+        block = ucc_ep_map_eval(block_map,
+                                (group_rank - step + group_size) % group_size);
+        buf   = PTR_OFFSET(rbuf, block * data_size);
         UCPCHECK_GOTO(
             ucc_tl_ucp_send_nb(buf, data_size, rmem, sendto, team, task),
             task, out);
-        buf = (void *)((ptrdiff_t)rbuf +
-                       ((group_rank - step - 1 + group_size) % group_size) *
-                           data_size);
+        block = ucc_ep_map_eval(block_map, (group_rank - step - 1 + group_size) %
+                                               group_size);
+        buf   = PTR_OFFSET(rbuf, block * data_size);
         UCPCHECK_GOTO(
             ucc_tl_ucp_recv_nb(buf, data_size, rmem, recvfrom, team, task),
             task, out);
@@ -78,7 +81,9 @@ ucc_status_t ucc_tl_ucp_allgather_ring_start(ucc_coll_task_t *coll_task)
 
     if (!UCC_IS_INPLACE(TASK_ARGS(task))) {
         status =
-            ucc_mc_memcpy(PTR_OFFSET(rbuf, data_size * task->subset.myrank),
+            ucc_mc_memcpy(PTR_OFFSET(rbuf, data_size * ucc_ep_map_eval(
+                                         task->allgather_ring.block_map,
+                                         task->subset.myrank)),
                           sbuf, data_size, rmem, smem);
         if (ucc_unlikely(UCC_OK != status)) {
             return status;
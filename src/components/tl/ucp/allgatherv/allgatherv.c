@@ -24,12 +24,30 @@ ucc_base_coll_alg_info_t
 
 ucc_status_t ucc_tl_ucp_allgatherv_init(ucc_tl_ucp_task_t *task)
 {
+    ucc_tl_ucp_team_t *team = TASK_TEAM(task);
+    ucc_tl_ucp_ring_t *ring;
+    ucc_status_t       status;
+
     if ((!UCC_DT_IS_PREDEFINED((TASK_ARGS(task)).dst.info_v.datatype)) ||
         (!UCC_IS_INPLACE(TASK_ARGS(task)) &&
          (!UCC_DT_IS_PREDEFINED((TASK_ARGS(task)).src.info.datatype)))) {
         tl_error(UCC_TASK_LIB(task), "user defined datatype is not supported");
         return UCC_ERR_NOT_SUPPORTED;
     }
+    if (UCC_COLL_ARGS_ACTIVE_SET(&TASK_ARGS(task))) {
+        /* ring follows the order of the active set */
+        task->allgatherv_ring.inv_map.type   = UCC_EP_MAP_FULL;
+        task->allgatherv_ring.inv_map.ep_num = task->subset.map.ep_num;
+        task->allgatherv_ring.pos            = task->subset.myrank;
+    } else {
+        status = ucc_tl_ucp_team_get_ring(team, 0, &ring);
+        if (ucc_unlikely(UCC_OK != status)) {
+            return status;
+        }
+        task->allgatherv_ring.inv_map = ring->inv_map;
+        task->allgatherv_ring.pos     =
+            ucc_ep_map_eval(ring->map, UCC_TL_TEAM_RANK(team));
+    }
     task->super.post     = ucc_tl_ucp_allgatherv_ring_start;
     task->super.progress = ucc_tl_ucp_allgatherv_ring_progress;
     return UCC_OK;
@@ -17,21 +17,26 @@ void ucc_tl_ucp_allgatherv_ring_progress(ucc_coll_task_t *coll_task)
     ucc_tl_ucp_task_t *task     = ucc_derived_of(coll_task, ucc_tl_ucp_task_t);
     ucc_coll_args_t   *args     = &TASK_ARGS(task);
     ucc_tl_ucp_team_t *team     = TASK_TEAM(task);
-    ucc_rank_t         grank    = UCC_TL_TEAM_RANK(team);
-    ucc_rank_t         gsize    = UCC_TL_TEAM_SIZE(team);
+    ucc_rank_t         gsize    = (ucc_rank_t)task->subset.map.ep_num;
+    ucc_ep_map_t       inv_map  = task->allgatherv_ring.inv_map;
+    ucc_rank_t         pos      = task->allgatherv_ring.pos;
     ptrdiff_t          rbuf     = (ptrdiff_t)args->dst.info_v.buffer;
     ucc_memory_type_t  rmem     = args->dst.info_v.mem_type;
     size_t             rdt_size = ucc_dt_size(args->dst.info_v.datatype);
-    ucc_rank_t         sendto   = (grank + 1) % gsize;
-    ucc_rank_t         recvfrom = (grank - 1 + gsize) % gsize;
+    ucc_rank_t         sendto   = ucc_ep_map_eval(inv_map, (pos + 1) % gsize);
+    ucc_rank_t         recvfrom =
+        ucc_ep_map_eval(inv_map, (pos - 1 + gsize) % gsize);
     ucc_rank_t         send_idx, recv_idx;
     size_t             data_size, data_displ;
 
     if (UCC_INPROGRESS == ucc_tl_ucp_test(task)) {
         return;
     }
+    sendto   = ucc_ep_map_eval(task->subset.map, sendto);
+    recvfrom = ucc_ep_map_eval(task->subset.map, recvfrom);
     while (task->tagged.send_posted < gsize) {
-        send_idx   = (grank - task->tagged.send_posted + 1 + gsize) % gsize;
+        send_idx   = ucc_ep_map_eval(
+            inv_map, (pos - task->tagged.send_posted + 1 + gsize) % gsize);
         data_displ = ucc_coll_args_get_displacement(
                          args, args->dst.info_v.displacements, send_idx) *
                      rdt_size;
@@ -41,7 +46,8 @@ void ucc_tl_ucp_allgatherv_ring_progress(ucc_coll_task_t *coll_task)
         UCPCHECK_GOTO(ucc_tl_ucp_send_nb((void *)(rbuf + data_displ), data_size,
                                          rmem, sendto, team, task),
                       task, out);
-        recv_idx   = (grank - task->tagged.recv_posted + gsize) % gsize;
+        recv_idx   = ucc_ep_map_eval(
+            inv_map, (pos - task->tagged.recv_posted + gsize) % gsize);
         data_displ = ucc_coll_args_get_displacement(
                          args, args->dst.info_v.displacements, recv_idx) *
                      rdt_size;
@@ -69,7 +75,8 @@ ucc_status_t ucc_tl_ucp_allgatherv_ring_start(ucc_coll_task_t *coll_task)
     ptrdiff_t          rbuf  = (ptrdiff_t)TASK_ARGS(task).dst.info_v.buffer;
     ucc_memory_type_t  smem  = TASK_ARGS(task).src.info.mem_type;
     ucc_memory_type_t  rmem  = TASK_ARGS(task).dst.info_v.mem_type;
-    ucc_rank_t         grank = UCC_TL_TEAM_RANK(team);
+    ucc_rank_t         grank = task->subset.myrank;
+    ucc_rank_t         ep    = ucc_ep_map_eval(task->subset.map, grank);
     size_t             data_size, data_displ, rdt_size;
 
     ucc_tl_ucp_task_reset(task, UCC_INPROGRESS);
@@ -86,9 +93,9 @@ ucc_status_t ucc_tl_ucp_allgatherv_ring_start(ucc_coll_task_t *coll_task)
                                     TASK_ARGS(task).dst.info_v.counts, grank) *
             rdt_size;
         UCPCHECK_GOTO(ucc_tl_ucp_recv_nb((void *)rbuf + data_displ, data_size,
-                                         rmem, grank, team, task),
+                                         rmem, ep, team, task),
                       task, error);
-        UCPCHECK_GOTO(ucc_tl_ucp_send_nb((void *)sbuf, data_size, smem, grank,
+        UCPCHECK_GOTO(ucc_tl_ucp_send_nb((void *)sbuf, data_size, smem, ep,
                                          team, task),
                       task, error);
     } else {
@@ -52,10 +52,12 @@ void ucc_tl_ucp_allreduce_knomial_progress(ucc_coll_task_t *coll_task)
         peer = ucc_ep_map_eval(task->subset.map,
                                ucc_knomial_pattern_get_proxy(p, rank));
         UCPCHECK_GOTO(
-            ucc_tl_ucp_send_nb(sbuf, data_size, mem_type, peer, team, task),
+            ucc_tl_ucp_send_eager_nb(sbuf, data_size, mem_type, peer, team,
+                                     task),
             task, out);
         UCPCHECK_GOTO(
-            ucc_tl_ucp_recv_nb(rbuf, data_size, mem_type, peer, team, task),
+            ucc_tl_ucp_recv_eager_nb(rbuf, data_size, mem_type, peer, team,
+                                     task),
             task, out);
     }
 
@@ -63,7 +65,8 @@ void ucc_tl_ucp_allreduce_knomial_progress(ucc_coll_task_t *coll_task)
         peer = ucc_ep_map_eval(task->subset.map,
                                ucc_knomial_pattern_get_extra(p, rank));
         UCPCHECK_GOTO(
-            ucc_tl_ucp_recv_nb(scratch, data_size, mem_type, peer, team, task),
+            ucc_tl_ucp_recv_eager_nb(scratch, data_size, mem_type, peer, team,
+                                     task),
             task, out);
     }
 UCC_KN_PHASE_EXTRA:
@@ -102,8 +105,8 @@ UCC_KN_PHASE_EXTRA_REDUCE:
                 send_buf = rbuf;
             }
             UCPCHECK_GOTO(
-                ucc_tl_ucp_send_nb(send_buf, data_size, mem_type, peer, team,
-                                   task),
+                ucc_tl_ucp_send_eager_nb(send_buf, data_size, mem_type, peer,
+                                         team, task),
                 task, out);
         }
 
@@ -114,8 +117,9 @@ UCC_KN_PHASE_EXTRA_REDUCE:
                 continue;
             peer = ucc_ep_map_eval(task->subset.map, peer);
             UCPCHECK_GOTO(
-                ucc_tl_ucp_recv_nb((void *)((ptrdiff_t)scratch + recv_offset),
-                                   data_size, mem_type, peer, team, task),
+                ucc_tl_ucp_recv_eager_nb(
+                    (void *)((ptrdiff_t)scratch + recv_offset), data_size,
+                    mem_type, peer, team, task),
                 task, out);
             recv_offset += data_size;
         }
@@ -159,7 +163,8 @@ UCC_KN_PHASE_REDUCE:
         peer = ucc_ep_map_eval(task->subset.map,
                                ucc_knomial_pattern_get_extra(p, rank));
         UCPCHECK_GOTO(
-            ucc_tl_ucp_send_nb(rbuf, data_size, mem_type, peer, team, task),
+            ucc_tl_ucp_send_eager_nb(rbuf, data_size, mem_type, peer, team,
+                                     task),
             task, out);
         goto UCC_KN_PHASE_PROXY;
     } else {
@@ -185,8 +190,6 @@ ucc_status_t ucc_tl_ucp_allreduce_knomial_start(ucc_coll_task_t *coll_task)
 {
     ucc_tl_ucp_task_t *task      = ucc_derived_of(coll_task, ucc_tl_ucp_task_t);
     ucc_tl_ucp_team_t *team      = TASK_TEAM(task);
-    ucc_rank_t         size      = (ucc_rank_t)task->subset.map.ep_num;
-    ucc_rank_t         rank      = task->subset.myrank;
     ucc_status_t       status;
 
     UCC_TL_UCP_PROFILE_REQUEST_EVENT(coll_task, "ucp_allreduce_kn_start", 0);
@@ -194,10 +197,7 @@ ucc_status_t ucc_tl_ucp_allreduce_knomial_start(ucc_coll_task_t *coll_task)
     ucc_assert(UCC_IS_INPLACE(TASK_ARGS(task)) ||
                (TASK_ARGS(task).src.info.mem_type ==
                TASK_ARGS(task).dst.info.mem_type));
-    ucc_knomial_pattern_init(size, rank,
-                             ucc_min(UCC_TL_UCP_TEAM_LIB(team)->
-                                     cfg.allreduce_kn_radix, size),
-                             &task->allreduce_kn.p);
+    ucc_knomial_pattern_reset(&task->allreduce_kn.p);
     ucc_tl_ucp_task_reset(task, UCC_INPROGRESS);
     status =
         ucc_coll_task_get_executor(&task->super, &task->allreduce_kn.executor);
@@ -221,6 +221,8 @@ ucc_status_t ucc_tl_ucp_allreduce_knomial_init_common(ucc_tl_ucp_task_t *task)
     task->super.post     = ucc_tl_ucp_allreduce_knomial_start;
     task->super.progress = ucc_tl_ucp_allreduce_knomial_progress;
     task->super.finalize = ucc_tl_ucp_allreduce_knomial_finalize;
+    ucc_knomial_pattern_init(size, task->subset.myrank, radix,
+                             &task->allreduce_kn.p);
     status               = ucc_mc_alloc(&task->allreduce_kn.scratch_mc_header,
                           (radix - 1) * data_size,
                           TASK_ARGS(task).dst.info.mem_type);
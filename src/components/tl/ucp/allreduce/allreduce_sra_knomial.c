@@ -35,7 +35,29 @@
    7. After the completion of reduce-scatter phase the local result (at non EXTRA
       ranks) will be located in dst buffer at offset the can be commputed by the
       routine from coll_patterns/sra_knomial.h: ucc_sra_kn_get_offset.
+   8. With ALLREDUCE_SRA_KN_COMPRESS the float32 data is sent as 16 bit values.
+      Reduce-scatter accumulates in float32 and stores the local result also
+      in the compressed format in the scratch of the fragment, allgather runs
+      on that scratch and the last task of the fragment expands it into dst.
+      All the ranks, including the owner of a segment, take the result from
+      the compressed data, so they end up with identical values.
  */
+
+/* Expands the compressed allgather result of the fragment into dst */
+static ucc_status_t
+ucc_tl_ucp_allreduce_sra_knomial_expand_start(ucc_coll_task_t *coll_task)
+{
+    ucc_tl_ucp_task_t *task = ucc_derived_of(coll_task, ucc_tl_ucp_task_t);
+    ucc_coll_args_t   *args = &TASK_ARGS(task);
+
+    ucc_tl_ucp_decompress(args->dst.info.buffer, args->src.info.buffer,
+                          args->dst.info.count,
+                          UCC_TL_UCP_TEAM_LIB(TASK_TEAM(task))
+                              ->cfg.allreduce_sra_kn_compress);
+    coll_task->status = UCC_OK;
+    return ucc_task_complete(coll_task);
+}
+
 static ucc_status_t
 ucc_tl_ucp_allreduce_sra_knomial_frag_start(ucc_coll_task_t *task)
 {
@@ -45,9 +67,14 @@ ucc_tl_ucp_allreduce_sra_knomial_frag_start(ucc_coll_task_t *task)
 static ucc_status_t
 ucc_tl_ucp_allreduce_sra_knomial_frag_finalize(ucc_coll_task_t *task)
 {
-    ucc_schedule_t *schedule = ucc_derived_of(task, ucc_schedule_t);
-    ucc_status_t    status;
+    ucc_schedule_t        *schedule    = ucc_derived_of(task, ucc_schedule_t);
+    ucc_tl_ucp_schedule_t *tl_schedule =
+        ucc_derived_of(task, ucc_tl_ucp_schedule_t);
+    ucc_status_t           status;
 
+    if (tl_schedule->scratch_mc_header) {
+        ucc_mc_free(tl_schedule->scratch_mc_header);
+    }
     status = ucc_schedule_finalize(task);
     ucc_tl_ucp_put_schedule(schedule);
     return status;
@@ -56,15 +83,18 @@ ucc_tl_ucp_allreduce_sra_knomial_frag_finalize(ucc_coll_task_t *task)
 static ucc_status_t ucc_tl_ucp_allreduce_sra_knomial_frag_setup(
     ucc_schedule_pipelined_t *schedule_p, ucc_schedule_t *frag, int frag_num)
 {
-    ucc_coll_args_t *args    = &schedule_p->super.super.bargs.args;
-    ucc_datatype_t   dt      = args->dst.info.datatype;
-    size_t           dt_size = ucc_dt_size(dt);
-    ucc_coll_args_t *targs;
-    int              n_frags    = schedule_p->super.n_tasks;
-    size_t           frag_count = ucc_buffer_block_count(args->dst.info.count,
-                                                         n_frags, frag_num);
-    size_t           offset     = ucc_buffer_block_offset(args->dst.info.count,
-                                                          n_frags, frag_num);
+    ucc_coll_args_t       *args    = &schedule_p->super.super.bargs.args;
+    ucc_tl_ucp_schedule_t *tl_frag =
+        ucc_derived_of(frag, ucc_tl_ucp_schedule_t);
+    ucc_datatype_t         dt      = args->dst.info.datatype;
+    size_t                 dt_size = ucc_dt_size(dt);
+    void                  *scratch;
+    ucc_coll_args_t       *targs;
+    int                    n_frags = schedule_p->super.n_tasks;
+    size_t                 frag_count =
+        ucc_buffer_block_count(args->dst.info.count, n_frags, frag_num);
+    size_t                 offset     =
+        ucc_buffer_block_offset(args->dst.info.count, n_frags, frag_num);
 
     targs = &frag->tasks[0]->bargs.args; //REDUCE_SCATTER
     targs->src.info.buffer =
@@ -81,6 +111,19 @@ static ucc_status_t ucc_tl_ucp_allreduce_sra_knomial_frag_setup(
     targs->src.info.count = 0;
     targs->dst.info.count = frag_count;
 
+    if (frag->n_tasks > 2) {
+        /* compressed: allgather runs on the scratch of the fragment */
+        scratch = tl_frag->scratch_mc_header->addr;
+        ucc_derived_of(frag->tasks[0], ucc_tl_ucp_task_t)
+            ->reduce_scatter_kn.wire_out = scratch;
+        targs->dst.info.buffer           = scratch;
+
+        targs                  = &frag->tasks[2]->bargs.args; //EXPAND
+        targs->src.info.buffer = scratch;
+        targs->dst.info.buffer =
+            PTR_OFFSET(args->dst.info.buffer, offset * dt_size);
+        targs->dst.info.count  = frag_count;
+    }
     return UCC_OK;
 }
 
@@ -89,27 +132,37 @@ static ucc_status_t ucc_tl_ucp_allreduce_sra_knomial_frag_init(
     ucc_schedule_pipelined_t *sp, //NOLINT
     ucc_base_team_t *team, ucc_schedule_t **frag_p)
 {
-    ucc_tl_ucp_team_t   *tl_team  = ucc_derived_of(team, ucc_tl_ucp_team_t);
-    size_t               count    = coll_args->args.dst.info.count;
-    ucc_base_coll_args_t args     = *coll_args;
-    ucc_schedule_t      *schedule;
-    ucc_coll_task_t     *task, *rs_task;
-    ucc_status_t         status;
-    ucc_kn_radix_t       radix, cfg_radix;
+    ucc_tl_ucp_team_t    *tl_team  = ucc_derived_of(team, ucc_tl_ucp_team_t);
+    size_t                count    = coll_args->args.dst.info.count;
+    ucc_base_coll_args_t  args     = *coll_args;
+    ucc_tl_ucp_compress_t compress =
+        UCC_TL_UCP_TEAM_LIB(tl_team)->cfg.allreduce_sra_kn_compress;
+    ucc_schedule_t       *schedule;
+    ucc_tl_ucp_schedule_t *tl_schedule;
+    ucc_coll_task_t      *task, *rs_task, *ag_task;
+    ucc_status_t          status;
+    ucc_kn_radix_t        radix, cfg_radix;
 
-    status = ucc_tl_ucp_get_schedule(tl_team, coll_args,
-                                     (ucc_tl_ucp_schedule_t **)&schedule);
+    status = ucc_tl_ucp_get_schedule(tl_team, coll_args, &tl_schedule);
     if (ucc_unlikely(UCC_OK != status)) {
         return status;
     }
+    schedule                       = &tl_schedule->super.super;
+    tl_schedule->scratch_mc_header = NULL;
+    if (!ucc_tl_ucp_compress_supported(&coll_args->args)) {
+        compress = UCC_TL_UCP_COMPRESS_NONE;
+    }
+    if (coll_args->mask & UCC_BASE_CARGS_MAX_FRAG_COUNT) {
+        count = coll_args->max_frag_count;
+    }
     cfg_radix = UCC_TL_UCP_TEAM_LIB(tl_team)->cfg.allreduce_sra_kn_radix;
-    radix = ucc_knomial_pattern_get_min_radix(cfg_radix,
-                                              UCC_TL_TEAM_SIZE(tl_team), count);
+    radix = ucc_knomial_pattern_get_min_radix(
+        cfg_radix, UCC_TL_UCP_COLL_SIZE(tl_team, &coll_args->args), count);
 
     /* 1st step of allreduce: knomial reduce_scatter */
-    UCC_CHECK_GOTO(
-        ucc_tl_ucp_reduce_scatter_knomial_init_r(&args, team, &task, radix),
-        out, status);
+    UCC_CHECK_GOTO(ucc_tl_ucp_reduce_scatter_knomial_init_compress_r(
+                       &args, team, &task, radix, compress),
+                   out, status);
 
     UCC_CHECK_GOTO(ucc_schedule_add_task(schedule, task), out, status);
     UCC_CHECK_GOTO(ucc_task_subscribe_dep(&schedule->super, task,
@@ -121,12 +174,31 @@ static ucc_status_t ucc_tl_ucp_allreduce_sra_knomial_frag_init(
      to completion event of reduce_scatter task. */
     args.args.mask  |= UCC_COLL_ARGS_FIELD_FLAGS;
     args.args.flags |= UCC_COLL_ARGS_FLAG_IN_PLACE;
+    if (compress != UCC_TL_UCP_COMPRESS_NONE) {
+        /* any 16 bit type, allgather only moves the data */
+        args.args.dst.info.datatype = UCC_DT_BFLOAT16;
+    }
     UCC_CHECK_GOTO(
         ucc_tl_ucp_allgather_knomial_init_r(&args, team, &task, radix), out,
         status);
     UCC_CHECK_GOTO(ucc_schedule_add_task(schedule, task), out, status);
     UCC_CHECK_GOTO(ucc_task_subscribe_dep(rs_task, task, UCC_EVENT_COMPLETED),
                    out, status);
+    ag_task = task;
+
+    if (compress != UCC_TL_UCP_COMPRESS_NONE) {
+        /* 3rd step: expand the compressed result into dst */
+        UCC_CHECK_GOTO(ucc_mc_alloc(&tl_schedule->scratch_mc_header,
+                                    count * sizeof(uint16_t),
+                                    UCC_MEMORY_TYPE_HOST),
+                       out, status);
+        task       = &ucc_tl_ucp_init_task(coll_args, team)->super;
+        task->post = ucc_tl_ucp_allreduce_sra_knomial_expand_start;
+        UCC_CHECK_GOTO(ucc_schedule_add_task(schedule, task), out, status);
+        UCC_CHECK_GOTO(ucc_task_subscribe_dep(ag_task, task,
+                                              UCC_EVENT_COMPLETED),
+                       out, status);
+    }
     schedule->super.finalize = ucc_tl_ucp_allreduce_sra_knomial_frag_finalize;
     schedule->super.post     = ucc_tl_ucp_allreduce_sra_knomial_frag_start;
     *frag_p                  = schedule;
@@ -199,6 +271,11 @@ ucc_tl_ucp_allreduce_sra_knomial_init(ucc_base_coll_args_t *coll_args,
 
     get_sra_n_frags(max_frag_count * dt_size, tl_team, &n_frags,
                     &pipeline_depth);
+    if (UCC_COLL_ARGS_ACTIVE_SET(&coll_args->args)) {
+        /* fragments of an active set collective would share the same tag */
+        n_frags        = 1;
+        pipeline_depth = 1;
+    }
 
     if (n_frags > 1) {
         bargs.mask         |= UCC_BASE_CARGS_MAX_FRAG_COUNT;
@@ -23,7 +23,8 @@ ucc_base_coll_alg_info_t
         [UCC_TL_UCP_ALLTOALL_ALG_ONESIDED] =
             {.id   = UCC_TL_UCP_ALLTOALL_ALG_ONESIDED,
              .name = "onesided",
-             .desc = "naive, linear one-sided implementation"},
+             .desc = "linear one-sided implementation with throttled, "
+                     "rank-offset ordering of puts"},
         [UCC_TL_UCP_ALLTOALL_ALG_LAST] = {.id = 0, .name = NULL, .desc = NULL}};
 
 ucc_status_t ucc_tl_ucp_alltoall_init(ucc_tl_ucp_task_t *task)
@@ -61,21 +62,10 @@ ucc_status_t ucc_tl_ucp_alltoall_onesided_init(ucc_base_coll_args_t *coll_args,
     ucc_status_t       status;
 
     ALLTOALL_TASK_CHECK(coll_args->args, tl_team);
-
-    if (!(coll_args->args.mask & UCC_COLL_ARGS_FIELD_GLOBAL_WORK_BUFFER)) {
-        tl_error(UCC_TL_TEAM_LIB(tl_team),
-                 "global work buffer not provided nor associated with team");
-        status = UCC_ERR_NOT_SUPPORTED;
+    status = ucc_tl_ucp_onesided_check_args(coll_args, tl_team);
+    if (ucc_unlikely(UCC_OK != status)) {
         goto out;
     }
-    if (coll_args->args.mask & UCC_COLL_ARGS_FIELD_FLAGS) {
-        if (!(coll_args->args.flags & UCC_COLL_ARGS_FLAG_MEM_MAPPED_BUFFERS)) {
-            tl_error(UCC_TL_TEAM_LIB(tl_team),
-                     "non memory mapped buffers are not supported");
-            status = UCC_ERR_NOT_SUPPORTED;
-            goto out;
-        }
-    }
     task                 = ucc_tl_ucp_init_task(coll_args, team);
     *task_h              = &task->super;
     task->super.post     = ucc_tl_ucp_alltoall_onesided_start;
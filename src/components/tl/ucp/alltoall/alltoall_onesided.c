@@ -14,6 +14,15 @@
 void ucc_tl_ucp_alltoall_onesided_progress(ucc_coll_task_t *ctask);
 
 ucc_status_t ucc_tl_ucp_alltoall_onesided_start(ucc_coll_task_t *ctask)
+{
+    ucc_tl_ucp_task_t *task = ucc_derived_of(ctask, ucc_tl_ucp_task_t);
+    ucc_tl_ucp_team_t *team = TASK_TEAM(task);
+
+    ucc_tl_ucp_task_reset(task, UCC_INPROGRESS);
+    return ucc_progress_queue_enqueue(UCC_TL_CORE_CTX(team)->pq, &task->super);
+}
+
+void ucc_tl_ucp_alltoall_onesided_progress(ucc_coll_task_t *ctask)
 {
     ucc_tl_ucp_task_t *task   = ucc_derived_of(ctask, ucc_tl_ucp_task_t);
     ucc_tl_ucp_team_t *team   = TASK_TEAM(task);
@@ -22,45 +31,39 @@ ucc_status_t ucc_tl_ucp_alltoall_onesided_start(ucc_coll_task_t *ctask)
     size_t             nelems = TASK_ARGS(task).src.info.count;
     ucc_rank_t         grank  = UCC_TL_TEAM_RANK(team);
     ucc_rank_t         gsize  = UCC_TL_TEAM_SIZE(team);
-    ucc_rank_t         start  = (grank + 1) % gsize;
     long *             pSync  = TASK_ARGS(task).global_work_buffer;
+    uint32_t           posts;
+    uint32_t           nreqs;
     ucc_rank_t         peer;
 
-    ucc_tl_ucp_task_reset(task, UCC_INPROGRESS);
+    posts = UCC_TL_UCP_TEAM_LIB(team)->cfg.alltoall_onesided_num_posts;
+    nreqs = (posts > gsize || posts == 0) ? gsize : posts;
     /* TODO: change when support for library-based work buffers is complete */
     nelems = (nelems / gsize) * ucc_dt_size(TASK_ARGS(task).src.info.datatype);
     dest   = dest + grank * nelems;
-    UCPCHECK_GOTO(ucc_tl_ucp_put_nb((void *)(src + start * nelems),
-                                    (void *)dest, nelems, start, team, task),
-                  task, out);
-    UCPCHECK_GOTO(ucc_tl_ucp_atomic_inc(pSync, start, team), task, out);
 
-    for (peer = (start + 1) % gsize; peer != start; peer = (peer + 1) % gsize) {
-        UCPCHECK_GOTO(ucc_tl_ucp_put_nb((void *)(src + peer * nelems),
-                                        (void *)dest, nelems, peer, team, task),
+    /* Each rank starts from its right neighbor, so at any given moment
+       the outstanding puts of different ranks target different peers.
+       Number of outstanding puts is limited by nreqs to avoid incast. */
+    while ((task->onesided.put_posted < gsize) &&
+           ((task->onesided.put_posted - task->onesided.put_completed) <
+            nreqs)) {
+        peer = (grank + 1 + task->onesided.put_posted) % gsize;
+        UCPCHECK_GOTO(ucc_tl_ucp_put_signal_nb((void *)(src + peer * nelems),
+                                               (void *)dest, nelems, pSync,
+                                               peer, team, task),
                       task, out);
-        UCPCHECK_GOTO(ucc_tl_ucp_atomic_inc(pSync, peer, team), task,
-                      out);
     }
 
-    return ucc_progress_queue_enqueue(UCC_TL_CORE_CTX(team)->pq, &task->super);
-out:
-    return task->super.status;
-}
-
-void ucc_tl_ucp_alltoall_onesided_progress(ucc_coll_task_t *ctask)
-{
-    ucc_tl_ucp_task_t *task  = ucc_derived_of(ctask, ucc_tl_ucp_task_t);
-    ucc_tl_ucp_team_t *team  = TASK_TEAM(task);
-    ucc_rank_t         gsize = UCC_TL_TEAM_SIZE(team);
-    long *             pSync = TASK_ARGS(task).global_work_buffer;
-
     if ((*pSync < gsize) ||
-        (task->onesided.put_completed < task->onesided.put_posted)) {
-        ucp_worker_progress(UCC_TL_UCP_TEAM_CTX(team)->ucp_worker);
+        (task->onesided.put_completed < task->onesided.put_posted) ||
+        (task->onesided.put_posted < gsize)) {
+        ucp_worker_progress(UCC_TL_UCP_ONESIDED_WORKER(team));
         return;
     }
 
     pSync[0]           = 0;
     task->super.status = UCC_OK;
+out:
+    return;
 }
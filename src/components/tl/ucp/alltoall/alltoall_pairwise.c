@@ -10,18 +10,7 @@
 #include "core/ucc_progress_queue.h"
 #include "utils/ucc_math.h"
 #include "tl_ucp_sendrecv.h"
-
-static inline ucc_rank_t get_recv_peer(ucc_rank_t rank, ucc_rank_t size,
-                                       ucc_rank_t step)
-{
-    return (rank + step) % size;
-}
-
-static inline ucc_rank_t get_send_peer(ucc_rank_t rank, ucc_rank_t size,
-                                       ucc_rank_t step)
-{
-    return (rank - step + size) % size;
-}
+#include "tl_ucp_pairwise.h"
 
 void ucc_tl_ucp_alltoall_pairwise_progress(ucc_coll_task_t *coll_task)
 {
@@ -31,36 +20,41 @@ void ucc_tl_ucp_alltoall_pairwise_progress(ucc_coll_task_t *coll_task)
     ptrdiff_t          rbuf  = (ptrdiff_t)TASK_ARGS(task).dst.info.buffer;
     ucc_memory_type_t  smem  = TASK_ARGS(task).src.info.mem_type;
     ucc_memory_type_t  rmem  = TASK_ARGS(task).dst.info.mem_type;
-    ucc_rank_t         grank = UCC_TL_TEAM_RANK(team);
-    ucc_rank_t         gsize = UCC_TL_TEAM_SIZE(team);
+    ucc_rank_t         gsize = (ucc_rank_t)task->subset.map.ep_num;
     int                polls = 0;
     ucc_rank_t         peer;
-    int                posts, nreqs;
     size_t             data_size;
 
-    posts     = UCC_TL_UCP_TEAM_LIB(team)->cfg.alltoall_pairwise_num_posts;
-    nreqs     = (posts > gsize || posts == 0) ? gsize : posts;
     data_size = (size_t)(TASK_ARGS(task).src.info.count / gsize) *
                 ucc_dt_size(TASK_ARGS(task).src.info.datatype);
     while ((task->tagged.send_posted < gsize ||
             task->tagged.recv_posted < gsize) &&
            (polls++ < task->n_polls)) {
-        ucp_worker_progress(UCC_TL_UCP_TEAM_CTX(team)->ucp_worker);
+        ucc_tl_ucp_team_progress(team);
+        ucc_tl_ucp_pairwise_update_window(task, gsize);
         while ((task->tagged.recv_posted < gsize) &&
                ((task->tagged.recv_posted - task->tagged.recv_completed) <
-                nreqs)) {
-            peer = get_recv_peer(grank, gsize, task->tagged.recv_posted);
+                task->pairwise.window)) {
+            peer = ucc_tl_ucp_pairwise_recv_peer(task, gsize,
+                                                 task->tagged.recv_posted);
             UCPCHECK_GOTO(ucc_tl_ucp_recv_nb((void *)(rbuf + peer * data_size),
-                                             data_size, rmem, peer, team, task),
+                                             data_size, rmem,
+                                             ucc_ep_map_eval(task->subset.map,
+                                                             peer),
+                                             team, task),
                           task, out);
             polls = 0;
         }
         while ((task->tagged.send_posted < gsize) &&
                ((task->tagged.send_posted - task->tagged.send_completed) <
-                nreqs)) {
-            peer = get_send_peer(grank, gsize, task->tagged.send_posted);
+                task->pairwise.window)) {
+            peer = ucc_tl_ucp_pairwise_send_peer(task, gsize,
+                                                 task->tagged.send_posted);
             UCPCHECK_GOTO(ucc_tl_ucp_send_nb((void *)(sbuf + peer * data_size),
-                                             data_size, smem, peer, team, task),
+                                             data_size, smem,
+                                             ucc_ep_map_eval(task->subset.map,
+                                                             peer),
+                                             team, task),
                           task, out);
             polls = 0;
         }
@@ -71,6 +65,9 @@ void ucc_tl_ucp_alltoall_pairwise_progress(ucc_coll_task_t *coll_task)
     }
 
     task->super.status = ucc_tl_ucp_test(task);
+    if (task->super.status == UCC_OK && task->pairwise.adaptive) {
+        team->alltoall_window = task->pairwise.window;
+    }
 out:
     if (task->super.status != UCC_INPROGRESS) {
         UCC_TL_UCP_PROFILE_REQUEST_EVENT(coll_task,
@@ -85,20 +82,30 @@ ucc_status_t ucc_tl_ucp_alltoall_pairwise_start(ucc_coll_task_t *coll_task)
 
     UCC_TL_UCP_PROFILE_REQUEST_EVENT(coll_task, "ucp_alltoall_pairwise_start", 0);
     ucc_tl_ucp_task_reset(task, UCC_INPROGRESS);
+    ucc_tl_ucp_pairwise_start(
+        task, UCC_TL_UCP_TEAM_LIB(team)->cfg.alltoall_pairwise_num_posts,
+        team->alltoall_window);
 
     return ucc_progress_queue_enqueue(UCC_TL_CORE_CTX(team)->pq, &task->super);
 }
 
 ucc_status_t ucc_tl_ucp_alltoall_pairwise_init_common(ucc_tl_ucp_task_t *task)
 {
-    ucc_tl_ucp_team_t *team = TASK_TEAM(task);
-    ucc_coll_args_t   *args = &TASK_ARGS(task);
-    size_t data_size;
+    ucc_tl_ucp_team_t       *team = TASK_TEAM(task);
+    ucc_coll_args_t         *args = &TASK_ARGS(task);
+    ucc_tl_ucp_lib_config_t *cfg  = &UCC_TL_UCP_TEAM_LIB(team)->cfg;
+    size_t                   data_size;
+    ucc_status_t             status;
 
     task->super.post     = ucc_tl_ucp_alltoall_pairwise_start;
     task->super.progress = ucc_tl_ucp_alltoall_pairwise_progress;
 
     task->n_polls = ucc_min(1, task->n_polls);
+    status = ucc_tl_ucp_pairwise_init(task, cfg->alltoall_pairwise_schedule,
+                                      cfg->alltoall_pairwise_adaptive);
+    if (ucc_unlikely(UCC_OK != status)) {
+        return status;
+    }
     if (UCC_TL_UCP_TEAM_CTX(team)->cfg.pre_reg_mem) {
         data_size =
             (size_t)args->src.info.count * ucc_dt_size(args->src.info.datatype);
@@ -18,6 +18,16 @@ ucc_base_coll_alg_info_t
              .name = "pairwise",
              .desc = "O(N) pairwise exchange with adjustable number "
              "of outstanding sends/recvs"},
+        [UCC_TL_UCP_ALLTOALLV_ALG_ONESIDED] =
+            {.id   = UCC_TL_UCP_ALLTOALLV_ALG_ONESIDED,
+             .name = "onesided",
+             .desc = "O(N) one-sided puts with completion counter, dst "
+             "displacements refer to the remote buffers"},
+        [UCC_TL_UCP_ALLTOALLV_ALG_SPARSE] =
+            {.id   = UCC_TL_UCP_ALLTOALLV_ALG_SPARSE,
+             .name = "sparse",
+             .desc = "pairwise exchange that posts only the transfers with "
+             "non zero counts, O(number of non empty peers) messages"},
         [UCC_TL_UCP_ALLTOALLV_ALG_LAST] = {
             .id = 0, .name = NULL, .desc = NULL}};
 
@@ -26,7 +36,11 @@ ucc_status_t ucc_tl_ucp_alltoallv_init(ucc_tl_ucp_task_t *task)
     ucc_status_t status;
 
     ALLTOALLV_TASK_CHECK(TASK_ARGS(task), TASK_TEAM(task));
-    status = ucc_tl_ucp_alltoallv_pairwise_init_common(task);
+    if (ucc_tl_ucp_alltoallv_is_sparse(task)) {
+        status = ucc_tl_ucp_alltoallv_sparse_init_common(task);
+    } else {
+        status = ucc_tl_ucp_alltoallv_pairwise_init_common(task);
+    }
 out:
     return status;
 }
@@ -46,3 +60,19 @@ ucc_status_t ucc_tl_ucp_alltoallv_pairwise_init(ucc_base_coll_args_t *coll_args,
 out:
     return status;
 }
+
+ucc_status_t ucc_tl_ucp_alltoallv_sparse_init(ucc_base_coll_args_t *coll_args,
+                                              ucc_base_team_t      *team,
+                                              ucc_coll_task_t     **task_h)
+{
+    ucc_tl_ucp_team_t *tl_team = ucc_derived_of(team, ucc_tl_ucp_team_t);
+    ucc_tl_ucp_task_t *task;
+    ucc_status_t       status;
+
+    ALLTOALLV_TASK_CHECK(coll_args->args, tl_team);
+    task    = ucc_tl_ucp_init_task(coll_args, team);
+    *task_h = &task->super;
+    status  = ucc_tl_ucp_alltoallv_sparse_init_common(task);
+out:
+    return status;
+}
@@ -12,6 +12,8 @@
 
 enum {
     UCC_TL_UCP_ALLTOALLV_ALG_PAIRWISE,
+    UCC_TL_UCP_ALLTOALLV_ALG_ONESIDED,
+    UCC_TL_UCP_ALLTOALLV_ALG_SPARSE,
     UCC_TL_UCP_ALLTOALLV_ALG_LAST
 };
 
@@ -26,6 +28,18 @@ ucc_status_t ucc_tl_ucp_alltoallv_pairwise_init(ucc_base_coll_args_t *coll_args,
 
 ucc_status_t ucc_tl_ucp_alltoallv_pairwise_init_common(ucc_tl_ucp_task_t *task);
 
+ucc_status_t ucc_tl_ucp_alltoallv_sparse_init(ucc_base_coll_args_t *coll_args,
+                                              ucc_base_team_t      *team,
+                                              ucc_coll_task_t     **task_h);
+
+ucc_status_t ucc_tl_ucp_alltoallv_sparse_init_common(ucc_tl_ucp_task_t *task);
+
+int ucc_tl_ucp_alltoallv_is_sparse(ucc_tl_ucp_task_t *task);
+
+ucc_status_t ucc_tl_ucp_alltoallv_onesided_init(ucc_base_coll_args_t *coll_args,
+                                                ucc_base_team_t      *team,
+                                                ucc_coll_task_t     **task_h);
+
 #define ALLTOALLV_CHECK_INPLACE(_args, _team)               \
     do {                                                    \
         if (UCC_IS_INPLACE(_args)) {                        \
@@ -51,4 +65,15 @@ ucc_status_t ucc_tl_ucp_alltoallv_pairwise_init_common(ucc_tl_ucp_task_t *task);
     ALLTOALLV_CHECK_INPLACE((_args), (_team));          \
     ALLTOALLV_CHECK_USERDEFINED_DT((_args), (_team));
 
+static inline int ucc_tl_ucp_alltoallv_alg_from_str(const char *str)
+{
+    int i;
+    for (i = 0; i < UCC_TL_UCP_ALLTOALLV_ALG_LAST; i++) {
+        if (0 == strcasecmp(str, ucc_tl_ucp_alltoallv_algs[i].name)) {
+            break;
+        }
+    }
+    return i;
+}
+
 #endif
@@ -0,0 +1,97 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "config.h"
+#include "tl_ucp.h"
+#include "alltoallv.h"
+#include "core/ucc_progress_queue.h"
+#include "utils/ucc_math.h"
+#include "utils/ucc_coll_utils.h"
+#include "tl_ucp_sendrecv.h"
+
+/* One-sided alltoallv: every rank puts its block directly into the
+   destination buffer of the peer and increments the sync counter of the
+   peer (global work buffer). The destination displacement provided for
+   a peer is the offset within the dst buffer of that peer where the data
+   of the calling rank has to be placed. */
+ucc_status_t ucc_tl_ucp_alltoallv_onesided_start(ucc_coll_task_t *ctask)
+{
+    ucc_tl_ucp_task_t *task = ucc_derived_of(ctask, ucc_tl_ucp_task_t);
+    ucc_tl_ucp_team_t *team = TASK_TEAM(task);
+
+    ucc_tl_ucp_task_reset(task, UCC_INPROGRESS);
+    return ucc_progress_queue_enqueue(UCC_TL_CORE_CTX(team)->pq, &task->super);
+}
+
+void ucc_tl_ucp_alltoallv_onesided_progress(ucc_coll_task_t *ctask)
+{
+    ucc_tl_ucp_task_t *task  = ucc_derived_of(ctask, ucc_tl_ucp_task_t);
+    ucc_tl_ucp_team_t *team  = TASK_TEAM(task);
+    ucc_coll_args_t   *args  = &TASK_ARGS(task);
+    ptrdiff_t          src   = (ptrdiff_t)args->src.info_v.buffer;
+    ptrdiff_t          dest  = (ptrdiff_t)args->dst.info_v.buffer;
+    ucc_rank_t         grank = UCC_TL_TEAM_RANK(team);
+    ucc_rank_t         gsize = UCC_TL_TEAM_SIZE(team);
+    long *             pSync = args->global_work_buffer;
+    size_t             sdt_size, rdt_size, data_size, sd_disp, dd_disp;
+    uint32_t           posts, nreqs;
+    ucc_rank_t         peer;
+
+    posts    = UCC_TL_UCP_TEAM_LIB(team)->cfg.alltoallv_onesided_num_posts;
+    nreqs    = (posts > gsize || posts == 0) ? gsize : posts;
+    sdt_size = ucc_dt_size(args->src.info_v.datatype);
+    rdt_size = ucc_dt_size(args->dst.info_v.datatype);
+
+    while ((task->onesided.put_posted < gsize) &&
+           ((task->onesided.put_posted - task->onesided.put_completed) <
+            nreqs)) {
+        peer      = (grank + 1 + task->onesided.put_posted) % gsize;
+        data_size = ucc_coll_args_get_count(args, args->src.info_v.counts,
+                                            peer) * sdt_size;
+        sd_disp   = ucc_coll_args_get_displacement(
+                        args, args->src.info_v.displacements, peer) * sdt_size;
+        dd_disp   = ucc_coll_args_get_displacement(
+                        args, args->dst.info_v.displacements, peer) * rdt_size;
+        UCPCHECK_GOTO(ucc_tl_ucp_put_signal_nb((void *)(src + sd_disp),
+                                               (void *)(dest + dd_disp),
+                                               data_size, pSync, peer, team,
+                                               task),
+                      task, out);
+    }
+
+    if ((*pSync < gsize) ||
+        (task->onesided.put_completed < task->onesided.put_posted) ||
+        (task->onesided.put_posted < gsize)) {
+        ucp_worker_progress(UCC_TL_UCP_ONESIDED_WORKER(team));
+        return;
+    }
+
+    pSync[0]           = 0;
+    task->super.status = UCC_OK;
+out:
+    return;
+}
+
+ucc_status_t ucc_tl_ucp_alltoallv_onesided_init(ucc_base_coll_args_t *coll_args,
+                                                ucc_base_team_t      *team,
+                                                ucc_coll_task_t     **task_h)
+{
+    ucc_tl_ucp_team_t *tl_team = ucc_derived_of(team, ucc_tl_ucp_team_t);
+    ucc_tl_ucp_task_t *task;
+    ucc_status_t       status;
+
+    ALLTOALLV_TASK_CHECK(coll_args->args, tl_team);
+    status = ucc_tl_ucp_onesided_check_args(coll_args, tl_team);
+    if (ucc_unlikely(UCC_OK != status)) {
+        goto out;
+    }
+    task                 = ucc_tl_ucp_init_task(coll_args, team);
+    *task_h              = &task->super;
+    task->super.post     = ucc_tl_ucp_alltoallv_onesided_start;
+    task->super.progress = ucc_tl_ucp_alltoallv_onesided_progress;
+out:
+    return status;
+}
@@ -0,0 +1,182 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "config.h"
+#include "tl_ucp.h"
+#include "alltoallv.h"
+#include "core/ucc_progress_queue.h"
+#include "utils/ucc_math.h"
+#include "utils/ucc_malloc.h"
+#include "utils/ucc_coll_utils.h"
+#include "tl_ucp_sendrecv.h"
+
+/* Sparse alltoallv: the counts are scanned once on start and only the
+   peers with non zero counts are kept, in the order of the pairwise
+   algorithm. The number of posted messages and of progress iterations is
+   then proportional to the number of non empty transfers rather than to
+   the team size. Zero count peers are skipped on both sides, so the
+   messages still match as long as the counts are consistent. */
+
+static ucc_status_t
+ucc_tl_ucp_alltoallv_sparse_start(ucc_coll_task_t *coll_task)
+{
+    ucc_tl_ucp_task_t *task   = ucc_derived_of(coll_task, ucc_tl_ucp_task_t);
+    ucc_tl_ucp_team_t *team   = TASK_TEAM(task);
+    ucc_coll_args_t   *args   = &TASK_ARGS(task);
+    ucc_rank_t         grank  = task->subset.myrank;
+    ucc_rank_t         gsize  = (ucc_rank_t)task->subset.map.ep_num;
+    ucc_rank_t        *peers  = task->alltoallv_sparse.peers;
+    ucc_rank_t         n_recv = 0;
+    ucc_rank_t         n_send = 0;
+    ucc_rank_t         step, peer;
+
+    UCC_TL_UCP_PROFILE_REQUEST_EVENT(coll_task, "ucp_alltoallv_sparse_start",
+                                     0);
+    ucc_tl_ucp_task_reset(task, UCC_INPROGRESS);
+    for (step = 0; step < gsize; step++) {
+        peer = (grank + step) % gsize;
+        if (ucc_coll_args_get_count(args, args->dst.info_v.counts, peer)) {
+            peers[n_recv++] = peer;
+        }
+        peer = (grank - step + gsize) % gsize;
+        if (ucc_coll_args_get_count(args, args->src.info_v.counts, peer)) {
+            peers[gsize + n_send++] = peer;
+        }
+    }
+    task->alltoallv_sparse.n_recv = n_recv;
+    task->alltoallv_sparse.n_send = n_send;
+    return ucc_progress_queue_enqueue(UCC_TL_CORE_CTX(team)->pq, &task->super);
+}
+
+static void ucc_tl_ucp_alltoallv_sparse_progress(ucc_coll_task_t *coll_task)
+{
+    ucc_tl_ucp_task_t *task   = ucc_derived_of(coll_task, ucc_tl_ucp_task_t);
+    ucc_tl_ucp_team_t *team   = TASK_TEAM(task);
+    ucc_coll_args_t   *args   = &TASK_ARGS(task);
+    ptrdiff_t          sbuf   = (ptrdiff_t)args->src.info_v.buffer;
+    ptrdiff_t          rbuf   = (ptrdiff_t)args->dst.info_v.buffer;
+    ucc_memory_type_t  smem   = args->src.info_v.mem_type;
+    ucc_memory_type_t  rmem   = args->dst.info_v.mem_type;
+    ucc_rank_t         gsize  = (ucc_rank_t)task->subset.map.ep_num;
+    ucc_rank_t        *peers  = task->alltoallv_sparse.peers;
+    ucc_rank_t         n_recv = task->alltoallv_sparse.n_recv;
+    ucc_rank_t         n_send = task->alltoallv_sparse.n_send;
+    int                polls  = 0;
+    ucc_rank_t         peer;
+    uint32_t           posts, nreqs;
+    size_t             rdt_size, sdt_size, data_size, data_displ;
+
+    posts    = UCC_TL_UCP_TEAM_LIB(team)->cfg.alltoallv_pairwise_num_posts;
+    nreqs    = (posts > gsize || posts == 0) ? gsize : posts;
+    rdt_size = ucc_dt_size(args->dst.info_v.datatype);
+    sdt_size = ucc_dt_size(args->src.info_v.datatype);
+    while ((task->tagged.send_posted < n_send ||
+            task->tagged.recv_posted < n_recv) &&
+           (polls++ < task->n_polls)) {
+        ucc_tl_ucp_team_progress(team);
+        while ((task->tagged.recv_posted < n_recv) &&
+               ((task->tagged.recv_posted - task->tagged.recv_completed) <
+                nreqs)) {
+            peer      = peers[task->tagged.recv_posted];
+            data_size = ucc_coll_args_get_count(args, args->dst.info_v.counts,
+                                                peer) * rdt_size;
+            data_displ = ucc_coll_args_get_displacement(
+                             args, args->dst.info_v.displacements, peer) *
+                         rdt_size;
+            UCPCHECK_GOTO(ucc_tl_ucp_recv_nb((void *)(rbuf + data_displ),
+                                             data_size, rmem,
+                                             ucc_ep_map_eval(task->subset.map,
+                                                             peer),
+                                             team, task),
+                          task, out);
+            polls = 0;
+        }
+        while ((task->tagged.send_posted < n_send) &&
+               ((task->tagged.send_posted - task->tagged.send_completed) <
+                nreqs)) {
+            peer      = peers[gsize + task->tagged.send_posted];
+            data_size = ucc_coll_args_get_count(args, args->src.info_v.counts,
+                                                peer) * sdt_size;
+            data_displ = ucc_coll_args_get_displacement(
+                             args, args->src.info_v.displacements, peer) *
+                         sdt_size;
+            UCPCHECK_GOTO(ucc_tl_ucp_send_nb((void *)(sbuf + data_displ),
+                                             data_size, smem,
+                                             ucc_ep_map_eval(task->subset.map,
+                                                             peer),
+                                             team, task),
+                          task, out);
+            polls = 0;
+        }
+    }
+    if ((task->tagged.send_posted < n_send) ||
+        (task->tagged.recv_posted < n_recv)) {
+        return;
+    }
+    task->super.status = ucc_tl_ucp_test(task);
+out:
+    if (task->super.status != UCC_INPROGRESS) {
+        UCC_TL_UCP_PROFILE_REQUEST_EVENT(coll_task,
+                                         "ucp_alltoallv_sparse_done", 0);
+    }
+}
+
+static ucc_status_t
+ucc_tl_ucp_alltoallv_sparse_finalize(ucc_coll_task_t *coll_task)
+{
+    ucc_tl_ucp_task_t *task = ucc_derived_of(coll_task, ucc_tl_ucp_task_t);
+
+    ucc_free(task->alltoallv_sparse.peers);
+    return ucc_tl_ucp_coll_finalize(coll_task);
+}
+
+/* Used by the default alltoallv selection: the sparse algorithm is taken
+   when the share of the peers this rank exchanges data with is at most
+   ALLTOALLV_SPARSE_THRESH percent. The decision is local, each rank can
+   use either algorithm since both post the same messages. */
+int ucc_tl_ucp_alltoallv_is_sparse(ucc_tl_ucp_task_t *task)
+{
+    ucc_tl_ucp_team_t *team   = TASK_TEAM(task);
+    ucc_coll_args_t   *args   = &TASK_ARGS(task);
+    ucc_rank_t         gsize  = (ucc_rank_t)task->subset.map.ep_num;
+    uint32_t           thresh =
+        UCC_TL_UCP_TEAM_LIB(team)->cfg.alltoallv_sparse_thresh;
+    ucc_rank_t         n_recv = 0, n_send = 0;
+    ucc_rank_t         i;
+
+    if (thresh == 0) {
+        return 0;
+    }
+    for (i = 0; i < gsize; i++) {
+        if (ucc_coll_args_get_count(args, args->dst.info_v.counts, i)) {
+            n_recv++;
+        }
+        if (ucc_coll_args_get_count(args, args->src.info_v.counts, i)) {
+            n_send++;
+        }
+    }
+    return (uint64_t)ucc_max(n_recv, n_send) * 100 <=
+           (uint64_t)thresh * gsize;
+}
+
+ucc_status_t ucc_tl_ucp_alltoallv_sparse_init_common(ucc_tl_ucp_task_t *task)
+{
+    ucc_rank_t         size = (ucc_rank_t)task->subset.map.ep_num;
+
+    task->alltoallv_sparse.peers =
+        ucc_malloc(2 * size * sizeof(ucc_rank_t), "sparse_peers");
+    if (!task->alltoallv_sparse.peers) {
+        tl_error(UCC_TASK_LIB(task),
+                 "failed to allocate %zd bytes for sparse peers",
+                 2 * size * sizeof(ucc_rank_t));
+        return UCC_ERR_NO_MEMORY;
+    }
+    task->super.post     = ucc_tl_ucp_alltoallv_sparse_start;
+    task->super.progress = ucc_tl_ucp_alltoallv_sparse_progress;
+    task->super.finalize = ucc_tl_ucp_alltoallv_sparse_finalize;
+    task->n_polls        = ucc_min(1, task->n_polls);
+    return UCC_OK;
+}
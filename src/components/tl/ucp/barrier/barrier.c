@@ -21,7 +21,14 @@ ucc_base_coll_alg_info_t
 
 ucc_status_t ucc_tl_ucp_barrier_init(ucc_tl_ucp_task_t *task)
 {
+    ucc_tl_ucp_team_t *team = TASK_TEAM(task);
+    ucc_rank_t         size = (ucc_rank_t)task->subset.map.ep_num;
+
     task->super.post     = ucc_tl_ucp_barrier_knomial_start;
     task->super.progress = ucc_tl_ucp_barrier_knomial_progress;
+    ucc_knomial_pattern_init(size, task->subset.myrank,
+                             ucc_min(UCC_TL_UCP_TEAM_LIB(team)->
+                                     cfg.barrier_kn_radix, size),
+                             &task->barrier.p);
     return UCC_OK;
 }
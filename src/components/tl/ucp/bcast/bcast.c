@@ -19,6 +19,11 @@ ucc_base_coll_alg_info_t
              .name = "sag_knomial",
              .desc = "recursive knomial scatter followed by knomial "
                      "allgather (optimized for BW)"},
+        [UCC_TL_UCP_BCAST_ALG_ONESIDED] =
+            {.id   = UCC_TL_UCP_BCAST_ALG_ONESIDED,
+             .name = "onesided",
+             .desc = "knomial tree of one-sided puts, each rank is signaled "
+                     "once by its parent"},
         [UCC_TL_UCP_BCAST_ALG_LAST] = {
             .id = 0, .name = NULL, .desc = NULL}};
 
@@ -39,9 +44,24 @@ ucc_status_t ucc_tl_ucp_bcast_knomial_init(ucc_base_coll_args_t *coll_args,
                                                ucc_base_team_t *     team,
                                                ucc_coll_task_t **    task_h)
 {
-    ucc_tl_ucp_task_t *task;
-    ucc_status_t       status;
+    ucc_tl_ucp_team_t       *tl_team = ucc_derived_of(team, ucc_tl_ucp_team_t);
+    ucc_tl_ucp_lib_config_t *cfg     = &UCC_TL_UCP_TEAM_LIB(tl_team)->cfg;
+    size_t                   msgsize =
+        coll_args->args.src.info.count *
+        ucc_dt_size(coll_args->args.src.info.datatype);
+    ucc_tl_ucp_task_t       *task;
+    ucc_status_t             status;
+    int                      n_frags, pipeline_depth;
 
+    if (!(coll_args->args.mask & UCC_COLL_ARGS_FIELD_ACTIVE_SET)) {
+        UCC_TL_UCP_KN_PIPELINE_N_FRAGS(msgsize, cfg->bcast_kn_frag_size,
+                                       cfg->bcast_kn_pipeline_depth, n_frags,
+                                       pipeline_depth);
+        if (n_frags > 1) {
+            return ucc_tl_ucp_bcast_knomial_pipelined_init(
+                coll_args, team, n_frags, pipeline_depth, task_h);
+        }
+    }
     task    = ucc_tl_ucp_init_task(coll_args, team);
     status  = ucc_tl_ucp_bcast_init(task);
     *task_h = &task->super;
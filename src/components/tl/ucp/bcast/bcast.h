@@ -11,6 +11,7 @@
 enum {
     UCC_TL_UCP_BCAST_ALG_KNOMIAL,
     UCC_TL_UCP_BCAST_ALG_SAG_KNOMIAL,
+    UCC_TL_UCP_BCAST_ALG_ONESIDED,
     UCC_TL_UCP_BCAST_ALG_LAST
 };
 
@@ -42,8 +43,18 @@ ucc_tl_ucp_bcast_knomial_progress(ucc_coll_task_t *task);
 ucc_status_t
 ucc_tl_ucp_bcast_knomial_start(ucc_coll_task_t *task);
 
+ucc_status_t
+ucc_tl_ucp_bcast_knomial_pipelined_init(ucc_base_coll_args_t *coll_args,
+                                        ucc_base_team_t      *team,
+                                        int n_frags, int pipeline_depth,
+                                        ucc_coll_task_t     **task_h);
+
 ucc_status_t
 ucc_tl_ucp_bcast_sag_knomial_init(ucc_base_coll_args_t *coll_args,
                               ucc_base_team_t *team, ucc_coll_task_t **task_h);
 
+ucc_status_t
+ucc_tl_ucp_bcast_onesided_init(ucc_base_coll_args_t *coll_args,
+                               ucc_base_team_t *team, ucc_coll_task_t **task_h);
+
 #endif
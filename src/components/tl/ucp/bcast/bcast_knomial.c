@@ -10,6 +10,7 @@
 #include "core/ucc_progress_queue.h"
 #include "tl_ucp_sendrecv.h"
 #include "utils/ucc_math.h"
+#include "utils/ucc_coll_utils.h"
 
 void ucc_tl_ucp_bcast_knomial_progress(ucc_coll_task_t *coll_task)
 {
@@ -40,9 +41,9 @@ void ucc_tl_ucp_bcast_knomial_progress(ucc_coll_task_t *coll_task)
                     if (vpeer < size) {
                         peer = ucc_ep_map_eval(task->subset.map,
                                                (vpeer + root) % size);
-                        UCPCHECK_GOTO(ucc_tl_ucp_send_nb(buffer, data_size,
-                                                         mtype, peer, team,
-                                                         task),
+                        UCPCHECK_GOTO(
+                            ucc_tl_ucp_send_eager_nb(buffer, data_size, mtype,
+                                                     peer, team, task),
                                       task, out);
                     }
                 }
@@ -51,8 +52,8 @@ void ucc_tl_ucp_bcast_knomial_progress(ucc_coll_task_t *coll_task)
                 root_at_level  = (vroot_at_level + root) % size;
                 peer = ucc_ep_map_eval(task->subset.map,
                                        root_at_level);
-                UCPCHECK_GOTO(ucc_tl_ucp_recv_nb(buffer, data_size, mtype,
-                                                 peer, team, task),
+                UCPCHECK_GOTO(ucc_tl_ucp_recv_eager_nb(buffer, data_size,
+                                                       mtype, peer, team, task),
                               task, out);
             }
         }
@@ -83,3 +84,131 @@ ucc_status_t ucc_tl_ucp_bcast_knomial_start(ucc_coll_task_t *coll_task)
 
     return ucc_progress_queue_enqueue(UCC_TL_CORE_CTX(team)->pq, &task->super);
 }
+
+static ucc_status_t
+ucc_tl_ucp_bcast_knomial_frag_start(ucc_coll_task_t *task)
+{
+    return ucc_schedule_start(task);
+}
+
+static ucc_status_t
+ucc_tl_ucp_bcast_knomial_frag_finalize(ucc_coll_task_t *task)
+{
+    ucc_schedule_t *schedule = ucc_derived_of(task, ucc_schedule_t);
+    ucc_status_t    status;
+
+    status = ucc_schedule_finalize(task);
+    ucc_tl_ucp_put_schedule(schedule);
+    return status;
+}
+
+static ucc_status_t
+ucc_tl_ucp_bcast_knomial_frag_setup(ucc_schedule_pipelined_t *schedule_p,
+                                    ucc_schedule_t *frag, int frag_num)
+{
+    ucc_coll_args_t *args       = &schedule_p->super.super.bargs.args;
+    size_t           dt_size    = ucc_dt_size(args->src.info.datatype);
+    int              n_frags    = schedule_p->super.n_tasks;
+    size_t           frag_count = ucc_buffer_block_count(args->src.info.count,
+                                                         n_frags, frag_num);
+    size_t           offset     = ucc_buffer_block_offset(args->src.info.count,
+                                                          n_frags, frag_num);
+    ucc_coll_args_t *targs;
+
+    targs                  = &frag->tasks[0]->bargs.args;
+    targs->src.info.buffer = PTR_OFFSET(args->src.info.buffer,
+                                        offset * dt_size);
+    targs->src.info.count  = frag_count;
+    return UCC_OK;
+}
+
+static ucc_status_t
+ucc_tl_ucp_bcast_knomial_frag_init(ucc_base_coll_args_t     *coll_args,
+                                   ucc_schedule_pipelined_t *sp, //NOLINT
+                                   ucc_base_team_t          *team,
+                                   ucc_schedule_t          **frag_p)
+{
+    ucc_tl_ucp_team_t *tl_team = ucc_derived_of(team, ucc_tl_ucp_team_t);
+    ucc_schedule_t    *schedule;
+    ucc_tl_ucp_task_t *task;
+    ucc_status_t       status;
+
+    status = ucc_tl_ucp_get_schedule(tl_team, coll_args,
+                                     (ucc_tl_ucp_schedule_t **)&schedule);
+    if (ucc_unlikely(UCC_OK != status)) {
+        return status;
+    }
+    task = ucc_tl_ucp_init_task(coll_args, team);
+    UCC_CHECK_GOTO(ucc_tl_ucp_bcast_init(task), err_task, status);
+    UCC_CHECK_GOTO(ucc_schedule_add_task(schedule, &task->super), err_task,
+                   status);
+    UCC_CHECK_GOTO(ucc_task_subscribe_dep(&schedule->super, &task->super,
+                                          UCC_EVENT_SCHEDULE_STARTED),
+                   err_sched, status);
+    schedule->super.finalize = ucc_tl_ucp_bcast_knomial_frag_finalize;
+    schedule->super.post     = ucc_tl_ucp_bcast_knomial_frag_start;
+    *frag_p                  = schedule;
+    return UCC_OK;
+err_task:
+    ucc_tl_ucp_put_task(task);
+err_sched:
+    ucc_tl_ucp_put_schedule(schedule);
+    return status;
+}
+
+static ucc_status_t
+ucc_tl_ucp_bcast_knomial_pipelined_finalize(ucc_coll_task_t *task)
+{
+    ucc_schedule_t *schedule = ucc_derived_of(task, ucc_schedule_t);
+    ucc_status_t    status;
+
+    UCC_TL_UCP_PROFILE_REQUEST_EVENT(schedule, "ucp_bcast_kn_pipe_done", 0);
+    status = ucc_schedule_pipelined_finalize(task);
+    ucc_tl_ucp_put_schedule(schedule);
+    return status;
+}
+
+static ucc_status_t
+ucc_tl_ucp_bcast_knomial_pipelined_start(ucc_coll_task_t *task)
+{
+    UCC_TL_UCP_PROFILE_REQUEST_EVENT(task, "ucp_bcast_kn_pipe_start", 0);
+    return ucc_schedule_pipelined_post(task);
+}
+
+/* Large messages are split into fragments, each fragment is broadcast with
+   its own knomial task. Up to BCAST_KN_PIPELINE_DEPTH fragments are in
+   flight, so the inner ranks of the tree forward fragment i while fragment
+   i + 1 is being received, instead of storing and forwarding the whole
+   buffer at every level. */
+ucc_status_t
+ucc_tl_ucp_bcast_knomial_pipelined_init(ucc_base_coll_args_t *coll_args,
+                                        ucc_base_team_t      *team,
+                                        int n_frags, int pipeline_depth,
+                                        ucc_coll_task_t     **task_h)
+{
+    ucc_tl_ucp_team_t        *tl_team = ucc_derived_of(team,
+                                                       ucc_tl_ucp_team_t);
+    ucc_schedule_pipelined_t *schedule_p;
+    ucc_status_t              status;
+
+    status = ucc_tl_ucp_get_schedule(tl_team, coll_args,
+                                     (ucc_tl_ucp_schedule_t **)&schedule_p);
+    if (ucc_unlikely(UCC_OK != status)) {
+        return status;
+    }
+    status = ucc_schedule_pipelined_init(
+        coll_args, team, ucc_tl_ucp_bcast_knomial_frag_init,
+        ucc_tl_ucp_bcast_knomial_frag_setup, pipeline_depth, n_frags,
+        UCC_PIPELINE_PARALLEL, schedule_p);
+    if (UCC_OK != status) {
+        tl_error(team->context->lib, "failed to init pipelined schedule");
+        ucc_tl_ucp_put_schedule(&schedule_p->super);
+        return status;
+    }
+    schedule_p->super.super.finalize =
+        ucc_tl_ucp_bcast_knomial_pipelined_finalize;
+    schedule_p->super.super.triggered_post = ucc_triggered_post;
+    schedule_p->super.super.post = ucc_tl_ucp_bcast_knomial_pipelined_start;
+    *task_h                      = &schedule_p->super.super;
+    return UCC_OK;
+}
@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "config.h"
+#include "tl_ucp.h"
+#include "bcast.h"
+#include "core/ucc_progress_queue.h"
+#include "tl_ucp_sendrecv.h"
+#include "utils/ucc_math.h"
+
+/* One-sided knomial bcast: data is pushed down the knomial tree with puts.
+   A non-root rank waits for the sync counter in the global work buffer to be
+   signaled by its parent and then forwards the data to its own children.
+   Each rank receives exactly one signal, so there is no contention on the
+   counters regardless of the team size. */
+ucc_status_t ucc_tl_ucp_bcast_onesided_start(ucc_coll_task_t *ctask)
+{
+    ucc_tl_ucp_task_t *task = ucc_derived_of(ctask, ucc_tl_ucp_task_t);
+    ucc_tl_ucp_team_t *team = TASK_TEAM(task);
+    ucc_rank_t         size = UCC_TL_TEAM_SIZE(team);
+
+    ucc_tl_ucp_task_reset(task, UCC_INPROGRESS);
+    CALC_KN_TREE_DIST(size, task->bcast_kn.radix, task->bcast_kn.dist);
+    return ucc_progress_queue_enqueue(UCC_TL_CORE_CTX(team)->pq, &task->super);
+}
+
+void ucc_tl_ucp_bcast_onesided_progress(ucc_coll_task_t *ctask)
+{
+    ucc_tl_ucp_task_t *task      = ucc_derived_of(ctask, ucc_tl_ucp_task_t);
+    ucc_tl_ucp_team_t *team      = TASK_TEAM(task);
+    ucc_coll_args_t   *args      = &TASK_ARGS(task);
+    ucc_rank_t         rank      = UCC_TL_TEAM_RANK(team);
+    ucc_rank_t         size      = UCC_TL_TEAM_SIZE(team);
+    ucc_rank_t         root      = (ucc_rank_t)args->root;
+    uint32_t           radix     = task->bcast_kn.radix;
+    ucc_rank_t         vrank     = VRANK(rank, root, size);
+    void              *buffer    = args->src.info.buffer;
+    long *             pSync     = args->global_work_buffer;
+    size_t             data_size = args->src.info.count *
+                                   ucc_dt_size(args->src.info.datatype);
+    ucc_rank_t         dist, vpeer;
+    uint32_t           i;
+
+    if (task->bcast_kn.dist > 0) {
+        if ((vrank != 0) && (*pSync < 1)) {
+            ucp_worker_progress(UCC_TL_UCP_ONESIDED_WORKER(team));
+            return;
+        }
+        for (dist = task->bcast_kn.dist; dist >= 1; dist /= radix) {
+            if (vrank % (dist * radix) != 0) {
+                /* not a parent at this level of the tree */
+                continue;
+            }
+            for (i = 1; i < radix; i++) {
+                vpeer = vrank + i * dist;
+                if (vpeer >= size) {
+                    break;
+                }
+                UCPCHECK_GOTO(ucc_tl_ucp_put_signal_nb(
+                                  buffer, buffer, data_size, pSync,
+                                  INV_VRANK(vpeer, root, size), team, task),
+                              task, out);
+            }
+        }
+        task->bcast_kn.dist = 0;
+    }
+
+    if (task->onesided.put_completed < task->onesided.put_posted) {
+        ucp_worker_progress(UCC_TL_UCP_ONESIDED_WORKER(team));
+        return;
+    }
+
+    pSync[0]           = 0;
+    task->super.status = UCC_OK;
+out:
+    return;
+}
+
+ucc_status_t ucc_tl_ucp_bcast_onesided_init(ucc_base_coll_args_t *coll_args,
+                                            ucc_base_team_t      *team,
+                                            ucc_coll_task_t     **task_h)
+{
+    ucc_tl_ucp_team_t *tl_team = ucc_derived_of(team, ucc_tl_ucp_team_t);
+    ucc_tl_ucp_task_t *task;
+    ucc_status_t       status;
+
+    status = ucc_tl_ucp_onesided_check_args(coll_args, tl_team);
+    if (ucc_unlikely(UCC_OK != status)) {
+        return status;
+    }
+    task                 = ucc_tl_ucp_init_task(coll_args, team);
+    task->bcast_kn.radix =
+        ucc_min(UCC_TL_UCP_TEAM_LIB(tl_team)->cfg.bcast_kn_radix,
+                UCC_TL_TEAM_SIZE(tl_team));
+    task->super.post     = ucc_tl_ucp_bcast_onesided_start;
+    task->super.progress = ucc_tl_ucp_bcast_onesided_progress;
+    *task_h              = &task->super;
+    return UCC_OK;
+}
@@ -67,14 +67,9 @@ ucc_tl_ucp_bcast_sag_knomial_init(ucc_base_coll_args_t *coll_args,
     ucc_status_t         status;
     ucc_kn_radix_t       radix, cfg_radix;
 
-    if (UCC_COLL_ARGS_ACTIVE_SET(&coll_args->args)) {
-        /* ActiveSets currently are only supported with KN alg */
-        return ucc_tl_ucp_bcast_knomial_init(coll_args, team, task_h);
-    }
-
     cfg_radix = UCC_TL_UCP_TEAM_LIB(tl_team)->cfg.bcast_sag_kn_radix;
-    radix = ucc_knomial_pattern_get_min_radix(cfg_radix,
-                                              UCC_TL_TEAM_SIZE(tl_team), count);
+    radix = ucc_knomial_pattern_get_min_radix(
+        cfg_radix, UCC_TL_UCP_COLL_SIZE(tl_team, &coll_args->args), count);
     status = ucc_tl_ucp_get_schedule(tl_team, coll_args,
                                      (ucc_tl_ucp_schedule_t **)&schedule);
     if (ucc_unlikely(UCC_OK != status)) {
@@ -19,7 +19,7 @@ ucc_base_coll_alg_info_t
 ucc_status_t ucc_tl_ucp_fanin_init(ucc_tl_ucp_task_t *task)
 {
     ucc_tl_ucp_team_t *team      = TASK_TEAM(task);
-    ucc_rank_t         team_size = UCC_TL_TEAM_SIZE(team);
+    ucc_rank_t         team_size = (ucc_rank_t)task->subset.map.ep_num;
     ucc_status_t       status    = UCC_OK;
 
     TASK_ARGS(task).src.info.buffer   = NULL;
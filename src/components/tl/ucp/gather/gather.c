@@ -32,8 +32,8 @@ ucc_status_t ucc_tl_ucp_gather_init(ucc_tl_ucp_task_t *task)
 {
     ucc_coll_args_t *  args      = &TASK_ARGS(task);
     ucc_tl_ucp_team_t *team      = TASK_TEAM(task);
-    ucc_rank_t         myrank    = UCC_TL_TEAM_RANK(team);
-    ucc_rank_t         team_size = UCC_TL_TEAM_SIZE(team);
+    ucc_rank_t         myrank    = task->subset.myrank;
+    ucc_rank_t         team_size = (ucc_rank_t)task->subset.map.ep_num;
     ucc_rank_t         root      = args->root;
     ucc_rank_t         vrank     = (myrank - root + team_size) % team_size;
     ucc_status_t       status    = UCC_OK;
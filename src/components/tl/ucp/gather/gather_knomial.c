@@ -20,9 +20,9 @@ void ucc_tl_ucp_gather_knomial_progress(ucc_coll_task_t *coll_task)
     ucc_tl_ucp_task_t *task      = ucc_derived_of(coll_task, ucc_tl_ucp_task_t);
     ucc_coll_args_t *  args      = &TASK_ARGS(task);
     ucc_tl_ucp_team_t *team      = TASK_TEAM(task);
-    ucc_rank_t         team_size = UCC_TL_TEAM_SIZE(team);
-    ucc_rank_t         rank      = UCC_TL_TEAM_RANK(team);
-    ucc_rank_t         size      = UCC_TL_TEAM_SIZE(team);
+    ucc_rank_t         team_size = (ucc_rank_t)task->subset.map.ep_num;
+    ucc_rank_t         rank      = task->subset.myrank;
+    ucc_rank_t         size      = (ucc_rank_t)task->subset.map.ep_num;
     ucc_rank_t         root      = (ucc_rank_t)args->root;
     uint32_t           radix     = task->gather_kn.radix;
     ucc_rank_t         vrank     = (rank - root + size) % size;
@@ -32,7 +32,7 @@ void ucc_tl_ucp_gather_knomial_progress(ucc_coll_task_t *coll_task)
         args->src.info.count * ucc_dt_size(args->src.info.datatype);
     size_t     msg_size, msg_count;
     void *     scratch_offset;
-    ucc_rank_t vpeer, peer, vroot_at_level, root_at_level, pos;
+    ucc_rank_t vpeer, peer, ep, vroot_at_level, root_at_level, pos;
     uint32_t   i;
 
 UCC_GATHER_KN_PHASE_PROGRESS:
@@ -58,12 +58,15 @@ UCC_GATHER_KN_PHASE_INIT:
                         scratch_offset = PTR_OFFSET(
                             scratch_offset, data_size * task->gather_kn.dist);
                         peer = (vpeer + root) % size;
+                        ep   = ucc_ep_map_eval(task->subset.map, peer);
                         UCPCHECK_GOTO(ucc_tl_ucp_recv_nb(scratch_offset,
-                                                         msg_size, mtype, peer,
+                                                         msg_size, mtype, ep,
                                                          team, task),
                                       task, out);
                     } else { //The root is a particular case because it must aggregate the data sorted by ranks
                         peer           = (vpeer + root) % size;
+                        ep             = ucc_ep_map_eval(task->subset.map,
+                                                         peer);
                         scratch_offset = PTR_OFFSET(task->gather_kn.scratch,
                                                     data_size * peer);
                         // check if received data correspond to contiguous ranks
@@ -71,20 +74,20 @@ UCC_GATHER_KN_PHASE_INIT:
                             msg_size = data_size * msg_count;
                             UCPCHECK_GOTO(ucc_tl_ucp_recv_nb(scratch_offset,
                                                              msg_size, mtype,
-                                                             peer, team, task),
+                                                             ep, team, task),
                                           task, out);
                         } else { // in this case, data must be split in two at the destination buffer
                             msg_size = data_size * (team_size - peer);
                             UCPCHECK_GOTO(ucc_tl_ucp_recv_nb(scratch_offset,
                                                              msg_size, mtype,
-                                                             peer, team, task),
+                                                             ep, team, task),
                                           task, out);
 
                             msg_size =
                                 data_size * (msg_count - (team_size - peer));
                             UCPCHECK_GOTO(ucc_tl_ucp_recv_nb(
                                               task->gather_kn.scratch, msg_size,
-                                              mtype, peer, team, task),
+                                              mtype, ep, team, task),
                                           task, out);
                         }
                     }
@@ -111,26 +114,28 @@ UCC_GATHER_KN_PHASE_INIT:
             } else {
                 vroot_at_level = vrank - pos * task->gather_kn.dist;
                 root_at_level  = (vroot_at_level + root) % size;
+                ep             = ucc_ep_map_eval(task->subset.map,
+                                                 root_at_level);
                 msg_count      = ucc_min(task->gather_kn.dist,
                                                             team_size - vrank);
                 msg_size       = data_size * msg_count;
                 if (root_at_level != root || msg_count <= team_size - rank) {
                     UCPCHECK_GOTO(ucc_tl_ucp_send_nb(task->gather_kn.scratch,
                                                      msg_size, mtype,
-                                                     root_at_level, team, task),
+                                                     ep, team, task),
                                   task, out);
                 } else {
                     msg_size = data_size * (team_size - rank);
                     UCPCHECK_GOTO(ucc_tl_ucp_send_nb(task->gather_kn.scratch,
                                                      msg_size, mtype,
-                                                     root_at_level, team, task),
+                                                     ep, team, task),
                                   task, out);
                     msg_size = data_size * (msg_count - (team_size - rank));
                     UCPCHECK_GOTO(
                         ucc_tl_ucp_send_nb(
                             PTR_OFFSET(task->gather_kn.scratch,
                                        data_size * (team_size - rank)),
-                            msg_size, mtype, root_at_level, team, task),
+                            msg_size, mtype, ep, team, task),
                         task, out);
                 }
             }
@@ -153,8 +158,8 @@ ucc_status_t ucc_tl_ucp_gather_knomial_start(ucc_coll_task_t *coll_task)
     ucc_coll_args_t *  args = &TASK_ARGS(task);
     ucc_tl_ucp_team_t *team = TASK_TEAM(task);
     ucc_rank_t         root = (ucc_rank_t)args->root;
-    ucc_rank_t         rank = UCC_TL_TEAM_RANK(team);
-    ucc_rank_t         size = UCC_TL_TEAM_SIZE(team);
+    ucc_rank_t         rank = task->subset.myrank;
+    ucc_rank_t         size = (ucc_rank_t)task->subset.map.ep_num;
 
     if (root == rank && UCC_IS_INPLACE(*args)) {
         args->src.info       = args->dst.info;
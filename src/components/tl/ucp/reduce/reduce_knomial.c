@@ -10,6 +10,7 @@
 #include "tl_ucp_sendrecv.h"
 #include "utils/ucc_math.h"
 #include "utils/ucc_dt_reduce.h"
+#include "utils/ucc_coll_utils.h"
 
 #define SAVE_STATE(_phase)                                                     \
     do {                                                                       \
@@ -24,8 +25,8 @@ void ucc_tl_ucp_reduce_knomial_progress(ucc_coll_task_t *coll_task)
     ucc_tl_ucp_team_t *team       = TASK_TEAM(task);
     int                avg_pre_op =
         UCC_TL_UCP_TEAM_LIB(team)->cfg.reduce_avg_pre_op;
-    ucc_rank_t         rank       = UCC_TL_TEAM_RANK(team);
-    ucc_rank_t         size       = UCC_TL_TEAM_SIZE(team);
+    ucc_rank_t         rank       = task->subset.myrank;
+    ucc_rank_t         size       = (ucc_rank_t)task->subset.map.ep_num;
     ucc_rank_t         root       = (ucc_rank_t)args->root;
     uint32_t           radix      = task->reduce_kn.radix;
     ucc_rank_t         vrank      = (rank - root + size) % size;
@@ -74,7 +75,8 @@ UCC_REDUCE_KN_PHASE_INIT:
                     	break;
                     } else {
                         task->reduce_kn.children_per_cycle += 1;
-                        peer = (vpeer + root) % size;
+                        peer = ucc_ep_map_eval(task->subset.map,
+                                               (vpeer + root) % size);
                         UCPCHECK_GOTO(ucc_tl_ucp_recv_nb(scratch_offset,
                                           data_size, mtype, peer, team, task),
                                           task, out);
@@ -108,7 +110,8 @@ UCC_REDUCE_KN_PHASE_MULTI:
                 }
             } else {
                 vroot_at_level = vrank - pos * task->reduce_kn.dist;
-                root_at_level  = (vroot_at_level + root) % size;
+                root_at_level  = ucc_ep_map_eval(task->subset.map,
+                                    (vroot_at_level + root) % size);
                 UCPCHECK_GOTO(ucc_tl_ucp_send_nb(task->reduce_kn.scratch,
                                   data_size, mtype, root_at_level, team, task),
                                   task, out);
@@ -134,8 +137,8 @@ ucc_status_t ucc_tl_ucp_reduce_knomial_start(ucc_coll_task_t *coll_task)
     ucc_tl_ucp_team_t *team       = TASK_TEAM(task);
     uint32_t           radix      = task->reduce_kn.radix;
     ucc_rank_t         root       = (ucc_rank_t)args->root;
-    ucc_rank_t         rank       = UCC_TL_TEAM_RANK(team);
-    ucc_rank_t         size       = UCC_TL_TEAM_SIZE(team);
+    ucc_rank_t         rank       = task->subset.myrank;
+    ucc_rank_t         size       = (ucc_rank_t)task->subset.map.ep_num;
     ucc_rank_t         vrank      = (rank - root + size) % size;
     int                isleaf     =
         (vrank % radix != 0 || vrank == size - 1);
@@ -182,7 +185,7 @@ ucc_status_t ucc_tl_ucp_reduce_knomial_start(ucc_coll_task_t *coll_task)
             ucc_dt_reduce(args->src.info.buffer, args->src.info.buffer,
                           task->reduce_kn.scratch, count, dt, args,
                           UCC_EEE_TASK_FLAG_REDUCE_WITH_ALPHA,
-                          1.0 / (double)(UCC_TL_TEAM_SIZE(TASK_TEAM(task)) * 2),
+                          1.0 / (double)(size * 2),
                           task->reduce_kn.executor, &task->reduce_kn.etask);
         if (ucc_unlikely(UCC_OK != status)) {
             tl_error(UCC_TASK_LIB(task),
@@ -209,3 +212,179 @@ ucc_status_t ucc_tl_ucp_reduce_knomial_finalize(ucc_coll_task_t *coll_task)
     }
     return ucc_tl_ucp_coll_finalize(coll_task);
 }
+
+static ucc_status_t
+ucc_tl_ucp_reduce_knomial_frag_start(ucc_coll_task_t *task)
+{
+    return ucc_schedule_start(task);
+}
+
+static ucc_status_t
+ucc_tl_ucp_reduce_knomial_frag_finalize(ucc_coll_task_t *task)
+{
+    ucc_schedule_t *schedule = ucc_derived_of(task, ucc_schedule_t);
+    ucc_status_t    status;
+
+    status = ucc_schedule_finalize(task);
+    ucc_tl_ucp_put_schedule(schedule);
+    return status;
+}
+
+static ucc_status_t
+ucc_tl_ucp_reduce_knomial_frag_setup(ucc_schedule_pipelined_t *schedule_p,
+                                     ucc_schedule_t *frag, int frag_num)
+{
+    ucc_coll_args_t   *args    = &schedule_p->super.super.bargs.args;
+    ucc_tl_ucp_team_t *team    = ucc_derived_of(schedule_p->super.super.team,
+                                                ucc_tl_ucp_team_t);
+    int                is_root = (UCC_TL_TEAM_RANK(team) == args->root);
+    ucc_coll_buffer_info_t *info = is_root ? &args->dst.info : &args->src.info;
+    size_t             dt_size = ucc_dt_size(info->datatype);
+    int                n_frags = schedule_p->super.n_tasks;
+    size_t             frag_count, offset;
+    ucc_coll_args_t   *targs;
+
+    frag_count = ucc_buffer_block_count(info->count, n_frags, frag_num);
+    offset     = ucc_buffer_block_offset(info->count, n_frags, frag_num);
+    targs      = &frag->tasks[0]->bargs.args;
+    if (is_root) {
+        targs->dst.info.buffer = PTR_OFFSET(args->dst.info.buffer,
+                                            offset * dt_size);
+        targs->dst.info.count  = frag_count;
+    }
+    if (!is_root || !UCC_IS_INPLACE(*args)) {
+        targs->src.info.buffer = PTR_OFFSET(args->src.info.buffer,
+                                            offset * dt_size);
+        targs->src.info.count  = frag_count;
+    }
+    return UCC_OK;
+}
+
+static ucc_status_t
+ucc_tl_ucp_reduce_knomial_frag_init(ucc_base_coll_args_t     *coll_args,
+                                    ucc_schedule_pipelined_t *sp, //NOLINT
+                                    ucc_base_team_t          *team,
+                                    ucc_schedule_t          **frag_p)
+{
+    ucc_tl_ucp_team_t *tl_team = ucc_derived_of(team, ucc_tl_ucp_team_t);
+    ucc_schedule_t    *schedule;
+    ucc_tl_ucp_task_t *task;
+    ucc_status_t       status;
+
+    status = ucc_tl_ucp_get_schedule(tl_team, coll_args,
+                                     (ucc_tl_ucp_schedule_t **)&schedule);
+    if (ucc_unlikely(UCC_OK != status)) {
+        return status;
+    }
+    task = ucc_tl_ucp_init_task(coll_args, team);
+    UCC_CHECK_GOTO(ucc_tl_ucp_reduce_init(task), err_task, status);
+    UCC_CHECK_GOTO(ucc_schedule_add_task(schedule, &task->super), err_task,
+                   status);
+    UCC_CHECK_GOTO(ucc_task_subscribe_dep(&schedule->super, &task->super,
+                                          UCC_EVENT_SCHEDULE_STARTED),
+                   err_sched, status);
+    schedule->super.finalize = ucc_tl_ucp_reduce_knomial_frag_finalize;
+    schedule->super.post     = ucc_tl_ucp_reduce_knomial_frag_start;
+    *frag_p                  = schedule;
+    return UCC_OK;
+err_task:
+    ucc_tl_ucp_put_task(task);
+err_sched:
+    ucc_tl_ucp_put_schedule(schedule);
+    return status;
+}
+
+static ucc_status_t
+ucc_tl_ucp_reduce_knomial_pipelined_finalize(ucc_coll_task_t *task)
+{
+    ucc_schedule_t *schedule = ucc_derived_of(task, ucc_schedule_t);
+    ucc_status_t    status;
+
+    UCC_TL_UCP_PROFILE_REQUEST_EVENT(schedule, "ucp_reduce_kn_pipe_done", 0);
+    status = ucc_schedule_pipelined_finalize(task);
+    ucc_tl_ucp_put_schedule(schedule);
+    return status;
+}
+
+static ucc_status_t
+ucc_tl_ucp_reduce_knomial_pipelined_start(ucc_coll_task_t *task)
+{
+    UCC_TL_UCP_PROFILE_REQUEST_EVENT(task, "ucp_reduce_kn_pipe_start", 0);
+    return ucc_schedule_pipelined_post(task);
+}
+
+/* Large messages are split into fragments reduced by separate knomial
+   tasks, up to REDUCE_KN_PIPELINE_DEPTH of them in flight. Inner ranks of
+   the tree reduce and forward fragment i while the children are sending
+   fragment i + 1. The scratch of every fragment task is sized by the
+   largest fragment (UCC_BASE_CARGS_MAX_FRAG_COUNT). */
+static ucc_status_t
+ucc_tl_ucp_reduce_knomial_pipelined_init(ucc_base_coll_args_t *coll_args,
+                                         ucc_base_team_t      *team,
+                                         size_t count, int n_frags,
+                                         int               pipeline_depth,
+                                         ucc_coll_task_t **task_h)
+{
+    ucc_tl_ucp_team_t        *tl_team = ucc_derived_of(team,
+                                                       ucc_tl_ucp_team_t);
+    ucc_base_coll_args_t      bargs   = *coll_args;
+    ucc_schedule_pipelined_t *schedule_p;
+    ucc_status_t              status;
+
+    status = ucc_tl_ucp_get_schedule(tl_team, coll_args,
+                                     (ucc_tl_ucp_schedule_t **)&schedule_p);
+    if (ucc_unlikely(UCC_OK != status)) {
+        return status;
+    }
+    bargs.mask          |= UCC_BASE_CARGS_MAX_FRAG_COUNT;
+    bargs.max_frag_count = ucc_buffer_block_count(count, n_frags, 0);
+
+    status = ucc_schedule_pipelined_init(
+        &bargs, team, ucc_tl_ucp_reduce_knomial_frag_init,
+        ucc_tl_ucp_reduce_knomial_frag_setup, pipeline_depth, n_frags,
+        UCC_PIPELINE_PARALLEL, schedule_p);
+    if (UCC_OK != status) {
+        tl_error(team->context->lib, "failed to init pipelined schedule");
+        ucc_tl_ucp_put_schedule(&schedule_p->super);
+        return status;
+    }
+    schedule_p->super.super.finalize =
+        ucc_tl_ucp_reduce_knomial_pipelined_finalize;
+    schedule_p->super.super.triggered_post = ucc_triggered_post;
+    schedule_p->super.super.post = ucc_tl_ucp_reduce_knomial_pipelined_start;
+    *task_h                      = &schedule_p->super.super;
+    return UCC_OK;
+}
+
+ucc_status_t ucc_tl_ucp_reduce_knomial_init(ucc_base_coll_args_t *coll_args,
+                                            ucc_base_team_t      *team,
+                                            ucc_coll_task_t     **task_h)
+{
+    ucc_tl_ucp_team_t       *tl_team = ucc_derived_of(team, ucc_tl_ucp_team_t);
+    ucc_tl_ucp_lib_config_t *cfg     = &UCC_TL_UCP_TEAM_LIB(tl_team)->cfg;
+    ucc_coll_args_t         *args    = &coll_args->args;
+    ucc_coll_buffer_info_t  *info;
+    ucc_tl_ucp_task_t       *task;
+    ucc_status_t             status;
+    int                      n_frags, pipeline_depth;
+
+    info = (UCC_TL_TEAM_RANK(tl_team) == args->root) ? &args->dst.info
+                                                     : &args->src.info;
+    UCC_TL_UCP_KN_PIPELINE_N_FRAGS(info->count * ucc_dt_size(info->datatype),
+                                   cfg->reduce_kn_frag_size,
+                                   cfg->reduce_kn_pipeline_depth, n_frags,
+                                   pipeline_depth);
+    /* fragments of an active set collective would share the same tag */
+    if (n_frags > 1 && !UCC_COLL_ARGS_ACTIVE_SET(args)) {
+        return ucc_tl_ucp_reduce_knomial_pipelined_init(
+            coll_args, team, info->count, n_frags, pipeline_depth, task_h);
+    }
+    task   = ucc_tl_ucp_init_task(coll_args, team);
+    status = ucc_tl_ucp_reduce_init(task);
+    if (ucc_unlikely(UCC_OK != status)) {
+        ucc_tl_ucp_put_task(task);
+        return status;
+    }
+    *task_h = &task->super;
+    return UCC_OK;
+}
@@ -6,6 +6,8 @@
 #ifndef REDUCE_SCATTER_H_
 #define REDUCE_SCATTER_H_
 #include "tl_ucp_coll.h"
+#include "utils/ucc_math.h"
+#include "utils/ucc_coll_utils.h"
 
 enum
 {
@@ -42,6 +44,85 @@ ucc_status_t ucc_tl_ucp_reduce_scatter_knomial_init_r(
     ucc_base_coll_args_t *coll_args, ucc_base_team_t *team,
     ucc_coll_task_t **task_h, ucc_kn_radix_t radix);
 
+/* KN reduce scatter that sends float32 data compressed to 16 bit: partial
+   sums stay in float32, only the transfers are converted. If wire_out is
+   set by the caller the local result is also stored there in the wire
+   format, at the same element offset as in dst. */
+ucc_status_t ucc_tl_ucp_reduce_scatter_knomial_init_compress_r(
+    ucc_base_coll_args_t *coll_args, ucc_base_team_t *team,
+    ucc_coll_task_t **task_h, ucc_kn_radix_t radix,
+    ucc_tl_ucp_compress_t compress);
+
+/* Compressed transfers are supported for float32 sum and average on host */
+static inline int ucc_tl_ucp_compress_supported(ucc_coll_args_t *args)
+{
+    return args->dst.info.datatype == UCC_DT_FLOAT32 &&
+           (args->op == UCC_OP_SUM || args->op == UCC_OP_AVG) &&
+           args->dst.info.mem_type == UCC_MEMORY_TYPE_HOST &&
+           (UCC_IS_INPLACE(*args) ||
+            args->src.info.mem_type == UCC_MEMORY_TYPE_HOST);
+}
+
+static inline void ucc_tl_ucp_compress(void *dst, const float *src,
+                                       size_t count,
+                                       ucc_tl_ucp_compress_t compress)
+{
+    uint16_t *d = dst;
+    size_t    i;
+
+    if (compress == UCC_TL_UCP_COMPRESS_BF16) {
+        for (i = 0; i < count; i++) {
+            float32tobfloat16(src[i], &d[i]);
+        }
+    } else {
+        for (i = 0; i < count; i++) {
+            float32tofloat16(src[i], &d[i]);
+        }
+    }
+}
+
+static inline float ucc_tl_ucp_decompress_one(const uint16_t       *src,
+                                              ucc_tl_ucp_compress_t compress)
+{
+    return (compress == UCC_TL_UCP_COMPRESS_BF16) ? bfloat16tofloat32(src)
+                                                  : float16tofloat32(src);
+}
+
+static inline void ucc_tl_ucp_decompress(float *dst, const void *src,
+                                         size_t count,
+                                         ucc_tl_ucp_compress_t compress)
+{
+    const uint16_t *s = src;
+    size_t          i;
+
+    for (i = 0; i < count; i++) {
+        dst[i] = ucc_tl_ucp_decompress_one(&s[i], compress);
+    }
+}
+
+/* dst = (local + sum of n_srcs compressed vectors located stride elements
+   apart) * alpha */
+static inline void ucc_tl_ucp_reduce_compressed(float *dst, const float *local,
+                                                const void *srcs,
+                                                ucc_rank_t n_srcs,
+                                                size_t count, size_t stride,
+                                                double alpha,
+                                                ucc_tl_ucp_compress_t compress)
+{
+    const uint16_t *s = srcs;
+    size_t          i;
+    ucc_rank_t      j;
+    float           acc;
+
+    for (i = 0; i < count; i++) {
+        acc = local[i];
+        for (j = 0; j < n_srcs; j++) {
+            acc += ucc_tl_ucp_decompress_one(&s[j * stride + i], compress);
+        }
+        dst[i] = (alpha != 1.0) ? (float)(acc * alpha) : acc;
+    }
+}
+
 ucc_status_t
 ucc_tl_ucp_reduce_scatter_ring_init(ucc_base_coll_args_t *coll_args,
                                     ucc_base_team_t *     team,
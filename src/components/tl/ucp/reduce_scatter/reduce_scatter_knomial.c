@@ -15,6 +15,85 @@
         task->reduce_scatter_kn.phase = _phase;                                \
     } while (0)
 
+#define IS_COMPRESSED(_task)                                                   \
+    ((_task)->reduce_scatter_kn.compress != UCC_TL_UCP_COMPRESS_NONE)
+
+/* Size of an element on the wire */
+#define WIRE_DT_SIZE(_task, _dt)                                               \
+    (IS_COMPRESSED(_task) ? sizeof(uint16_t) : ucc_dt_size(_dt))
+
+/* Posts the p2p of one chunk of the current step: chunk "chunk" of the
+   segment of every peer is sent and chunk "chunk" of the local segment is
+   received from every peer. Chunk 0 is always posted, even if empty, so that
+   the number of messages matches on both sides. */
+static inline ucc_status_t
+ucc_tl_ucp_reduce_scatter_knomial_post_chunk(ucc_tl_ucp_task_t *task,
+                                             void *sbuf, void *rbuf,
+                                             size_t     block_count,
+                                             ucc_rank_t step_radix, int chunk)
+{
+    ucc_coll_args_t       *args        = &TASK_ARGS(task);
+    ucc_tl_ucp_team_t     *team        = TASK_TEAM(task);
+    ucc_knomial_pattern_t *p           = &task->reduce_scatter_kn.p;
+    ucc_kn_radix_t         radix       = p->radix;
+    ucc_memory_type_t      mem_type    = args->dst.info.mem_type;
+    size_t                 dt_size     =
+        WIRE_DT_SIZE(task, args->dst.info.datatype);
+    size_t                 chunk_count = task->reduce_scatter_kn.chunk_count;
+    size_t                 chunk_start = chunk * chunk_count;
+    ucc_rank_t             rank        = task->subset.myrank;
+    ucc_rank_t             size        = (ucc_rank_t)task->subset.map.ep_num;
+    size_t                 peer_seg_count, local_seg_count, peer_seg_offset;
+    ucc_rank_t             peer, peer_seg_index, local_seg_index;
+    ucc_kn_radix_t         loop_step;
+    ucc_status_t           status;
+
+    for (loop_step = 1; loop_step < radix; loop_step++) {
+        peer = ucc_knomial_pattern_get_loop_peer(p, rank, size, loop_step);
+        if (peer == UCC_KN_PEER_NULL)
+            continue;
+
+        peer_seg_index  = ucc_sra_kn_compute_seg_index(peer, p->radix_pow, p);
+        peer_seg_count  = ucc_sra_kn_compute_seg_size(block_count, step_radix,
+                                                      peer_seg_index);
+        peer_seg_offset = ucc_sra_kn_compute_seg_offset(block_count, step_radix,
+                                                        peer_seg_index);
+        if (chunk > 0 && chunk_start >= peer_seg_count) {
+            continue;
+        }
+        peer   = ucc_ep_map_eval(task->subset.map, peer);
+        status = ucc_tl_ucp_send_nb(
+            PTR_OFFSET(sbuf, (peer_seg_offset + chunk_start) * dt_size),
+            ucc_min(chunk_count, peer_seg_count - chunk_start) * dt_size,
+            mem_type, peer, team, task);
+        if (ucc_unlikely(UCC_OK != status)) {
+            return status;
+        }
+    }
+
+    local_seg_index = ucc_sra_kn_compute_seg_index(rank, p->radix_pow, p);
+    local_seg_count = ucc_sra_kn_compute_seg_size(block_count, step_radix,
+                                                  local_seg_index);
+    if (chunk > 0 && chunk_start >= local_seg_count) {
+        return UCC_OK;
+    }
+    rbuf = PTR_OFFSET(rbuf, chunk_start * dt_size);
+    for (loop_step = 1; loop_step < radix; loop_step++) {
+        peer = ucc_knomial_pattern_get_loop_peer(p, rank, size, loop_step);
+        if (peer == UCC_KN_PEER_NULL)
+            continue;
+        peer   = ucc_ep_map_eval(task->subset.map, peer);
+        status = ucc_tl_ucp_recv_nb(
+            rbuf, ucc_min(chunk_count, local_seg_count - chunk_start) * dt_size,
+            mem_type, peer, team, task);
+        if (ucc_unlikely(UCC_OK != status)) {
+            return status;
+        }
+        rbuf = PTR_OFFSET(rbuf, local_seg_count * dt_size);
+    }
+    return UCC_OK;
+}
+
 void ucc_tl_ucp_reduce_scatter_knomial_progress(ucc_coll_task_t *coll_task)
 {
     ucc_tl_ucp_task_t     *task  = ucc_derived_of(coll_task, ucc_tl_ucp_task_t);
@@ -34,32 +113,50 @@ void ucc_tl_ucp_reduce_scatter_knomial_progress(ucc_coll_task_t *coll_task)
         rbuf : args->src.info.buffer;
     size_t                 dt_size    = ucc_dt_size(dt);
     size_t                 data_size  = count * dt_size;
-    ucc_rank_t             rank       = UCC_TL_TEAM_RANK(team);
-    ucc_rank_t             size       = UCC_TL_TEAM_SIZE(team);
-    ptrdiff_t              peer_seg_offset, local_seg_offset, offset;
-    ucc_rank_t             peer, step_radix, peer_seg_index, local_seg_index;
+    ucc_rank_t             rank       = task->subset.myrank;
+    ucc_rank_t             size       = (ucc_rank_t)task->subset.map.ep_num;
+    ptrdiff_t              local_seg_offset, offset;
+    ucc_rank_t             peer, step_radix, local_seg_index;
     ucc_status_t           status;
     ucc_kn_radix_t         loop_step;
-    size_t                 block_count, peer_seg_count, local_seg_count;
+    size_t                 chunk_count = task->reduce_scatter_kn.chunk_count;
+    size_t                 block_count, local_seg_count, max_seg_count;
+    size_t                 chunk_offset;
     void                  *reduce_data, *local_data;
-    int                    is_avg;
+    int                    is_avg, chunk;
+    ucc_rank_t             n_peers;
     ucc_ee_executor_task_args_t eargs;
+    ucc_tl_ucp_compress_t  compress   = task->reduce_scatter_kn.compress;
+    void                  *wire_send  = task->reduce_scatter_kn.wire_send;
+    void                  *wire_recv  = task->reduce_scatter_kn.wire_recv;
+    void                  *wsbuf, *wrbuf;
 
     local_seg_count = 0;
     block_count     = ucc_sra_kn_compute_block_count(count, rank, p);
     UCC_KN_REDUCE_GOTO_PHASE(task->reduce_scatter_kn.phase);
 
+    if (IS_COMPRESSED(task)) {
+        data_size = count * sizeof(uint16_t);
+    }
     if (KN_NODE_EXTRA == node_type) {
-        peer = ucc_knomial_pattern_get_proxy(p, rank);
+        peer  = ucc_ep_map_eval(task->subset.map,
+                                ucc_knomial_pattern_get_proxy(p, rank));
+        wsbuf = sbuf;
+        if (IS_COMPRESSED(task)) {
+            ucc_tl_ucp_compress(wire_send, sbuf, count, compress);
+            wsbuf = wire_send;
+        }
         UCPCHECK_GOTO(
-            ucc_tl_ucp_send_nb(sbuf, data_size, mem_type, peer, team, task),
+            ucc_tl_ucp_send_nb(wsbuf, data_size, mem_type, peer, team, task),
             task, out);
     }
 
     if (KN_NODE_PROXY == node_type) {
-        peer = ucc_knomial_pattern_get_extra(p, rank);
+        peer  = ucc_ep_map_eval(task->subset.map,
+                                ucc_knomial_pattern_get_extra(p, rank));
+        wrbuf = IS_COMPRESSED(task) ? wire_recv : scratch;
         UCPCHECK_GOTO(
-            ucc_tl_ucp_recv_nb(scratch, data_size, mem_type, peer, team, task),
+            ucc_tl_ucp_recv_nb(wrbuf, data_size, mem_type, peer, team, task),
             task, out);
     }
 
@@ -71,6 +168,9 @@ UCC_KN_PHASE_EXTRA:
         }
         if (KN_NODE_EXTRA == node_type) {
             goto out;
+        } else if (IS_COMPRESSED(task)) {
+            ucc_tl_ucp_reduce_compressed(rbuf, sbuf, wire_recv, 1, count,
+                                         count, 1.0, compress);
         } else {
             status = ucc_dt_reduce(sbuf, scratch, rbuf, count, dt, args, 0, 0,
                                    task->reduce_scatter_kn.executor,
@@ -94,47 +194,33 @@ UCC_KN_PHASE_EXTRA_REDUCE:
                                  ? args->dst.info.buffer
                                  : args->src.info.buffer)
                           : task->reduce_scatter_kn.scratch;
-        for (loop_step = 1; loop_step < radix; loop_step++) {
-            peer = ucc_knomial_pattern_get_loop_peer(p, rank, size, loop_step);
-            if (peer == UCC_KN_PEER_NULL)
-                continue;
-
-            peer_seg_index =
-                ucc_sra_kn_compute_seg_index(peer, p->radix_pow, p);
-            peer_seg_count = ucc_sra_kn_compute_seg_size(
-                block_count, step_radix, peer_seg_index);
-            peer_seg_offset = ucc_sra_kn_compute_seg_offset(
-                block_count, step_radix, peer_seg_index);
-            UCPCHECK_GOTO(
-                ucc_tl_ucp_send_nb(PTR_OFFSET(sbuf, peer_seg_offset * dt_size),
-                                   peer_seg_count * dt_size, mem_type, peer,
-                                   team, task),
-                task, out);
-        }
-
-        local_seg_index = ucc_sra_kn_compute_seg_index(rank, p->radix_pow, p);
-        local_seg_count = ucc_sra_kn_compute_seg_size(block_count, step_radix,
-                                                      local_seg_index);
-
-        rbuf = task->reduce_scatter_kn.scratch;
+        rbuf        = task->reduce_scatter_kn.scratch;
         if (!ucc_knomial_pattern_loop_first_iteration(p)) {
             rbuf = PTR_OFFSET(rbuf, block_count * dt_size);
         }
-        for (loop_step = 1; loop_step < radix; loop_step++) {
-            peer = ucc_knomial_pattern_get_loop_peer(p, rank, size, loop_step);
-            if (peer == UCC_KN_PEER_NULL)
-                continue;
-            UCPCHECK_GOTO(ucc_tl_ucp_recv_nb(rbuf, local_seg_count * dt_size,
-                                             mem_type, peer, team, task),
-                          task, out);
-            rbuf = PTR_OFFSET(rbuf, local_seg_count * dt_size);
+        if (IS_COMPRESSED(task)) {
+            ucc_tl_ucp_compress(wire_send, sbuf, block_count, compress);
+            sbuf = wire_send;
+            rbuf = wire_recv;
         }
+        task->reduce_scatter_kn.chunk = 0;
+        UCPCHECK_GOTO(ucc_tl_ucp_reduce_scatter_knomial_post_chunk(
+                          task, sbuf, rbuf, block_count, step_radix, 0),
+                      task, out);
     UCC_KN_PHASE_LOOP:
         if (UCC_INPROGRESS == ucc_tl_ucp_test(task)) {
             SAVE_STATE(UCC_KN_PHASE_LOOP);
             return;
         }
-        if (task->tagged.send_posted > p->iteration * (radix - 1)) {
+        n_peers = 0;
+        for (loop_step = 1; loop_step < radix; loop_step++) {
+            if (ucc_knomial_pattern_get_loop_peer(p, rank, size, loop_step) !=
+                UCC_KN_PEER_NULL) {
+                n_peers++;
+            }
+        }
+        if (n_peers > 0) {
+            chunk      = task->reduce_scatter_kn.chunk;
             sbuf       = (ucc_knomial_pattern_loop_first_iteration(p))
                              ? ((KN_NODE_PROXY == node_type || UCC_IS_INPLACE(*args))
                                     ? args->dst.info.buffer
@@ -145,6 +231,20 @@ UCC_KN_PHASE_EXTRA_REDUCE:
                                     block_count * dt_size)
                              : task->reduce_scatter_kn.scratch;
             step_radix = ucc_sra_kn_compute_step_radix(rank, size, p);
+            max_seg_count = ucc_sra_kn_compute_seg_size(block_count,
+                                                        step_radix, 0);
+            task->reduce_scatter_kn.n_chunks =
+                max_seg_count / chunk_count +
+                ((max_seg_count % chunk_count) ? 1 : 0);
+            wsbuf = IS_COMPRESSED(task) ? wire_send : sbuf;
+            wrbuf = IS_COMPRESSED(task) ? wire_recv : rbuf;
+            /* keep the next chunk in flight while this one is reduced */
+            if (chunk + 1 < task->reduce_scatter_kn.n_chunks) {
+                UCPCHECK_GOTO(ucc_tl_ucp_reduce_scatter_knomial_post_chunk(
+                                  task, wsbuf, wrbuf, block_count, step_radix,
+                                  chunk + 1),
+                              task, out);
+            }
             local_seg_index =
                 ucc_sra_kn_compute_seg_index(rank, p->radix_pow, p);
             local_seg_count = ucc_sra_kn_compute_seg_size(
@@ -163,22 +263,44 @@ UCC_KN_PHASE_EXTRA_REDUCE:
                                                  &offset, &local_seg_count);
                 reduce_data = PTR_OFFSET(args->dst.info.buffer, offset);
             }
-            status = ucc_dt_reduce_strided(
-                local_data, rbuf, reduce_data,
-                task->tagged.send_posted - p->iteration * (radix - 1),
-                local_seg_count, local_seg_count * dt_size, dt, args,
-                is_avg ? UCC_EEE_TASK_FLAG_REDUCE_WITH_ALPHA : 0,
-                AVG_ALPHA(task), task->reduce_scatter_kn.executor,
-                &task->reduce_scatter_kn.etask);
-            if (ucc_unlikely(UCC_OK != status)) {
-                tl_error(UCC_TASK_LIB(task), "failed to perform dt reduction");
-                task->super.status = status;
-                return;
+            task->reduce_scatter_kn.etask = NULL;
+            if (IS_COMPRESSED(task) &&
+                (chunk == 0 || chunk * chunk_count < local_seg_count)) {
+                chunk_offset = chunk * chunk_count;
+                ucc_tl_ucp_reduce_compressed(
+                    PTR_OFFSET(reduce_data, chunk_offset * dt_size),
+                    PTR_OFFSET(local_data, chunk_offset * dt_size),
+                    PTR_OFFSET(wrbuf, chunk_offset * sizeof(uint16_t)),
+                    n_peers,
+                    ucc_min(chunk_count, local_seg_count - chunk_offset),
+                    local_seg_count, is_avg ? AVG_ALPHA(task) : 1.0,
+                    compress);
+            } else if (chunk == 0 || chunk * chunk_count < local_seg_count) {
+                chunk_offset = chunk * chunk_count * dt_size;
+                status = ucc_dt_reduce_strided(
+                    PTR_OFFSET(local_data, chunk_offset),
+                    PTR_OFFSET(rbuf, chunk_offset),
+                    PTR_OFFSET(reduce_data, chunk_offset), n_peers,
+                    ucc_min(chunk_count, local_seg_count - chunk * chunk_count),
+                    local_seg_count * dt_size, dt, args,
+                    is_avg ? UCC_EEE_TASK_FLAG_REDUCE_WITH_ALPHA : 0,
+                    AVG_ALPHA(task), task->reduce_scatter_kn.executor,
+                    &task->reduce_scatter_kn.etask);
+                if (ucc_unlikely(UCC_OK != status)) {
+                    tl_error(UCC_TASK_LIB(task),
+                             "failed to perform dt reduction");
+                    task->super.status = status;
+                    return;
+                }
             }
 UCC_KN_PHASE_REDUCE:
             EXEC_TASK_TEST(UCC_KN_PHASE_REDUCE,
                            "failed to perform dt reduction",
                            task->reduce_scatter_kn.etask);
+            if (++task->reduce_scatter_kn.chunk <
+                task->reduce_scatter_kn.n_chunks) {
+                goto UCC_KN_PHASE_LOOP;
+            }
         }
         ucc_knomial_pattern_next_iteration(p);
     }
@@ -201,6 +323,15 @@ UCC_KN_PHASE_REDUCE:
         EXEC_TASK_TEST(UCC_KN_PHASE_COMPLETE, "failed to perform memcpy",
                        task->reduce_scatter_kn.etask);
     }
+    if (IS_COMPRESSED(task) && task->reduce_scatter_kn.wire_out) {
+        ucc_sra_kn_get_offset_and_seglen(count, 1, rank, size, radix, &offset,
+                                         &local_seg_count);
+        ucc_tl_ucp_compress(
+            PTR_OFFSET(task->reduce_scatter_kn.wire_out,
+                       offset * sizeof(uint16_t)),
+            PTR_OFFSET(args->dst.info.buffer, offset * dt_size),
+            local_seg_count, compress);
+    }
 UCC_KN_PHASE_PROXY: /* unused label */
 out:
     UCC_TL_UCP_PROFILE_REQUEST_EVENT(coll_task, "ucp_reduce_scatter_kn_done",
@@ -213,15 +344,12 @@ ucc_status_t ucc_tl_ucp_reduce_scatter_knomial_start(ucc_coll_task_t *coll_task)
     ucc_tl_ucp_task_t *task = ucc_derived_of(coll_task, ucc_tl_ucp_task_t);
     ucc_coll_args_t   *args = &TASK_ARGS(task);
     ucc_tl_ucp_team_t *team = TASK_TEAM(task);
-    ucc_rank_t         rank = UCC_TL_TEAM_RANK(team);
-    ucc_rank_t         size = UCC_TL_TEAM_SIZE(team);
     ucc_status_t       status;
 
     UCC_TL_UCP_PROFILE_REQUEST_EVENT(coll_task, "ucp_reduce_scatter_kn_start",
                                      0);
     ucc_tl_ucp_task_reset(task, UCC_INPROGRESS);
-    ucc_knomial_pattern_init(size, rank, task->reduce_scatter_kn.p.radix,
-                             &task->reduce_scatter_kn.p);
+    ucc_knomial_pattern_reset(&task->reduce_scatter_kn.p);
     if (!task->reduce_scatter_kn.scratch_mc_header) {
         task->reduce_scatter_kn.scratch = args->dst.info.buffer;
     }
@@ -243,26 +371,31 @@ ucc_tl_ucp_reduce_scatter_knomial_finalize(ucc_coll_task_t *coll_task)
     if (task->reduce_scatter_kn.scratch_mc_header) {
         ucc_mc_free(task->reduce_scatter_kn.scratch_mc_header);
     }
+    if (task->reduce_scatter_kn.wire_mc_header) {
+        ucc_mc_free(task->reduce_scatter_kn.wire_mc_header);
+    }
     return ucc_tl_ucp_coll_finalize(coll_task);
 }
 
-ucc_status_t ucc_tl_ucp_reduce_scatter_knomial_init_r(
+ucc_status_t ucc_tl_ucp_reduce_scatter_knomial_init_compress_r(
     ucc_base_coll_args_t *coll_args, ucc_base_team_t *team,
-    ucc_coll_task_t **task_h, ucc_kn_radix_t radix)
+    ucc_coll_task_t **task_h, ucc_kn_radix_t radix,
+    ucc_tl_ucp_compress_t compress)
 {
     ucc_tl_ucp_team_t *tl_team   = ucc_derived_of(team, ucc_tl_ucp_team_t);
-    ucc_rank_t         rank      = UCC_TL_TEAM_RANK(tl_team);
-    ucc_rank_t         size      = UCC_TL_TEAM_SIZE(tl_team);
     size_t             count     = coll_args->args.dst.info.count;
     ucc_datatype_t     dt        = coll_args->args.dst.info.datatype;
     size_t             dt_size   = ucc_dt_size(dt);
     ucc_memory_type_t  mem_type  = coll_args->args.dst.info.mem_type;
     ucc_tl_ucp_task_t *task;
     ucc_status_t       status;
-    size_t             max_recv_size, data_size;
+    size_t             max_recv_size, data_size, wire_count;
     ucc_kn_radix_t     step_radix;
+    ucc_rank_t         rank, size;
 
     task                 = ucc_tl_ucp_init_task(coll_args, team);
+    rank                 = task->subset.myrank;
+    size                 = (ucc_rank_t)task->subset.map.ep_num;
     task->super.flags    |= UCC_COLL_TASK_FLAG_EXECUTOR;
     task->super.post     = ucc_tl_ucp_reduce_scatter_knomial_start;
     task->super.progress = ucc_tl_ucp_reduce_scatter_knomial_progress;
@@ -270,19 +403,32 @@ ucc_status_t ucc_tl_ucp_reduce_scatter_knomial_init_r(
 
     ucc_assert(coll_args->args.src.info.mem_type ==
                coll_args->args.dst.info.mem_type);
-    ucc_knomial_pattern_init(size, rank, radix, &task->reduce_scatter_kn.p);
+    ucc_knomial_pattern_init(size, rank, ucc_min(radix, size),
+                             &task->reduce_scatter_kn.p);
     task->reduce_scatter_kn.scratch_mc_header = NULL;
+    task->reduce_scatter_kn.chunk_count       = ucc_max(1,
+        UCC_TL_UCP_TEAM_LIB(tl_team)->cfg.reduce_scatter_kn_chunk_size /
+        dt_size);
+    task->reduce_scatter_kn.compress          =
+        ucc_tl_ucp_compress_supported(&coll_args->args) ?
+        compress : UCC_TL_UCP_COMPRESS_NONE;
+    task->reduce_scatter_kn.wire_out          = NULL;
+    task->reduce_scatter_kn.wire_mc_header    = NULL;
+    if (coll_args->mask & UCC_BASE_CARGS_MAX_FRAG_COUNT) {
+        count = coll_args->max_frag_count;
+    }
+    /* compressed send buffer followed by the compressed receive buffer,
+       extra ranks only send */
+    wire_count = count;
 
     if (KN_NODE_EXTRA != task->reduce_scatter_kn.p.node_type) {
-        if (coll_args->mask & UCC_BASE_CARGS_MAX_FRAG_COUNT) {
-            count = coll_args->max_frag_count;
-        }
         data_size = count * dt_size;
         step_radix =
             ucc_sra_kn_compute_step_radix(rank, size,
                                           &task->reduce_scatter_kn.p);
         max_recv_size = ucc_sra_kn_compute_seg_size(count, step_radix, 0) *
             step_radix * dt_size;
+        wire_count   += ucc_max(count, max_recv_size / dt_size);
 
         if (UCC_IS_INPLACE(coll_args->args) ||
             (KN_NODE_PROXY == task->reduce_scatter_kn.p.node_type) ||
@@ -297,17 +443,39 @@ ucc_status_t ucc_tl_ucp_reduce_scatter_knomial_init_r(
         }
     }
 
+    if (task->reduce_scatter_kn.compress != UCC_TL_UCP_COMPRESS_NONE) {
+        status = ucc_mc_alloc(&task->reduce_scatter_kn.wire_mc_header,
+                              wire_count * sizeof(uint16_t), mem_type);
+        if (UCC_OK != status) {
+            return status;
+        }
+        task->reduce_scatter_kn.wire_send =
+            task->reduce_scatter_kn.wire_mc_header->addr;
+        task->reduce_scatter_kn.wire_recv =
+            PTR_OFFSET(task->reduce_scatter_kn.wire_send,
+                       count * sizeof(uint16_t));
+    }
+
     *task_h = &task->super;
     return UCC_OK;
 }
 
+ucc_status_t ucc_tl_ucp_reduce_scatter_knomial_init_r(
+    ucc_base_coll_args_t *coll_args, ucc_base_team_t *team,
+    ucc_coll_task_t **task_h, ucc_kn_radix_t radix)
+{
+    return ucc_tl_ucp_reduce_scatter_knomial_init_compress_r(
+        coll_args, team, task_h, radix, UCC_TL_UCP_COMPRESS_NONE);
+}
+
 ucc_status_t
 ucc_tl_ucp_reduce_scatter_knomial_init(ucc_base_coll_args_t *coll_args,
                                        ucc_base_team_t *     team,
                                        ucc_coll_task_t **    task_h)
 {
     ucc_tl_ucp_team_t *tl_team = ucc_derived_of(team, ucc_tl_ucp_team_t);
-    ucc_rank_t         size    = UCC_TL_TEAM_SIZE(tl_team);
+    ucc_rank_t         size    = UCC_TL_UCP_COLL_SIZE(tl_team,
+                                                      &coll_args->args);
     size_t             count   = coll_args->args.dst.info.count;
     ucc_kn_radix_t     radix, cfg_radix;
 
@@ -49,8 +49,7 @@ static void send_completion_2(void *request, ucs_status_t status,
 static inline void ucc_ring_frag_count(ucc_tl_ucp_task_t *task, size_t count,
                                        ucc_rank_t block, size_t *frag_count)
 {
-    ucc_tl_ucp_team_t *team = TASK_TEAM(task);
-    size_t             size = UCC_TL_TEAM_SIZE(team);
+    size_t             size = task->subset.map.ep_num;
     int                n_frags, frag;
     size_t             block_count;
 
@@ -66,8 +65,7 @@ static inline void ucc_ring_frag_block_offset(ucc_tl_ucp_task_t *task,
                                               size_t *block_offset,
                                               size_t *frag_offset)
 {
-    ucc_tl_ucp_team_t *team = TASK_TEAM(task);
-    size_t             size = UCC_TL_TEAM_SIZE(team);
+    size_t             size = task->subset.map.ep_num;
     int                n_frags, frag;
     size_t             block_count;
 
@@ -88,7 +86,7 @@ static inline ucc_status_t ucc_tl_ucp_test_ring(ucc_tl_ucp_task_t *task)
             task->tagged.recv_posted == task->tagged.recv_completed) {
             return UCC_OK;
         }
-        ucp_worker_progress(TASK_CTX(task)->ucp_worker);
+        ucc_tl_ucp_team_progress(TASK_TEAM(task));
     }
     return UCC_INPROGRESS;
 }
@@ -100,7 +98,7 @@ static void ucc_tl_ucp_reduce_scatter_ring_progress(ucc_coll_task_t *coll_task)
     ucc_coll_args_t        *args     = &TASK_ARGS(task);
     ucc_tl_ucp_team_t      *team     = TASK_TEAM(task);
     ucc_rank_t              size     = task->subset.map.ep_num;
-    ucc_rank_t              rank     = task->subset.myrank;
+    ucc_rank_t              rank     = task->reduce_scatter_ring.pos;
     void                   *sbuf     = args->src.info.buffer;
     ucc_memory_type_t       mem_type = args->dst.info.mem_type;
     size_t                  count    = args->dst.info.count * size;
@@ -121,11 +119,13 @@ static void ucc_tl_ucp_reduce_scatter_ring_progress(ucc_coll_task_t *coll_task)
         sbuf = args->dst.info.buffer;
         count /= size;
         final_offset =
-            ucc_buffer_block_offset(count, size, UCC_TL_TEAM_RANK(team));
+            ucc_buffer_block_offset(count, size, task->subset.myrank);
     }
 
     sendto   = ucc_ep_map_eval(task->reduce_scatter_ring.inv_map, sendto);
     recvfrom = ucc_ep_map_eval(task->reduce_scatter_ring.inv_map, recvfrom);
+    sendto   = ucc_ep_map_eval(task->subset.map, sendto);
+    recvfrom = ucc_ep_map_eval(task->subset.map, recvfrom);
 
     max_block_size = task->reduce_scatter_ring.max_block_count * dt_size;
     busy           = task->reduce_scatter_ring.s_scratch_busy;
@@ -212,7 +212,7 @@ ucc_tl_ucp_reduce_scatter_ring_start(ucc_coll_task_t *coll_task)
     ucc_coll_args_t *  args     = &TASK_ARGS(task);
     ucc_tl_ucp_team_t *team     = TASK_TEAM(task);
     ucc_rank_t         size     = task->subset.map.ep_num;
-    ucc_rank_t         rank     = task->subset.myrank;
+    ucc_rank_t         rank     = task->reduce_scatter_ring.pos;
     ucc_rank_t         sendto   = (rank + 1) % size;
     ucc_rank_t         recvfrom = (rank - 1 + size) % size;
     size_t             count    = args->dst.info.count * size;
@@ -239,6 +239,8 @@ ucc_tl_ucp_reduce_scatter_ring_start(ucc_coll_task_t *coll_task)
 
     sendto     = ucc_ep_map_eval(task->reduce_scatter_ring.inv_map, sendto);
     recvfrom   = ucc_ep_map_eval(task->reduce_scatter_ring.inv_map, recvfrom);
+    sendto     = ucc_ep_map_eval(task->subset.map, sendto);
+    recvfrom   = ucc_ep_map_eval(task->subset.map, recvfrom);
     r_scratch  = task->reduce_scatter_ring.scratch;
     recv_block = (rank - 2 - step + size) % size;
     send_block = (rank - 1 - step + size) % size;
@@ -263,41 +265,22 @@ out:
     return task->super.status;
 }
 
-static ucc_status_t
-ucc_tl_ucp_reduce_scatter_ring_finalize(ucc_coll_task_t *coll_task)
-{
-    ucc_tl_ucp_task_t *task = ucc_derived_of(coll_task, ucc_tl_ucp_task_t);
-
-    if (task->reduce_scatter_ring.inv_map.type != UCC_EP_MAP_FULL) {
-        ucc_ep_map_destroy(&task->reduce_scatter_ring.inv_map);
-    }
-    return ucc_tl_ucp_coll_finalize(coll_task);
-}
-
 static ucc_status_t ucc_tl_ucp_reduce_scatter_ring_init_subset(
     ucc_base_coll_args_t *coll_args, ucc_base_team_t *team,
-    ucc_coll_task_t **task_h, ucc_subset_t subset, int n_frags, int frag,
+    ucc_coll_task_t **task_h, ucc_tl_ucp_ring_t *ring, int n_frags, int frag,
     void *scratch, size_t max_block_count)
 {
     ucc_tl_ucp_task_t *task;
-    ucc_status_t       status;
 
     task                 = ucc_tl_ucp_init_task(coll_args, team);
     task->super.post     = ucc_tl_ucp_reduce_scatter_ring_start;
     task->super.progress = ucc_tl_ucp_reduce_scatter_ring_progress;
-    task->super.finalize = ucc_tl_ucp_reduce_scatter_ring_finalize;
-    task->subset         = subset;
-
-    if (task->subset.map.type != UCC_EP_MAP_FULL) {
-        status = ucc_ep_map_create_inverse(task->subset.map,
-                                           &task->reduce_scatter_ring.inv_map);
-        if (UCC_OK != status) {
-            return status;
-        }
-    } else {
-        task->reduce_scatter_ring.inv_map.type   = UCC_EP_MAP_FULL;
-        task->reduce_scatter_ring.inv_map.ep_num = task->subset.map.ep_num;
-    }
+    /* task->subset keeps the endpoints (team or active set), the ring only
+       orders them. Ring maps are either cached on the team or plain, nothing
+       to destroy in finalize */
+    task->reduce_scatter_ring.pos               =
+        ucc_ep_map_eval(ring->map, task->subset.myrank);
+    task->reduce_scatter_ring.inv_map           = ring->inv_map;
     task->reduce_scatter_ring.n_frags           = n_frags;
     task->reduce_scatter_ring.frag              = frag;
     task->reduce_scatter_ring.scratch           = scratch;
@@ -334,7 +317,8 @@ ucc_tl_ucp_reduce_scatter_ring_init(ucc_base_coll_args_t *coll_args,
 {
 
     ucc_tl_ucp_team_t *tl_team  = ucc_derived_of(team, ucc_tl_ucp_team_t);
-    ucc_rank_t         size     = UCC_TL_TEAM_SIZE(tl_team);
+    ucc_rank_t         size     = UCC_TL_UCP_COLL_SIZE(tl_team,
+                                                       &coll_args->args);
     size_t             count    = coll_args->args.dst.info.count;
     ucc_datatype_t     dt       = coll_args->args.dst.info.datatype;
     size_t             dt_size  = ucc_dt_size(dt);
@@ -346,7 +330,7 @@ ucc_tl_ucp_reduce_scatter_ring_init(ucc_base_coll_args_t *coll_args,
     ucc_schedule_t        *schedule;
     ucc_coll_task_t       *ctask;
     ucc_status_t           status;
-    ucc_subset_t           s[2];
+    ucc_tl_ucp_ring_t     *ring, as_ring;
     int                    i, n_subsets;
 
     if (UCC_TL_UCP_TEAM_LIB(tl_team)->cfg.reduce_avg_pre_op &&
@@ -365,16 +349,10 @@ ucc_tl_ucp_reduce_scatter_ring_init(ucc_base_coll_args_t *coll_args,
 
     schedule     = &tl_schedule->super.super;
     /* if count == size then we have 1 elem per rank, not enough
-       to split into 2 sets */
-    n_subsets    = (bidir && (count > size)) ? 2 : 1;
-
-    s[0].myrank     = UCC_TL_TEAM_RANK(tl_team);
-    s[0].map.type   = UCC_EP_MAP_FULL;
-    s[0].map.ep_num = UCC_TL_TEAM_SIZE(tl_team);
-
-    s[1].map    = ucc_ep_map_create_reverse(UCC_TL_TEAM_SIZE(tl_team));
-    s[1].myrank = ucc_ep_map_eval(s[1].map, UCC_TL_TEAM_RANK(tl_team));
-
+       to split into 2 sets. The two directions of an active set would
+       share the active set tag, so it always uses a single ring. */
+    n_subsets    = (bidir && (count > size) &&
+                    !UCC_COLL_ARGS_ACTIVE_SET(&coll_args->args)) ? 2 : 1;
 
     count_per_set    = (count + n_subsets - 1) / n_subsets;
     max_segcount     = ucc_buffer_block_count(count_per_set, size, 0);
@@ -387,8 +365,15 @@ ucc_tl_ucp_reduce_scatter_ring_init(ucc_base_coll_args_t *coll_args,
                    out, status);
 
     for (i = 0; i < n_subsets; i++) {
+        if (UCC_COLL_ARGS_ACTIVE_SET(&coll_args->args)) {
+            ucc_tl_ucp_ring_init_plain(size, i, &as_ring);
+            ring = &as_ring;
+        } else {
+            UCC_CHECK_GOTO(ucc_tl_ucp_team_get_ring(tl_team, i, &ring),
+                           out_free, status);
+        }
         UCC_CHECK_GOTO(ucc_tl_ucp_reduce_scatter_ring_init_subset(
-                           coll_args, team, &ctask, s[i], n_subsets, i,
+                           coll_args, team, &ctask, ring, n_subsets, i,
                            PTR_OFFSET(tl_schedule->scratch_mc_header->addr,
                                       to_alloc_per_set * i * dt_size),
                            max_segcount),
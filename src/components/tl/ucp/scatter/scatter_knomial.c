@@ -63,8 +63,8 @@ void ucc_tl_ucp_scatter_knomial_progress(ucc_coll_task_t *coll_task)
     ucc_datatype_t         dt        = args->src.info.datatype;
     size_t                 dt_size   = ucc_dt_size(dt);
     ucc_rank_t             root      = (ucc_rank_t)args->root;
-    ucc_rank_t             size      = UCC_TL_TEAM_SIZE(team);
-    ucc_rank_t             rank      = VRANK(UCC_TL_TEAM_RANK(team), root, size);
+    ucc_rank_t             size      = (ucc_rank_t)task->subset.map.ep_num;
+    ucc_rank_t             rank      = VRANK(task->subset.myrank, root, size);
     ucc_rank_t             team_size = size - p->n_extra;
     void                  *sbuf;
     ucc_rank_t             peer, vroot, vpeer, peer_recv_dist;
@@ -113,10 +113,11 @@ void ucc_tl_ucp_scatter_knomial_progress(ucc_coll_task_t *coll_task)
                 peer_recv_dist =
                     calc_recv_dist(team_size, vpeer, radix, vroot);
                 if (peer_recv_dist < task->scatter_kn.recv_dist) {
+                    peer = ucc_ep_map_eval(task->subset.map,
+                               INV_VRANK(peer, (ucc_rank_t)args->root, size));
                     UCPCHECK_GOTO(ucc_tl_ucp_recv_nb(rbuf,
                                   local_seg_count * dt_size, mem_type,
-                                  INV_VRANK(peer, (ucc_rank_t)args->root,
-                                  size), team, task), task, out);
+                                  peer, team, task), task, out);
                     goto UCC_SCATTER_KN_PHASE_LOOP;
                 }
             }
@@ -143,10 +144,12 @@ void ucc_tl_ucp_scatter_knomial_progress(ucc_coll_task_t *coll_task)
                     block_count, step_radix, peer_seg_index);
                 peer_seg_offset = ucc_sra_kn_compute_seg_offset(
                     block_count, step_radix, peer_seg_index);
+                peer = ucc_ep_map_eval(task->subset.map,
+                           INV_VRANK(peer, (ucc_rank_t)args->root, size));
                 UCPCHECK_GOTO(ucc_tl_ucp_send_nb(PTR_OFFSET(sbuf,
                     peer_seg_offset * dt_size + task->scatter_kn.send_offset),
-                    peer_seg_count * dt_size, mem_type, INV_VRANK(peer,
-                    (ucc_rank_t)args->root, size), team, task), task, out);
+                    peer_seg_count * dt_size, mem_type, peer, team, task),
+                    task, out);
             }
             local_seg_index =
                 ucc_sra_kn_compute_seg_index(rank, p->radix_pow, p);
@@ -183,8 +186,8 @@ ucc_status_t ucc_tl_ucp_scatter_knomial_start(ucc_coll_task_t *coll_task)
 {
     ucc_tl_ucp_task_t     *task = ucc_derived_of(coll_task, ucc_tl_ucp_task_t);
     ucc_tl_ucp_team_t     *team = TASK_TEAM(task);
-    ucc_rank_t             size = UCC_TL_TEAM_SIZE(team);
-    ucc_rank_t             rank = UCC_TL_TEAM_RANK(team);
+    ucc_rank_t             size = (ucc_rank_t)task->subset.map.ep_num;
+    ucc_rank_t             rank = task->subset.myrank;
     ucc_knomial_pattern_t *p    = &task->scatter_kn.p;
     ucc_rank_t             vrank, vroot, root;
 
@@ -214,12 +217,11 @@ ucc_status_t ucc_tl_ucp_scatter_knomial_init_r(
     ucc_base_coll_args_t *coll_args, ucc_base_team_t *team,
     ucc_coll_task_t **task_h, ucc_kn_radix_t radix)
 {
-    ucc_tl_ucp_team_t *tl_team = ucc_derived_of(team, ucc_tl_ucp_team_t);
-    ucc_rank_t         size    = UCC_TL_TEAM_SIZE(tl_team);
-    ucc_rank_t         rank    = UCC_TL_TEAM_RANK(tl_team);
     ucc_tl_ucp_task_t *task;
+    ucc_rank_t         size;
 
     task                 = ucc_tl_ucp_init_task(coll_args, team);
+    size                 = (ucc_rank_t)task->subset.map.ep_num;
     task->super.post     = ucc_tl_ucp_scatter_knomial_start;
     task->super.progress = ucc_tl_ucp_scatter_knomial_progress;
     task->super.finalize = ucc_tl_ucp_scatter_knomial_finalize;
@@ -227,7 +229,8 @@ ucc_status_t ucc_tl_ucp_scatter_knomial_init_r(
     ucc_assert(coll_args->args.src.info.mem_type ==
                coll_args->args.dst.info.mem_type);
 
-    ucc_knomial_pattern_init(size, rank, radix, &task->scatter_kn.p);
+    ucc_knomial_pattern_init(size, task->subset.myrank, ucc_min(radix, size),
+                             &task->scatter_kn.p);
 
     *task_h = &task->super;
     return UCC_OK;
@@ -243,7 +246,7 @@ ucc_tl_ucp_scatter_knomial_init(ucc_base_coll_args_t *coll_args,
     ucc_kn_radix_t     radix, cfg_radix;
 
     cfg_radix = UCC_TL_UCP_TEAM_LIB(tl_team)->cfg.scatter_kn_radix;
-    radix = ucc_knomial_pattern_get_min_radix(cfg_radix,
-                                              UCC_TL_TEAM_SIZE(tl_team), count);
+    radix = ucc_knomial_pattern_get_min_radix(
+        cfg_radix, UCC_TL_UCP_COLL_SIZE(tl_team, &coll_args->args), count);
     return ucc_tl_ucp_scatter_knomial_init_r(coll_args, team, task_h, radix);
 }
@@ -27,6 +27,20 @@ ucc_status_t ucc_tl_ucp_get_lib_attr(const ucc_base_lib_t *lib,
 ucc_status_t ucc_tl_ucp_get_context_attr(const ucc_base_context_t *context,
                                          ucc_base_ctx_attr_t      *base_attr);
 
+const char *ucc_tl_ucp_pairwise_schedule_names[] = {
+    [UCC_TL_UCP_PAIRWISE_SCHEDULE_ROTATED] = "rotated",
+    [UCC_TL_UCP_PAIRWISE_SCHEDULE_RANDOM]  = "random",
+    [UCC_TL_UCP_PAIRWISE_SCHEDULE_NODE]    = "node",
+    [UCC_TL_UCP_PAIRWISE_SCHEDULE_LAST]    = NULL
+};
+
+const char *ucc_tl_ucp_compress_names[] = {
+    [UCC_TL_UCP_COMPRESS_NONE] = "none",
+    [UCC_TL_UCP_COMPRESS_BF16] = "bf16",
+    [UCC_TL_UCP_COMPRESS_FP16] = "fp16",
+    [UCC_TL_UCP_COMPRESS_LAST] = NULL
+};
+
 static ucc_config_field_t ucc_tl_ucp_lib_config_table[] = {
     {"", "", NULL, ucc_offsetof(ucc_tl_ucp_lib_config_t, super),
      UCC_CONFIG_TYPE_TABLE(ucc_tl_lib_config_table)},
@@ -43,6 +57,56 @@ static ucc_config_field_t ucc_tl_ucp_lib_config_table[] = {
      ucc_offsetof(ucc_tl_ucp_lib_config_t, alltoallv_pairwise_num_posts),
      UCC_CONFIG_TYPE_UINT},
 
+    {"ALLTOALL_PAIRWISE_ADAPTIVE", "n",
+     "Adapt the number of outstanding messages of alltoall pairwise algorithm "
+     "to the observed completion latency: it grows while the latency stays "
+     "close to the best one and halves when the fabric gets congested. "
+     "ALLTOALL_PAIRWISE_NUM_POSTS gives the initial value",
+     ucc_offsetof(ucc_tl_ucp_lib_config_t, alltoall_pairwise_adaptive),
+     UCC_CONFIG_TYPE_BOOL},
+
+    {"ALLTOALLV_PAIRWISE_ADAPTIVE", "n",
+     "Adapt the number of outstanding messages of alltoallv pairwise "
+     "algorithm to the observed completion latency. "
+     "ALLTOALLV_PAIRWISE_NUM_POSTS gives the initial value",
+     ucc_offsetof(ucc_tl_ucp_lib_config_t, alltoallv_pairwise_adaptive),
+     UCC_CONFIG_TYPE_BOOL},
+
+    {"ALLTOALL_PAIRWISE_SCHEDULE", "rotated",
+     "Peer order of alltoall pairwise algorithm:\n"
+     "rotated - step i sends to rank - i and receives from rank + i\n"
+     "random  - steps are visited in a pseudo random order that changes on "
+     "every call\n"
+     "node    - ranks are rotated in the host grouped order of "
+     "RING_TOPO_ORDER, so every node talks to few nodes at a time",
+     ucc_offsetof(ucc_tl_ucp_lib_config_t, alltoall_pairwise_schedule),
+     UCC_CONFIG_TYPE_ENUM(ucc_tl_ucp_pairwise_schedule_names)},
+
+    {"ALLTOALLV_PAIRWISE_SCHEDULE", "rotated",
+     "Peer order of alltoallv pairwise algorithm: rotated, random or node, "
+     "see ALLTOALL_PAIRWISE_SCHEDULE",
+     ucc_offsetof(ucc_tl_ucp_lib_config_t, alltoallv_pairwise_schedule),
+     UCC_CONFIG_TYPE_ENUM(ucc_tl_ucp_pairwise_schedule_names)},
+
+    {"ALLTOALLV_SPARSE_THRESH", "10",
+     "Percentage of peers with non zero send or receive counts at or below "
+     "which the default alltoallv algorithm is replaced with the sparse one, "
+     "that posts only the non empty transfers, 0 - disable",
+     ucc_offsetof(ucc_tl_ucp_lib_config_t, alltoallv_sparse_thresh),
+     UCC_CONFIG_TYPE_UINT},
+
+    {"ALLTOALL_ONESIDED_NUM_POSTS", "8",
+     "Maximum number of outstanding puts in alltoall onesided algorithm, "
+     "0 - no limit",
+     ucc_offsetof(ucc_tl_ucp_lib_config_t, alltoall_onesided_num_posts),
+     UCC_CONFIG_TYPE_UINT},
+
+    {"ALLTOALLV_ONESIDED_NUM_POSTS", "8",
+     "Maximum number of outstanding puts in alltoallv onesided algorithm, "
+     "0 - no limit",
+     ucc_offsetof(ucc_tl_ucp_lib_config_t, alltoallv_onesided_num_posts),
+     UCC_CONFIG_TYPE_UINT},
+
     {"KN_RADIX", "0",
      "Radix of all algorithms based on knomial pattern. When set to a "
      "positive value it is used as a convinience parameter to set all "
@@ -101,11 +165,30 @@ static ucc_config_field_t ucc_tl_ucp_lib_config_table[] = {
      ucc_offsetof(ucc_tl_ucp_lib_config_t, allreduce_sra_kn_pipeline_order),
      UCC_CONFIG_TYPE_ENUM(ucc_pipeline_order_names)},
 
+    {"ALLREDUCE_SRA_KN_COMPRESS", "none",
+     "Wire format of float32 sum and average of SRA knomial allreduce on "
+     "host memory:\n"
+     "none - data is sent as is\n"
+     "bf16 - data is sent as bfloat16, the mantissa is truncated to 7 bits\n"
+     "fp16 - data is sent as float16, rounded to nearest with 10 bits "
+     "mantissa, values above 65504 overflow to infinity\n"
+     "Partial sums are accumulated in float32, only the transfers are "
+     "compressed",
+     ucc_offsetof(ucc_tl_ucp_lib_config_t, allreduce_sra_kn_compress),
+     UCC_CONFIG_TYPE_ENUM(ucc_tl_ucp_compress_names)},
+
     {"REDUCE_SCATTER_KN_RADIX", "4",
      "Radix of the knomial reduce-scatter algorithm",
      ucc_offsetof(ucc_tl_ucp_lib_config_t, reduce_scatter_kn_radix),
      UCC_CONFIG_TYPE_UINT},
 
+    {"REDUCE_SCATTER_KN_CHUNK_SIZE", "inf",
+     "Size of the chunk the data of each step of the knomial reduce-scatter "
+     "algorithm is split into. Reduction of a chunk overlaps with the "
+     "transfer of the next one, inf - no chunking",
+     ucc_offsetof(ucc_tl_ucp_lib_config_t, reduce_scatter_kn_chunk_size),
+     UCC_CONFIG_TYPE_MEMUNITS},
+
     {"ALLGATHER_KN_RADIX", "4", "Radix of the knomial allgather algorithm",
      ucc_offsetof(ucc_tl_ucp_lib_config_t, allgather_kn_radix),
      UCC_CONFIG_TYPE_UINT},
@@ -114,6 +197,17 @@ static ucc_config_field_t ucc_tl_ucp_lib_config_table[] = {
      ucc_offsetof(ucc_tl_ucp_lib_config_t, bcast_kn_radix),
      UCC_CONFIG_TYPE_UINT},
 
+    {"BCAST_KN_FRAG_SIZE", "inf",
+     "Messages larger than this size are split into fragments which are "
+     "pipelined through the knomial bcast tree, inf - no pipelining",
+     ucc_offsetof(ucc_tl_ucp_lib_config_t, bcast_kn_frag_size),
+     UCC_CONFIG_TYPE_MEMUNITS},
+
+    {"BCAST_KN_PIPELINE_DEPTH", "2",
+     "Number of fragments simultaneously progressed by the knomial bcast alg",
+     ucc_offsetof(ucc_tl_ucp_lib_config_t, bcast_kn_pipeline_depth),
+     UCC_CONFIG_TYPE_UINT},
+
     {"BCAST_SAG_KN_RADIX", "4",
      "Radix of the scatter-allgather (SAG) knomial bcast algorithm",
      ucc_offsetof(ucc_tl_ucp_lib_config_t, bcast_sag_kn_radix),
@@ -123,6 +217,17 @@ static ucc_config_field_t ucc_tl_ucp_lib_config_table[] = {
      ucc_offsetof(ucc_tl_ucp_lib_config_t, reduce_kn_radix),
      UCC_CONFIG_TYPE_UINT},
 
+    {"REDUCE_KN_FRAG_SIZE", "inf",
+     "Messages larger than this size are split into fragments which are "
+     "pipelined through the knomial reduce tree, inf - no pipelining",
+     ucc_offsetof(ucc_tl_ucp_lib_config_t, reduce_kn_frag_size),
+     UCC_CONFIG_TYPE_MEMUNITS},
+
+    {"REDUCE_KN_PIPELINE_DEPTH", "2",
+     "Number of fragments simultaneously progressed by the knomial reduce alg",
+     ucc_offsetof(ucc_tl_ucp_lib_config_t, reduce_kn_pipeline_depth),
+     UCC_CONFIG_TYPE_UINT},
+
     {"GATHER_KN_RADIX", "4", "Radix of the knomial tree reduce algorithm",
      ucc_offsetof(ucc_tl_ucp_lib_config_t, gather_kn_radix),
      UCC_CONFIG_TYPE_UINT},
@@ -149,6 +254,12 @@ static ucc_config_field_t ucc_tl_ucp_lib_config_table[] = {
      ucc_offsetof(ucc_tl_ucp_lib_config_t, reduce_scatterv_ring_bidirectional),
      UCC_CONFIG_TYPE_BOOL},
 
+    {"RING_TOPO_ORDER", "y",
+     "Order the ranks of ring algorithms by host and socket instead of the "
+     "team rank order, so that each node is traversed contiguously",
+     ucc_offsetof(ucc_tl_ucp_lib_config_t, ring_topo_order),
+     UCC_CONFIG_TYPE_BOOL},
+
     {NULL}};
 
 static ucs_config_field_t ucc_tl_ucp_context_config_table[] = {
@@ -175,6 +286,27 @@ static ucs_config_field_t ucc_tl_ucp_context_config_table[] = {
      ucc_offsetof(ucc_tl_ucp_context_config_t, pre_reg_mem),
      UCC_CONFIG_TYPE_UINT},
 
+    {"AM_EAGER_THRESH", "0",
+     "Messages of knomial barrier, allreduce and bcast up to this size are "
+     "sent as UCP active messages bypassing tag matching, 0 - disable. "
+     "Host memory only, must be the same on all the processes",
+     ucc_offsetof(ucc_tl_ucp_context_config_t, am_eager_thresh),
+     UCC_CONFIG_TYPE_MEMUNITS},
+
+    {"N_WORKERS", "1",
+     "Number of ucp workers per context. Teams are spread across the workers "
+     "by team id, so threads driving their own teams progress different "
+     "workers. Must be the same on all the processes",
+     ucc_offsetof(ucc_tl_ucp_context_config_t, n_workers),
+     UCC_CONFIG_TYPE_UINT},
+
+    {"STRIPE_THRESH", "inf",
+     "Point-to-point messages of at least this size are split across all "
+     "the workers of the context, inf - disable. Requires N_WORKERS > 1, "
+     "must be the same on all the processes",
+     ucc_offsetof(ucc_tl_ucp_context_config_t, stripe_thresh),
+     UCC_CONFIG_TYPE_MEMUNITS},
+
     {NULL}};
 
 UCC_CLASS_DEFINE_NEW_FUNC(ucc_tl_ucp_lib_t, ucc_base_lib_t,
@@ -10,6 +10,7 @@
 #include "components/tl/ucc_tl_log.h"
 #include "core/ucc_ee.h"
 #include "utils/ucc_mpool.h"
+#include "utils/ucc_list.h"
 #include "tl_ucp_ep_hash.h"
 #include "schedule/ucc_schedule_pipelined.h"
 #include <ucp/api/ucp.h>
@@ -32,6 +33,7 @@
 #define UCC_TL_UCP_PROFILE_REQUEST_FREE UCC_PROFILE_REQUEST_FREE
 
 #define MAX_NR_SEGMENTS 32
+#define UCC_TL_UCP_AM_ID 0x55
 #define ONESIDED_SYNC_SIZE 1
 #define ONESIDED_REDUCE_SIZE 4
 
@@ -41,31 +43,65 @@ typedef struct ucc_tl_ucp_iface {
 /* Extern iface should follow the pattern: ucc_tl_<tl_name> */
 extern ucc_tl_ucp_iface_t ucc_tl_ucp;
 
+/* Order in which the pairwise alltoall(v) visits the peers */
+typedef enum ucc_tl_ucp_pairwise_schedule {
+    UCC_TL_UCP_PAIRWISE_SCHEDULE_ROTATED,
+    UCC_TL_UCP_PAIRWISE_SCHEDULE_RANDOM,
+    UCC_TL_UCP_PAIRWISE_SCHEDULE_NODE,
+    UCC_TL_UCP_PAIRWISE_SCHEDULE_LAST
+} ucc_tl_ucp_pairwise_schedule_t;
+
+extern const char *ucc_tl_ucp_pairwise_schedule_names[];
+
+/* Wire format of the fp32 data of compressed allreduce */
+typedef enum ucc_tl_ucp_compress {
+    UCC_TL_UCP_COMPRESS_NONE,
+    UCC_TL_UCP_COMPRESS_BF16,
+    UCC_TL_UCP_COMPRESS_FP16,
+    UCC_TL_UCP_COMPRESS_LAST
+} ucc_tl_ucp_compress_t;
+
+extern const char *ucc_tl_ucp_compress_names[];
+
 typedef struct ucc_tl_ucp_lib_config {
-    ucc_tl_lib_config_t  super;
-    uint32_t             kn_radix;
-    uint32_t             fanin_kn_radix;
-    uint32_t             fanout_kn_radix;
-    uint32_t             barrier_kn_radix;
-    uint32_t             allreduce_kn_radix;
-    uint32_t             allreduce_sra_kn_radix;
-    uint32_t             reduce_scatter_kn_radix;
-    uint32_t             allgather_kn_radix;
-    uint32_t             bcast_kn_radix;
-    uint32_t             bcast_sag_kn_radix;
-    uint32_t             reduce_kn_radix;
-    uint32_t             gather_kn_radix;
-    uint32_t             scatter_kn_radix;
-    uint32_t             alltoall_pairwise_num_posts;
-    uint32_t             alltoallv_pairwise_num_posts;
-    uint32_t             allreduce_sra_kn_n_frags;
-    uint32_t             allreduce_sra_kn_pipeline_depth;
-    ucc_pipeline_order_t allreduce_sra_kn_pipeline_order;
-    size_t               allreduce_sra_kn_frag_thresh;
-    size_t               allreduce_sra_kn_frag_size;
-    int                  reduce_avg_pre_op;
-    int                  reduce_scatter_ring_bidirectional;
-    int                  reduce_scatterv_ring_bidirectional;
+    ucc_tl_lib_config_t            super;
+    uint32_t                       kn_radix;
+    uint32_t                       fanin_kn_radix;
+    uint32_t                       fanout_kn_radix;
+    uint32_t                       barrier_kn_radix;
+    uint32_t                       allreduce_kn_radix;
+    uint32_t                       allreduce_sra_kn_radix;
+    uint32_t                       reduce_scatter_kn_radix;
+    size_t                         reduce_scatter_kn_chunk_size;
+    uint32_t                       allgather_kn_radix;
+    uint32_t                       bcast_kn_radix;
+    size_t                         bcast_kn_frag_size;
+    uint32_t                       bcast_kn_pipeline_depth;
+    uint32_t                       bcast_sag_kn_radix;
+    uint32_t                       reduce_kn_radix;
+    size_t                         reduce_kn_frag_size;
+    uint32_t                       reduce_kn_pipeline_depth;
+    uint32_t                       gather_kn_radix;
+    uint32_t                       scatter_kn_radix;
+    uint32_t                       alltoall_pairwise_num_posts;
+    uint32_t                       alltoallv_pairwise_num_posts;
+    int                            alltoall_pairwise_adaptive;
+    int                            alltoallv_pairwise_adaptive;
+    ucc_tl_ucp_pairwise_schedule_t alltoall_pairwise_schedule;
+    ucc_tl_ucp_pairwise_schedule_t alltoallv_pairwise_schedule;
+    uint32_t                       alltoallv_sparse_thresh;
+    uint32_t                       alltoall_onesided_num_posts;
+    uint32_t                       alltoallv_onesided_num_posts;
+    uint32_t                       allreduce_sra_kn_n_frags;
+    uint32_t                       allreduce_sra_kn_pipeline_depth;
+    ucc_pipeline_order_t           allreduce_sra_kn_pipeline_order;
+    size_t                         allreduce_sra_kn_frag_thresh;
+    size_t                         allreduce_sra_kn_frag_size;
+    ucc_tl_ucp_compress_t          allreduce_sra_kn_compress;
+    int                            reduce_avg_pre_op;
+    int                            reduce_scatter_ring_bidirectional;
+    int                            reduce_scatterv_ring_bidirectional;
+    int                            ring_topo_order;
 } ucc_tl_ucp_lib_config_t;
 
 typedef struct ucc_tl_ucp_context_config {
@@ -74,6 +110,9 @@ typedef struct ucc_tl_ucp_context_config {
     uint32_t                n_polls;
     uint32_t                oob_npolls;
     uint32_t                pre_reg_mem;
+    size_t                  am_eager_thresh;
+    uint32_t                n_workers;
+    size_t                  stripe_thresh;
 } ucc_tl_ucp_context_config_t;
 
 typedef struct ucc_tl_ucp_lib {
@@ -92,32 +131,72 @@ typedef struct ucc_tl_ucp_remote_info {
     size_t packed_key_len;
 } ucc_tl_ucp_remote_info_t;
 
+typedef struct ucc_tl_ucp_worker {
+    ucp_worker_h      ucp_worker;
+    size_t            ucp_addrlen;
+    ucp_address_t *   worker_address;
+    tl_ucp_ep_hash_t *ep_hash;
+    ucp_ep_h *        eps;
+} ucc_tl_ucp_worker_t;
+
 typedef struct ucc_tl_ucp_context {
     ucc_tl_context_t            super;
     ucc_tl_ucp_context_config_t cfg;
     ucp_context_h               ucp_context;
-    ucp_worker_h                ucp_worker;
-    size_t                      ucp_addrlen;
-    ucp_address_t *             worker_address;
+    ucc_tl_ucp_worker_t *       workers;
+    uint32_t                    n_workers;
     ucc_mpool_t                 req_mp;
-    tl_ucp_ep_hash_t *          ep_hash;
-    ucp_ep_h *                  eps;
+    ucc_mpool_t                 stripe_mp;
     ucc_tl_ucp_remote_info_t *  remote_info;
     ucp_rkey_h *                rkeys;
     uint64_t                    n_rinfo_segs;
     uint64_t                    ucp_memory_types;
+    ucc_mpool_t                 am_mp;
+    ucc_list_link_t             am_teams; /*< teams using the am eager path */
+    ucc_list_link_t             am_early; /*< am messages of the teams not
+                                              created locally yet */
 } ucc_tl_ucp_context_t;
 UCC_CLASS_DECLARE(ucc_tl_ucp_context_t, const ucc_base_context_params_t *,
                   const ucc_base_config_t *);
 
+/* Order of the team ranks used by the ring algorithms */
+typedef struct ucc_tl_ucp_ring {
+    ucc_ep_map_t map;     /*< team rank -> position in the ring */
+    ucc_ep_map_t inv_map; /*< position in the ring -> team rank */
+} ucc_tl_ucp_ring_t;
+
 typedef struct ucc_tl_ucp_task ucc_tl_ucp_task_t;
+
+/* Tracks the stripes of a message sent or received over several workers */
+typedef struct ucc_tl_ucp_stripe_req {
+    ucc_tl_ucp_task_t      *task;
+    volatile uint32_t       n_pending;
+    ucp_send_nbx_callback_t cb; /*< completion of a striped send_cb, called
+                                    with NULL request once all the stripes
+                                    are sent */
+} ucc_tl_ucp_stripe_req_t;
+
 typedef struct ucc_tl_ucp_team {
     ucc_tl_team_t              super;
     ucc_status_t               status;
     uint32_t                   seq_num;
+    uint32_t                   worker_id; /*< worker of the team p2p traffic */
+    ucp_ep_h                  *eps;       /*< endpoints of the team worker
+                                              resolved so far, by team rank */
     ucc_tl_ucp_task_t         *preconnect_task;
     void *                     va_base[MAX_NR_SEGMENTS];
     size_t                     base_length[MAX_NR_SEGMENTS];
+    ucc_tl_ucp_ring_t          rings[2];   /*< forward and backward rings,
+                                               built on first use */
+    ucc_rank_t                *ring_ranks; /*< storage of the ring maps */
+    int                        rings_init;
+    uint32_t                   alltoall_window;  /*< adaptive pairwise */
+    uint32_t                   alltoallv_window; /*< windows, 0 - not set */
+    ucc_list_link_t            am_list_elem;  /*< in ctx->am_teams */
+    ucp_tag_t                  am_key;        /*< team bits of the am tags */
+    ucc_list_link_t            am_posted;     /*< am eager receives posted */
+    ucc_list_link_t            am_unexpected; /*< am eager messages received
+                                                  before the receive */
 } ucc_tl_ucp_team_t;
 UCC_CLASS_DECLARE(ucc_tl_ucp_team_t, ucc_base_context_t *,
                   const ucc_base_team_params_t *);
@@ -135,7 +214,19 @@ UCC_CLASS_DECLARE(ucc_tl_ucp_team_t, ucc_base_context_t *,
 #define UCC_TL_UCP_TEAM_CTX(_team)                                             \
     (ucc_derived_of((_team)->super.super.context, ucc_tl_ucp_context_t))
 
-#define UCC_TL_UCP_WORKER(_team) UCC_TL_UCP_TEAM_CTX(_team)->ucp_worker
+/* Worker 0 of the context serves active messages, one-sided operations
+   and the context level service traffic */
+#define UCC_TL_UCP_CTX_WORKER(_ctx) ((_ctx)->workers[0].ucp_worker)
+
+#define UCC_TL_UCP_ONESIDED_WORKER(_team)                                      \
+    UCC_TL_UCP_CTX_WORKER(UCC_TL_UCP_TEAM_CTX(_team))
+
+/* Worker used by the tagged send/recv of the team */
+#define UCC_TL_UCP_WORKER(_team)                                               \
+    UCC_TL_UCP_TEAM_CTX(_team)->workers[(_team)->worker_id].ucp_worker
+
+#define UCC_TL_UCP_CTX_STRIPING(_ctx)                                          \
+    ((_ctx)->n_workers > 1 && (_ctx)->cfg.stripe_thresh != SIZE_MAX)
 
 #define UCC_TL_CTX_HAS_OOB(_ctx)                                               \
     ((_ctx)->super.super.ucc_context->params.mask & UCC_CONTEXT_PARAM_FIELD_OOB)
@@ -149,9 +240,50 @@ UCC_CLASS_DECLARE(ucc_tl_ucp_team_t, ucc_base_context_t *,
 
 extern ucs_memory_type_t ucc_memtype_to_ucs[UCC_MEMORY_TYPE_LAST+1];
 
+/* Progresses the worker of the team, and the other workers of the context
+   when large messages may be striped across them. Active messages arrive
+   on the worker 0. */
+static inline void ucc_tl_ucp_team_progress(ucc_tl_ucp_team_t *team)
+{
+    ucc_tl_ucp_context_t *ctx = UCC_TL_UCP_TEAM_CTX(team);
+    uint32_t              i;
+
+    if (!UCC_TL_UCP_CTX_STRIPING(ctx)) {
+        ucp_worker_progress(UCC_TL_UCP_WORKER(team));
+        if (team->worker_id != 0 && ctx->cfg.am_eager_thresh) {
+            ucp_worker_progress(UCC_TL_UCP_CTX_WORKER(ctx));
+        }
+        return;
+    }
+    for (i = 0; i < ctx->n_workers; i++) {
+        ucp_worker_progress(ctx->workers[i].ucp_worker);
+    }
+}
+
+/* Returns the cached forward (backward = 0) or backward ring of the team.
+   With RING_TOPO_ORDER the ranks are grouped by host and socket, so that
+   only nnodes hops of the ring go over the network. */
+ucc_status_t ucc_tl_ucp_team_get_ring(ucc_tl_ucp_team_t *team, int backward,
+                                      ucc_tl_ucp_ring_t **ring);
+
+/* Fills the ring over size positions in natural (backward = 0) or reverse
+   order. Used for the cached team rings and for rings over an active set,
+   which always follow the set order. */
+void ucc_tl_ucp_ring_init_plain(ucc_rank_t size, int backward,
+                                ucc_tl_ucp_ring_t *ring);
+
 void ucc_tl_ucp_pre_register_mem(ucc_tl_ucp_team_t *team, void *addr,
                                  size_t length, ucc_memory_type_t mem_type);
 
+ucc_status_t ucc_tl_ucp_am_init(ucc_tl_ucp_context_t *ctx,
+                                ucc_thread_mode_t     tm);
+
+void ucc_tl_ucp_am_cleanup(ucc_tl_ucp_context_t *ctx);
+
+void ucc_tl_ucp_am_team_init(ucc_tl_ucp_team_t *team);
+
+void ucc_tl_ucp_am_team_cleanup(ucc_tl_ucp_team_t *team);
+
 ucc_status_t ucc_tl_ucp_ctx_remote_populate(ucc_tl_ucp_context_t *ctx,
                                             ucc_mem_map_params_t  map,
                                             ucc_team_oob_coll_t   oob);
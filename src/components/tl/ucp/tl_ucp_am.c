@@ -0,0 +1,310 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "tl_ucp.h"
+#include "tl_ucp_coll.h"
+#include "tl_ucp_sendrecv.h"
+#include "utils/ucc_math.h"
+#include <limits.h>
+
+/* Descriptor of the AM eager path. The same object is used for:
+   - the header of an outstanding AM send (must stay valid until completion);
+   - a receive posted before the matching message arrived;
+   - an unexpected message, payload is stored right after the descriptor. */
+typedef struct ucc_tl_ucp_am_desc {
+    ucc_list_link_t    list_elem;
+    ucp_tag_t          tag;
+    ucc_tl_ucp_task_t *task;
+    void              *buffer;
+    size_t             length;
+} ucc_tl_ucp_am_desc_t;
+
+static inline ucp_tag_t ucc_tl_ucp_am_team_key(ucc_tl_ucp_team_t *team)
+{
+    return UCC_TL_UCP_MAKE_TAG(0, 0, 0, team->super.super.params.id,
+                               team->super.super.params.scope_id,
+                               team->super.super.params.scope) &
+           UCC_TL_UCP_TAG_TEAM_MASK;
+}
+
+static inline ucc_tl_ucp_team_t *
+ucc_tl_ucp_am_find_team(ucc_tl_ucp_context_t *ctx, ucp_tag_t tag)
+{
+    ucp_tag_t          key = tag & UCC_TL_UCP_TAG_TEAM_MASK;
+    ucc_tl_ucp_team_t *team;
+
+    ucc_list_for_each(team, &ctx->am_teams, am_list_elem) {
+        if (team->am_key == key) {
+            return team;
+        }
+    }
+    return NULL;
+}
+
+static ucs_status_t
+ucc_tl_ucp_am_recv_handler(void *arg, const void *header, size_t header_length,
+                           void *data, size_t length,
+                           const ucp_am_recv_param_t *param)
+{
+    ucc_tl_ucp_context_t *ctx = (ucc_tl_ucp_context_t *)arg;
+    ucc_tl_ucp_am_desc_t *desc, *tmp;
+    ucc_tl_ucp_team_t    *team;
+    ucp_tag_t             tag;
+
+    ucc_assert(header_length == sizeof(ucp_tag_t));
+    ucc_assert(!(param->recv_attr & UCP_AM_RECV_ATTR_FLAG_RNDV));
+    ucc_assert(length <= ctx->cfg.am_eager_thresh);
+    tag  = *(const ucp_tag_t *)header;
+    team = ucc_tl_ucp_am_find_team(ctx, tag);
+
+    if (team) {
+        ucc_list_for_each_safe(desc, tmp, &team->am_posted, list_elem) {
+            if (desc->tag == tag) {
+                ucc_assert(length <= desc->length);
+                ucc_list_del(&desc->list_elem);
+                if (length) {
+                    memcpy(desc->buffer, data, length);
+                }
+                desc->task->tagged.recv_completed++;
+                ucc_mpool_put(desc);
+                return UCS_OK;
+            }
+        }
+    }
+
+    desc = ucc_mpool_get(&ctx->am_mp);
+    if (ucc_unlikely(!desc)) {
+        tl_error(ctx->super.super.lib, "failed to allocate am descriptor");
+        return UCS_ERR_NO_MEMORY;
+    }
+    desc->tag    = tag;
+    desc->length = length;
+    if (length) {
+        memcpy(PTR_OFFSET(desc, sizeof(*desc)), data, length);
+    }
+    /* the sender may have created its team before this process did */
+    ucc_list_add_tail(team ? &team->am_unexpected : &ctx->am_early,
+                      &desc->list_elem);
+    return UCS_OK;
+}
+
+static void ucc_tl_ucp_am_send_completion_cb(void *request, ucs_status_t status,
+                                             void *user_data)
+{
+    ucc_tl_ucp_am_desc_t *desc = (ucc_tl_ucp_am_desc_t *)user_data;
+    ucc_tl_ucp_task_t    *task = desc->task;
+
+    if (ucc_unlikely(UCS_OK != status)) {
+        tl_error(UCC_TASK_LIB(task), "failure in am send completion %s",
+                 ucs_status_string(status));
+        task->super.status = ucs_status_to_ucc_status(status);
+    }
+    task->tagged.send_completed++;
+    ucc_mpool_put(desc);
+    ucp_request_free(request);
+}
+
+ucc_status_t ucc_tl_ucp_am_init(ucc_tl_ucp_context_t *ctx,
+                                ucc_thread_mode_t     tm)
+{
+    ucp_am_handler_param_t param;
+    ucc_status_t           status;
+    ucs_status_t           ucs_status;
+
+    ucc_list_head_init(&ctx->am_teams);
+    ucc_list_head_init(&ctx->am_early);
+    if (0 == ctx->cfg.am_eager_thresh) {
+        return UCC_OK;
+    }
+    if (UCC_THREAD_MULTIPLE == tm) {
+        /* posted/unexpected queues are not protected */
+        tl_debug(ctx->super.super.lib,
+                 "am eager path is disabled for thread mode multiple");
+        ctx->cfg.am_eager_thresh = 0;
+        return UCC_OK;
+    }
+
+    status = ucc_mpool_init(&ctx->am_mp, 0,
+                            sizeof(ucc_tl_ucp_am_desc_t) +
+                                ctx->cfg.am_eager_thresh,
+                            0, UCC_CACHE_LINE_SIZE, 16, UINT_MAX, NULL, tm,
+                            "tl_ucp_am_mp");
+    if (UCC_OK != status) {
+        tl_error(ctx->super.super.lib, "failed to initialize tl_ucp_am mpool");
+        return status;
+    }
+
+    param.field_mask = UCP_AM_HANDLER_PARAM_FIELD_ID |
+                       UCP_AM_HANDLER_PARAM_FIELD_CB |
+                       UCP_AM_HANDLER_PARAM_FIELD_ARG;
+    param.id         = UCC_TL_UCP_AM_ID;
+    param.cb         = ucc_tl_ucp_am_recv_handler;
+    param.arg        = ctx;
+    ucs_status =
+        ucp_worker_set_am_recv_handler(UCC_TL_UCP_CTX_WORKER(ctx), &param);
+    if (UCS_OK != ucs_status) {
+        tl_error(ctx->super.super.lib, "failed to set am recv handler, %s",
+                 ucs_status_string(ucs_status));
+        ucc_mpool_cleanup(&ctx->am_mp, 0);
+        return ucs_status_to_ucc_status(ucs_status);
+    }
+    return UCC_OK;
+}
+
+void ucc_tl_ucp_am_cleanup(ucc_tl_ucp_context_t *ctx)
+{
+    if (0 == ctx->cfg.am_eager_thresh) {
+        return;
+    }
+    if (!ucc_list_is_empty(&ctx->am_early)) {
+        tl_warn(ctx->super.super.lib,
+                "%d am eager messages were not claimed by any team",
+                ucc_list_length(&ctx->am_early));
+    }
+    ucc_list_destruct(&ctx->am_early, ucc_tl_ucp_am_desc_t, ucc_mpool_put,
+                      list_elem);
+    ucc_mpool_cleanup(&ctx->am_mp, 1);
+}
+
+void ucc_tl_ucp_am_team_init(ucc_tl_ucp_team_t *team)
+{
+    ucc_tl_ucp_context_t *ctx = UCC_TL_UCP_TEAM_CTX(team);
+    ucc_tl_ucp_am_desc_t *desc, *tmp;
+
+    ucc_list_head_init(&team->am_posted);
+    ucc_list_head_init(&team->am_unexpected);
+    if (0 == ctx->cfg.am_eager_thresh) {
+        return;
+    }
+    team->am_key = ucc_tl_ucp_am_team_key(team);
+    /* claim the messages that arrived before the team was created,
+       preserving their order */
+    ucc_list_for_each_safe(desc, tmp, &ctx->am_early, list_elem) {
+        if ((desc->tag & UCC_TL_UCP_TAG_TEAM_MASK) == team->am_key) {
+            ucc_list_del(&desc->list_elem);
+            ucc_list_add_tail(&team->am_unexpected, &desc->list_elem);
+        }
+    }
+    ucc_list_add_tail(&ctx->am_teams, &team->am_list_elem);
+}
+
+void ucc_tl_ucp_am_team_cleanup(ucc_tl_ucp_team_t *team)
+{
+    ucc_tl_ucp_context_t *ctx = UCC_TL_UCP_TEAM_CTX(team);
+
+    if (0 == ctx->cfg.am_eager_thresh) {
+        return;
+    }
+    ucc_list_del(&team->am_list_elem);
+    if (!ucc_list_is_empty(&team->am_posted) ||
+        !ucc_list_is_empty(&team->am_unexpected)) {
+        tl_warn(UCC_TL_TEAM_LIB(team), "am eager queues are not empty: "
+                "posted %d, unexpected %d",
+                ucc_list_length(&team->am_posted),
+                ucc_list_length(&team->am_unexpected));
+    }
+    ucc_list_destruct(&team->am_posted, ucc_tl_ucp_am_desc_t, ucc_mpool_put,
+                      list_elem);
+    ucc_list_destruct(&team->am_unexpected, ucc_tl_ucp_am_desc_t,
+                      ucc_mpool_put, list_elem);
+}
+
+ucc_status_t ucc_tl_ucp_send_am_nb(void *buffer, size_t msglen,
+                                   ucc_rank_t         dest_group_rank,
+                                   ucc_tl_ucp_team_t *team,
+                                   ucc_tl_ucp_task_t *task)
+{
+    ucc_tl_ucp_context_t *ctx  = UCC_TL_UCP_TEAM_CTX(team);
+    ucc_coll_args_t      *args = &TASK_ARGS(task);
+    ucp_request_param_t   req_param;
+    ucc_tl_ucp_am_desc_t *desc;
+    ucs_status_ptr_t      ucp_status;
+    ucc_status_t          status;
+    ucp_ep_h              ep;
+
+    status = ucc_tl_ucp_get_ep(team, dest_group_rank, &ep);
+    if (ucc_unlikely(UCC_OK != status)) {
+        return status;
+    }
+    desc = ucc_mpool_get(&ctx->am_mp);
+    if (ucc_unlikely(!desc)) {
+        tl_error(UCC_TL_TEAM_LIB(team), "failed to allocate am descriptor");
+        return UCC_ERR_NO_MEMORY;
+    }
+    desc->task = task;
+    desc->tag  = UCC_TL_UCP_MAKE_SEND_TAG(
+        (args->mask & UCC_COLL_ARGS_FIELD_TAG), task->tagged.tag,
+        UCC_TL_TEAM_RANK(team), team->super.super.params.id,
+        team->super.super.params.scope_id, team->super.super.params.scope);
+
+    req_param.op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK |
+                             UCP_OP_ATTR_FIELD_USER_DATA |
+                             UCP_OP_ATTR_FIELD_FLAGS;
+    req_param.flags        = UCP_AM_SEND_FLAG_EAGER;
+    req_param.cb.send      = ucc_tl_ucp_am_send_completion_cb;
+    req_param.user_data    = (void *)desc;
+    task->tagged.send_posted++;
+    ucp_status = ucp_am_send_nbx(ep, UCC_TL_UCP_AM_ID, &desc->tag,
+                                 sizeof(desc->tag), buffer, msglen, &req_param);
+    if (UCS_OK == ucp_status) {
+        task->tagged.send_completed++;
+        ucc_mpool_put(desc);
+    } else if (ucc_unlikely(UCS_PTR_IS_ERR(ucp_status))) {
+        tl_error(UCC_TL_TEAM_LIB(team),
+                 "tag %u; dest %d; team_id %u; errmsg %s", task->tagged.tag,
+                 dest_group_rank,
+                 team->super.super.params.id,
+                 ucs_status_string(UCS_PTR_STATUS(ucp_status)));
+        ucc_mpool_put(desc);
+        return ucs_status_to_ucc_status(UCS_PTR_STATUS(ucp_status));
+    }
+    return UCC_OK;
+}
+
+ucc_status_t ucc_tl_ucp_recv_am_nb(void *buffer, size_t msglen,
+                                   ucc_rank_t         dest_group_rank,
+                                   ucc_tl_ucp_team_t *team,
+                                   ucc_tl_ucp_task_t *task)
+{
+    ucc_tl_ucp_context_t *ctx  = UCC_TL_UCP_TEAM_CTX(team);
+    ucc_coll_args_t      *args = &TASK_ARGS(task);
+    ucc_tl_ucp_am_desc_t *desc, *tmp;
+    ucp_tag_t             tag;
+
+    tag = UCC_TL_UCP_MAKE_TAG((args->mask & UCC_COLL_ARGS_FIELD_TAG),
+                              task->tagged.tag, dest_group_rank,
+                              team->super.super.params.id,
+                              team->super.super.params.scope_id,
+                              team->super.super.params.scope);
+    task->tagged.recv_posted++;
+
+    /* messages from the same sender are delivered in order, so the first
+       matching descriptor is the one this receive corresponds to */
+    ucc_list_for_each_safe(desc, tmp, &team->am_unexpected, list_elem) {
+        if (desc->tag == tag) {
+            ucc_assert(desc->length <= msglen);
+            ucc_list_del(&desc->list_elem);
+            if (desc->length) {
+                memcpy(buffer, PTR_OFFSET(desc, sizeof(*desc)), desc->length);
+            }
+            task->tagged.recv_completed++;
+            ucc_mpool_put(desc);
+            return UCC_OK;
+        }
+    }
+
+    desc = ucc_mpool_get(&ctx->am_mp);
+    if (ucc_unlikely(!desc)) {
+        tl_error(UCC_TL_TEAM_LIB(team), "failed to allocate am descriptor");
+        return UCC_ERR_NO_MEMORY;
+    }
+    desc->tag    = tag;
+    desc->task   = task;
+    desc->buffer = buffer;
+    desc->length = msglen;
+    ucc_list_add_tail(&team->am_posted, &desc->list_elem);
+    return UCC_OK;
+}
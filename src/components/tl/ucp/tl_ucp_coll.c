@@ -6,6 +6,7 @@
 
 #include "tl_ucp.h"
 #include "tl_ucp_coll.h"
+#include "tl_ucp_sendrecv.h"
 #include "components/mc/ucc_mc.h"
 #include "core/ucc_team.h"
 #include "barrier/barrier.h"
@@ -28,7 +29,8 @@ const char
         UCC_TL_UCP_BCAST_DEFAULT_ALG_SELECT_STR,
         UCC_TL_UCP_ALLTOALL_DEFAULT_ALG_SELECT_STR,
         UCC_TL_UCP_REDUCE_SCATTER_DEFAULT_ALG_SELECT_STR,
-        UCC_TL_UCP_REDUCE_SCATTERV_DEFAULT_ALG_SELECT_STR};
+        UCC_TL_UCP_REDUCE_SCATTERV_DEFAULT_ALG_SELECT_STR,
+        UCC_TL_UCP_REDUCE_DEFAULT_ALG_SELECT_STR};
 
 void ucc_tl_ucp_send_completion_cb(void *request, ucs_status_t status,
                                    void *user_data)
@@ -83,6 +85,42 @@ void ucc_tl_ucp_recv_completion_cb(void *request, ucs_status_t status,
     ucp_request_free(request);
 }
 
+void ucc_tl_ucp_send_stripe_completion_cb(void *request, ucs_status_t status,
+                                          void *user_data)
+{
+    ucc_tl_ucp_stripe_req_t *req  = (ucc_tl_ucp_stripe_req_t *)user_data;
+    ucc_tl_ucp_task_t       *task = req->task;
+    ucp_send_nbx_callback_t  cb   = req->cb;
+
+    if (ucc_unlikely(UCS_OK != status)) {
+        tl_error(UCC_TASK_LIB(task), "failure in send stripe completion %s",
+                 ucs_status_string(status));
+        task->super.status = ucs_status_to_ucc_status(status);
+    }
+    if (ucc_tl_ucp_stripe_release(req, 1)) {
+        ucc_tl_ucp_stripe_send_completed(task, cb);
+    }
+    ucp_request_free(request);
+}
+
+void ucc_tl_ucp_recv_stripe_completion_cb(void *request, ucs_status_t status,
+                                          const ucp_tag_recv_info_t *info, /* NOLINT */
+                                          void *user_data)
+{
+    ucc_tl_ucp_stripe_req_t *req  = (ucc_tl_ucp_stripe_req_t *)user_data;
+    ucc_tl_ucp_task_t       *task = req->task;
+
+    if (ucc_unlikely(UCS_OK != status)) {
+        tl_error(UCC_TASK_LIB(task), "failure in recv stripe completion %s",
+                 ucs_status_string(status));
+        task->super.status = ucs_status_to_ucc_status(status);
+    }
+    if (ucc_tl_ucp_stripe_release(req, 1)) {
+        task->tagged.recv_completed++;
+    }
+    ucp_request_free(request);
+}
+
 ucc_status_t ucc_tl_ucp_coll_finalize(ucc_coll_task_t *coll_task)
 {
     ucc_tl_ucp_task_t *task = ucc_derived_of(coll_task, ucc_tl_ucp_task_t);
@@ -154,6 +192,12 @@ static inline int alg_id_from_str(ucc_coll_type_t coll_type, const char *str)
         return ucc_tl_ucp_bcast_alg_from_str(str);
     case UCC_COLL_TYPE_ALLTOALL:
         return ucc_tl_ucp_alltoall_alg_from_str(str);
+    case UCC_COLL_TYPE_ALLTOALLV:
+        return ucc_tl_ucp_alltoallv_alg_from_str(str);
+    case UCC_COLL_TYPE_ALLGATHER:
+        return ucc_tl_ucp_allgather_alg_from_str(str);
+    case UCC_COLL_TYPE_REDUCE:
+        return ucc_tl_ucp_reduce_alg_from_str(str);
     case UCC_COLL_TYPE_REDUCE_SCATTER:
         return ucc_tl_ucp_reduce_scatter_alg_from_str(str);
     case UCC_COLL_TYPE_REDUCE_SCATTERV:
@@ -196,6 +240,9 @@ ucc_status_t ucc_tl_ucp_alg_id_to_init(int alg_id, const char *alg_id_str,
         case UCC_TL_UCP_BCAST_ALG_SAG_KNOMIAL:
             *init = ucc_tl_ucp_bcast_sag_knomial_init;
             break;
+        case UCC_TL_UCP_BCAST_ALG_ONESIDED:
+            *init = ucc_tl_ucp_bcast_onesided_init;
+            break;
         default:
            status = UCC_ERR_INVALID_PARAM;
            break;
@@ -214,6 +261,45 @@ ucc_status_t ucc_tl_ucp_alg_id_to_init(int alg_id, const char *alg_id_str,
             break;
         };
         break;
+    case UCC_COLL_TYPE_ALLTOALLV:
+        switch (alg_id) {
+        case UCC_TL_UCP_ALLTOALLV_ALG_PAIRWISE:
+            *init = ucc_tl_ucp_alltoallv_pairwise_init;
+            break;
+        case UCC_TL_UCP_ALLTOALLV_ALG_ONESIDED:
+            *init = ucc_tl_ucp_alltoallv_onesided_init;
+            break;
+        case UCC_TL_UCP_ALLTOALLV_ALG_SPARSE:
+            *init = ucc_tl_ucp_alltoallv_sparse_init;
+            break;
+        default:
+            status = UCC_ERR_INVALID_PARAM;
+            break;
+        };
+        break;
+    case UCC_COLL_TYPE_ALLGATHER:
+        switch (alg_id) {
+        case UCC_TL_UCP_ALLGATHER_ALG_RING:
+            *init = ucc_tl_ucp_allgather_ring_init;
+            break;
+        case UCC_TL_UCP_ALLGATHER_ALG_ONESIDED:
+            *init = ucc_tl_ucp_allgather_onesided_init;
+            break;
+        default:
+            status = UCC_ERR_INVALID_PARAM;
+            break;
+        };
+        break;
+    case UCC_COLL_TYPE_REDUCE:
+        switch (alg_id) {
+        case UCC_TL_UCP_REDUCE_ALG_KNOMIAL:
+            *init = ucc_tl_ucp_reduce_knomial_init;
+            break;
+        default:
+            status = UCC_ERR_INVALID_PARAM;
+            break;
+        };
+        break;
     case UCC_COLL_TYPE_REDUCE_SCATTER:
         switch (alg_id) {
         case UCC_TL_UCP_REDUCE_SCATTER_ALG_RING:
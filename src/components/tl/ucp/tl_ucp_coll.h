@@ -15,7 +15,7 @@
 #include "components/ec/ucc_ec.h"
 #include "tl_ucp_tag.h"
 
-#define UCC_TL_UCP_N_DEFAULT_ALG_SELECT_STR 5
+#define UCC_TL_UCP_N_DEFAULT_ALG_SELECT_STR 6
 extern const char
     *ucc_tl_ucp_default_alg_select_str[UCC_TL_UCP_N_DEFAULT_ALG_SELECT_STR];
 
@@ -33,6 +33,22 @@ extern const char
 #define INV_VRANK(_rank, _root, _team_size)                                   \
     (((_rank) + (_root)) % (_team_size))
 
+/* Number of fragments and pipeline depth for the pipelined knomial
+   rooted algorithms: the message is split into fragments of at most
+   frag_size, 1 fragment means no pipelining. */
+#define UCC_TL_UCP_KN_PIPELINE_N_FRAGS(_msgsize, _frag_size, _cfg_depth,      \
+                                       _n_frags, _pipeline_depth)             \
+    do {                                                                      \
+        _n_frags = 1;                                                         \
+        if ((_msgsize) > (_frag_size)) {                                      \
+            _n_frags = (_msgsize) / (_frag_size) +                            \
+                       (((_msgsize) % (_frag_size)) ? 1 : 0);                 \
+        }                                                                     \
+        _pipeline_depth = ucc_min(_n_frags, ucc_max(1, (int)(_cfg_depth)));   \
+        _pipeline_depth =                                                     \
+            ucc_min(_pipeline_depth, UCC_SCHEDULE_PIPELINED_MAX_FRAGS);       \
+    } while (0)
+
 #define EXEC_TASK_TEST(_phase, _errmsg, _etask) do {                           \
     if (_etask != NULL) {                                                      \
         status = ucc_ee_executor_task_test(_etask);                            \
@@ -109,11 +125,20 @@ typedef struct ucc_tl_ucp_task {
             ucc_mc_buffer_header_t *scratch_mc_header;
             ucc_ee_executor_task_t *etask;
             ucc_ee_executor_t      *executor;
+            size_t                  chunk_count;
+            int                     chunk;
+            int                     n_chunks;
+            ucc_tl_ucp_compress_t   compress;
+            void                   *wire_send;
+            void                   *wire_recv;
+            void                   *wire_out;
+            ucc_mc_buffer_header_t *wire_mc_header;
         } reduce_scatter_kn;
         struct {
             void                   *scratch;
             size_t                  max_block_count;
             ucc_ep_map_t            inv_map;
+            ucc_rank_t              pos;
             int                     n_frags;
             int                     frag;
             char                    s_scratch_busy[2];
@@ -124,6 +149,7 @@ typedef struct ucc_tl_ucp_task {
             void                   *scratch;
             size_t                  max_block_count;
             ucc_ep_map_t            inv_map;
+            ucc_rank_t              pos;
             int                     n_frags;
             int                     frag;
             char                    s_scratch_busy[2];
@@ -142,6 +168,31 @@ typedef struct ucc_tl_ucp_task {
             void                   *sbuf;
             ucc_ee_executor_task_t *etask;
         } allgather_kn;
+        struct {
+            ucc_ep_map_t            block_map;
+        } allgather_ring;
+        struct {
+            ucc_ep_map_t            inv_map;
+            ucc_rank_t              pos;
+        } allgatherv_ring;
+        struct {
+            ucc_ep_map_t            inv_map;
+            ucc_rank_t              pos;
+            ucc_rank_t              step_mul;
+            ucc_rank_t              step_add;
+            uint32_t                n_starts;
+            int                     random;
+            int                     adaptive;
+            uint32_t                window;
+            uint32_t                round_start;
+            double                  round_time;
+            double                  best_lat;
+        } pairwise;
+        struct {
+            ucc_rank_t             *peers;
+            ucc_rank_t              n_recv;
+            ucc_rank_t              n_send;
+        } alltoallv_sparse;
         struct {
             ucc_rank_t              dist;
             uint32_t                radix;
@@ -181,7 +232,7 @@ typedef struct ucc_tl_ucp_schedule {
     (ucc_derived_of((_task)->super.team->context->lib, ucc_tl_ucp_lib_t))
 #define TASK_ARGS(_task) (_task)->super.bargs.args
 
-#define AVG_ALPHA(_task) (1.0 / (double)UCC_TL_TEAM_SIZE(TASK_TEAM(_task)))
+#define AVG_ALPHA(_task) (1.0 / (double)(_task)->subset.map.ep_num)
 
 static inline void ucc_tl_ucp_task_reset(ucc_tl_ucp_task_t *task,
                                          ucc_status_t status)
@@ -239,6 +290,13 @@ static inline void ucc_tl_ucp_put_schedule(ucc_schedule_t *schedule)
 }
 
 
+/* Number of ranks taking part in the collective: the active set size if
+   args have one, the team size otherwise. Algorithms running on the task
+   use task->subset instead. */
+#define UCC_TL_UCP_COLL_SIZE(_team, _args)                                     \
+    (UCC_COLL_ARGS_ACTIVE_SET(_args) ? (ucc_rank_t)(_args)->active_set.size   \
+                                     : UCC_TL_TEAM_SIZE(_team))
+
 ucc_status_t ucc_tl_ucp_coll_init(ucc_base_coll_args_t *coll_args,
                                   ucc_base_team_t *     team,
                                   ucc_coll_task_t **    task_h);
@@ -264,11 +322,12 @@ ucc_tl_ucp_init_task(ucc_base_coll_args_t *coll_args, ucc_base_team_t *team)
         task->subset.myrank =
             ucc_ep_map_local_rank(task->subset.map,
                                   UCC_TL_TEAM_RANK(tl_team));
-        ucc_assert(coll_args->args.coll_type == UCC_COLL_TYPE_BCAST);
-        /* root value in args corresponds to the  original team ranks,
-           need to convert to subset local value */
-        TASK_ARGS(task).root = ucc_ep_map_local_rank(task->subset.map,
-                                                     coll_args->args.root);
+        if (coll_args->args.coll_type & UCC_COLL_TYPE_ROOTED) {
+            /* root value in args corresponds to the  original team ranks,
+               need to convert to subset local value */
+            TASK_ARGS(task).root =
+                ucc_ep_map_local_rank(task->subset.map, coll_args->args.root);
+        }
     } else {
         if (coll_args->mask & UCC_COLL_ARGS_FIELD_TAG) {
             task->tagged.tag = coll_args->args.tag;
@@ -283,6 +342,32 @@ ucc_tl_ucp_init_task(ucc_base_coll_args_t *coll_args, ucc_base_team_t *team)
     return task;
 }
 
+/* Checks the requirements common for all one-sided algorithms: global work
+   buffer used for completion signaling and memory mapped src/dst buffers.
+   Active sets are not supported, the work buffer counters assume that all
+   the team ranks take part, selection falls back to the tagged algorithms */
+static inline ucc_status_t
+ucc_tl_ucp_onesided_check_args(ucc_base_coll_args_t *coll_args,
+                               ucc_tl_ucp_team_t    *team)
+{
+    if (UCC_COLL_ARGS_ACTIVE_SET(&coll_args->args)) {
+        return UCC_ERR_NOT_SUPPORTED;
+    }
+    if (!(coll_args->args.mask & UCC_COLL_ARGS_FIELD_GLOBAL_WORK_BUFFER)) {
+        tl_error(UCC_TL_TEAM_LIB(team),
+                 "global work buffer not provided nor associated with team");
+        return UCC_ERR_NOT_SUPPORTED;
+    }
+    if (coll_args->args.mask & UCC_COLL_ARGS_FIELD_FLAGS) {
+        if (!(coll_args->args.flags & UCC_COLL_ARGS_FLAG_MEM_MAPPED_BUFFERS)) {
+            tl_error(UCC_TL_TEAM_LIB(team),
+                     "non memory mapped buffers are not supported");
+            return UCC_ERR_NOT_SUPPORTED;
+        }
+    }
+    return UCC_OK;
+}
+
 #define UCC_TL_UCP_TASK_P2P_COMPLETE(_task)                                    \
     (((_task)->tagged.send_posted == (_task)->tagged.send_completed) &&        \
      ((_task)->tagged.recv_posted == (_task)->tagged.recv_completed))
@@ -297,7 +382,7 @@ static inline ucc_status_t ucc_tl_ucp_test(ucc_tl_ucp_task_t *task)
         if (UCC_TL_UCP_TASK_P2P_COMPLETE(task)) {
             return UCC_OK;
         }
-        ucp_worker_progress(TASK_CTX(task)->ucp_worker);
+        ucc_tl_ucp_team_progress(TASK_TEAM(task));
     }
     return UCC_INPROGRESS;
 }
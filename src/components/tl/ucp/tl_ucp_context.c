@@ -28,6 +28,7 @@ UCC_CLASS_INIT_FUNC(ucc_tl_ucp_context_t,
     ucp_context_h       ucp_context;
     ucp_worker_h        ucp_worker;
     ucs_status_t        status;
+    uint32_t            i;
 
     UCC_CLASS_CALL_SUPER_INIT(ucc_tl_context_t, &tl_ucp_config->super,
                               params->context);
@@ -91,28 +92,45 @@ UCC_CLASS_INIT_FUNC(ucc_tl_ucp_context_t,
         ucc_assert(0);
         break;
     }
-    status = ucp_worker_create(ucp_context, &worker_params, &ucp_worker);
-    if (UCS_OK != status) {
-        tl_error(self->super.super.lib, "failed to create ucp worker, %s",
-                 ucs_status_string(status));
-        ucc_status = ucs_status_to_ucc_status(status);
+
+    if (self->cfg.n_workers == 0) {
+        tl_warn(self->super.super.lib, "N_WORKERS must be positive, using 1");
+        self->cfg.n_workers = 1;
+    }
+    self->n_workers = self->cfg.n_workers;
+    self->workers   = ucc_calloc(self->n_workers, sizeof(ucc_tl_ucp_worker_t),
+                                 "ucp_workers");
+    if (!self->workers) {
+        tl_error(self->super.super.lib,
+                 "failed to allocate %zd bytes for ucp workers",
+                 self->n_workers * sizeof(ucc_tl_ucp_worker_t));
+        ucc_status = UCC_ERR_NO_MEMORY;
         goto err_worker_create;
     }
 
-    if (params->thread_mode == UCC_THREAD_MULTIPLE) {
-        worker_attr.field_mask = UCP_WORKER_ATTR_FIELD_THREAD_MODE;
-        ucp_worker_query(ucp_worker, &worker_attr);
-        if (worker_attr.thread_mode != UCS_THREAD_MODE_MULTI) {
-            tl_error(self->super.super.lib,
-                     "thread mode multiple is not supported by ucp worker");
-            ucc_status = UCC_ERR_NOT_SUPPORTED;
+    for (i = 0; i < self->n_workers; i++) {
+        status = ucp_worker_create(ucp_context, &worker_params, &ucp_worker);
+        if (UCS_OK != status) {
+            tl_error(self->super.super.lib, "failed to create ucp worker, %s",
+                     ucs_status_string(status));
+            ucc_status = ucs_status_to_ucc_status(status);
             goto err_thread_mode;
         }
+        self->workers[i].ucp_worker = ucp_worker;
+
+        if (params->thread_mode == UCC_THREAD_MULTIPLE) {
+            worker_attr.field_mask = UCP_WORKER_ATTR_FIELD_THREAD_MODE;
+            ucp_worker_query(ucp_worker, &worker_attr);
+            if (worker_attr.thread_mode != UCS_THREAD_MODE_MULTI) {
+                tl_error(self->super.super.lib,
+                         "thread mode multiple is not supported by ucp worker");
+                ucc_status = UCC_ERR_NOT_SUPPORTED;
+                goto err_thread_mode;
+            }
+        }
     }
 
     self->ucp_context = ucp_context;
-    self->ucp_worker  = ucp_worker;
-    self->worker_address = NULL;
 
     ucc_status = ucc_mpool_init(
         &self->req_mp, 0,
@@ -124,13 +142,29 @@ UCC_CLASS_INIT_FUNC(ucc_tl_ucp_context_t,
                  "failed to initialize tl_ucp_req mpool");
         goto err_thread_mode;
     }
-    if (UCC_OK != ucc_context_progress_register(
-                      params->context,
-                      (ucc_context_progress_fn_t)ucp_worker_progress,
-                      self->ucp_worker)) {
-        tl_error(self->super.super.lib, "failed to register progress function");
-        ucc_status = UCC_ERR_NO_MESSAGE;
-        goto err_thread_mode;
+    ucc_status = ucc_mpool_init(&self->stripe_mp, 0,
+                                sizeof(ucc_tl_ucp_stripe_req_t), 0,
+                                UCC_CACHE_LINE_SIZE, 16, UINT_MAX, NULL,
+                                params->thread_mode, "tl_ucp_stripe_mp");
+    if (UCC_OK != ucc_status) {
+        tl_error(self->super.super.lib,
+                 "failed to initialize tl_ucp_stripe mpool");
+        goto err_am_init;
+    }
+    ucc_status = ucc_tl_ucp_am_init(self, params->thread_mode);
+    if (UCC_OK != ucc_status) {
+        goto err_stripe_mp;
+    }
+    for (i = 0; i < self->n_workers; i++) {
+        if (UCC_OK != ucc_context_progress_register(
+                          params->context,
+                          (ucc_context_progress_fn_t)ucp_worker_progress,
+                          self->workers[i].ucp_worker)) {
+            tl_error(self->super.super.lib,
+                     "failed to register progress function");
+            ucc_status = UCC_ERR_NO_MESSAGE;
+            goto err_stripe_mp;
+        }
     }
 
     self->remote_info  = NULL;
@@ -142,29 +176,43 @@ UCC_CLASS_INIT_FUNC(ucc_tl_ucp_context_t,
             self, params->params.mem_params, params->params.oob);
         if (UCC_OK != ucc_status) {
             tl_error(self->super.super.lib, "failed to gather RMA information");
-            goto err_thread_mode;
+            goto err_stripe_mp;
         }
     }
-    if (params->context->params.mask & UCC_CONTEXT_PARAM_FIELD_OOB) {
-        /* Global ctx mode, we will have ctx_map so can use array for eps */
-        self->eps = ucc_calloc(params->context->params.oob.n_oob_eps,
-                               sizeof(ucp_ep_h), "ucp_eps");
-        if (!self->eps) {
-            tl_error(self->super.super.lib,
-                     "failed to allocate %zd bytes for ucp_eps",
-                     params->context->params.oob.n_oob_eps * sizeof(ucp_ep_h));
-            ucc_status = UCC_ERR_NO_MEMORY;
-            goto err_thread_mode;
+    for (i = 0; i < self->n_workers; i++) {
+        if (params->context->params.mask & UCC_CONTEXT_PARAM_FIELD_OOB) {
+            /* Global ctx mode, we will have ctx_map so can use array for eps */
+            self->workers[i].eps =
+                ucc_calloc(params->context->params.oob.n_oob_eps,
+                           sizeof(ucp_ep_h), "ucp_eps");
+            if (!self->workers[i].eps) {
+                tl_error(self->super.super.lib,
+                         "failed to allocate %zd bytes for ucp_eps",
+                         params->context->params.oob.n_oob_eps *
+                             sizeof(ucp_ep_h));
+                ucc_status = UCC_ERR_NO_MEMORY;
+                goto err_stripe_mp;
+            }
+        } else {
+            self->workers[i].eps     = NULL;
+            self->workers[i].ep_hash = kh_init(tl_ucp_ep_hash);
         }
-    } else {
-        self->eps     = NULL;
-        self->ep_hash = kh_init(tl_ucp_ep_hash);
     }
-    tl_info(self->super.super.lib, "initialized tl context: %p", self);
+    tl_info(self->super.super.lib, "initialized tl context: %p, n_workers %u",
+            self, self->n_workers);
     return UCC_OK;
 
+err_stripe_mp:
+    ucc_mpool_cleanup(&self->stripe_mp, 1);
+err_am_init:
+    ucc_mpool_cleanup(&self->req_mp, 1);
 err_thread_mode:
-    ucp_worker_destroy(ucp_worker);
+    for (i = 0; i < self->n_workers; i++) {
+        if (self->workers[i].ucp_worker) {
+            ucp_worker_destroy(self->workers[i].ucp_worker);
+        }
+    }
+    ucc_free(self->workers);
 err_worker_create:
     ucp_cleanup(ucp_context);
 err_cfg:
@@ -178,6 +226,7 @@ static void ucc_tl_ucp_context_barrier(ucc_tl_ucp_context_t *ctx,
     ucc_status_t status;
     char         sbuf;
     void        *req;
+    uint32_t     i;
 
     if (ucc_unlikely(oob->n_oob_eps < 2)) {
         return;
@@ -194,7 +243,9 @@ static void ucc_tl_ucp_context_barrier(ucc_tl_ucp_context_t *ctx,
                                  &req)) {
         ucc_assert(req);
         while (UCC_OK != (status = oob->req_test(req))) {
-            ucp_worker_progress(ctx->ucp_worker);
+            for (i = 0; i < ctx->n_workers; i++) {
+                ucp_worker_progress(ctx->workers[i].ucp_worker);
+            }
             if (status < 0) {
                 tl_error(ctx->super.super.lib, "failed to test oob req");
                 break;
@@ -235,12 +286,17 @@ ucc_status_t ucc_tl_ucp_rinfo_destroy(ucc_tl_ucp_context_t *ctx)
 
 UCC_CLASS_CLEANUP_FUNC(ucc_tl_ucp_context_t)
 {
+    ucc_tl_ucp_worker_t *w;
+    uint32_t             i;
+
     tl_info(self->super.super.lib, "finalizing tl context: %p", self);
     ucc_tl_ucp_close_eps(self);
-    if (self->eps) {
-        ucc_free(self->eps);
-    } else {
-        kh_destroy(tl_ucp_ep_hash, self->ep_hash);
+    for (i = 0; i < self->n_workers; i++) {
+        if (self->workers[i].eps) {
+            ucc_free(self->workers[i].eps);
+        } else {
+            kh_destroy(tl_ucp_ep_hash, self->workers[i].ep_hash);
+        }
     }
     if (self->remote_info) {
         ucc_tl_ucp_rinfo_destroy(self);
@@ -248,13 +304,21 @@ UCC_CLASS_CLEANUP_FUNC(ucc_tl_ucp_context_t)
     if (UCC_TL_CTX_HAS_OOB(self)) {
         ucc_tl_ucp_context_barrier(self, &UCC_TL_CTX_OOB(self));
     }
-    ucc_context_progress_deregister(
-        self->super.super.ucc_context,
-        (ucc_context_progress_fn_t)ucp_worker_progress, self->ucp_worker);
-    if (self->worker_address) {
-        ucp_worker_release_address(self->ucp_worker, self->worker_address);
+    for (i = 0; i < self->n_workers; i++) {
+        w = &self->workers[i];
+        ucc_context_progress_deregister(
+            self->super.super.ucc_context,
+            (ucc_context_progress_fn_t)ucp_worker_progress, w->ucp_worker);
+        if (w->worker_address) {
+            ucp_worker_release_address(w->ucp_worker, w->worker_address);
+        }
     }
-    ucp_worker_destroy(self->ucp_worker);
+    ucc_tl_ucp_am_cleanup(self);
+    for (i = 0; i < self->n_workers; i++) {
+        ucp_worker_destroy(self->workers[i].ucp_worker);
+    }
+    ucc_free(self->workers);
+    ucc_mpool_cleanup(&self->stripe_mp, 1);
     ucc_mpool_cleanup(&self->req_mp, 1);
     ucp_cleanup(self->ucp_context);
 }
@@ -403,27 +467,62 @@ static void ucc_tl_ucp_ctx_remote_pack_data(ucc_tl_ucp_context_t *ctx,
     }
 }
 
+/* Size of the workers section of the ctx address, see tl_ucp_ep.h */
+static inline size_t ucc_tl_ucp_ctx_workers_addrlen(ucc_tl_ucp_context_t *ctx)
+{
+    size_t   len = TL_UCP_EP_ADDRLEN_SIZE;
+    uint32_t i;
+
+    for (i = 0; i < ctx->n_workers; i++) {
+        len += TL_UCP_EP_ADDRLEN_SIZE + ctx->workers[i].ucp_addrlen;
+    }
+    return len;
+}
+
+static void ucc_tl_ucp_ctx_workers_pack(ucc_tl_ucp_context_t *ctx, void *pack)
+{
+    void    *p = PTR_OFFSET(pack, 2 * TL_UCP_EP_ADDRLEN_SIZE);
+    uint32_t i;
+
+    TL_UCP_EP_ADDR_WORKERS_LEN(pack) = ucc_tl_ucp_ctx_workers_addrlen(ctx);
+    TL_UCP_EP_ADDR_N_WORKERS(pack)   = ctx->n_workers;
+    for (i = 0; i < ctx->n_workers; i++) {
+        *((uint64_t*)p) = ctx->workers[i].ucp_addrlen;
+        memcpy(PTR_OFFSET(p, TL_UCP_EP_ADDRLEN_SIZE),
+               ctx->workers[i].worker_address, ctx->workers[i].ucp_addrlen);
+        p = PTR_OFFSET(p, TL_UCP_EP_ADDRLEN_SIZE + ctx->workers[i].ucp_addrlen);
+    }
+}
+
 ucc_status_t ucc_tl_ucp_get_context_attr(const ucc_base_context_t *context,
                                          ucc_base_ctx_attr_t      *attr)
 {
     ucc_tl_ucp_context_t *ctx = ucc_derived_of(context, ucc_tl_ucp_context_t);
+    ucc_tl_ucp_worker_t  *w;
     ucs_status_t          ucs_status;
     size_t                packed_length;
     int                   i;
 
-    if ((attr->attr.mask & (UCC_CONTEXT_ATTR_FIELD_CTX_ADDR_LEN |
-                            UCC_CONTEXT_ATTR_FIELD_CTX_ADDR)) &&
-        (NULL == ctx->worker_address)) {
-        ucs_status = ucp_worker_get_address(
-            ctx->ucp_worker, &ctx->worker_address, &ctx->ucp_addrlen);
-        if (UCS_OK != ucs_status) {
-            tl_error(ctx->super.super.lib, "failed to get ucp worker address");
-            return ucs_status_to_ucc_status(ucs_status);
+    if (attr->attr.mask & (UCC_CONTEXT_ATTR_FIELD_CTX_ADDR_LEN |
+                           UCC_CONTEXT_ATTR_FIELD_CTX_ADDR)) {
+        for (i = 0; i < ctx->n_workers; i++) {
+            w = &ctx->workers[i];
+            if (NULL != w->worker_address) {
+                continue;
+            }
+            ucs_status = ucp_worker_get_address(
+                w->ucp_worker, &w->worker_address, &w->ucp_addrlen);
+            if (UCS_OK != ucs_status) {
+                tl_error(ctx->super.super.lib,
+                         "failed to get ucp worker address");
+                return ucs_status_to_ucc_status(ucs_status);
+            }
         }
     }
 
     if (attr->attr.mask & UCC_CONTEXT_ATTR_FIELD_CTX_ADDR_LEN) {
-        packed_length = TL_UCP_EP_ADDRLEN_SIZE + ctx->ucp_addrlen;
+        packed_length = TL_UCP_EP_ADDRLEN_SIZE +
+                        ucc_tl_ucp_ctx_workers_addrlen(ctx);
         if (NULL != ctx->remote_info) {
             packed_length += ctx->n_rinfo_segs * (sizeof(size_t) * 3);
             for (i = 0; i < ctx->n_rinfo_segs; i++) {
@@ -433,9 +532,7 @@ ucc_status_t ucc_tl_ucp_get_context_attr(const ucc_base_context_t *context,
         attr->attr.ctx_addr_len = packed_length;
     }
     if (attr->attr.mask & UCC_CONTEXT_ATTR_FIELD_CTX_ADDR) {
-        *((uint64_t*)attr->attr.ctx_addr) = ctx->ucp_addrlen;
-        memcpy(TL_UCP_EP_ADDR_WORKER(attr->attr.ctx_addr),
-               ctx->worker_address, ctx->ucp_addrlen);
+        ucc_tl_ucp_ctx_workers_pack(ctx, attr->attr.ctx_addr);
         if (NULL != ctx->remote_info) {
             ucc_tl_ucp_ctx_remote_pack_data(ctx,
                             TL_UCP_EP_ADDR_ONESIDED_INFO(attr->attr.ctx_addr));
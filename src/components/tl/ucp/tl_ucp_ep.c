@@ -10,6 +10,7 @@ static void ucc_tl_ucp_err_handler(void *arg, ucp_ep_h ep, ucs_status_t status)
 }
 
 static inline ucc_status_t ucc_tl_ucp_connect_ep(ucc_tl_ucp_context_t *ctx,
+                                                 ucp_worker_h          worker,
                                                  ucp_ep_h             *ep,
                                                  void *ucp_address)
 {
@@ -29,7 +30,7 @@ static inline ucc_status_t ucc_tl_ucp_connect_ep(ucc_tl_ucp_context_t *ctx,
         ep_params.field_mask     |= UCP_EP_PARAM_FIELD_ERR_HANDLING_MODE |
                                     UCP_EP_PARAM_FIELD_ERR_HANDLER;
     }
-    status = ucp_ep_create(ctx->ucp_worker, &ep_params, ep);
+    status = ucp_ep_create(worker, &ep_params, ep);
 
     if (ucc_unlikely(UCS_OK != status)) {
         tl_error(ctx->super.super.lib, "ucp returned connect error: %s",
@@ -40,38 +41,49 @@ static inline ucc_status_t ucc_tl_ucp_connect_ep(ucc_tl_ucp_context_t *ctx,
 }
 
 ucc_status_t ucc_tl_ucp_connect_team_ep(ucc_tl_ucp_team_t *team,
-                                        ucc_rank_t core_rank, ucp_ep_h *ep)
+                                        ucc_rank_t core_rank,
+                                        uint32_t worker_id, ucp_ep_h *ep)
 {
     ucc_tl_ucp_context_t *ctx = UCC_TL_UCP_TEAM_CTX(team);
     void                 *addr;
 
     addr = ucc_get_team_ep_addr(UCC_TL_CORE_CTX(team), UCC_TL_CORE_TEAM(team),
                                 core_rank, ucc_tl_ucp.super.super.id);
-    return ucc_tl_ucp_connect_ep(ctx, ep, TL_UCP_EP_ADDR_WORKER(addr));
+    if (TL_UCP_EP_ADDR_N_WORKERS(addr) != ctx->n_workers) {
+        tl_error(ctx->super.super.lib,
+                 "number of workers mismatch: local %u, remote %u, "
+                 "UCC_TL_UCP_N_WORKERS must be the same on all the processes",
+                 ctx->n_workers, (uint32_t)TL_UCP_EP_ADDR_N_WORKERS(addr));
+        return UCC_ERR_INVALID_PARAM;
+    }
+    return ucc_tl_ucp_connect_ep(ctx, ctx->workers[worker_id].ucp_worker, ep,
+                                 tl_ucp_ep_addr_worker(addr, worker_id));
 }
 
 /* Finds next non-NULL ep in the storage and returns that handle
    for closure. In case of "hash" storage it pops the item,
    in case of "array" sets it to NULL */
-static inline ucp_ep_h get_next_ep_to_close(ucc_tl_ucp_context_t *ctx, int *i)
+static inline ucp_ep_h get_next_ep_to_close(ucc_tl_ucp_context_t *ctx,
+                                            ucc_tl_ucp_worker_t  *w, int *i)
 {
     ucp_ep_h   ep = NULL;
     ucc_rank_t size;
 
-    if (ctx->eps) {
+    if (w->eps) {
         size = (ucc_rank_t)ctx->super.super.ucc_context->params.oob.n_oob_eps;
         while (NULL == ep && (*i) < size) {
-            ep           = ctx->eps[*i];
-            ctx->eps[*i] = NULL;
+            ep         = w->eps[*i];
+            w->eps[*i] = NULL;
             (*i)++;
         }
     } else {
-        ep = tl_ucp_hash_pop(ctx->ep_hash);
+        ep = tl_ucp_hash_pop(w->ep_hash);
     }
     return ep;
 }
 
-void ucc_tl_ucp_close_eps(ucc_tl_ucp_context_t *ctx)
+static void ucc_tl_ucp_close_worker_eps(ucc_tl_ucp_context_t *ctx,
+                                        ucc_tl_ucp_worker_t  *w)
 {
      int                          i = 0;
      ucp_ep_h                     ep;
@@ -81,13 +93,13 @@ void ucc_tl_ucp_close_eps(ucc_tl_ucp_context_t *ctx)
 
      param.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS;
      param.flags        = 0; // 0 means FLUSH
-     ep                 = get_next_ep_to_close(ctx, &i);
+     ep                 = get_next_ep_to_close(ctx, w, &i);
      while (ep) {
          close_req = ucp_ep_close_nbx(ep, &param);
 
          if (UCS_PTR_IS_PTR(close_req)) {
              do {
-                 ucp_worker_progress(ctx->ucp_worker);
+                 ucp_worker_progress(w->ucp_worker);
                  status = ucp_request_check_status(close_req);
              } while (status == UCS_INPROGRESS);
              ucp_request_free(close_req);
@@ -100,6 +112,15 @@ void ucc_tl_ucp_close_eps(ucc_tl_ucp_context_t *ctx)
                       "error during ucp ep close, ep %p, status %s",
                       ep, ucs_status_string(status));
          }
-         ep = get_next_ep_to_close(ctx, &i);
+         ep = get_next_ep_to_close(ctx, w, &i);
      }
 }
+
+void ucc_tl_ucp_close_eps(ucc_tl_ucp_context_t *ctx)
+{
+    uint32_t i;
+
+    for (i = 0; i < ctx->n_workers; i++) {
+        ucc_tl_ucp_close_worker_eps(ctx, &ctx->workers[i]);
+    }
+}
@@ -14,20 +14,39 @@
 
 /* TL/UCP endpoint address layout: (ucp_addrlen may very per proc)
 
-   [ucp_addrlen][ucp_worker_address][onesided_info]
-       8 bytes    ucp_addrlen bytes
+   [workers_len][n_workers][ucp_addrlen_0][ucp_worker_address_0]...
+      8 bytes     8 bytes     8 bytes       ucp_addrlen_0 bytes
+
+   ...[ucp_addrlen_n-1][ucp_worker_address_n-1][onesided_info]
+
+   workers_len covers everything between itself and onesided_info
 */
 #define TL_UCP_EP_ADDRLEN_SIZE 8
-#define TL_UCP_EP_ADDR_WORKER_LEN(_addr) (*((uint64_t*)(_addr)))
-#define TL_UCP_EP_ADDR_WORKER(_addr) PTR_OFFSET((_addr), 8)
-#define TL_UCP_EP_ADDR_ONESIDED_INFO(_addr) \
-    PTR_OFFSET((_addr), 8 + TL_UCP_EP_ADDR_WORKER_LEN(_addr))
+#define TL_UCP_EP_ADDR_WORKERS_LEN(_addr) (*((uint64_t*)(_addr)))
+#define TL_UCP_EP_ADDR_N_WORKERS(_addr)                                        \
+    (*((uint64_t*)PTR_OFFSET((_addr), TL_UCP_EP_ADDRLEN_SIZE)))
+#define TL_UCP_EP_ADDR_ONESIDED_INFO(_addr)                                    \
+    PTR_OFFSET((_addr), TL_UCP_EP_ADDRLEN_SIZE +                              \
+                            TL_UCP_EP_ADDR_WORKERS_LEN(_addr))
+
+/* Returns the address of the worker _worker_id of the remote context */
+static inline void *tl_ucp_ep_addr_worker(void *addr, uint32_t worker_id)
+{
+    void    *p = PTR_OFFSET(addr, 2 * TL_UCP_EP_ADDRLEN_SIZE);
+    uint32_t i;
+
+    for (i = 0; i < worker_id; i++) {
+        p = PTR_OFFSET(p, TL_UCP_EP_ADDRLEN_SIZE + *((uint64_t*)p));
+    }
+    return PTR_OFFSET(p, TL_UCP_EP_ADDRLEN_SIZE);
+}
 
 typedef struct ucc_tl_ucp_context ucc_tl_ucp_context_t;
 typedef struct ucc_tl_ucp_team    ucc_tl_ucp_team_t;
 
 ucc_status_t ucc_tl_ucp_connect_team_ep(ucc_tl_ucp_team_t         *team,
                                         ucc_rank_t                 team_rank,
+                                        uint32_t                   worker_id,
                                         ucp_ep_h                  *ep);
 
 void ucc_tl_ucp_close_eps(ucc_tl_ucp_context_t *ctx);
@@ -40,43 +59,67 @@ ucc_tl_ucp_get_team_ep_header(ucc_tl_ucp_team_t *team, ucc_rank_t core_rank)
                                   core_rank);
 }
 
-static inline ucc_status_t ucc_tl_ucp_get_ep(ucc_tl_ucp_team_t *team, ucc_rank_t rank,
-                                             ucp_ep_h *ep)
+/* Returns the endpoint from the worker worker_id of this context to the
+   worker with the same id of the context of the team rank. Endpoints of
+   the team worker are kept in the team by team rank, so that repeated
+   sends (e.g. reposts of persistent collectives) skip the rank mapping
+   and the context lookup. */
+static inline ucc_status_t
+ucc_tl_ucp_get_worker_ep(ucc_tl_ucp_team_t *team, ucc_rank_t rank,
+                         uint32_t worker_id, ucp_ep_h *ep)
 {
     ucc_tl_ucp_context_t      *ctx      = UCC_TL_UCP_TEAM_CTX(team);
+    ucc_tl_ucp_worker_t       *w        = &ctx->workers[worker_id];
     ucc_context_addr_header_t *h        = NULL;
     ucc_rank_t                 ctx_rank = 0;
     ucc_status_t               status;
     ucc_rank_t                 core_rank;
 
+    if (ucc_likely(worker_id == team->worker_id)) {
+        *ep = team->eps[rank];
+        if (ucc_likely(NULL != *ep)) {
+            return UCC_OK;
+        }
+    }
     core_rank = ucc_ep_map_eval(UCC_TL_TEAM_MAP(team), rank);
-    if (ctx->eps) {
+    if (w->eps) {
         ucc_team_t *core_team = UCC_TL_CORE_TEAM(team);
         /* Core super.super.team ptr is NULL for service_team
            which has scope == UCC_CL_LAST + 1*/
         ucc_assert((NULL != core_team) || IS_SERVICE_TEAM(team));
         ctx_rank = core_team ? ucc_get_ctx_rank(core_team, core_rank)
                        : core_rank;
-        *ep      = ctx->eps[ctx_rank];
+        *ep      = w->eps[ctx_rank];
     } else {
         h   = ucc_tl_ucp_get_team_ep_header(team, core_rank);
-        *ep = tl_ucp_hash_get(ctx->ep_hash, h->ctx_id);
+        *ep = tl_ucp_hash_get(w->ep_hash, h->ctx_id);
     }
     if (NULL == (*ep)) {
         /* Not connected yet */
-        status = ucc_tl_ucp_connect_team_ep(team, core_rank, ep);
+        status = ucc_tl_ucp_connect_team_ep(team, core_rank, worker_id, ep);
         if (ucc_unlikely(UCC_OK != status)) {
             tl_error(UCC_TL_TEAM_LIB(team), "failed to connect team ep");
             *ep = NULL;
             return status;
         }
-        if (ctx->eps) {
-            ctx->eps[ctx_rank] = *ep;
+        if (w->eps) {
+            w->eps[ctx_rank] = *ep;
         } else {
-            tl_ucp_hash_put(ctx->ep_hash, h->ctx_id, *ep);
+            tl_ucp_hash_put(w->ep_hash, h->ctx_id, *ep);
         }
     }
+    if (worker_id == team->worker_id) {
+        team->eps[rank] = *ep;
+    }
     return UCC_OK;
 }
 
+/* Endpoint on the service worker, used by active messages and one-sided
+   operations */
+static inline ucc_status_t ucc_tl_ucp_get_ep(ucc_tl_ucp_team_t *team,
+                                             ucc_rank_t rank, ucp_ep_h *ep)
+{
+    return ucc_tl_ucp_get_worker_ep(team, rank, 0, ep);
+}
+
 #endif
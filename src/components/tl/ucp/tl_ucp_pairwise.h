@@ -0,0 +1,186 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCC_TL_UCP_PAIRWISE_H_
+#define UCC_TL_UCP_PAIRWISE_H_
+
+#include "tl_ucp.h"
+#include "tl_ucp_coll.h"
+#include "utils/ucc_math.h"
+#include "utils/ucc_time.h"
+#include "utils/ucc_coll_utils.h"
+
+/* Peer order and window of outstanding messages shared by the pairwise
+   alltoall and alltoallv.
+
+   At step s rank in position pos of inv_map receives from position
+   pos + perm(s) and sends to position pos - perm(s), where perm is the
+   affine permutation of the steps (step_mul * s + step_add) % size.
+   Peers are returned as ranks of task->subset (team or active set), which
+   is also the order of the data blocks; map them with task->subset.map
+   to get the endpoint.
+   Any permutation of the steps keeps the pairs matched as long as all
+   the ranks use the same one: the random schedule derives it from the
+   tag and the number of starts of the task which are equal on all the
+   ranks. */
+
+static inline ucc_rank_t ucc_tl_ucp_pairwise_gcd(ucc_rank_t a, ucc_rank_t b)
+{
+    ucc_rank_t t;
+
+    while (b) {
+        t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static inline uint32_t ucc_tl_ucp_pairwise_hash(uint32_t a, uint32_t b)
+{
+    uint32_t x = a * 0x9e3779b1u + b;
+
+    x ^= x >> 16;
+    x *= 0x85ebca6bu;
+    x ^= x >> 13;
+    x *= 0xc2b2ae35u;
+    x ^= x >> 16;
+    return x;
+}
+
+static inline ucc_status_t
+ucc_tl_ucp_pairwise_init(ucc_tl_ucp_task_t             *task,
+                         ucc_tl_ucp_pairwise_schedule_t schedule,
+                         int                            adaptive)
+{
+    ucc_tl_ucp_team_t *team = TASK_TEAM(task);
+    ucc_rank_t         size = (ucc_rank_t)task->subset.map.ep_num;
+    ucc_tl_ucp_ring_t *ring;
+    ucc_status_t       status;
+
+    if (schedule == UCC_TL_UCP_PAIRWISE_SCHEDULE_NODE &&
+        !UCC_COLL_ARGS_ACTIVE_SET(&TASK_ARGS(task))) {
+        /* ranks of a node are adjacent in the ring order, so the peers of
+           a node in a step are located on few other nodes */
+        status = ucc_tl_ucp_team_get_ring(team, 0, &ring);
+        if (ucc_unlikely(UCC_OK != status)) {
+            return status;
+        }
+        task->pairwise.inv_map = ring->inv_map;
+        task->pairwise.pos     = ucc_ep_map_eval(ring->map,
+                                                 UCC_TL_TEAM_RANK(team));
+    } else {
+        task->pairwise.inv_map.type   = UCC_EP_MAP_FULL;
+        task->pairwise.inv_map.ep_num = size;
+        task->pairwise.pos            = task->subset.myrank;
+    }
+    task->pairwise.random   = (schedule == UCC_TL_UCP_PAIRWISE_SCHEDULE_RANDOM);
+    task->pairwise.adaptive = adaptive;
+    task->pairwise.step_mul = 1;
+    task->pairwise.step_add = 0;
+    task->pairwise.n_starts = 0;
+    return UCC_OK;
+}
+
+/* Called on every start of the task: picks the steps permutation and the
+   initial window. The adaptive window continues from the value reached
+   by the previous collective of the team. */
+static inline void ucc_tl_ucp_pairwise_start(ucc_tl_ucp_task_t *task,
+                                             uint32_t           num_posts,
+                                             uint32_t           team_window)
+{
+    ucc_rank_t size = (ucc_rank_t)task->subset.map.ep_num;
+    uint32_t   seed;
+    ucc_rank_t mul;
+
+    if (task->pairwise.random && size > 2) {
+        seed = ucc_tl_ucp_pairwise_hash(task->tagged.tag,
+                                        task->pairwise.n_starts);
+        mul  = 1 + seed % (size - 1);
+        while (ucc_tl_ucp_pairwise_gcd(mul, size) != 1) {
+            mul = (mul % (size - 1)) + 1;
+        }
+        task->pairwise.step_mul = mul;
+        task->pairwise.step_add = (seed >> 16) % size;
+    }
+    task->pairwise.n_starts++;
+
+    task->pairwise.window = (num_posts > size || num_posts == 0) ? size
+                                                                 : num_posts;
+    if (task->pairwise.adaptive) {
+        if (team_window) {
+            task->pairwise.window = team_window;
+        }
+        task->pairwise.round_start = 0;
+        task->pairwise.round_time  = ucc_get_time();
+        task->pairwise.best_lat    = 0;
+    }
+}
+
+static inline ucc_rank_t ucc_tl_ucp_pairwise_step(ucc_tl_ucp_task_t *task,
+                                                  ucc_rank_t         size,
+                                                  uint32_t           step)
+{
+    return (ucc_rank_t)(((uint64_t)task->pairwise.step_mul * step +
+                         task->pairwise.step_add) % size);
+}
+
+static inline ucc_rank_t ucc_tl_ucp_pairwise_recv_peer(ucc_tl_ucp_task_t *task,
+                                                       ucc_rank_t         size,
+                                                       uint32_t           step)
+{
+    ucc_rank_t s = ucc_tl_ucp_pairwise_step(task, size, step);
+
+    return ucc_ep_map_eval(task->pairwise.inv_map,
+                           (task->pairwise.pos + s) % size);
+}
+
+static inline ucc_rank_t ucc_tl_ucp_pairwise_send_peer(ucc_tl_ucp_task_t *task,
+                                                       ucc_rank_t         size,
+                                                       uint32_t           step)
+{
+    ucc_rank_t s = ucc_tl_ucp_pairwise_step(task, size, step);
+
+    return ucc_ep_map_eval(task->pairwise.inv_map,
+                           (task->pairwise.pos - s + size) % size);
+}
+
+/* Adaptive window: once twice the window of messages completed since the
+   last update the average time per message of this round is compared
+   with the best one seen. The window grows by a quarter while the time
+   stays within 1.5x of the best and is halved when it degrades, i.e.
+   when more messages in flight only add up to congestion. */
+static inline void ucc_tl_ucp_pairwise_update_window(ucc_tl_ucp_task_t *task,
+                                                     ucc_rank_t         size)
+{
+    uint32_t done, n;
+    double   now, lat;
+
+    if (!task->pairwise.adaptive) {
+        return;
+    }
+    done = task->tagged.send_completed + task->tagged.recv_completed;
+    n    = done - task->pairwise.round_start;
+    if (n < 2 * task->pairwise.window) {
+        return;
+    }
+    now = ucc_get_time();
+    lat = (now - task->pairwise.round_time) / n;
+    if (task->pairwise.best_lat == 0 || lat < task->pairwise.best_lat) {
+        task->pairwise.best_lat = lat;
+    }
+    if (lat <= 1.5 * task->pairwise.best_lat) {
+        task->pairwise.window =
+            ucc_min(size, task->pairwise.window +
+                              ucc_max(1, task->pairwise.window / 4));
+    } else {
+        task->pairwise.window = ucc_max(1, task->pairwise.window / 2);
+    }
+    task->pairwise.round_start = done;
+    task->pairwise.round_time  = now;
+}
+
+#endif
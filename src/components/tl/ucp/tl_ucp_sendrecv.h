@@ -13,6 +13,8 @@
 #include "tl_ucp_tag.h"
 #include "tl_ucp_ep.h"
 #include "utils/ucc_compiler_def.h"
+#include "utils/ucc_atomic.h"
+#include "utils/ucc_coll_utils.h"
 #include "components/mc/base/ucc_mc_base.h"
 
 void ucc_tl_ucp_send_completion_cb(void *request, ucs_status_t status,
@@ -28,6 +30,13 @@ void ucc_tl_ucp_recv_completion_cb(void *request, ucs_status_t status,
                                    const ucp_tag_recv_info_t *info,
                                    void *user_data);
 
+void ucc_tl_ucp_send_stripe_completion_cb(void *request, ucs_status_t status,
+                                          void *user_data);
+
+void ucc_tl_ucp_recv_stripe_completion_cb(void *request, ucs_status_t status,
+                                          const ucp_tag_recv_info_t *info,
+                                          void *user_data);
+
 #define UCC_TL_UCP_MAKE_TAG(_user_tag, _tag, _rank, _id, _scope_id, _scope)    \
     ((((uint64_t) (_user_tag)) << UCC_TL_UCP_USER_TAG_BITS_OFFSET) |           \
      (((uint64_t) (_tag))      << UCC_TL_UCP_TAG_BITS_OFFSET)      |           \
@@ -66,9 +75,10 @@ void ucc_tl_ucp_recv_completion_cb(void *request, ucs_status_t status,
     } while (0)
 
 static inline ucs_status_ptr_t
-ucc_tl_ucp_send_common(void *buffer, size_t msglen, ucc_memory_type_t mtype,
-                       ucc_rank_t dest_group_rank, ucc_tl_ucp_team_t *team,
-                       ucc_tl_ucp_task_t *task, ucp_send_nbx_callback_t cb)
+ucc_tl_ucp_tag_send(void *buffer, size_t msglen, ucc_memory_type_t mtype,
+                    ucc_rank_t dest_group_rank, uint32_t worker_id,
+                    ucc_tl_ucp_team_t *team, ucc_tl_ucp_task_t *task,
+                    ucp_send_nbx_callback_t cb, void *user_data)
 {
     ucc_coll_args_t    *args = &TASK_ARGS(task);
     ucp_request_param_t req_param;
@@ -76,7 +86,7 @@ ucc_tl_ucp_send_common(void *buffer, size_t msglen, ucc_memory_type_t mtype,
     ucp_ep_h            ep;
     ucp_tag_t           ucp_tag;
 
-    status = ucc_tl_ucp_get_ep(team, dest_group_rank, &ep);
+    status = ucc_tl_ucp_get_worker_ep(team, dest_group_rank, worker_id, &ep);
     if (ucc_unlikely(UCC_OK != status)) {
         return UCS_STATUS_PTR(UCS_ERR_NO_MESSAGE);
     }
@@ -89,11 +99,157 @@ ucc_tl_ucp_send_common(void *buffer, size_t msglen, ucc_memory_type_t mtype,
     req_param.datatype    = ucp_dt_make_contig(msglen);
     req_param.cb.send     = cb;
     req_param.memory_type = ucc_memtype_to_ucs[mtype];
-    req_param.user_data   = (void *)task;
-    task->tagged.send_posted++;
+    req_param.user_data   = user_data;
     return ucp_tag_send_nbx(ep, buffer, 1, ucp_tag, &req_param);
 }
 
+static inline ucs_status_ptr_t
+ucc_tl_ucp_send_common(void *buffer, size_t msglen, ucc_memory_type_t mtype,
+                       ucc_rank_t dest_group_rank, ucc_tl_ucp_team_t *team,
+                       ucc_tl_ucp_task_t *task, ucp_send_nbx_callback_t cb)
+{
+    task->tagged.send_posted++;
+    return ucc_tl_ucp_tag_send(buffer, msglen, mtype, dest_group_rank,
+                               team->worker_id, team, task, cb, (void *)task);
+}
+
+static inline ucs_status_ptr_t
+ucc_tl_ucp_tag_recv(void *buffer, size_t msglen, ucc_memory_type_t mtype,
+                    ucc_rank_t dest_group_rank, uint32_t worker_id,
+                    ucc_tl_ucp_team_t *team, ucc_tl_ucp_task_t *task,
+                    ucp_tag_recv_nbx_callback_t cb, void *user_data)
+{
+    ucc_tl_ucp_context_t *ctx  = UCC_TL_UCP_TEAM_CTX(team);
+    ucc_coll_args_t      *args = &TASK_ARGS(task);
+    ucp_request_param_t   req_param;
+    ucp_tag_t             ucp_tag, ucp_tag_mask;
+
+    // coverity[result_independent_of_operands:FALSE]
+    UCC_TL_UCP_MAKE_RECV_TAG(ucp_tag, ucp_tag_mask,
+                             (args->mask & UCC_COLL_ARGS_FIELD_TAG),
+                             task->tagged.tag, dest_group_rank,
+                             team->super.super.params.id,
+                             team->super.super.params.scope_id,
+                             team->super.super.params.scope);
+    req_param.op_attr_mask =
+        UCP_OP_ATTR_FIELD_CALLBACK | UCP_OP_ATTR_FIELD_DATATYPE |
+        UCP_OP_ATTR_FIELD_USER_DATA | UCP_OP_ATTR_FIELD_MEMORY_TYPE;
+    req_param.datatype    = ucp_dt_make_contig(msglen);
+    req_param.cb.recv     = cb;
+    req_param.memory_type = ucc_memtype_to_ucs[mtype];
+    req_param.user_data   = user_data;
+    return ucp_tag_recv_nbx(ctx->workers[worker_id].ucp_worker, buffer, 1,
+                            ucp_tag, ucp_tag_mask, &req_param);
+}
+
+static inline ucs_status_ptr_t
+ucc_tl_ucp_recv_common(void *buffer, size_t msglen, ucc_memory_type_t mtype,
+                       ucc_rank_t dest_group_rank, ucc_tl_ucp_team_t *team,
+                       ucc_tl_ucp_task_t *task, ucp_tag_recv_nbx_callback_t cb)
+{
+    task->tagged.recv_posted++;
+    return ucc_tl_ucp_tag_recv(buffer, msglen, mtype, dest_group_rank,
+                               team->worker_id, team, task, cb, (void *)task);
+}
+
+/* Messages of at least STRIPE_THRESH bytes are split into n_workers
+   contiguous stripes, stripe i goes over the worker (team worker + i) % n
+   on both sides. The decision depends only on msglen, so both sides of a
+   send/recv pair must pass the same length, whichever of the send/recv
+   functions below is used. A striped message is counted once in the
+   posted/completed counters of the task. */
+#define UCC_TL_UCP_USE_STRIPES(_team, _msglen)                                \
+    (UCC_TL_UCP_CTX_STRIPING(UCC_TL_UCP_TEAM_CTX(_team)) &&                   \
+     (_msglen) >= UCC_TL_UCP_TEAM_CTX(_team)->cfg.stripe_thresh)
+
+/* Drops n references of the stripe request, returns 1 when the last one
+   is gone */
+static inline int ucc_tl_ucp_stripe_release(ucc_tl_ucp_stripe_req_t *req,
+                                            uint32_t                 n)
+{
+    if (ucc_atomic_fadd32(&req->n_pending, -n) != n) {
+        return 0;
+    }
+    ucc_mpool_put(req);
+    return 1;
+}
+
+static inline void
+ucc_tl_ucp_stripe_send_completed(ucc_tl_ucp_task_t      *task,
+                                 ucp_send_nbx_callback_t cb)
+{
+    if (cb) {
+        cb(NULL, UCS_OK, (void *)task);
+    } else {
+        task->tagged.send_completed++;
+    }
+}
+
+static inline ucc_status_t
+ucc_tl_ucp_stripe_post(void *buffer, size_t msglen, ucc_memory_type_t mtype,
+                       ucc_rank_t dest_group_rank, ucc_tl_ucp_team_t *team,
+                       ucc_tl_ucp_task_t *task, int is_send,
+                       ucp_send_nbx_callback_t cb)
+{
+    ucc_tl_ucp_context_t    *ctx    = UCC_TL_UCP_TEAM_CTX(team);
+    uint32_t                 n      = ctx->n_workers;
+    size_t                   offset = 0;
+    ucc_tl_ucp_stripe_req_t *req;
+    ucs_status_ptr_t         ucp_status;
+    size_t                   len;
+    uint32_t                 i, w;
+
+    req = ucc_mpool_get(&ctx->stripe_mp);
+    if (ucc_unlikely(!req)) {
+        tl_error(UCC_TL_TEAM_LIB(team), "failed to allocate stripe request");
+        return UCC_ERR_NO_MEMORY;
+    }
+    req->task = task;
+    req->cb   = cb;
+    /* one extra reference is held while the stripes are being posted */
+    req->n_pending = n + 1;
+    if (is_send) {
+        task->tagged.send_posted++;
+    } else {
+        task->tagged.recv_posted++;
+    }
+    for (i = 0; i < n; i++) {
+        len = ucc_buffer_block_count(msglen, n, i);
+        w   = (team->worker_id + i) % n;
+        if (is_send) {
+            ucp_status = ucc_tl_ucp_tag_send(
+                PTR_OFFSET(buffer, offset), len, mtype, dest_group_rank, w,
+                team, task, ucc_tl_ucp_send_stripe_completion_cb, req);
+        } else {
+            ucp_status = ucc_tl_ucp_tag_recv(
+                PTR_OFFSET(buffer, offset), len, mtype, dest_group_rank, w,
+                team, task, ucc_tl_ucp_recv_stripe_completion_cb, req);
+        }
+        if (ucc_unlikely(UCS_PTR_IS_ERR(ucp_status))) {
+            tl_error(UCC_TL_TEAM_LIB(team),
+                     "tag %u; dest %d; team_id %u; stripe %u; errmsg %s",
+                     task->tagged.tag, dest_group_rank,
+                     team->super.super.params.id, i,
+                     ucs_status_string(UCS_PTR_STATUS(ucp_status)));
+            /* stripes that are not posted and the posting reference */
+            ucc_tl_ucp_stripe_release(req, n - i + 1);
+            return ucs_status_to_ucc_status(UCS_PTR_STATUS(ucp_status));
+        }
+        if (UCS_OK == ucp_status) {
+            ucc_tl_ucp_stripe_release(req, 1);
+        }
+        offset += len;
+    }
+    if (ucc_tl_ucp_stripe_release(req, 1)) {
+        if (is_send) {
+            ucc_tl_ucp_stripe_send_completed(task, cb);
+        } else {
+            task->tagged.recv_completed++;
+        }
+    }
+    return UCC_OK;
+}
+
 static inline ucc_status_t
 ucc_tl_ucp_send_nb(void *buffer, size_t msglen, ucc_memory_type_t mtype,
                    ucc_rank_t dest_group_rank, ucc_tl_ucp_team_t *team,
@@ -101,6 +257,10 @@ ucc_tl_ucp_send_nb(void *buffer, size_t msglen, ucc_memory_type_t mtype,
 {
     ucs_status_ptr_t ucp_status;
 
+    if (UCC_TL_UCP_USE_STRIPES(team, msglen)) {
+        return ucc_tl_ucp_stripe_post(buffer, msglen, mtype, dest_group_rank,
+                                      team, task, 1, NULL);
+    }
     ucp_status = ucc_tl_ucp_send_common(buffer, msglen, mtype, dest_group_rank,
                                         team, task, ucc_tl_ucp_send_completion_cb);
     if (UCS_OK != ucp_status) {
@@ -118,6 +278,10 @@ ucc_tl_ucp_send_cb(void *buffer, size_t msglen, ucc_memory_type_t mtype,
 {
     ucs_status_ptr_t ucp_status;
 
+    if (UCC_TL_UCP_USE_STRIPES(team, msglen)) {
+        return ucc_tl_ucp_stripe_post(buffer, msglen, mtype, dest_group_rank,
+                                      team, task, 1, cb);
+    }
     ucp_status = ucc_tl_ucp_send_common(buffer, msglen, mtype, dest_group_rank,
                                      team, task, cb);
     if (UCS_OK != ucp_status) {
@@ -128,34 +292,6 @@ ucc_tl_ucp_send_cb(void *buffer, size_t msglen, ucc_memory_type_t mtype,
     return UCC_OK;
 }
 
-static inline ucs_status_ptr_t
-ucc_tl_ucp_recv_common(void *buffer, size_t msglen, ucc_memory_type_t mtype,
-                       ucc_rank_t dest_group_rank, ucc_tl_ucp_team_t *team,
-                       ucc_tl_ucp_task_t *task, ucp_tag_recv_nbx_callback_t cb)
-{
-    ucc_coll_args_t    *args = &TASK_ARGS(task);
-    ucp_request_param_t req_param;
-    ucp_tag_t           ucp_tag, ucp_tag_mask;
-
-    // coverity[result_independent_of_operands:FALSE]
-    UCC_TL_UCP_MAKE_RECV_TAG(ucp_tag, ucp_tag_mask,
-                             (args->mask & UCC_COLL_ARGS_FIELD_TAG),
-                             task->tagged.tag, dest_group_rank,
-                             team->super.super.params.id,
-                             team->super.super.params.scope_id,
-                             team->super.super.params.scope);
-    req_param.op_attr_mask =
-        UCP_OP_ATTR_FIELD_CALLBACK | UCP_OP_ATTR_FIELD_DATATYPE |
-        UCP_OP_ATTR_FIELD_USER_DATA | UCP_OP_ATTR_FIELD_MEMORY_TYPE;
-    req_param.datatype    = ucp_dt_make_contig(msglen);
-    req_param.cb.recv     = cb;
-    req_param.memory_type = ucc_memtype_to_ucs[mtype];
-    req_param.user_data   = (void *)task;
-    task->tagged.recv_posted++;
-    return ucp_tag_recv_nbx(UCC_TL_UCP_WORKER(team), buffer, 1, ucp_tag,
-                            ucp_tag_mask, &req_param);
-}
-
 static inline ucc_status_t
 ucc_tl_ucp_recv_nb(void *buffer, size_t msglen, ucc_memory_type_t mtype,
                    ucc_rank_t dest_group_rank, ucc_tl_ucp_team_t *team,
@@ -163,6 +299,10 @@ ucc_tl_ucp_recv_nb(void *buffer, size_t msglen, ucc_memory_type_t mtype,
 {
     ucs_status_ptr_t ucp_status;
 
+    if (UCC_TL_UCP_USE_STRIPES(team, msglen)) {
+        return ucc_tl_ucp_stripe_post(buffer, msglen, mtype, dest_group_rank,
+                                      team, task, 0, NULL);
+    }
     ucp_status = ucc_tl_ucp_recv_common(buffer, msglen, mtype, dest_group_rank,
                                         team, task, ucc_tl_ucp_recv_completion_cb);
     if (UCS_OK != ucp_status) {
@@ -223,6 +363,50 @@ static inline ucc_status_t ucc_tl_ucp_send_nz(void *buffer, size_t msglen,
                               dest_group_rank, team, task);
 }
 
+ucc_status_t ucc_tl_ucp_send_am_nb(void *buffer, size_t msglen,
+                                   ucc_rank_t         dest_group_rank,
+                                   ucc_tl_ucp_team_t *team,
+                                   ucc_tl_ucp_task_t *task);
+
+ucc_status_t ucc_tl_ucp_recv_am_nb(void *buffer, size_t msglen,
+                                   ucc_rank_t         dest_group_rank,
+                                   ucc_tl_ucp_team_t *team,
+                                   ucc_tl_ucp_task_t *task);
+
+/* Small host messages go through the AM eager path when it is enabled
+   (AM_EAGER_THRESH). The decision depends only on msglen and mtype, so both
+   sides of a send/recv pair must pass the same values. */
+#define UCC_TL_UCP_USE_AM_EAGER(_team, _msglen, _mtype)                       \
+    (UCC_TL_UCP_TEAM_CTX(_team)->cfg.am_eager_thresh &&                       \
+     (_msglen) <= UCC_TL_UCP_TEAM_CTX(_team)->cfg.am_eager_thresh &&          \
+     ((_mtype) == UCC_MEMORY_TYPE_HOST || (_msglen) == 0))
+
+static inline ucc_status_t
+ucc_tl_ucp_send_eager_nb(void *buffer, size_t msglen, ucc_memory_type_t mtype,
+                         ucc_rank_t dest_group_rank, ucc_tl_ucp_team_t *team,
+                         ucc_tl_ucp_task_t *task)
+{
+    if (UCC_TL_UCP_USE_AM_EAGER(team, msglen, mtype)) {
+        return ucc_tl_ucp_send_am_nb(buffer, msglen, dest_group_rank, team,
+                                     task);
+    }
+    return ucc_tl_ucp_send_nb(buffer, msglen, mtype, dest_group_rank, team,
+                              task);
+}
+
+static inline ucc_status_t
+ucc_tl_ucp_recv_eager_nb(void *buffer, size_t msglen, ucc_memory_type_t mtype,
+                         ucc_rank_t dest_group_rank, ucc_tl_ucp_team_t *team,
+                         ucc_tl_ucp_task_t *task)
+{
+    if (UCC_TL_UCP_USE_AM_EAGER(team, msglen, mtype)) {
+        return ucc_tl_ucp_recv_am_nb(buffer, msglen, dest_group_rank, team,
+                                     task);
+    }
+    return ucc_tl_ucp_recv_nb(buffer, msglen, mtype, dest_group_rank, team,
+                              task);
+}
+
 static inline ucc_status_t
 ucc_tl_ucp_resolve_p2p_by_va(ucc_tl_ucp_team_t *team, void *va, ucp_ep_h *ep,
                              ucc_rank_t peer, uint64_t *rva, ucp_rkey_h *rkey,
@@ -282,8 +466,7 @@ static inline ucc_status_t ucc_tl_ucp_flush(ucc_tl_ucp_team_t *team)
     ucp_request_param_t req_param = {0};
     ucs_status_ptr_t    req;
 
-    req =
-        ucp_worker_flush_nbx(UCC_TL_UCP_TEAM_CTX(team)->ucp_worker, &req_param);
+    req = ucp_worker_flush_nbx(UCC_TL_UCP_ONESIDED_WORKER(team), &req_param);
     if (UCS_OK != req) {
         if (UCS_PTR_IS_ERR(req)) {
             return ucs_status_to_ucc_status(UCS_PTR_STATUS(req));
@@ -442,6 +625,31 @@ static inline ucc_status_t ucc_tl_ucp_atomic_inc(void *     target,
     return UCC_OK;
 }
 
+/* Put followed by the increment of the remote sync counter. The fence
+   guarantees that the target observes the counter update only after
+   the data of the put has been delivered. */
+static inline ucc_status_t
+ucc_tl_ucp_put_signal_nb(void *buffer, void *target, size_t msglen,
+                         void *sync, ucc_rank_t dest_group_rank,
+                         ucc_tl_ucp_team_t *team, ucc_tl_ucp_task_t *task)
+{
+    ucs_status_t ucs_status;
+    ucc_status_t status;
+
+    status = ucc_tl_ucp_put_nb(buffer, target, msglen, dest_group_rank, team,
+                               task);
+    if (ucc_unlikely(UCC_OK != status)) {
+        return status;
+    }
+
+    ucs_status = ucp_worker_fence(UCC_TL_UCP_ONESIDED_WORKER(team));
+    if (ucc_unlikely(UCS_OK != ucs_status)) {
+        return ucs_status_to_ucc_status(ucs_status);
+    }
+
+    return ucc_tl_ucp_atomic_inc(sync, dest_group_rank, team);
+}
+
 #define UCPCHECK_GOTO(_cmd, _task, _label)                                     \
     do {                                                                       \
         ucc_status_t _status = (_cmd);                                         \
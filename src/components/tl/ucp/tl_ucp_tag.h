@@ -55,6 +55,12 @@
     UCC_MASK(UCC_TL_UCP_ID_BITS + UCC_TL_UCP_SENDER_BITS + \
              UCC_TL_UCP_SCOPE_ID_BITS + UCC_TL_UCP_SCOPE_BITS)
 
+/* Bits of the tag identifying the team: id, scope_id and scope */
+#define UCC_TL_UCP_TAG_TEAM_MASK                                               \
+    (UCC_MASK(UCC_TL_UCP_ID_BITS) |                                            \
+     (UCC_MASK(UCC_TL_UCP_SCOPE_ID_BITS + UCC_TL_UCP_SCOPE_BITS)               \
+      << UCC_TL_UCP_SCOPE_ID_BITS_OFFSET))
+
 #define UCC_TL_UCP_GET_SENDER(_tag) ((uint32_t)(((_tag) >> UCC_TL_UCP_SENDER_BITS_OFFSET) & \
                                                 UCC_MASK(UCC_TL_UCP_SENDER_BITS)))
 #endif
@@ -10,6 +10,7 @@
 #include "tl_ucp_sendrecv.h"
 #include "utils/ucc_malloc.h"
 #include "coll_score/ucc_coll_score.h"
+#include "core/ucc_team.h"
 
 UCC_CLASS_INIT_FUNC(ucc_tl_ucp_team_t, ucc_base_context_t *tl_context,
                     const ucc_base_team_params_t *params)
@@ -30,7 +31,21 @@ UCC_CLASS_INIT_FUNC(ucc_tl_ucp_team_t, ucc_base_context_t *tl_context,
 
     self->preconnect_task    = NULL;
     self->seq_num            = 0;
+    self->worker_id          = params->id % ctx->n_workers;
     self->status             = UCC_INPROGRESS;
+    self->ring_ranks         = NULL;
+    self->rings_init         = 0;
+    self->alltoall_window    = 0;
+    self->alltoallv_window   = 0;
+    self->eps                = ucc_calloc(UCC_TL_TEAM_SIZE(self),
+                                          sizeof(ucp_ep_h), "tl_ucp_team_eps");
+    if (!self->eps) {
+        tl_error(tl_context->lib,
+                 "failed to allocate %zd bytes for team eps",
+                 UCC_TL_TEAM_SIZE(self) * sizeof(ucp_ep_h));
+        return UCC_ERR_NO_MEMORY;
+    }
+    ucc_tl_ucp_am_team_init(self);
 
     tl_info(tl_context->lib, "posted tl team: %p", self);
     return UCC_OK;
@@ -39,11 +54,154 @@ UCC_CLASS_INIT_FUNC(ucc_tl_ucp_team_t, ucc_base_context_t *tl_context,
 UCC_CLASS_CLEANUP_FUNC(ucc_tl_ucp_team_t)
 {
     tl_info(self->super.super.context->lib, "finalizing tl team: %p", self);
+    ucc_tl_ucp_am_team_cleanup(self);
+    ucc_free(self->ring_ranks);
+    ucc_free(self->eps);
 }
 
 UCC_CLASS_DEFINE_DELETE_FUNC(ucc_tl_ucp_team_t, ucc_base_team_t);
 UCC_CLASS_DEFINE(ucc_tl_ucp_team_t, ucc_tl_team_t);
 
+typedef struct ucc_tl_ucp_ring_key {
+    ucc_host_id_t   host_id;
+    ucc_socket_id_t socket_id;
+    ucc_rank_t      rank;
+} ucc_tl_ucp_ring_key_t;
+
+static int ucc_tl_ucp_ring_key_cmp(const void *a, const void *b)
+{
+    const ucc_tl_ucp_ring_key_t *k1 = a;
+    const ucc_tl_ucp_ring_key_t *k2 = b;
+
+    if (k1->host_id != k2->host_id) {
+        return (k1->host_id < k2->host_id) ? -1 : 1;
+    }
+    if (k1->socket_id != k2->socket_id) {
+        return (k1->socket_id < k2->socket_id) ? -1 : 1;
+    }
+    return (int)k1->rank - (int)k2->rank;
+}
+
+static inline void ucc_tl_ucp_ring_set_array(ucc_ep_map_t *map,
+                                             ucc_rank_t *array,
+                                             ucc_rank_t size)
+{
+    map->type            = UCC_EP_MAP_ARRAY;
+    map->ep_num          = size;
+    map->array.map       = array;
+    map->array.elem_size = sizeof(ucc_rank_t);
+}
+
+/* Sorts the team ranks by (host, socket, rank). Ranks of the same node
+   are adjacent in the ring, their relative order is kept so the ring is
+   the team order when the launcher places ranks by node. */
+static ucc_status_t ucc_tl_ucp_team_init_rings(ucc_tl_ucp_team_t *team)
+{
+    ucc_rank_t             size = UCC_TL_TEAM_SIZE(team);
+    ucc_topo_t            *topo = NULL;
+    ucc_tl_ucp_ring_key_t *keys;
+    ucc_proc_info_t       *pi;
+    ucc_rank_t            *ranks;
+    ucc_rank_t             r, ctx_rank;
+    int                    identity;
+
+    ucc_tl_ucp_ring_init_plain(size, 0, &team->rings[0]);
+    ucc_tl_ucp_ring_init_plain(size, 1, &team->rings[1]);
+    team->rings_init = 1;
+
+    if (!IS_SERVICE_TEAM(team) && team->super.super.params.team) {
+        topo = team->super.super.params.team->topo;
+    }
+    if (!UCC_TL_UCP_TEAM_LIB(team)->cfg.ring_topo_order || !topo ||
+        (ucc_topo_is_single_node(topo) && !topo->topo->sock_bound)) {
+        return UCC_OK;
+    }
+
+    keys = ucc_malloc(size * sizeof(*keys), "ring_keys");
+    if (ucc_unlikely(!keys)) {
+        tl_error(team->super.super.context->lib,
+                 "failed to allocate %zd bytes for ring keys",
+                 size * sizeof(*keys));
+        return UCC_ERR_NO_MEMORY;
+    }
+    for (r = 0; r < size; r++) {
+        ctx_rank = ucc_ep_map_eval(
+            topo->set.map, ucc_ep_map_eval(team->super.super.params.map, r));
+        pi                = &topo->topo->procs[ctx_rank];
+        keys[r].host_id   = pi->host_id;
+        keys[r].socket_id = topo->topo->sock_bound ? pi->socket_id : 0;
+        keys[r].rank      = r;
+    }
+    qsort(keys, size, sizeof(*keys), ucc_tl_ucp_ring_key_cmp);
+
+    identity = 1;
+    for (r = 0; r < size; r++) {
+        if (keys[r].rank != r) {
+            identity = 0;
+            break;
+        }
+    }
+    if (identity) {
+        ucc_free(keys);
+        return UCC_OK;
+    }
+
+    /* forward inv_map, forward map, backward inv_map, backward map */
+    ranks = ucc_malloc(4 * size * sizeof(*ranks), "ring_ranks");
+    if (ucc_unlikely(!ranks)) {
+        tl_error(team->super.super.context->lib,
+                 "failed to allocate %zd bytes for ring ranks",
+                 4 * size * sizeof(*ranks));
+        ucc_free(keys);
+        return UCC_ERR_NO_MEMORY;
+    }
+    for (r = 0; r < size; r++) {
+        ranks[r]                                  = keys[r].rank;
+        ranks[size + keys[r].rank]                = r;
+        ranks[2 * size + r]                       = keys[size - 1 - r].rank;
+        ranks[3 * size + keys[size - 1 - r].rank] = r;
+    }
+    ucc_free(keys);
+
+    ucc_tl_ucp_ring_set_array(&team->rings[0].inv_map, ranks, size);
+    ucc_tl_ucp_ring_set_array(&team->rings[0].map, ranks + size, size);
+    ucc_tl_ucp_ring_set_array(&team->rings[1].inv_map, ranks + 2 * size,
+                              size);
+    ucc_tl_ucp_ring_set_array(&team->rings[1].map, ranks + 3 * size, size);
+    team->ring_ranks = ranks;
+    tl_debug(team->super.super.context->lib,
+             "team %p: topology aware ring, nnodes %u", team,
+             ucc_topo_nnodes(topo));
+    return UCC_OK;
+}
+
+void ucc_tl_ucp_ring_init_plain(ucc_rank_t size, int backward,
+                                ucc_tl_ucp_ring_t *ring)
+{
+    if (backward) {
+        ring->map = ucc_ep_map_create_reverse(size);
+    } else {
+        ring->map.type   = UCC_EP_MAP_FULL;
+        ring->map.ep_num = size;
+    }
+    ring->inv_map = ring->map;
+}
+
+ucc_status_t ucc_tl_ucp_team_get_ring(ucc_tl_ucp_team_t *team, int backward,
+                                      ucc_tl_ucp_ring_t **ring)
+{
+    ucc_status_t status;
+
+    if (ucc_unlikely(!team->rings_init)) {
+        status = ucc_tl_ucp_team_init_rings(team);
+        if (UCC_OK != status) {
+            return status;
+        }
+    }
+    *ring = &team->rings[backward ? 1 : 0];
+    return UCC_OK;
+}
+
 ucc_status_t ucc_tl_ucp_team_destroy(ucc_base_team_t *tl_team)
 {
     UCC_CLASS_DELETE_FUNC_NAME(ucc_tl_ucp_team_t)(tl_team);
@@ -17,6 +17,7 @@
 #include "schedule/ucc_schedule.h"
 #include "coll_score/ucc_coll_score.h"
 #include "ucc_ee.h"
+#include "ucc_coll_packed.h"
 
 #define UCC_BUFFER_INFO_CHECK_MEM_TYPE(_info) do {                             \
     if ((_info).mem_type == UCC_MEMORY_TYPE_UNKNOWN) {                         \
@@ -158,24 +159,56 @@ static ucc_status_t ucc_coll_args_check_mem_type(ucc_coll_args_t *coll_args,
     };
 }
 
-UCC_CORE_PROFILE_FUNC(ucc_status_t, ucc_collective_init,
-                      (coll_args, request, team), ucc_coll_args_t *coll_args,
-                      ucc_coll_req_h *request, ucc_team_h team)
+/* The active set must be a subset of at least 2 team ranks that includes
+   the calling rank and the root of a rooted collective */
+static ucc_status_t ucc_coll_check_active_set(ucc_coll_args_t *args,
+                                              ucc_team_t      *team)
 {
-    ucc_coll_task_t          *task;
-    ucc_base_coll_args_t      op_args;
-    ucc_status_t              status;
-    ucc_ee_executor_params_t  params;
-    ucc_memory_type_t         coll_mem_type;
-    ucc_ee_type_t             coll_ee_type;
+    int64_t last;
+
+    if (args->active_set.size < 2) {
+        ucc_warn("active sets of less than 2 ranks are not supported");
+        return UCC_ERR_NOT_SUPPORTED;
+    }
+    last = (int64_t)args->active_set.start +
+           args->active_set.stride * (int64_t)(args->active_set.size - 1);
+    if (args->active_set.stride == 0 ||
+        args->active_set.start >= team->size || last < 0 ||
+        last >= team->size) {
+        ucc_error("active set start %lu stride %ld size %lu is out of "
+                  "team of size %u", args->active_set.start,
+                  args->active_set.stride, args->active_set.size,
+                  team->size);
+        return UCC_ERR_INVALID_PARAM;
+    }
+    if (!ucc_active_set_contains(args, team->rank)) {
+        ucc_error("rank %u is not a member of the active set", team->rank);
+        return UCC_ERR_INVALID_PARAM;
+    }
+    if ((args->coll_type & UCC_COLL_TYPE_ROOTED) &&
+        !ucc_active_set_contains(args, args->root)) {
+        ucc_error("root %lu is not a member of the active set", args->root);
+        return UCC_ERR_INVALID_PARAM;
+    }
+    return UCC_OK;
+}
+
+/* Checks the arguments and selects the task of a collective, common for
+   ucc_collective_init and the members of a collective group */
+static ucc_status_t ucc_coll_task_create(ucc_coll_args_t *coll_args,
+                                         ucc_team_h team,
+                                         ucc_coll_task_t **task_p)
+{
+    ucc_base_coll_args_t op_args;
+    ucc_status_t         status;
 
     /* Global check to reduce the amount of checks throughout
        all TLs */
-    if (UCC_COLL_ARGS_ACTIVE_SET(coll_args) &&
-        ((UCC_COLL_TYPE_BCAST != coll_args->coll_type) ||
-         coll_args->active_set.size != 2)) {
-        ucc_warn("Active Sets are only supported for bcast and set size = 2");
-        return UCC_ERR_NOT_SUPPORTED;
+    if (UCC_COLL_ARGS_ACTIVE_SET(coll_args)) {
+        status = ucc_coll_check_active_set(coll_args, team);
+        if (ucc_unlikely(status != UCC_OK)) {
+            return status;
+        }
     }
 
     status = ucc_coll_args_check_mem_type(coll_args, team->rank);
@@ -199,7 +232,12 @@ UCC_CORE_PROFILE_FUNC(ucc_status_t, ucc_collective_init,
     UCC_COPY_PARAM_BY_FIELD(&op_args.args, coll_args, UCC_COLL_ARGS_FIELD_FLAGS,
                             flags);
 
-    status = ucc_coll_init(team->score_map, &op_args, &task);
+    if (ucc_coll_args_need_pack(coll_args, team->rank)) {
+        /* generic datatypes without fixed size are not seen by the CLs */
+        status = ucc_coll_packed_init(&op_args, team, task_p);
+    } else {
+        status = ucc_coll_init(team->score_map, &op_args, task_p);
+    }
     if (UCC_ERR_NOT_SUPPORTED == status) {
         ucc_debug("failed to init collective: not supported");
         return status;
@@ -207,32 +245,62 @@ UCC_CORE_PROFILE_FUNC(ucc_status_t, ucc_collective_init,
         ucc_error("failed to init collective: %s", ucc_status_string(status));
         return status;
     }
+    return UCC_OK;
+}
+
+/* Creates the executor of a top level task, started on post and stopped
+   on the task completion */
+static ucc_status_t ucc_coll_task_init_executor(ucc_coll_task_t *task,
+                                                ucc_coll_args_t *coll_args,
+                                                ucc_team_h team)
+{
+    ucc_ee_executor_params_t  params;
+    ucc_memory_type_t         coll_mem_type;
+    ucc_ee_type_t             coll_ee_type;
+    ucc_status_t              status;
+
+    task->flags |= UCC_COLL_TASK_FLAG_EXECUTOR_STOP;
+    coll_mem_type = ucc_coll_args_mem_type(coll_args, team->rank);
+    switch(coll_mem_type) {
+    case UCC_MEMORY_TYPE_CUDA:
+        coll_ee_type = UCC_EE_CUDA_STREAM;
+        break;
+    case UCC_MEMORY_TYPE_ROCM:
+        coll_ee_type = UCC_EE_ROCM_STREAM;
+        break;
+    case UCC_MEMORY_TYPE_HOST:
+        coll_ee_type = UCC_EE_CPU_THREAD;
+        break;
+    default:
+        ucc_error("no suitable executor available for memory type %s",
+                  ucc_memory_type_names[coll_mem_type]);
+        return UCC_ERR_INVALID_PARAM;
+    }
+    params.mask    = UCC_EE_EXECUTOR_PARAM_FIELD_TYPE;
+    params.ee_type = coll_ee_type;
+    status = ucc_ee_executor_init(&params, &task->executor);
+    if (UCC_OK != status) {
+        ucc_error("failed to init executor: %s", ucc_status_string(status));
+    }
+    return status;
+}
+
+UCC_CORE_PROFILE_FUNC(ucc_status_t, ucc_collective_init,
+                      (coll_args, request, team), ucc_coll_args_t *coll_args,
+                      ucc_coll_req_h *request, ucc_team_h team)
+{
+    ucc_coll_task_t          *task;
+    ucc_status_t              status;
+
+    status = ucc_coll_task_create(coll_args, team, &task);
+    if (status != UCC_OK) {
+        return status;
+    }
 
     task->flags |= UCC_COLL_TASK_FLAG_TOP_LEVEL;
     if (task->flags & UCC_COLL_TASK_FLAG_EXECUTOR) {
-        task->flags |= UCC_COLL_TASK_FLAG_EXECUTOR_STOP;
-        coll_mem_type = ucc_coll_args_mem_type(coll_args, team->rank);
-        switch(coll_mem_type) {
-        case UCC_MEMORY_TYPE_CUDA:
-            coll_ee_type = UCC_EE_CUDA_STREAM;
-            break;
-        case UCC_MEMORY_TYPE_ROCM:
-            coll_ee_type = UCC_EE_ROCM_STREAM;
-            break;
-       case UCC_MEMORY_TYPE_HOST:
-            coll_ee_type = UCC_EE_CPU_THREAD;
-            break;
-        default:
-            ucc_error("no suitable executor available for memory type %s",
-                      ucc_memory_type_names[coll_mem_type]);
-            status = UCC_ERR_INVALID_PARAM;
-            goto coll_finalize;
-        }
-        params.mask    = UCC_EE_EXECUTOR_PARAM_FIELD_TYPE;
-        params.ee_type = coll_ee_type;
-        status = ucc_ee_executor_init(&params, &task->executor);
+        status = ucc_coll_task_init_executor(task, coll_args, team);
         if (UCC_OK != status) {
-            ucc_error("failed to init executor: %s", ucc_status_string(status));
             goto coll_finalize;
         }
     }
@@ -258,6 +326,127 @@ coll_finalize:
     return status;
 }
 
+static ucc_status_t ucc_collective_group_finalize(ucc_coll_task_t *task)
+{
+    ucc_schedule_t *schedule = ucc_derived_of(task, ucc_schedule_t);
+    ucc_status_t    status;
+
+    status = ucc_schedule_finalize(task);
+    ucc_coll_task_destruct(task);
+    ucc_free(schedule);
+    return status;
+}
+
+/* The group is a schedule with the member collectives started together
+   on the schedule start: all their first messages are issued in one post
+   and they progress side by side in the progress queue. Members keep
+   their own tags, so the order of the members only has to be the same on
+   all the ranks. */
+UCC_CORE_PROFILE_FUNC(ucc_status_t, ucc_collective_group_init,
+                      (coll_args, n_colls, request, team),
+                      ucc_coll_args_t *coll_args, uint32_t n_colls,
+                      ucc_coll_req_h *request, ucc_team_h team)
+{
+    ucc_coll_args_t *exec_args  = NULL;
+    int              persistent = 1;
+    ucc_schedule_t  *schedule;
+    ucc_coll_task_t *task;
+    ucc_status_t     status;
+    uint32_t         i;
+
+    if (n_colls == 0) {
+        ucc_error("collective group is empty");
+        return UCC_ERR_INVALID_PARAM;
+    }
+    schedule = ucc_malloc(sizeof(*schedule), "coll_group");
+    if (!schedule) {
+        ucc_error("failed to allocate %zd bytes for collective group",
+                  sizeof(*schedule));
+        return UCC_ERR_NO_MEMORY;
+    }
+    ucc_coll_task_construct(&schedule->super);
+    schedule->n_tasks = 0;
+
+    for (i = 0; i < n_colls; i++) {
+        status = ucc_coll_task_create(&coll_args[i], team, &task);
+        if (status != UCC_OK) {
+            goto err;
+        }
+        if (i == 0) {
+            status = ucc_schedule_init(schedule, NULL, task->team);
+            if (ucc_unlikely(UCC_OK != status)) {
+                ucc_error("failed to init collective group schedule");
+                /* the task is not owned by the schedule yet */
+                goto err_task;
+            }
+        }
+        if (coll_args[i].mask & UCC_COLL_ARGS_FIELD_CB) {
+            task->cb = coll_args[i].cb;
+            task->flags |= UCC_COLL_TASK_FLAG_CB;
+        }
+        task->seq_num = team->seq_num++;
+        status = ucc_schedule_add_task(schedule, task);
+        if (ucc_unlikely(UCC_OK != status)) {
+            if (schedule->n_tasks == 0 ||
+                schedule->tasks[schedule->n_tasks - 1] != task) {
+                goto err_task;
+            }
+            goto err;
+        }
+        UCC_CHECK_GOTO(ucc_event_manager_subscribe(&schedule->super,
+                                                   UCC_EVENT_SCHEDULE_STARTED,
+                                                   task,
+                                                   ucc_task_start_handler),
+                       err, status);
+        if (task->flags & UCC_COLL_TASK_FLAG_EXECUTOR) {
+            if (!exec_args) {
+                exec_args = &coll_args[i];
+            } else if (ucc_coll_args_mem_type(exec_args, team->rank) !=
+                       ucc_coll_args_mem_type(&coll_args[i], team->rank)) {
+                /* the group has a single executor */
+                ucc_error("collective group mixes memory types of executors");
+                status = UCC_ERR_NOT_SUPPORTED;
+                goto err;
+            }
+        }
+        if (!UCC_IS_PERSISTENT(coll_args[i])) {
+            persistent = 0;
+        }
+    }
+
+    schedule->super.bargs.args.mask      = UCC_COLL_ARGS_FIELD_FLAGS;
+    schedule->super.bargs.args.coll_type = coll_args[0].coll_type;
+    schedule->super.bargs.args.flags     =
+        persistent ? UCC_COLL_ARGS_FLAG_PERSISTENT : 0;
+    schedule->super.post           = ucc_schedule_start;
+    schedule->super.triggered_post = ucc_triggered_post;
+    schedule->super.finalize       = ucc_collective_group_finalize;
+    schedule->super.flags         |= UCC_COLL_TASK_FLAG_TOP_LEVEL;
+    if (exec_args) {
+        /* members take the executor from the group schedule */
+        status = ucc_coll_task_init_executor(&schedule->super, exec_args,
+                                             team);
+        if (UCC_OK != status) {
+            goto err;
+        }
+    }
+    schedule->super.seq_num = schedule->tasks[0]->seq_num;
+    ucc_debug("coll_group_init: %u collectives, seq_num %u", n_colls,
+              schedule->super.seq_num);
+    *request = &schedule->super.super;
+    return UCC_OK;
+
+err_task:
+    task->finalize(task);
+err:
+    if (schedule->n_tasks > 0) {
+        ucc_schedule_finalize(&schedule->super);
+    }
+    ucc_coll_task_destruct(&schedule->super);
+    ucc_free(schedule);
+    return status;
+}
+
 /* Check if user is trying to post the request which is either in completed,
    inprogress or error state.
    The only allowed case is: request is completed and has a
@@ -0,0 +1,495 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * See file LICENSE for terms.
+ */
+
+#include "config.h"
+#include "ucc_coll_packed.h"
+#include "ucc_team.h"
+#include "ucc_context.h"
+#include "ucc_dt.h"
+#include "components/mc/ucc_mc.h"
+#include "coll_score/ucc_coll_score.h"
+#include "utils/ucc_malloc.h"
+#include "utils/ucc_log.h"
+#include "utils/ucc_math.h"
+#include "utils/ucc_coll_utils.h"
+
+/* Collectives on generic datatypes with pack/unpack callbacks.
+
+   The components work on datatypes of fixed size only, so the core runs
+   such a collective over the packed representation of the data: the user
+   buffers are packed into a host scratch, the collective of the selected
+   CL is executed on UCC_DT_UINT8 and the result is unpacked to the user
+   buffers.
+
+   The packed stream of every per-rank block is cut into fragments of the
+   same size on all the ranks. A fragment is a schedule "pack -> collective
+   -> unpack" on its own scratch, fragments are pipelined so that packing
+   of one fragment overlaps the transfer of another one. Only
+   pipeline_depth fragments are allocated, they are launched again for the
+   following parts of the stream. Data movement collectives with the same
+   count on all the ranks are supported. */
+
+static inline ucc_datatype_t ucc_coll_args_src_dt(const ucc_coll_args_t *args)
+{
+    return (args->coll_type &
+            (UCC_COLL_TYPE_ALLTOALLV | UCC_COLL_TYPE_SCATTERV))
+               ? args->src.info_v.datatype
+               : args->src.info.datatype;
+}
+
+static inline ucc_datatype_t ucc_coll_args_dst_dt(const ucc_coll_args_t *args)
+{
+    return (args->coll_type &
+            (UCC_COLL_TYPE_ALLTOALLV | UCC_COLL_TYPE_ALLGATHERV |
+             UCC_COLL_TYPE_GATHERV | UCC_COLL_TYPE_REDUCE_SCATTERV))
+               ? args->dst.info_v.datatype
+               : args->dst.info.datatype;
+}
+
+int ucc_coll_args_need_pack(const ucc_coll_args_t *args, ucc_rank_t rank)
+{
+    ucc_coll_type_t ct      = args->coll_type;
+    int             is_root = (args->root == rank);
+    int             src_used, dst_used;
+
+    if (ct & (UCC_COLL_TYPE_BARRIER | UCC_COLL_TYPE_FANIN |
+              UCC_COLL_TYPE_FANOUT)) {
+        return 0;
+    }
+    src_used = !UCC_IS_INPLACE(*args) || (ct == UCC_COLL_TYPE_BCAST);
+    dst_used = (ct != UCC_COLL_TYPE_BCAST);
+    if (ct & (UCC_COLL_TYPE_GATHER | UCC_COLL_TYPE_GATHERV |
+              UCC_COLL_TYPE_REDUCE)) {
+        src_used = !is_root || !UCC_IS_INPLACE(*args);
+        dst_used = is_root;
+    } else if (ct & (UCC_COLL_TYPE_SCATTER | UCC_COLL_TYPE_SCATTERV)) {
+        src_used = is_root;
+        dst_used = !is_root || !UCC_IS_INPLACE(*args);
+    }
+    return (src_used && UCC_DT_NEEDS_PACK(ucc_coll_args_src_dt(args))) ||
+           (dst_used && UCC_DT_NEEDS_PACK(ucc_coll_args_dst_dt(args)));
+}
+
+/* Size of "count" elements of "buffer" in the packed form */
+static size_t ucc_coll_packed_size(void *buffer, size_t count,
+                                   ucc_datatype_t dt)
+{
+    ucc_dt_generic_t *dt_gen;
+    void             *state;
+    size_t            size;
+
+    if (!UCC_DT_NEEDS_PACK(dt)) {
+        return count * ucc_dt_size(dt);
+    }
+    dt_gen = ucc_dt_to_generic(dt);
+    state  = dt_gen->ops.start_pack(dt_gen->context, buffer, count);
+    size   = dt_gen->ops.packed_size(state);
+    dt_gen->ops.finish(state);
+    return size;
+}
+
+static ucc_status_t ucc_coll_packed_task_post(ucc_coll_task_t *coll_task)
+{
+    ucc_coll_packed_task_t *task   =
+        ucc_derived_of(coll_task, ucc_coll_packed_task_t);
+    ucc_coll_packed_t      *coll   = task->coll;
+    ucc_coll_packed_buf_t  *buf    = task->buf;
+    size_t                  offset = task->frag_num * coll->frag_size;
+    size_t                  len    =
+        ucc_min(coll->frag_size, coll->block_size - offset);
+    ucc_status_t            status = UCC_OK;
+    ucc_dt_generic_t       *dt_gen;
+    void                   *state, *scratch;
+    size_t                  stream_offset;
+    ucc_rank_t              b;
+
+    if (!UCC_DT_NEEDS_PACK(buf->dt)) {
+        /* the other side of the collective is contiguous */
+        for (b = 0; b < buf->n_blocks; b++) {
+            stream_offset = (buf->first_block + b) * coll->block_size + offset;
+            scratch       = PTR_OFFSET(task->scratch, b * coll->frag_size);
+            if (task->unpack) {
+                memcpy(PTR_OFFSET(buf->buffer, stream_offset), scratch, len);
+            } else {
+                memcpy(scratch, PTR_OFFSET(buf->buffer, stream_offset), len);
+            }
+        }
+        goto out;
+    }
+
+    dt_gen = ucc_dt_to_generic(buf->dt);
+    state  = task->unpack
+                 ? dt_gen->ops.start_unpack(dt_gen->context, buf->buffer,
+                                            buf->count)
+                 : dt_gen->ops.start_pack(dt_gen->context, buf->buffer,
+                                          buf->count);
+    for (b = 0; b < buf->n_blocks && len > 0; b++) {
+        stream_offset = (buf->first_block + b) * coll->block_size + offset;
+        scratch       = PTR_OFFSET(task->scratch, b * coll->frag_size);
+        if (task->unpack) {
+            status = dt_gen->ops.unpack(state, stream_offset, scratch, len);
+            if (ucc_unlikely(UCC_OK != status)) {
+                ucc_error("failed to unpack %zd bytes at offset %zd",
+                          len, stream_offset);
+                break;
+            }
+        } else if (ucc_unlikely(dt_gen->ops.pack(state, stream_offset,
+                                                 scratch, len) != len)) {
+            ucc_error("failed to pack %zd bytes at offset %zd",
+                      len, stream_offset);
+            status = UCC_ERR_NO_MESSAGE;
+            break;
+        }
+    }
+    dt_gen->ops.finish(state);
+out:
+    coll_task->status = status;
+    return ucc_task_complete(coll_task);
+}
+
+static ucc_status_t ucc_coll_packed_task_finalize(ucc_coll_task_t *coll_task)
+{
+    ucc_coll_task_destruct(coll_task);
+    ucc_free(coll_task);
+    return UCC_OK;
+}
+
+static ucc_status_t
+ucc_coll_packed_task_init(ucc_coll_packed_t *coll, ucc_base_team_t *team,
+                          ucc_coll_packed_buf_t *buf, void *scratch,
+                          int unpack, ucc_coll_packed_task_t **task_p)
+{
+    ucc_coll_packed_task_t *task;
+    ucc_status_t            status;
+
+    task = ucc_malloc(sizeof(*task), "packed_task");
+    if (ucc_unlikely(!task)) {
+        ucc_error("failed to allocate %zd bytes for packed task",
+                  sizeof(*task));
+        return UCC_ERR_NO_MEMORY;
+    }
+    ucc_coll_task_construct(&task->super);
+    status = ucc_coll_task_init(&task->super, NULL, team);
+    if (ucc_unlikely(UCC_OK != status)) {
+        ucc_coll_packed_task_finalize(&task->super);
+        return status;
+    }
+    task->super.post     = ucc_coll_packed_task_post;
+    task->super.progress = NULL;
+    task->super.finalize = ucc_coll_packed_task_finalize;
+    task->coll           = coll;
+    task->buf            = buf;
+    task->scratch        = scratch;
+    task->unpack         = unpack;
+    task->frag_num       = 0;
+    *task_p              = task;
+    return UCC_OK;
+}
+
+static ucc_status_t ucc_coll_packed_frag_finalize(ucc_coll_task_t *task)
+{
+    ucc_coll_packed_frag_t *frag = ucc_derived_of(task, ucc_coll_packed_frag_t);
+    ucc_status_t            status;
+
+    status = ucc_schedule_finalize(task);
+    if (frag->scratch) {
+        ucc_mc_free(frag->scratch);
+    }
+    ucc_coll_task_destruct(task);
+    ucc_free(frag);
+    return status;
+}
+
+static ucc_status_t
+ucc_coll_packed_frag_setup(ucc_schedule_pipelined_t *schedule_p, //NOLINT
+                           ucc_schedule_t *schedule, int frag_num)
+{
+    ucc_coll_packed_frag_t *frag =
+        ucc_derived_of(schedule, ucc_coll_packed_frag_t);
+
+    if (frag->pack) {
+        frag->pack->frag_num = frag_num;
+    }
+    if (frag->unpack) {
+        frag->unpack->frag_num = frag_num;
+    }
+    return UCC_OK;
+}
+
+static ucc_status_t
+ucc_coll_packed_frag_init(ucc_base_coll_args_t     *coll_args,
+                          ucc_schedule_pipelined_t *sp,
+                          ucc_base_team_t          *team,
+                          ucc_schedule_t          **frag_p)
+{
+    ucc_coll_packed_t      *coll  = ucc_derived_of(sp, ucc_coll_packed_t);
+    size_t                  ssize = coll->n_src_scratch * coll->frag_size;
+    size_t                  dsize = coll->n_dst_scratch * coll->frag_size;
+    ucc_coll_task_t        *tasks[3];
+    ucc_coll_packed_frag_t *frag;
+    ucc_base_coll_args_t    bargs;
+    void                   *sscratch, *dscratch;
+    ucc_status_t            status;
+    int                     n_tasks, i;
+
+    frag = ucc_malloc(sizeof(*frag), "packed_frag");
+    if (ucc_unlikely(!frag)) {
+        ucc_error("failed to allocate %zd bytes for packed fragment",
+                  sizeof(*frag));
+        return UCC_ERR_NO_MEMORY;
+    }
+    ucc_coll_task_construct(&frag->super.super);
+    frag->scratch = NULL;
+    frag->pack    = NULL;
+    frag->unpack  = NULL;
+    n_tasks       = 0;
+    UCC_CHECK_GOTO(ucc_schedule_init(&frag->super, coll_args, team), err,
+                   status);
+    UCC_CHECK_GOTO(ucc_mc_alloc(&frag->scratch, ucc_max(ssize + dsize, 1),
+                                UCC_MEMORY_TYPE_HOST),
+                   err, status);
+    sscratch = frag->scratch->addr;
+    /* bcast works inplace on the src scratch */
+    dscratch = dsize ? PTR_OFFSET(sscratch, ssize) : sscratch;
+
+    if (coll->src.n_blocks) {
+        UCC_CHECK_GOTO(ucc_coll_packed_task_init(coll, team, &coll->src,
+                                                 sscratch, 0, &frag->pack),
+                       err, status);
+        tasks[n_tasks++] = &frag->pack->super;
+    }
+
+    bargs.mask                   = 0;
+    bargs.team                   = coll->team;
+    bargs.args                   = coll->args;
+    bargs.args.mask              = 0;
+    bargs.args.flags             = 0;
+    bargs.args.src.info.buffer   = sscratch;
+    bargs.args.src.info.count    = ssize;
+    bargs.args.src.info.datatype = UCC_DT_UINT8;
+    bargs.args.src.info.mem_type = UCC_MEMORY_TYPE_HOST;
+    bargs.args.dst.info.buffer   = dscratch;
+    bargs.args.dst.info.count    = dsize;
+    bargs.args.dst.info.datatype = UCC_DT_UINT8;
+    bargs.args.dst.info.mem_type = UCC_MEMORY_TYPE_HOST;
+    status = ucc_coll_init(coll->team->score_map, &bargs, &tasks[n_tasks]);
+    if (ucc_unlikely(UCC_OK != status)) {
+        ucc_error("failed to init packed %s: %s",
+                  ucc_coll_type_str(bargs.args.coll_type),
+                  ucc_status_string(status));
+        goto err;
+    }
+    frag->super.super.flags |= tasks[n_tasks]->flags &
+                               UCC_COLL_TASK_FLAG_EXECUTOR;
+    n_tasks++;
+
+    if (coll->dst.n_blocks) {
+        UCC_CHECK_GOTO(ucc_coll_packed_task_init(coll, team, &coll->dst,
+                                                 dscratch, 1, &frag->unpack),
+                       err, status);
+        tasks[n_tasks++] = &frag->unpack->super;
+    }
+
+    UCC_CHECK_GOTO(ucc_schedule_add_task(&frag->super, tasks[0]), err, status);
+    UCC_CHECK_GOTO(ucc_task_subscribe_dep(&frag->super.super, tasks[0],
+                                          UCC_EVENT_SCHEDULE_STARTED),
+                   err, status);
+    for (i = 1; i < n_tasks; i++) {
+        UCC_CHECK_GOTO(ucc_schedule_add_task(&frag->super, tasks[i]), err,
+                       status);
+        UCC_CHECK_GOTO(ucc_task_subscribe_dep(tasks[i - 1], tasks[i],
+                                              UCC_EVENT_COMPLETED),
+                       err, status);
+    }
+    frag->super.super.post     = ucc_schedule_start;
+    frag->super.super.progress = NULL;
+    frag->super.super.finalize = ucc_coll_packed_frag_finalize;
+    *frag_p                    = &frag->super;
+    return UCC_OK;
+
+err:
+    for (i = frag->super.n_tasks; i < n_tasks; i++) {
+        /* tasks not added to the schedule yet */
+        tasks[i]->finalize(tasks[i]);
+    }
+    ucc_coll_packed_frag_finalize(&frag->super.super);
+    return status;
+}
+
+static ucc_status_t ucc_coll_packed_finalize(ucc_coll_task_t *task)
+{
+    ucc_coll_packed_t *coll = ucc_derived_of(task, ucc_coll_packed_t);
+    ucc_status_t       status;
+
+    status = ucc_schedule_pipelined_finalize(task);
+    ucc_coll_task_destruct(task);
+    ucc_free(coll);
+    return status;
+}
+
+static inline void ucc_coll_packed_buf_set(ucc_coll_packed_buf_t *buf,
+                                           const ucc_coll_buffer_info_t *info,
+                                           ucc_rank_t first_block,
+                                           ucc_rank_t n_blocks)
+{
+    buf->buffer      = info->buffer;
+    buf->count       = info->count;
+    buf->dt          = info->datatype;
+    buf->first_block = first_block;
+    buf->n_blocks    = n_blocks;
+}
+
+ucc_status_t ucc_coll_packed_init(ucc_base_coll_args_t *op_args,
+                                  ucc_team_h team, ucc_coll_task_t **task_p)
+{
+    ucc_coll_args_t       *args     = &op_args->args;
+    ucc_context_t         *ctx      = team->contexts[0];
+    ucc_rank_t             rank     = team->rank;
+    ucc_rank_t             size     = team->size;
+    int                    is_root  = (args->root == rank);
+    int                    inplace  = UCC_IS_INPLACE(*args);
+    ucc_rank_t             n_blocks = size;
+    ucc_coll_packed_buf_t  src      = {0};
+    ucc_coll_packed_buf_t  dst      = {0};
+    ucc_coll_packed_buf_t *sized;
+    ucc_base_coll_args_t   bargs;
+    ucc_coll_packed_t     *coll;
+    ucc_status_t           status;
+    size_t                 block_count;
+    int                    n_frags, pipeline_depth;
+
+    if (UCC_COLL_ARGS_ACTIVE_SET(args) ||
+        ucc_coll_args_mem_type(args, rank) != UCC_MEMORY_TYPE_HOST) {
+        ucc_debug("generic datatypes are supported for host memory "
+                  "collectives without active set");
+        return UCC_ERR_NOT_SUPPORTED;
+    }
+
+    /* blocks of the user buffers handled by this rank, block_count is the
+       number of elements of a per-rank block */
+    switch (args->coll_type) {
+    case UCC_COLL_TYPE_BCAST:
+        n_blocks    = 1;
+        block_count = args->src.info.count;
+        ucc_coll_packed_buf_set(is_root ? &src : &dst, &args->src.info, 0, 1);
+        break;
+    case UCC_COLL_TYPE_ALLGATHER:
+        block_count = args->dst.info.count / size;
+        if (inplace) {
+            ucc_coll_packed_buf_set(&src, &args->dst.info, rank, 1);
+        } else {
+            ucc_coll_packed_buf_set(&src, &args->src.info, 0, 1);
+        }
+        ucc_coll_packed_buf_set(&dst, &args->dst.info, 0, size);
+        break;
+    case UCC_COLL_TYPE_ALLTOALL:
+        block_count = args->dst.info.count / size;
+        ucc_coll_packed_buf_set(&src, inplace ? &args->dst.info
+                                              : &args->src.info, 0, size);
+        ucc_coll_packed_buf_set(&dst, &args->dst.info, 0, size);
+        break;
+    case UCC_COLL_TYPE_GATHER:
+        if (is_root) {
+            block_count = args->dst.info.count / size;
+            ucc_coll_packed_buf_set(&dst, &args->dst.info, 0, size);
+        } else {
+            block_count = args->src.info.count;
+        }
+        if (is_root && inplace) {
+            ucc_coll_packed_buf_set(&src, &args->dst.info, rank, 1);
+        } else {
+            ucc_coll_packed_buf_set(&src, &args->src.info, 0, 1);
+        }
+        break;
+    case UCC_COLL_TYPE_SCATTER:
+        if (is_root) {
+            block_count = args->src.info.count / size;
+            ucc_coll_packed_buf_set(&src, &args->src.info, 0, size);
+        } else {
+            block_count = args->dst.info.count;
+        }
+        if (!is_root || !inplace) {
+            /* inplace root keeps its block in src */
+            ucc_coll_packed_buf_set(&dst, &args->dst.info, 0, 1);
+        }
+        break;
+    default:
+        ucc_debug("%s is not supported for generic datatypes",
+                  ucc_coll_type_str(args->coll_type));
+        return UCC_ERR_NOT_SUPPORTED;
+    }
+
+    coll = ucc_malloc(sizeof(*coll), "packed_coll");
+    if (ucc_unlikely(!coll)) {
+        ucc_error("failed to allocate %zd bytes for packed collective",
+                  sizeof(*coll));
+        return UCC_ERR_NO_MEMORY;
+    }
+    ucc_coll_task_construct(&coll->super.super.super);
+    sized            = dst.n_blocks ? &dst : &src;
+    coll->team       = team;
+    coll->args       = *args;
+    coll->src        = src;
+    coll->dst        = dst;
+    coll->block_size = ucc_coll_packed_size(sized->buffer, block_count,
+                                            sized->dt);
+    /* same fragment size on all the ranks: it depends on the block size and
+       the number of blocks of the collective only */
+    coll->frag_size  = ucc_max(ctx->dt_pack_frag_size / n_blocks, 1);
+    coll->frag_size  = ucc_max(ucc_min(coll->frag_size, coll->block_size), 1);
+    n_frags          = ucc_max(ucc_div_round_up(coll->block_size,
+                                                coll->frag_size), 1);
+    pipeline_depth   = ucc_min(n_frags,
+                               ucc_max(1, (int)ctx->dt_pack_pipeline_depth));
+    pipeline_depth   = ucc_min(pipeline_depth,
+                               UCC_SCHEDULE_PIPELINED_MAX_FRAGS);
+    switch (args->coll_type) {
+    case UCC_COLL_TYPE_BCAST:
+        coll->n_src_scratch = 1;
+        coll->n_dst_scratch = 0;
+        break;
+    case UCC_COLL_TYPE_GATHER:
+        coll->n_src_scratch = 1;
+        coll->n_dst_scratch = is_root ? size : 0;
+        break;
+    case UCC_COLL_TYPE_SCATTER:
+        coll->n_src_scratch = is_root ? size : 0;
+        coll->n_dst_scratch = 1;
+        break;
+    default:
+        coll->n_src_scratch = src.n_blocks;
+        coll->n_dst_scratch = dst.n_blocks;
+        break;
+    }
+
+    /* the schedule itself is seen as the collective on the packed bytes */
+    bargs                        = *op_args;
+    bargs.args.src.info.count    = coll->n_src_scratch * coll->block_size;
+    bargs.args.src.info.datatype = UCC_DT_UINT8;
+    bargs.args.dst.info.count    = coll->n_dst_scratch * coll->block_size;
+    bargs.args.dst.info.datatype = UCC_DT_UINT8;
+    if (args->coll_type == UCC_COLL_TYPE_BCAST) {
+        bargs.args.dst.info = bargs.args.src.info;
+    }
+
+    status = ucc_schedule_pipelined_init(
+        &bargs, &team->cl_teams[0]->super, ucc_coll_packed_frag_init,
+        ucc_coll_packed_frag_setup, pipeline_depth, n_frags,
+        UCC_PIPELINE_ORDERED, &coll->super);
+    if (ucc_unlikely(UCC_OK != status)) {
+        ucc_error("failed to init pipelined schedule of packed %s",
+                  ucc_coll_type_str(args->coll_type));
+        ucc_coll_task_destruct(&coll->super.super.super);
+        ucc_free(coll);
+        return status;
+    }
+    coll->super.super.super.triggered_post = ucc_triggered_post;
+    coll->super.super.super.finalize       = ucc_coll_packed_finalize;
+    ucc_debug("packed %s: block size %zd, frag size %zd, n_frags %d, "
+              "pdepth %d", ucc_coll_type_str(args->coll_type),
+              coll->block_size, coll->frag_size, n_frags, pipeline_depth);
+    *task_p = &coll->super.super.super;
+    return UCC_OK;
+}
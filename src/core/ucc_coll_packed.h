@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCC_COLL_PACKED_H_
+#define UCC_COLL_PACKED_H_
+
+#include "ucc/api/ucc.h"
+#include "schedule/ucc_schedule_pipelined.h"
+#include "components/mc/base/ucc_mc_base.h"
+
+/* User buffer of a packed collective. The buffer holds "count" elements of
+   "dt", its packed stream is seen as blocks of block_size bytes, the blocks
+   [first_block, first_block + n_blocks) are packed or unpacked by this
+   rank. n_blocks is 0 if the buffer is not used by this rank. */
+typedef struct ucc_coll_packed_buf {
+    void          *buffer;
+    size_t         count;
+    ucc_datatype_t dt;
+    ucc_rank_t     first_block;
+    ucc_rank_t     n_blocks;
+} ucc_coll_packed_buf_t;
+
+/* Collective on a generic non-contiguous datatype. It is a pipelined
+   schedule of fragments, each fragment packs frag_size bytes of every
+   block into the scratch, runs the collective on the packed bytes and
+   unpacks the result. The fragments are launched again until the whole
+   block_size is done, so the memory is bounded by frag_size. The last
+   fragment is padded up to frag_size: all the fragments run the same
+   collective. */
+typedef struct ucc_coll_packed {
+    ucc_schedule_pipelined_t super;
+    ucc_team_h               team;
+    ucc_coll_args_t          args; /*< collective on the user buffers */
+    ucc_coll_packed_buf_t    src;
+    ucc_coll_packed_buf_t    dst;
+    size_t                   block_size;
+    size_t                   frag_size;
+    ucc_rank_t               n_src_scratch; /*< blocks in the scratch */
+    ucc_rank_t               n_dst_scratch;
+} ucc_coll_packed_t;
+
+/* Local task of a fragment packing the blocks of "buf" to the scratch or
+   unpacking them from it */
+typedef struct ucc_coll_packed_task {
+    ucc_coll_task_t        super;
+    ucc_coll_packed_t     *coll;
+    ucc_coll_packed_buf_t *buf;
+    void                  *scratch;
+    int                    unpack;
+    int                    frag_num;
+} ucc_coll_packed_task_t;
+
+typedef struct ucc_coll_packed_frag {
+    ucc_schedule_t          super;
+    ucc_mc_buffer_header_t *scratch;
+    ucc_coll_packed_task_t *pack;   /*< NULL if nothing to pack */
+    ucc_coll_packed_task_t *unpack; /*< NULL if nothing to unpack */
+} ucc_coll_packed_frag_t;
+
+/* Returns 1 if the datatypes of the collective require packing */
+int ucc_coll_args_need_pack(const ucc_coll_args_t *args, ucc_rank_t rank);
+
+ucc_status_t ucc_coll_packed_init(ucc_base_coll_args_t *op_args,
+                                  ucc_team_h team, ucc_coll_task_t **task_p);
+
+#endif
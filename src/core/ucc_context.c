@@ -44,6 +44,20 @@ static ucc_config_field_t ucc_context_config_table[] = {
      "is configured with OOB (global mode). 0 - disable, 1 - try, 2 - force.",
      ucc_offsetof(ucc_context_config_t, internal_oob), UCC_CONFIG_TYPE_UINT},
 
+    {"DT_PACK_FRAG_SIZE", "256k",
+     "Size of the fragment used by collectives on generic non-contiguous "
+     "datatypes. The data are packed and unpacked by fragments, so the "
+     "scratch memory of such a collective is bounded by the fragment size "
+     "times the pipeline depth",
+     ucc_offsetof(ucc_context_config_t, dt_pack_frag_size),
+     UCC_CONFIG_TYPE_MEMUNITS},
+
+    {"DT_PACK_PIPELINE_DEPTH", "2",
+     "Number of fragments simultaneously progressed by collectives on "
+     "generic non-contiguous datatypes",
+     ucc_offsetof(ucc_context_config_t, dt_pack_pipeline_depth),
+     UCC_CONFIG_TYPE_UINT},
+
     {NULL}};
 UCC_CONFIG_REGISTER_TABLE(ucc_context_config_table, "UCC context", NULL,
                           ucc_context_config_t, &ucc_config_global_list);
@@ -577,9 +591,11 @@ ucc_status_t ucc_context_create(ucc_lib_h lib,
         status = UCC_ERR_NO_MEMORY;
         goto error;
     }
-    ctx->rank          = UCC_RANK_MAX;
-    ctx->lib           = lib;
-    ctx->ids.pool_size = config->team_ids_pool_size;
+    ctx->rank                   = UCC_RANK_MAX;
+    ctx->lib                    = lib;
+    ctx->ids.pool_size          = config->team_ids_pool_size;
+    ctx->dt_pack_frag_size      = config->dt_pack_frag_size;
+    ctx->dt_pack_pipeline_depth = config->dt_pack_pipeline_depth;
     ucc_list_head_init(&ctx->progress_list);
     ucc_copy_context_params(&ctx->params, params);
     ucc_copy_context_params(&b_params.params, params);
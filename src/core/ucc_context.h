@@ -68,6 +68,8 @@ typedef struct ucc_context {
     ucc_context_topo_t      *topo;
     uint64_t                 cl_flags;
     ucc_tl_team_t           *service_team;
+    size_t                   dt_pack_frag_size;
+    uint32_t                 dt_pack_pipeline_depth;
 } ucc_context_t;
 
 typedef struct ucc_context_config {
@@ -81,6 +83,8 @@ typedef struct ucc_context_config {
     uint32_t                  estimated_num_ppn;
     uint32_t                  lock_free_progress_q;
     uint32_t                  internal_oob;
+    size_t                    dt_pack_frag_size;
+    uint32_t                  dt_pack_pipeline_depth;
 } ucc_context_config_t;
 
 /* Any internal UCC component (TL, CL, etc) may register its own
@@ -31,6 +31,11 @@ typedef struct ucc_dt_generic {
 #define UCC_DT_IS_CONTIG(_dt) (UCC_DT_IS_GENERIC(_dt) && \
                                UCC_DT_GENERIC_IS_CONTIG(ucc_dt_to_generic(_dt)))
 
+/* Generic datatype described by pack/unpack callbacks only: collectives on
+   it are executed over the packed data, see ucc_coll_packed.h */
+#define UCC_DT_NEEDS_PACK(_dt) (UCC_DT_IS_GENERIC(_dt) && \
+                                !UCC_DT_GENERIC_IS_CONTIG(ucc_dt_to_generic(_dt)))
+
 #define UCC_DT_HAS_REDUCE(_dt) (UCC_DT_IS_GENERIC(_dt) && \
                                 UCC_DT_GENERIC_HAS_REDUCE(ucc_dt_to_generic(_dt)))
 
@@ -60,8 +65,8 @@ static inline size_t ucc_dt_size(ucc_datatype_t dt)
     } else if (UCC_DT_IS_CONTIG(dt)) {
         return ucc_contig_dt_size(dt);
     }
-    /* GENERIC callback pack/unpack
-       TODO remove ucc_likely once custom datatype is implemented
+    /* GENERIC callback pack/unpack: has no fixed size, collectives on it
+       are packed by the core before reaching the components.
        does not matter what to return - we should not get here */
     ucc_assert(0);
     return SIZE_MAX;
@@ -0,0 +1,341 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * See file LICENSE for terms.
+ */
+
+#include "config.h"
+#include "ucc_fusion.h"
+#include "ucc_team.h"
+#include "ucc_dt.h"
+#include "components/mc/ucc_mc.h"
+#include "utils/ucc_malloc.h"
+#include "utils/ucc_log.h"
+#include "utils/ucc_coll_utils.h"
+
+/* Fusion of small allreduce operations.
+
+   The inputs of the operations added to a fusion handle are packed
+   back to back into the staging buffer of the current bucket. The bucket
+   is posted as one inplace allreduce once it is full or on flush, and the
+   completion callback of that allreduce copies the results out and
+   completes the user requests of the bucket.
+
+   Buckets are cut by size and explicit flush only: both depend on the
+   sequence of operations alone, so all the ranks fuse the same operations
+   into the same collective. A time based cut would be a local decision
+   and the fused collectives would not match across the ranks. */
+
+#define UCC_FUSION_DEFAULT_SIZE_THRESH (2 * 1024 * 1024)
+
+static ucc_status_t ucc_fusion_bucket_get(ucc_fusion_t *fusion, size_t size,
+                                          ucc_fusion_bucket_t **bucket_p)
+{
+    ucc_fusion_bucket_t *bucket;
+    ucc_status_t         status;
+
+    if (size <= fusion->size_thresh && !ucc_list_is_empty(&fusion->free)) {
+        bucket = ucc_list_extract_head(&fusion->free, ucc_fusion_bucket_t,
+                                       list_elem);
+    } else {
+        bucket = ucc_malloc(sizeof(*bucket), "fusion_bucket");
+        if (!bucket) {
+            ucc_error("failed to allocate %zd bytes for fusion bucket",
+                      sizeof(*bucket));
+            return UCC_ERR_NO_MEMORY;
+        }
+        bucket->fusion   = fusion;
+        bucket->capacity = ucc_max(size, fusion->size_thresh);
+        status = ucc_mc_alloc(&bucket->staging, bucket->capacity,
+                              fusion->mem_type);
+        if (ucc_unlikely(UCC_OK != status)) {
+            ucc_error("failed to allocate %zd bytes for fusion staging buffer",
+                      bucket->capacity);
+            ucc_free(bucket);
+            return status;
+        }
+    }
+    bucket->size = 0;
+    bucket->req  = NULL;
+    ucc_list_head_init(&bucket->entries);
+    *bucket_p = bucket;
+    return UCC_OK;
+}
+
+static void ucc_fusion_bucket_free(ucc_fusion_bucket_t *bucket)
+{
+    ucc_mc_free(bucket->staging);
+    ucc_free(bucket);
+}
+
+static void ucc_fusion_bucket_put(ucc_fusion_bucket_t *bucket)
+{
+    ucc_fusion_t *fusion = bucket->fusion;
+
+    if (bucket->capacity > fusion->size_thresh) {
+        ucc_fusion_bucket_free(bucket);
+    } else {
+        ucc_list_add_tail(&fusion->free, &bucket->list_elem);
+    }
+}
+
+/* Completes all the entries of the bucket, with the results copied out of
+   the staging buffer if the fused collective succeeded */
+static void ucc_fusion_bucket_complete(void *data, ucc_status_t status)
+{
+    ucc_fusion_bucket_t *bucket = data;
+    ucc_fusion_entry_t  *entry, *tmp;
+    ucc_coll_args_t     *args;
+    ucc_status_t         st;
+
+    ucc_list_for_each_safe(entry, tmp, &bucket->entries, list_elem) {
+        args = &entry->super.bargs.args;
+        st   = status;
+        if (UCC_OK == st) {
+            st = ucc_mc_memcpy(args->dst.info.buffer,
+                               PTR_OFFSET(bucket->staging->addr, entry->offset),
+                               args->dst.info.count *
+                                   ucc_dt_size(args->dst.info.datatype),
+                               args->dst.info.mem_type,
+                               bucket->fusion->mem_type);
+            if (ucc_unlikely(UCC_OK != st)) {
+                ucc_error("failed to copy fused allreduce result");
+            }
+        }
+        ucc_list_del(&entry->list_elem);
+        entry->super.status = st;
+        ucc_task_complete(&entry->super);
+    }
+}
+
+/* Releases the buckets whose fused collective is completed */
+static void ucc_fusion_reclaim(ucc_fusion_t *fusion)
+{
+    ucc_fusion_bucket_t *bucket, *tmp;
+
+    ucc_list_for_each_safe(bucket, tmp, &fusion->posted, list_elem) {
+        if (UCC_INPROGRESS == ucc_collective_test(bucket->req)) {
+            continue;
+        }
+        ucc_collective_finalize(bucket->req);
+        ucc_list_del(&bucket->list_elem);
+        ucc_fusion_bucket_put(bucket);
+    }
+}
+
+static ucc_status_t ucc_fusion_post(ucc_fusion_t *fusion)
+{
+    ucc_fusion_bucket_t *bucket = fusion->current;
+    ucc_coll_args_t      args;
+    ucc_status_t         status;
+
+    if (!bucket) {
+        return UCC_OK;
+    }
+    fusion->current = NULL;
+
+    memset(&args, 0, sizeof(args));
+    args.mask              = UCC_COLL_ARGS_FIELD_FLAGS | UCC_COLL_ARGS_FIELD_CB;
+    args.coll_type         = UCC_COLL_TYPE_ALLREDUCE;
+    args.flags             = UCC_COLL_ARGS_FLAG_IN_PLACE;
+    args.op                = fusion->op;
+    args.dst.info.buffer   = bucket->staging->addr;
+    args.dst.info.count    = bucket->size / ucc_dt_size(fusion->dt);
+    args.dst.info.datatype = fusion->dt;
+    args.dst.info.mem_type = fusion->mem_type;
+    args.cb.cb             = ucc_fusion_bucket_complete;
+    args.cb.data           = bucket;
+
+    status = ucc_collective_init(&args, &bucket->req, fusion->team);
+    if (ucc_unlikely(UCC_OK != status)) {
+        ucc_error("failed to init fused allreduce: %s",
+                  ucc_status_string(status));
+        goto err;
+    }
+    status = ucc_collective_post(bucket->req);
+    if (ucc_unlikely(UCC_OK != status)) {
+        ucc_error("failed to post fused allreduce: %s",
+                  ucc_status_string(status));
+        ucc_collective_finalize(bucket->req);
+        goto err;
+    }
+    ucc_list_add_tail(&fusion->posted, &bucket->list_elem);
+    return UCC_OK;
+
+err:
+    ucc_fusion_bucket_complete(bucket, status);
+    ucc_fusion_bucket_put(bucket);
+    return status;
+}
+
+ucc_status_t ucc_fusion_create(ucc_team_h team,
+                               const ucc_fusion_params_t *params,
+                               ucc_fusion_h *fusion_p)
+{
+    ucc_fusion_t *fusion;
+
+    if (team->status != UCC_OK) {
+        ucc_error("team %p is used before team create is completed", team);
+        return UCC_ERR_INVALID_PARAM;
+    }
+    if (!UCC_DT_IS_PREDEFINED(params->datatype)) {
+        ucc_error("fusion is only supported for predefined datatypes");
+        return UCC_ERR_NOT_SUPPORTED;
+    }
+
+    fusion = ucc_malloc(sizeof(*fusion), "fusion");
+    if (!fusion) {
+        ucc_error("failed to allocate %zd bytes for fusion", sizeof(*fusion));
+        return UCC_ERR_NO_MEMORY;
+    }
+    fusion->team        = team;
+    fusion->dt          = params->datatype;
+    fusion->op          = params->op;
+    fusion->size_thresh = UCC_FUSION_DEFAULT_SIZE_THRESH;
+    fusion->mem_type    = UCC_MEMORY_TYPE_HOST;
+    fusion->current     = NULL;
+    if (params->mask & UCC_FUSION_PARAM_FIELD_SIZE_THRESH) {
+        fusion->size_thresh = ucc_max(params->size_thresh,
+                                      ucc_dt_size(params->datatype));
+    }
+    if (params->mask & UCC_FUSION_PARAM_FIELD_MEM_TYPE) {
+        fusion->mem_type = params->mem_type;
+    }
+    ucc_list_head_init(&fusion->posted);
+    ucc_list_head_init(&fusion->free);
+    *fusion_p = fusion;
+    return UCC_OK;
+}
+
+static ucc_status_t ucc_fusion_entry_finalize(ucc_coll_task_t *task)
+{
+    ucc_free(task);
+    return UCC_OK;
+}
+
+ucc_status_t ucc_fusion_add(ucc_fusion_h fusion, ucc_coll_args_t *coll_args,
+                            ucc_coll_req_h *request)
+{
+    ucc_coll_buffer_info_t *src;
+    ucc_fusion_entry_t     *entry;
+    ucc_coll_args_t        *args;
+    ucc_mem_attr_t          mem_attr;
+    ucc_status_t            status;
+    size_t                  size;
+
+    if (coll_args->coll_type != UCC_COLL_TYPE_ALLREDUCE ||
+        coll_args->dst.info.datatype != fusion->dt ||
+        coll_args->op != fusion->op) {
+        ucc_error("fusion only accepts allreduce with the datatype and op "
+                  "of the fusion handle");
+        return UCC_ERR_INVALID_PARAM;
+    }
+    if (!UCC_IS_INPLACE(*coll_args) &&
+        coll_args->src.info.datatype != fusion->dt) {
+        ucc_error("datatype missmatch");
+        return UCC_ERR_INVALID_PARAM;
+    }
+
+    entry = ucc_malloc(sizeof(*entry), "fusion_entry");
+    if (!entry) {
+        ucc_error("failed to allocate %zd bytes for fusion entry",
+                  sizeof(*entry));
+        return UCC_ERR_NO_MEMORY;
+    }
+    ucc_coll_task_construct(&entry->super);
+    ucc_coll_task_init(&entry->super, NULL, NULL);
+    args = &entry->super.bargs.args;
+    memcpy(args, coll_args, sizeof(*args));
+    if (!(args->mask & UCC_COLL_ARGS_FIELD_FLAGS)) {
+        args->flags = 0;
+    }
+    src = UCC_IS_INPLACE(*args) ? &args->dst.info : &args->src.info;
+    mem_attr.field_mask = UCC_MEM_ATTR_FIELD_MEM_TYPE;
+    if (args->dst.info.mem_type == UCC_MEMORY_TYPE_UNKNOWN) {
+        status = ucc_mc_get_mem_attr(args->dst.info.buffer, &mem_attr);
+        if (ucc_unlikely(UCC_OK != status)) {
+            goto free_entry;
+        }
+        args->dst.info.mem_type = mem_attr.mem_type;
+    }
+    if (src->mem_type == UCC_MEMORY_TYPE_UNKNOWN) {
+        status = ucc_mc_get_mem_attr(src->buffer, &mem_attr);
+        if (ucc_unlikely(UCC_OK != status)) {
+            goto free_entry;
+        }
+        src->mem_type = mem_attr.mem_type;
+    }
+    entry->super.finalize = ucc_fusion_entry_finalize;
+    entry->super.seq_num  = fusion->team->seq_num;
+    if (args->mask & UCC_COLL_ARGS_FIELD_CB) {
+        entry->super.cb     = args->cb;
+        entry->super.flags |= UCC_COLL_TASK_FLAG_CB;
+    }
+
+    ucc_fusion_reclaim(fusion);
+    size = args->dst.info.count * ucc_dt_size(fusion->dt);
+    if (size == 0) {
+        entry->super.status = UCC_OK;
+        *request            = &entry->super.super;
+        return ucc_task_complete(&entry->super);
+    }
+    if (fusion->current && fusion->current->size + size >
+                           fusion->current->capacity) {
+        status = ucc_fusion_post(fusion);
+        if (ucc_unlikely(UCC_OK != status)) {
+            goto free_entry;
+        }
+    }
+    if (!fusion->current) {
+        status = ucc_fusion_bucket_get(fusion, size, &fusion->current);
+        if (ucc_unlikely(UCC_OK != status)) {
+            goto free_entry;
+        }
+    }
+    status = ucc_mc_memcpy(PTR_OFFSET(fusion->current->staging->addr,
+                                      fusion->current->size),
+                           src->buffer, size, fusion->mem_type,
+                           src->mem_type);
+    if (ucc_unlikely(UCC_OK != status)) {
+        ucc_error("failed to pack allreduce into fusion staging buffer");
+        goto free_entry;
+    }
+    entry->offset              = fusion->current->size;
+    fusion->current->size     += size;
+    entry->super.status        = UCC_INPROGRESS;
+    entry->super.super.status  = UCC_INPROGRESS;
+    ucc_list_add_tail(&fusion->current->entries, &entry->list_elem);
+    *request = &entry->super.super;
+
+    if (fusion->current->size >= fusion->size_thresh) {
+        /* on error the entry is already completed with the error status */
+        return ucc_fusion_post(fusion);
+    }
+    return UCC_OK;
+
+free_entry:
+    ucc_free(entry);
+    return status;
+}
+
+ucc_status_t ucc_fusion_flush(ucc_fusion_h fusion)
+{
+    ucc_fusion_reclaim(fusion);
+    return ucc_fusion_post(fusion);
+}
+
+ucc_status_t ucc_fusion_destroy(ucc_fusion_h fusion)
+{
+    ucc_fusion_bucket_t *bucket, *tmp;
+
+    ucc_fusion_reclaim(fusion);
+    if (fusion->current || !ucc_list_is_empty(&fusion->posted)) {
+        ucc_error("fusion %p has operations in progress", fusion);
+        return UCC_ERR_INVALID_PARAM;
+    }
+    ucc_list_for_each_safe(bucket, tmp, &fusion->free, list_elem) {
+        ucc_list_del(&bucket->list_elem);
+        ucc_fusion_bucket_free(bucket);
+    }
+    ucc_free(fusion);
+    return UCC_OK;
+}
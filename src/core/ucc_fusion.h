@@ -0,0 +1,50 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCC_FUSION_H_
+#define UCC_FUSION_H_
+
+#include "ucc/api/ucc.h"
+#include "utils/ucc_list.h"
+#include "schedule/ucc_schedule.h"
+#include "components/mc/base/ucc_mc_base.h"
+
+typedef struct ucc_fusion ucc_fusion_t;
+
+/* User visible request of an operation added to the fusion handle. The
+   input is packed at "offset" of the staging buffer of the bucket, the
+   arguments of the operation are kept in super.bargs */
+typedef struct ucc_fusion_entry {
+    ucc_coll_task_t super;
+    ucc_list_link_t list_elem;
+    size_t          offset;
+} ucc_fusion_entry_t;
+
+/* Staging buffer with the operations packed into it. A bucket is executed
+   as one inplace allreduce, on completion the results are copied out to
+   the entries. Buckets of size_thresh capacity are reused, larger ones
+   are allocated for a single oversized operation. */
+typedef struct ucc_fusion_bucket {
+    ucc_list_link_t         list_elem;
+    ucc_fusion_t           *fusion;
+    ucc_mc_buffer_header_t *staging;
+    size_t                  capacity;
+    size_t                  size;
+    ucc_list_link_t         entries;
+    ucc_coll_req_h          req;
+} ucc_fusion_bucket_t;
+
+typedef struct ucc_fusion {
+    ucc_team_h           team;
+    ucc_datatype_t       dt;
+    ucc_reduction_op_t   op;
+    ucc_memory_type_t    mem_type;
+    size_t               size_thresh;
+    ucc_fusion_bucket_t *current; /*< bucket being filled */
+    ucc_list_link_t      posted;  /*< buckets with fused collective posted */
+    ucc_list_link_t      free;    /*< buckets available for reuse */
+} ucc_fusion_t;
+
+#endif
@@ -191,16 +191,58 @@ ucc_status_t ucc_schedule_init(ucc_schedule_t *schedule,
 {
     ucc_status_t status;
 
-    status            = ucc_coll_task_init(&schedule->super, bargs, team);
-    schedule->ctx     = team->context->ucc_context;
-    schedule->n_tasks = 0;
+    status              = ucc_coll_task_init(&schedule->super, bargs, team);
+    schedule->ctx       = team->context->ucc_context;
+    schedule->n_tasks   = 0;
+    schedule->tasks     = schedule->tasks_inline;
+    schedule->max_tasks = UCC_SCHEDULE_N_TASKS_INLINE;
     return status;
 }
 
+static ucc_status_t ucc_schedule_grow_tasks(ucc_schedule_t *schedule)
+{
+    uint32_t          max_tasks = schedule->max_tasks * 2;
+    ucc_coll_task_t **tasks;
+
+    if (schedule->tasks == schedule->tasks_inline) {
+        tasks = ucc_malloc(max_tasks * sizeof(*tasks), "schedule_tasks");
+        if (tasks) {
+            memcpy(tasks, schedule->tasks_inline,
+                   schedule->n_tasks * sizeof(*tasks));
+        }
+    } else {
+        tasks = ucc_realloc(schedule->tasks, max_tasks * sizeof(*tasks),
+                            "schedule_tasks");
+    }
+    if (ucc_unlikely(!tasks)) {
+        ucc_error("failed to allocate %zd bytes for schedule tasks",
+                  max_tasks * sizeof(*tasks));
+        return UCC_ERR_NO_MEMORY;
+    }
+    schedule->tasks     = tasks;
+    schedule->max_tasks = max_tasks;
+    return UCC_OK;
+}
+
+void ucc_schedule_free_tasks(ucc_schedule_t *schedule)
+{
+    if (schedule->tasks != schedule->tasks_inline) {
+        ucc_free(schedule->tasks);
+        schedule->tasks     = schedule->tasks_inline;
+        schedule->max_tasks = UCC_SCHEDULE_N_TASKS_INLINE;
+    }
+}
+
 ucc_status_t ucc_schedule_add_task(ucc_schedule_t *schedule, ucc_coll_task_t *task)
 {
     ucc_status_t status;
 
+    if (schedule->n_tasks == schedule->max_tasks) {
+        status = ucc_schedule_grow_tasks(schedule);
+        if (ucc_unlikely(UCC_OK != status)) {
+            return status;
+        }
+    }
     status = ucc_event_manager_subscribe(task, UCC_EVENT_COMPLETED_SCHEDULE,
                                 &schedule->super,
                                 ucc_schedule_completed_handler);
@@ -245,5 +287,6 @@ ucc_status_t ucc_schedule_finalize(ucc_coll_task_t *task)
             }
         }
     }
+    ucc_schedule_free_tasks(schedule);
     return status_overall;
 }
@@ -111,14 +111,18 @@ typedef struct ucc_coll_task {
 extern struct ucc_mpool_ops ucc_coll_task_mpool_ops;
 typedef struct ucc_context ucc_context_t;
 
-#define UCC_SCHEDULE_MAX_TASKS 8
+/* Number of tasks stored in the schedule object itself. Schedules with
+   more tasks move the task array to the heap, see ucc_schedule_add_task */
+#define UCC_SCHEDULE_N_TASKS_INLINE 8
 
 typedef struct ucc_schedule {
-    ucc_coll_task_t  super;
-    uint32_t         n_completed_tasks;
-    uint32_t         n_tasks;
-    ucc_context_t   *ctx;
-    ucc_coll_task_t *tasks[UCC_SCHEDULE_MAX_TASKS];
+    ucc_coll_task_t   super;
+    uint32_t          n_completed_tasks;
+    uint32_t          n_tasks;
+    uint32_t          max_tasks;
+    ucc_context_t    *ctx;
+    ucc_coll_task_t **tasks;
+    ucc_coll_task_t  *tasks_inline[UCC_SCHEDULE_N_TASKS_INLINE];
 } ucc_schedule_t;
 
 void ucc_coll_task_construct(ucc_coll_task_t *task);
@@ -146,6 +150,11 @@ ucc_status_t ucc_schedule_init(ucc_schedule_t *schedule,
 
 ucc_status_t ucc_schedule_add_task(ucc_schedule_t *schedule, ucc_coll_task_t *task);
 
+/* Releases the task array of the schedule if it was moved to the heap.
+   Called from ucc_schedule_finalize, schedules which do not use it must
+   call it explicitly. */
+void ucc_schedule_free_tasks(ucc_schedule_t *schedule);
+
 ucc_status_t ucc_schedule_start(ucc_coll_task_t *task);
 
 ucc_status_t ucc_task_start_handler(ucc_coll_task_t *parent,
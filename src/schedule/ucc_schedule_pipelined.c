@@ -106,6 +106,9 @@ ucc_status_t ucc_schedule_pipelined_finalize(ucc_coll_task_t *task)
     for (i = 0; i < schedule_p->n_frags; i++) {
         schedule_p->frags[i]->super.finalize(&frags[i]->super);
     }
+    if (frags != schedule_p->frags_inline) {
+        ucc_free(frags);
+    }
     ucc_recursive_spinlock_destroy(&schedule_p->lock);
     return UCC_OK;
 }
@@ -162,6 +165,17 @@ ucc_status_t ucc_schedule_pipelined_init(
         return status;
     }
 
+    if (n_frags > UCC_SCHEDULE_PIPELINED_N_FRAGS_INLINE) {
+        schedule->frags = ucc_malloc(n_frags * sizeof(*schedule->frags),
+                                     "pipelined_frags");
+        if (ucc_unlikely(!schedule->frags)) {
+            ucc_error("failed to allocate %zd bytes for pipelined frags",
+                      n_frags * sizeof(*schedule->frags));
+            return UCC_ERR_NO_MEMORY;
+        }
+    } else {
+        schedule->frags = schedule->frags_inline;
+    }
     ucc_recursive_spinlock_init(&schedule->lock, 0);
 
     schedule->super.n_tasks        = n_frags_total;
@@ -216,6 +230,10 @@ err:
     for (i = i - 1; i >= 0; i--) {
         frags[i]->super.finalize(&frags[i]->super);
     }
+    if (frags != schedule->frags_inline) {
+        ucc_free(frags);
+    }
+    ucc_recursive_spinlock_destroy(&schedule->lock);
     return status;
 }
 
@@ -10,7 +10,13 @@
 
 typedef struct ucc_schedule_pipelined ucc_schedule_pipelined_t;
 
-#define UCC_SCHEDULE_PIPELINED_MAX_FRAGS 4
+/* Max pipeline depth, i.e. number of fragment schedules that can be
+   outstanding at a time. Up to UCC_SCHEDULE_PIPELINED_N_FRAGS_INLINE frags
+   are stored in the schedule itself, deeper pipelines allocate the frags
+   array on the heap. */
+#define UCC_SCHEDULE_PIPELINED_MAX_FRAGS 64
+
+#define UCC_SCHEDULE_PIPELINED_N_FRAGS_INLINE 4
 
 /* frag_init is the callback provided by the user of pipelined
    framework (e.g., TL that needs to build a pipeline) that is reponsible
@@ -46,7 +52,8 @@ extern const char* ucc_pipeline_order_names[];
 typedef struct ucc_schedule_pipelined {
     ucc_schedule_t               super;
     /* Array of the frag schedules - 1 schedule per pipeline entry */
-    ucc_schedule_t *             frags[UCC_SCHEDULE_PIPELINED_MAX_FRAGS];
+    ucc_schedule_t **            frags;
+    ucc_schedule_t *             frags_inline[UCC_SCHEDULE_PIPELINED_N_FRAGS_INLINE];
     /* n_frags - is the depth of the pipeline, ie how many fragments can
        be outstanding at a time */
     int                          n_frags;
@@ -251,10 +251,12 @@ typedef enum {
  * This structure is the argument to the reduce.cb callback. It must implement
  * the reduction of n_vectors + 1 data vectors each containing "count" elements.
  * First vector is "src1", other n_vectors have start address
- * v_j = src2 + count * dt_extent * stride * j.
+ * v_j = src2 + stride * j, with "stride" in bytes.
  * The result is stored in dst, so that
  * dst[i] = src1[i] + v0[i] + v1[i] + ... +v_nvectors[i],
- * for i in [0:count), where "+" represents user-defined reduction of 2 elements
+ * for i in [0:count), where "+" represents user-defined reduction of 2 elements.
+ * A large reduction may be split into several calls, each one on consecutive
+ * elements of all the vectors.
  */
 
 typedef struct ucc_reduce_cb_params {
@@ -407,6 +409,14 @@ typedef struct ucc_generic_dt_ops {
  * is responsible for releasing the @a datatype_p  object using
  * @ref ucc_dt_destroy "ucc_dt_destroy()" routine.
  *
+ * Datatypes without @ref UCC_GENERIC_DT_OPS_FLAG_CONTIG are supported by
+ * bcast, allgather, alltoall, gather and scatter on host memory. The data
+ * are packed and unpacked by fragments of the size set by the
+ * UCC_DT_PACK_FRAG_SIZE parameter, so no temporary copy of the whole
+ * message is required. Every rank must use such a datatype for at least
+ * one of its buffers of the collective, the packed size of the per-rank
+ * blocks must be the same on all the ranks.
+ *
  * @param [in]  ops          Generic datatype function table as defined by
  *                           @ref ucc_generic_dt_ops_t .
  * @param [in]  context      Application defined context passed to this
@@ -1806,10 +1816,17 @@ typedef struct ucc_coll_args {
     ucc_coll_callback_t             cb;
     double                          timeout; /*!< Timeout in seconds */
     struct {
-        uint64_t start;
-        int64_t  stride;
-        uint64_t size;
-    } active_set;
+        uint64_t start;  /*!< Team rank of the first member */
+        int64_t  stride; /*!< Distance between consecutive members, may be
+                              negative */
+        uint64_t size;   /*!< Number of members, at least 2 */
+    } active_set; /*!< Subset of the team taking part in the collective:
+                       team ranks start + i * stride for 0 <= i < size.
+                       Only the members call the collective. For rooted
+                       collectives root is a team rank and must be a
+                       member. Per rank data (blocks of the buffers,
+                       counts and displacements) follows the order of the
+                       members in the set. */
 } ucc_coll_args_t;
 
 /**
@@ -1842,6 +1859,40 @@ typedef struct ucc_coll_args {
 ucc_status_t ucc_collective_init(ucc_coll_args_t *coll_args,
                                  ucc_coll_req_h *request, ucc_team_h team);
 
+/**
+ *  @ingroup UCC_COLLECTIVES
+ *
+ *  @brief The routine to initialize a group of collective operations.
+ *
+ *  @param [in]    coll_args   Array of collective arguments descriptors
+ *  @param [in]    n_colls     Number of collectives in the group
+ *  @param [out]   request     Request handle representing the group
+ *  @param [in]    team        Team handle
+ *
+ *  @parblock
+ *
+ *  @b Description
+ *
+ *  @ref ucc_collective_group_init initializes "n_colls" independent
+ *  collective operations on the team and returns a single request for all
+ *  of them. The request is posted with @ref ucc_collective_post, which
+ *  starts all the collectives of the group at once, tested with @ref
+ *  ucc_collective_test, which returns UCC_OK once all of them are completed,
+ *  and released with @ref ucc_collective_finalize. All the participants must
+ *  provide the collectives in the same order. The completion callback of
+ *  an individual descriptor, if set, is invoked on completion of that
+ *  collective. The group is persistent if all its collectives are
+ *  persistent.
+ *
+ *  @endparblock
+ *
+ *  @return Error code as defined by @ref ucc_status_t
+ */
+ucc_status_t ucc_collective_group_init(ucc_coll_args_t *coll_args,
+                                       uint32_t n_colls,
+                                       ucc_coll_req_h *request,
+                                       ucc_team_h team);
+
 /**
  *  @ingroup UCC_COLLECTIVES
  *
@@ -1941,6 +1992,141 @@ static inline ucc_status_t ucc_collective_test(ucc_coll_req_h request)
  */
 ucc_status_t ucc_collective_finalize(ucc_coll_req_h request);
 
+/**
+ *  @ingroup UCC_COLLECTIVES_DT
+ */
+enum ucc_fusion_params_field {
+    UCC_FUSION_PARAM_FIELD_SIZE_THRESH = UCC_BIT(0),
+    UCC_FUSION_PARAM_FIELD_MEM_TYPE    = UCC_BIT(1)
+};
+
+/**
+ *  @ingroup UCC_COLLECTIVES_DT
+ *
+ *  @brief Structure representing the parameters of a fusion handle
+ *
+ *  @parblock
+ *
+ *  @b Description
+ *  @n @n
+ *  @ref ucc_fusion_params_t defines the operations accepted by a fusion handle
+ *  and how they are grouped. All the allreduce operations added to the handle
+ *  must use "datatype" and "op". The optional fields are selected by the
+ *  "mask" bit array defined by @ref ucc_fusion_params_field. "size_thresh" is
+ *  the size in bytes of the staging buffer: once the packed operations reach
+ *  it the fused collective is posted. "mem_type" is the memory type of the
+ *  staging buffer, host memory is used by default.
+ *
+ *  @endparblock
+ */
+typedef struct ucc_fusion_params {
+    uint64_t           mask;
+    ucc_datatype_t     datatype; /*!< Datatype of the fused allreduces */
+    ucc_reduction_op_t op;       /*!< Reduction operation of the fused
+                                      allreduces */
+    size_t             size_thresh; /*!< Staging buffer size in bytes */
+    ucc_memory_type_t  mem_type;    /*!< Staging buffer memory type */
+} ucc_fusion_params_t;
+
+/**
+ *  @ingroup UCC_COLLECTIVES
+ *
+ *  @brief The routine creates a fusion handle on a team.
+ *
+ *  @param [in]   team      Team handle
+ *  @param [in]   params    Fusion parameters
+ *  @param [out]  fusion    Fusion handle
+ *
+ *  @parblock
+ *
+ *  @b Description
+ *
+ *  @ref ucc_fusion_create creates a handle that packs many small allreduce
+ *  operations into a staging buffer and executes them as a single allreduce.
+ *  This is a local operation, however all the participants of the team must
+ *  create the handle with the same parameters and add the same sequence of
+ *  operations to it.
+ *
+ *  @endparblock
+ *
+ *  @return Error code as defined by @ref ucc_status_t
+ */
+ucc_status_t ucc_fusion_create(ucc_team_h team,
+                               const ucc_fusion_params_t *params,
+                               ucc_fusion_h *fusion);
+
+/**
+ *  @ingroup UCC_COLLECTIVES
+ *
+ *  @brief The routine adds an allreduce operation to a fusion handle.
+ *
+ *  @param [in]   fusion      Fusion handle
+ *  @param [in]   coll_args   Collective arguments descriptor of the allreduce
+ *  @param [out]  request     Request handle representing the operation
+ *
+ *  @parblock
+ *
+ *  @b Description
+ *
+ *  @ref ucc_fusion_add copies the input of the allreduce into the staging
+ *  buffer of the fusion handle and returns a request that is already posted:
+ *  it must not be passed to @ref ucc_collective_post. The fused collective is
+ *  posted when the staging buffer is full or on @ref ucc_fusion_flush. The
+ *  request completes once the result is copied to its destination buffer,
+ *  its status is queried with @ref ucc_collective_test and its resources are
+ *  released with @ref ucc_collective_finalize. The completion callback of
+ *  the collective arguments, if set, is invoked on completion. The fusion
+ *  handle is not thread safe.
+ *
+ *  @endparblock
+ *
+ *  @return Error code as defined by @ref ucc_status_t
+ */
+ucc_status_t ucc_fusion_add(ucc_fusion_h fusion, ucc_coll_args_t *coll_args,
+                            ucc_coll_req_h *request);
+
+/**
+ *  @ingroup UCC_COLLECTIVES
+ *
+ *  @brief The routine posts the operations accumulated in a fusion handle.
+ *
+ *  @param [in]   fusion      Fusion handle
+ *
+ *  @parblock
+ *
+ *  @b Description
+ *
+ *  @ref ucc_fusion_flush posts the fused collective for the operations added
+ *  since the last post, even if the staging buffer is not full. It has to be
+ *  called by all the participants at the same point of the sequence of
+ *  operations, typically at the end of a training step.
+ *
+ *  @endparblock
+ *
+ *  @return Error code as defined by @ref ucc_status_t
+ */
+ucc_status_t ucc_fusion_flush(ucc_fusion_h fusion);
+
+/**
+ *  @ingroup UCC_COLLECTIVES
+ *
+ *  @brief The routine releases a fusion handle.
+ *
+ *  @param [in]   fusion      Fusion handle
+ *
+ *  @parblock
+ *
+ *  @b Description
+ *
+ *  @ref ucc_fusion_destroy releases the resources of the fusion handle. All
+ *  the operations added to the handle must be completed.
+ *
+ *  @endparblock
+ *
+ *  @return Error code as defined by @ref ucc_status_t
+ */
+ucc_status_t ucc_fusion_destroy(ucc_fusion_h fusion);
+
 /**
  * @ingroup UCC_EVENT_DT
  *
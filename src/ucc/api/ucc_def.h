@@ -75,6 +75,16 @@ typedef struct ucc_coll_callback {
     void (*cb)(void *data, ucc_status_t status);
     void  *data;
 } ucc_coll_callback_t;
+/**
+ * @ingroup UCC_COLLECTIVES_DT
+ * @brief UCC fusion handle
+ *
+ * The UCC fusion handle is an opaque handle created by the library. It
+ * accumulates small allreduce operations on a team and executes them as a
+ * single collective over a shared staging buffer.
+ */
+typedef struct ucc_fusion*          ucc_fusion_h;
+
 /**
  * @ingroup UCC_COLLECTIVES
  * @brief UCC memory handle
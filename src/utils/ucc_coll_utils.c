@@ -256,14 +256,7 @@ ucc_ep_map_t ucc_ep_map_from_array_64(uint64_t **array, ucc_rank_t size,
 static inline int
 ucc_coll_args_is_rooted(const ucc_base_coll_args_t *bargs)
 {
-    ucc_coll_type_t ct = bargs->args.coll_type;
-    if (ct == UCC_COLL_TYPE_REDUCE || ct == UCC_COLL_TYPE_BCAST ||
-        ct == UCC_COLL_TYPE_GATHER || ct == UCC_COLL_TYPE_SCATTER ||
-        ct == UCC_COLL_TYPE_FANIN || ct == UCC_COLL_TYPE_FANOUT ||
-        ct == UCC_COLL_TYPE_GATHERV || ct == UCC_COLL_TYPE_SCATTERV) {
-        return 1;
-    }
-    return 0;
+    return !!(bargs->args.coll_type & UCC_COLL_TYPE_ROOTED);
 }
 
 void ucc_coll_str(const ucc_coll_task_t *task, char *str, size_t len)
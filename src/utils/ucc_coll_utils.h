@@ -67,6 +67,11 @@
 #define UCC_COLL_ARGS_ACTIVE_SET(_args)             \
     ((_args)->mask & UCC_COLL_ARGS_FIELD_ACTIVE_SET)
 
+#define UCC_COLL_TYPE_ROOTED                                                   \
+    (UCC_COLL_TYPE_BCAST | UCC_COLL_TYPE_REDUCE | UCC_COLL_TYPE_GATHER |       \
+     UCC_COLL_TYPE_GATHERV | UCC_COLL_TYPE_SCATTER | UCC_COLL_TYPE_SCATTERV |  \
+     UCC_COLL_TYPE_FANIN | UCC_COLL_TYPE_FANOUT)
+
 
 static inline size_t
 ucc_coll_args_get_count(const ucc_coll_args_t *args, const ucc_count_t *counts,
@@ -297,6 +302,19 @@ static inline ucc_ep_map_t ucc_active_set_to_ep_map(ucc_coll_args_t *args)
     return map;
 }
 
+/* Returns 1 if the team rank is a member of the active set of args */
+static inline int ucc_active_set_contains(const ucc_coll_args_t *args,
+                                          ucc_rank_t             rank)
+{
+    int64_t vrank = (int64_t)rank - (int64_t)args->active_set.start;
+
+    if (vrank % args->active_set.stride) {
+        return 0;
+    }
+    vrank /= args->active_set.stride;
+    return (vrank >= 0) && (vrank < (int64_t)args->active_set.size);
+}
+
 static inline size_t ucc_buffer_block_count_aligned(size_t total_count,
                                                     ucc_rank_t n_blocks,
                                                     ucc_rank_t block,
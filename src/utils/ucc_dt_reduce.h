@@ -20,7 +20,8 @@ ucc_dt_reduce_userdefined(void *src1, void *src2, void *dst, size_t n_vectors,
                                      .n_vectors = n_vectors,
                                      .count     = count,
                                      .stride    = stride,
-                                     .dt        = dt};
+                                     .dt        = dt,
+                                     .cb_ctx    = dt->ops.reduce.cb_ctx};
 
     return dt->ops.reduce.cb(&params);
 }
@@ -39,24 +40,27 @@ ucc_dt_reduce_strided(void *src1, void *src2, void *dst, size_t n_vectors,
     }
     if (!UCC_DT_IS_PREDEFINED(dt)) {
         ucc_assert(UCC_DT_HAS_REDUCE(dt));
-        *task = NULL;
-        return ucc_dt_reduce_userdefined(src1, src2, dst, n_vectors, count,
-                                         stride, ucc_dt_to_generic(dt));
-    } else {
-        eargs.flags                 = flags;
-        eargs.task_type             = UCC_EE_EXECUTOR_TASK_REDUCE_STRIDED;
-        eargs.reduce_strided.count  = count;
-        eargs.reduce_strided.dt     = dt;
-        eargs.reduce_strided.op     = args->op;
-        eargs.reduce_strided.n_src2 = n_vectors;
-        eargs.reduce_strided.dst    = dst;
-        eargs.reduce_strided.src1   = src1;
-        eargs.reduce_strided.src2   = src2;
-        eargs.reduce_strided.stride = stride;
-        eargs.reduce_strided.alpha  = alpha;
-
-        return ucc_ee_executor_task_post(exec, &eargs, task);
+        if (!exec || exec->ee_type != UCC_EE_CPU_THREAD) {
+            /* user callback can only access host memory */
+            *task = NULL;
+            return ucc_dt_reduce_userdefined(src1, src2, dst, n_vectors, count,
+                                             stride, ucc_dt_to_generic(dt));
+        }
     }
+
+    eargs.flags                 = flags;
+    eargs.task_type             = UCC_EE_EXECUTOR_TASK_REDUCE_STRIDED;
+    eargs.reduce_strided.count  = count;
+    eargs.reduce_strided.dt     = dt;
+    eargs.reduce_strided.op     = args->op;
+    eargs.reduce_strided.n_src2 = n_vectors;
+    eargs.reduce_strided.dst    = dst;
+    eargs.reduce_strided.src1   = src1;
+    eargs.reduce_strided.src2   = src2;
+    eargs.reduce_strided.stride = stride;
+    eargs.reduce_strided.alpha  = alpha;
+
+    return ucc_ee_executor_task_post(exec, &eargs, task);
 }
 
 static inline ucc_status_t ucc_dt_reduce(void *src1, void *src2, void *dst,
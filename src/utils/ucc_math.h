@@ -87,6 +87,72 @@ static inline void float32tobfloat16(float float_val, void *bfloat16_ptr)
 #endif
 }
 
+/* IEEE 754 binary16 conversions, the float to half one rounds to nearest
+   even and saturates to infinity */
+static inline float float16tofloat32(const void *float16_ptr)
+{
+    uint16_t h = *((uint16_t *)float16_ptr);
+    uint32_t mant = h & 0x3ff;
+    int32_t  exp  = (h >> 10) & 0x1f;
+    union {
+        float    f;
+        uint32_t u;
+    } res;
+
+    res.u = (uint32_t)(h & 0x8000) << 16;
+    if (exp == 0x1f) {
+        res.u |= 0x7f800000 | (mant << 13);
+    } else if (exp != 0) {
+        res.u |= ((uint32_t)(exp + 112) << 23) | (mant << 13);
+    } else if (mant != 0) {
+        exp = 1;
+        while (!(mant & 0x400)) {
+            mant <<= 1;
+            exp--;
+        }
+        res.u |= ((uint32_t)(exp + 112) << 23) | ((mant & 0x3ff) << 13);
+    }
+    return res.f;
+}
+
+static inline void float32tofloat16(float float_val, void *float16_ptr)
+{
+    union {
+        float    f;
+        uint32_t u;
+    } v = {.f = float_val};
+    uint32_t sign = (v.u >> 16) & 0x8000;
+    uint32_t mant = v.u & 0x7fffff;
+    int32_t  exp  = (int32_t)((v.u >> 23) & 0xff) - 112;
+    uint32_t h, rem, half, shift;
+
+    if (((v.u >> 23) & 0xff) == 0xff) {
+        h = 0x7c00 | (mant ? 0x200 : 0);
+    } else if (exp >= 0x1f) {
+        h = 0x7c00;
+    } else if (exp <= 0) {
+        if (exp < -10) {
+            h = 0;
+        } else {
+            mant |= 0x800000;
+            shift = 14 - exp;
+            h     = mant >> shift;
+            rem   = mant & ((1u << shift) - 1);
+            half  = 1u << (shift - 1);
+            if (rem > half || (rem == half && (h & 1))) {
+                h++;
+            }
+        }
+    } else {
+        h   = ((uint32_t)exp << 10) | (mant >> 13);
+        rem = mant & 0x1fff;
+        if (rem > 0x1000 || (rem == 0x1000 && (h & 1))) {
+            h++;
+        }
+    }
+    *((uint16_t *)float16_ptr) = (uint16_t)(sign | h);
+}
+
 #define ucc_padding(_n, _alignment)                                            \
     ( ((_alignment) - (_n) % (_alignment)) % (_alignment) )
 
@@ -178,3 +178,464 @@ INSTANTIATE_TEST_CASE_P(
                     OP_T(11, 3, 65530, HOST),
                     OP_T(7, 5, 123456, HOST)
                 })));
+
+class test_active_set_strided : public test_active_set
+{
+public:
+    UccCollCtxVec                      ctxs;
+    std::vector<std::vector<uint32_t>> counts;
+    int                                start, stride, size;
+    size_t                             count = 1031;
+
+    int member(int i)
+    {
+        return start + i * stride;
+    }
+
+    int root()
+    {
+        return member(size - 1);
+    }
+
+    /* block of set member i in the "v" collectives */
+    size_t v_count(int i)
+    {
+        return count + i;
+    }
+
+    size_t v_displ(int i)
+    {
+        return i * count + i * (i - 1) / 2;
+    }
+
+    /* alltoallv count from set member i to set member j, some of the
+       blocks are empty so that the sparse algorithm skips peers */
+    size_t a2av_count(int i, int j)
+    {
+        return ((i + j) % 3 == 0) ? 0 : count + i;
+    }
+
+    /* element k sent from team rank "from" to team rank "to" in
+       alltoall(v) */
+    int32_t a2a_value(int from, int to, size_t k)
+    {
+        return from + 16 * to + 256 * (int32_t)k;
+    }
+
+    /* element k of the sum over the set of the buffers "r + k" */
+    int32_t reduced(size_t k)
+    {
+        int32_t sum = 0;
+
+        for (int j = 0; j < size; j++) {
+            sum += member(j) + k;
+        }
+        return sum;
+    }
+
+    int32_t *alloc_buf(size_t n)
+    {
+        int32_t *buf = (int32_t *)ucc_malloc(
+            (n ? n : 1) * sizeof(int32_t), "buf");
+
+        EXPECT_NE(buf, nullptr);
+        return buf;
+    }
+
+    /* buffer of n elements "r + k", or unset elements if r is negative */
+    void init_info(ucc_coll_buffer_info_t *info, size_t n, int r)
+    {
+        int32_t *buf = alloc_buf(n);
+
+        for (size_t k = 0; k < n; k++) {
+            buf[k] = (r < 0) ? -1 : r + k;
+        }
+        info->buffer   = buf;
+        info->count    = n;
+        info->datatype = UCC_DT_INT32;
+        info->mem_type = UCC_MEMORY_TYPE_HOST;
+    }
+
+    void init_info_v(ucc_coll_buffer_info_v_t *info, size_t n,
+                     std::vector<uint32_t> c, std::vector<uint32_t> d)
+    {
+        info->buffer   = alloc_buf(n);
+        info->datatype = UCC_DT_INT32;
+        info->mem_type = UCC_MEMORY_TYPE_HOST;
+        counts.push_back(c);
+        info->counts = (ucc_count_t *)counts.back().data();
+        counts.push_back(d);
+        info->displacements = (ucc_aint_t *)counts.back().data();
+    }
+
+    void data_init(UccTeam_h team, ucc_coll_type_t coll_type, int _start,
+                   int _stride, int _size)
+    {
+        start  = _start;
+        stride = _stride;
+        size   = _size;
+        ctxs.assign(team->procs.size(), NULL);
+        for (int i = 0; i < size; i++) {
+            int                   r    = member(i);
+            gtest_ucc_coll_ctx_t *ctx  = (gtest_ucc_coll_ctx_t *)calloc(
+                1, sizeof(gtest_ucc_coll_ctx_t));
+            ucc_coll_args_t      *coll = (ucc_coll_args_t *)calloc(
+                1, sizeof(ucc_coll_args_t));
+            std::vector<uint32_t> sc(size), sd(size), rc(size), rd(size);
+            size_t                stotal = 0, rtotal = 0;
+            int32_t              *sbuf;
+
+            ctx->args               = coll;
+            coll->mask              = UCC_COLL_ARGS_FIELD_ACTIVE_SET;
+            coll->coll_type         = coll_type;
+            coll->active_set.start  = start;
+            coll->active_set.stride = stride;
+            coll->active_set.size   = size;
+            coll->root              = root();
+            coll->op                = UCC_OP_SUM;
+            ctxs[r]                 = ctx;
+            switch (coll_type) {
+            case UCC_COLL_TYPE_BARRIER:
+            case UCC_COLL_TYPE_FANIN:
+            case UCC_COLL_TYPE_FANOUT:
+                break;
+            case UCC_COLL_TYPE_BCAST:
+                init_info(&coll->src.info, count, (r == root()) ? r : -1);
+                break;
+            case UCC_COLL_TYPE_ALLGATHERV:
+                for (int j = 0; j < size; j++) {
+                    rc[j] = v_count(j);
+                    rd[j] = v_displ(j);
+                }
+                init_info(&coll->src.info, v_count(i), r);
+                init_info_v(&coll->dst.info_v, v_displ(size), rc, rd);
+                break;
+            case UCC_COLL_TYPE_REDUCE_SCATTERV:
+                for (int j = 0; j < size; j++) {
+                    rc[j] = v_count(j);
+                    rd[j] = v_displ(j);
+                }
+                init_info(&coll->src.info, v_displ(size), r);
+                init_info_v(&coll->dst.info_v, v_count(i), rc, rd);
+                break;
+            case UCC_COLL_TYPE_ALLTOALL:
+                init_info(&coll->src.info, count * size, -1);
+                init_info(&coll->dst.info, count * size, -1);
+                sbuf = (int32_t *)coll->src.info.buffer;
+                for (size_t k = 0; k < count * size; k++) {
+                    sbuf[k] = a2a_value(r, member(k / count), k % count);
+                }
+                break;
+            case UCC_COLL_TYPE_ALLTOALLV:
+                for (int j = 0; j < size; j++) {
+                    sc[j] = a2av_count(i, j);
+                    sd[j] = stotal;
+                    stotal += sc[j];
+                    rc[j] = a2av_count(j, i);
+                    rd[j] = rtotal;
+                    rtotal += rc[j];
+                }
+                init_info_v(&coll->src.info_v, stotal, sc, sd);
+                init_info_v(&coll->dst.info_v, rtotal, rc, rd);
+                sbuf = (int32_t *)coll->src.info_v.buffer;
+                for (int j = 0; j < size; j++) {
+                    for (size_t k = 0; k < sc[j]; k++) {
+                        sbuf[sd[j] + k] = a2a_value(r, member(j), k);
+                    }
+                }
+                break;
+            case UCC_COLL_TYPE_REDUCE_SCATTER:
+                init_info(&coll->src.info, count * size, r);
+                init_info(&coll->dst.info, count, -1);
+                break;
+            case UCC_COLL_TYPE_ALLGATHER:
+            case UCC_COLL_TYPE_GATHER:
+                init_info(&coll->src.info, count, r);
+                init_info(&coll->dst.info, count * size, -1);
+                break;
+            default:
+                init_info(&coll->src.info, count, r);
+                init_info(&coll->dst.info, count, -1);
+                break;
+            }
+        }
+    }
+
+    void data_fini()
+    {
+        for (auto ctx : ctxs) {
+            if (!ctx) {
+                continue;
+            }
+            ucc_free(ctx->args->src.info.buffer);
+            ucc_free(ctx->args->dst.info.buffer);
+            free(ctx->args);
+            free(ctx);
+        }
+        ctxs.clear();
+        counts.clear();
+    }
+
+    ~test_active_set_strided()
+    {
+        data_fini();
+    }
+
+    bool data_validate()
+    {
+        for (int i = 0; i < size; i++) {
+            ucc_coll_args_t *coll = ctxs[member(i)]->args;
+            int32_t         *rbuf = (int32_t *)coll->dst.info.buffer;
+            size_t           offset;
+
+            switch (coll->coll_type) {
+            case UCC_COLL_TYPE_BARRIER:
+            case UCC_COLL_TYPE_FANIN:
+            case UCC_COLL_TYPE_FANOUT:
+                break;
+            case UCC_COLL_TYPE_BCAST:
+                rbuf = (int32_t *)coll->src.info.buffer;
+                for (size_t k = 0; k < count; k++) {
+                    if (rbuf[k] != (int32_t)(root() + k)) {
+                        return false;
+                    }
+                }
+                break;
+            case UCC_COLL_TYPE_GATHER:
+                if (member(i) != root()) {
+                    break;
+                }
+                /* fall through */
+            case UCC_COLL_TYPE_ALLGATHER:
+                /* blocks are in the order of the set */
+                for (size_t k = 0; k < count * size; k++) {
+                    if (rbuf[k] != (int32_t)(member(k / count) + k % count)) {
+                        return false;
+                    }
+                }
+                break;
+            case UCC_COLL_TYPE_ALLGATHERV:
+                for (int j = 0; j < size; j++) {
+                    for (size_t k = 0; k < v_count(j); k++) {
+                        if (rbuf[v_displ(j) + k] != (int32_t)(member(j) + k)) {
+                            return false;
+                        }
+                    }
+                }
+                break;
+            case UCC_COLL_TYPE_ALLTOALL:
+                for (size_t k = 0; k < count * size; k++) {
+                    if (rbuf[k] != a2a_value(member(k / count), member(i),
+                                             k % count)) {
+                        return false;
+                    }
+                }
+                break;
+            case UCC_COLL_TYPE_ALLTOALLV:
+                offset = 0;
+                for (int j = 0; j < size; j++) {
+                    for (size_t k = 0; k < a2av_count(j, i); k++) {
+                        if (rbuf[offset + k] !=
+                            a2a_value(member(j), member(i), k)) {
+                            return false;
+                        }
+                    }
+                    offset += a2av_count(j, i);
+                }
+                break;
+            case UCC_COLL_TYPE_REDUCE_SCATTER:
+                for (size_t k = 0; k < count; k++) {
+                    if (rbuf[k] != reduced(i * count + k)) {
+                        return false;
+                    }
+                }
+                break;
+            case UCC_COLL_TYPE_REDUCE_SCATTERV:
+                for (size_t k = 0; k < v_count(i); k++) {
+                    if (rbuf[k] != reduced(v_displ(i) + k)) {
+                        return false;
+                    }
+                }
+                break;
+            case UCC_COLL_TYPE_REDUCE:
+                if (member(i) != root()) {
+                    break;
+                }
+                /* fall through */
+            default:
+                for (size_t k = 0; k < count; k++) {
+                    if (rbuf[k] != reduced(k)) {
+                        return false;
+                    }
+                }
+                break;
+            }
+        }
+        return true;
+    }
+
+    void run_set(UccTeam_h team, ucc_coll_type_t coll_type, int _start,
+                 int _stride, int _size)
+    {
+        data_init(team, coll_type, _start, _stride, _size);
+        {
+            UccReq req(team, ctxs);
+            req.start();
+            req.wait();
+        }
+        EXPECT_EQ(true, data_validate());
+        data_fini();
+    }
+
+    void run(ucc_coll_type_t coll_type, UccTeam_h team)
+    {
+        int tsize = (int)team->procs.size();
+
+        /* every other rank, a backward set with stride 3 and a set of
+           2 ranks */
+        run_set(team, coll_type, 1, 2, tsize / 2);
+        run_set(team, coll_type, tsize - 1, -3, (tsize - 1) / 3 + 1);
+        run_set(team, coll_type, 3, tsize - 5, 2);
+    }
+
+    void run(ucc_coll_type_t coll_type)
+    {
+        run(coll_type, UccJob::getStaticTeams().back());
+    }
+
+    /* runs on a job of its own with the TL/UCP algorithm forced by env */
+    void run_alg(ucc_coll_type_t coll_type, ucc_job_env_t env)
+    {
+        UccJob job(UccJob::staticUccJobSize, UccJob::UCC_JOB_CTX_GLOBAL,
+                   env);
+
+        run(coll_type, job.create_team(UccJob::staticUccJobSize));
+    }
+};
+
+UCC_TEST_F(test_active_set_strided, barrier)
+{
+    run(UCC_COLL_TYPE_BARRIER);
+}
+
+UCC_TEST_F(test_active_set_strided, allreduce)
+{
+    run(UCC_COLL_TYPE_ALLREDUCE);
+}
+
+UCC_TEST_F(test_active_set_strided, allgather)
+{
+    run(UCC_COLL_TYPE_ALLGATHER);
+}
+
+UCC_TEST_F(test_active_set_strided, reduce)
+{
+    run(UCC_COLL_TYPE_REDUCE);
+}
+
+UCC_TEST_F(test_active_set_strided, gather)
+{
+    run(UCC_COLL_TYPE_GATHER);
+}
+
+UCC_TEST_F(test_active_set_strided, fanin)
+{
+    run(UCC_COLL_TYPE_FANIN);
+}
+
+UCC_TEST_F(test_active_set_strided, fanout)
+{
+    run(UCC_COLL_TYPE_FANOUT);
+}
+
+UCC_TEST_F(test_active_set_strided, bcast)
+{
+    run(UCC_COLL_TYPE_BCAST);
+}
+
+UCC_TEST_F(test_active_set_strided, alltoall_pairwise)
+{
+    run_alg(UCC_COLL_TYPE_ALLTOALL,
+            {{"UCC_CL_BASIC_TUNE", "inf"},
+             {"UCC_TL_UCP_TUNE", "alltoall:@pairwise:inf"}});
+}
+
+UCC_TEST_F(test_active_set_strided, alltoallv_pairwise)
+{
+    run_alg(UCC_COLL_TYPE_ALLTOALLV,
+            {{"UCC_CL_BASIC_TUNE", "inf"},
+             {"UCC_TL_UCP_TUNE", "alltoallv:@pairwise:inf"}});
+}
+
+UCC_TEST_F(test_active_set_strided, alltoallv_sparse)
+{
+    run_alg(UCC_COLL_TYPE_ALLTOALLV,
+            {{"UCC_CL_BASIC_TUNE", "inf"},
+             {"UCC_TL_UCP_TUNE", "alltoallv:@sparse:inf"}});
+}
+
+UCC_TEST_F(test_active_set_strided, allgatherv_ring)
+{
+    run_alg(UCC_COLL_TYPE_ALLGATHERV,
+            {{"UCC_CL_BASIC_TUNE", "inf"},
+             {"UCC_TL_UCP_TUNE", "allgatherv:@ring:inf"}});
+}
+
+/* bidirectional ring is configured but active sets use a single ring */
+UCC_TEST_F(test_active_set_strided, reduce_scatter_ring)
+{
+    run_alg(UCC_COLL_TYPE_REDUCE_SCATTER,
+            {{"UCC_CL_BASIC_TUNE", "inf"},
+             {"UCC_TL_UCP_TUNE", "reduce_scatter:@ring:inf"},
+             {"UCC_TL_UCP_REDUCE_SCATTER_RING_BIDIRECTIONAL", "y"}});
+}
+
+UCC_TEST_F(test_active_set_strided, reduce_scatterv_ring)
+{
+    run_alg(UCC_COLL_TYPE_REDUCE_SCATTERV,
+            {{"UCC_CL_BASIC_TUNE", "inf"},
+             {"UCC_TL_UCP_TUNE", "reduce_scatterv:@ring:inf"},
+             {"UCC_TL_UCP_REDUCE_SCATTERV_RING_BIDIRECTIONAL", "y"}});
+}
+
+/* scatter is covered by the knomial scatter step of SAG bcast, TL/UCP has
+   no standalone scatter */
+UCC_TEST_F(test_active_set_strided, bcast_sag_large)
+{
+    count = 65536;
+    run_alg(UCC_COLL_TYPE_BCAST,
+            {{"UCC_CL_BASIC_TUNE", "inf"},
+             {"UCC_TL_UCP_TUNE", "bcast:@sag_knomial:inf"}});
+}
+
+/* message above the fragmentation threshold: the SRA pipeline of an
+   active set runs as a single fragment */
+UCC_TEST_F(test_active_set_strided, allreduce_sra_large)
+{
+    count = 65536;
+    run_alg(UCC_COLL_TYPE_ALLREDUCE,
+            {{"UCC_CL_BASIC_TUNE", "inf"},
+             {"UCC_TL_UCP_TUNE", "allreduce:@sra_knomial:inf"},
+             {"UCC_TL_UCP_ALLREDUCE_SRA_KN_FRAG_THRESH", "16k"},
+             {"UCC_TL_UCP_ALLREDUCE_SRA_KN_FRAG_SIZE", "16k"}});
+}
+
+/* message above the knomial fragment size: active sets do not use the
+   pipelined bcast and reduce, whose fragments would share the tag */
+UCC_TEST_F(test_active_set_strided, reduce_knomial_large)
+{
+    count = 16384;
+    run_alg(UCC_COLL_TYPE_REDUCE,
+            {{"UCC_CL_BASIC_TUNE", "inf"},
+             {"UCC_TL_UCP_TUNE", "reduce:@knomial:inf"},
+             {"UCC_TL_UCP_REDUCE_KN_FRAG_SIZE", "4k"}});
+}
+
+UCC_TEST_F(test_active_set_strided, bcast_knomial_large)
+{
+    count = 16384;
+    run_alg(UCC_COLL_TYPE_BCAST,
+            {{"UCC_CL_BASIC_TUNE", "inf"},
+             {"UCC_TL_UCP_TUNE", "bcast:@knomial:inf"},
+             {"UCC_TL_UCP_BCAST_KN_FRAG_SIZE", "4k"}});
+}
@@ -13,8 +13,10 @@ class test_allgather : public UccCollArgs, public ucc::test
 {
 public:
     void data_init(int nprocs, ucc_datatype_t dtype, size_t single_rank_count,
-                   UccCollCtxVec &ctxs, bool persistent)
+                   UccCollCtxVec &ctxs, UccTeam_h team, bool persistent)
     {
+        bool is_onesided = (NULL != team);
+
         ctxs.resize(nprocs);
         for (auto r = 0; r < nprocs; r++) {
             ucc_coll_args_t *coll = (ucc_coll_args_t*)
@@ -41,9 +43,18 @@ public:
             }
 
             ctxs[r]->rbuf_size = ucc_dt_size(dtype) * single_rank_count * nprocs;
-            UCC_CHECK(ucc_mc_alloc(&ctxs[r]->dst_mc_header, ctxs[r]->rbuf_size,
-                                   mem_type));
-            coll->dst.info.buffer = ctxs[r]->dst_mc_header->addr;
+            if (is_onesided) {
+                coll->mask  = UCC_COLL_ARGS_FIELD_FLAGS |
+                             UCC_COLL_ARGS_FIELD_GLOBAL_WORK_BUFFER;
+                coll->flags = UCC_COLL_ARGS_FLAG_MEM_MAPPED_BUFFERS;
+                coll->src.info.buffer    = team->procs[r].p->onesided_buf[0];
+                coll->dst.info.buffer    = team->procs[r].p->onesided_buf[1];
+                coll->global_work_buffer = team->procs[r].p->onesided_buf[2];
+            } else {
+                UCC_CHECK(ucc_mc_alloc(&ctxs[r]->dst_mc_header,
+                                       ctxs[r]->rbuf_size, mem_type));
+                coll->dst.info.buffer = ctxs[r]->dst_mc_header->addr;
+            }
             if (TEST_INPLACE == inplace) {
                 coll->mask  |= UCC_COLL_ARGS_FIELD_FLAGS;
                 coll->flags |= UCC_COLL_ARGS_FLAG_IN_PLACE;
@@ -53,10 +64,13 @@ public:
                     ctxs[r]->init_buf, ucc_dt_size(dtype) * single_rank_count,
                     mem_type, UCC_MEMORY_TYPE_HOST));
             } else {
-                UCC_CHECK(ucc_mc_alloc(&ctxs[r]->src_mc_header,
-                                       ucc_dt_size(dtype) * single_rank_count,
-                                       mem_type));
-                coll->src.info.buffer = ctxs[r]->src_mc_header->addr;
+                if (!is_onesided) {
+                    UCC_CHECK(ucc_mc_alloc(&ctxs[r]->src_mc_header,
+                                           ucc_dt_size(dtype) *
+                                               single_rank_count,
+                                           mem_type));
+                    coll->src.info.buffer = ctxs[r]->src_mc_header->addr;
+                }
                 UCC_CHECK(ucc_mc_memcpy(coll->src.info.buffer, ctxs[r]->init_buf,
                                         ucc_dt_size(dtype) * single_rank_count,
                                         mem_type, UCC_MEMORY_TYPE_HOST));
@@ -81,6 +95,15 @@ public:
         }
         ctxs.clear();
     }
+    void data_fini_onesided(UccCollCtxVec ctxs)
+    {
+        for (gtest_ucc_coll_ctx_t *ctx : ctxs) {
+            ucc_free(ctx->init_buf);
+            free(ctx->args);
+            free(ctx);
+        }
+        ctxs.clear();
+    }
     void reset(UccCollCtxVec ctxs)
     {
         for (auto r = 0; r < ctxs.size(); r++) {
@@ -155,7 +178,7 @@ UCC_TEST_P(test_allgather_0, single)
     set_inplace(inplace);
     SET_MEM_TYPE(mem_type);
 
-    data_init(size, dtype, count, ctxs, false);
+    data_init(size, dtype, count, ctxs, NULL, false);
     UccReq    req(team, ctxs);
     req.start();
     req.wait();
@@ -163,6 +186,47 @@ UCC_TEST_P(test_allgather_0, single)
     data_fini(ctxs);
 }
 
+UCC_TEST_P(test_allgather_0, single_onesided)
+{
+    const int                 team_id  = std::get<0>(GetParam());
+    const ucc_datatype_t      dtype    = std::get<1>(GetParam());
+    const ucc_memory_type_t   mem_type = std::get<2>(GetParam());
+    const int                 count    = std::get<3>(GetParam());
+    const gtest_ucc_inplace_t inplace  = std::get<4>(GetParam());
+    UccTeam_h        reference_team = UccJob::getStaticTeams()[team_id];
+    int              size           = reference_team->procs.size();
+    ucc_job_env_t    env = {{"UCC_TL_UCP_TUNE", "allgather:0-inf:@1"}};
+    bool             is_contig = true;
+    UccJob           job(size, UccJob::UCC_JOB_CTX_GLOBAL_ONESIDED, env);
+    UccTeam_h        team;
+    std::vector<int> reference_ranks;
+    UccCollCtxVec    ctxs;
+
+    if (UCC_MEMORY_TYPE_HOST != mem_type ||
+        ucc_dt_size(dtype) * count * size > UCC_TEST_MEM_SEGMENT_SIZE) {
+        GTEST_SKIP();
+    }
+    for (auto i = 0; i < reference_team->n_procs; i++) {
+        int rank = reference_team->procs[i].p->job_rank;
+        reference_ranks.push_back(rank);
+        if (is_contig && i > 0 &&
+            (rank - reference_ranks[i - 1] > 1 ||
+             reference_ranks[i - 1] - rank > 1)) {
+            is_contig = false;
+        }
+    }
+    team = job.create_team(reference_ranks, true, is_contig, true);
+    set_inplace(inplace);
+    SET_MEM_TYPE(mem_type);
+
+    data_init(size, dtype, count, ctxs, team, false);
+    UccReq req(team, ctxs);
+    req.start();
+    req.wait();
+    EXPECT_EQ(true, data_validate(ctxs));
+    data_fini_onesided(ctxs);
+}
+
 UCC_TEST_P(test_allgather_0, single_persistent)
 {
     const int                 team_id = std::get<0>(GetParam());
@@ -178,7 +242,7 @@ UCC_TEST_P(test_allgather_0, single_persistent)
     set_inplace(inplace);
     SET_MEM_TYPE(mem_type);
 
-    data_init(size, dtype, count, ctxs, true);
+    data_init(size, dtype, count, ctxs, NULL, true);
     UccReq req(team, ctxs);
 
     for (auto i = 0; i < n_calls; i++) {
@@ -225,7 +289,7 @@ UCC_TEST_P(test_allgather_1, multiple_host)
         this->set_inplace(inplace);
         SET_MEM_TYPE(mem_type);
 
-        data_init(size, dtype, count, ctx, false);
+        data_init(size, dtype, count, ctx, NULL, false);
         reqs.push_back(UccReq(team, ctx));
         ctxs.push_back(ctx);
     }
@@ -249,3 +313,65 @@ INSTANTIATE_TEST_CASE_P(
 #endif
         ::testing::Values(1,3,8192), // count
         ::testing::Values(TEST_INPLACE, TEST_NO_INPLACE)));
+
+/* CL/HIER split_rail allgather over 2 fake nodes of 4 processes */
+UCC_TEST_F(test_allgather, hier_split_rail)
+{
+    int           n_procs = 8;
+    ucc_job_env_t env     = {{"UCC_CLS", "basic,hier"},
+                             {"UCC_CL_HIER_TUNE", "allgather:@split_rail:inf"}};
+    UccJob        job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+
+    job.set_fake_topo(4);
+    UccTeam_h team = job.create_team(n_procs);
+
+    SET_MEM_TYPE(UCC_MEMORY_TYPE_HOST);
+    for (auto count : {1, 1023}) {
+        for (auto inplace : {TEST_NO_INPLACE, TEST_INPLACE}) {
+            UccCollCtxVec ctxs;
+
+            set_inplace(inplace);
+            data_init(n_procs, UCC_DT_INT8, count, ctxs, NULL, false);
+            UccReq req(team, ctxs);
+            req.start();
+            req.wait();
+            EXPECT_EQ(true, data_validate(ctxs));
+            data_fini(ctxs);
+        }
+    }
+}
+
+/* TL/UCP ring allgather over a team whose ranks alternate between 2 fake
+   nodes, so the topology aware ring differs from the team order. Runs
+   with RING_TOPO_ORDER forced on and off. */
+UCC_TEST_F(test_allgather, ring_topo_order)
+{
+    int              n_procs = 8;
+    std::vector<int> ranks   = {0, 4, 1, 5, 2, 6, 3, 7};
+
+    for (auto topo_order : {"y", "n"}) {
+        ucc_job_env_t env = {{"UCC_CLS", "basic,hier"},
+                             {"UCC_CL_BASIC_TUNE", "inf"},
+                             {"UCC_TL_UCP_TUNE", "allgather:@ring:inf"},
+                             {"UCC_TL_UCP_RING_TOPO_ORDER", topo_order}};
+        UccJob        job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+
+        job.set_fake_topo(4);
+        UccTeam_h team = job.create_team(ranks);
+
+        SET_MEM_TYPE(UCC_MEMORY_TYPE_HOST);
+        for (auto count : {1, 1023}) {
+            for (auto inplace : {TEST_NO_INPLACE, TEST_INPLACE}) {
+                UccCollCtxVec ctxs;
+
+                set_inplace(inplace);
+                data_init(n_procs, UCC_DT_INT8, count, ctxs, NULL, false);
+                UccReq req(team, ctxs);
+                req.start();
+                req.wait();
+                EXPECT_EQ(true, data_validate(ctxs));
+                data_fini(ctxs);
+            }
+        }
+    }
+}
@@ -6,6 +6,9 @@
 #include "core/test_mc_reduce.h"
 #include "common/test_ucc.h"
 #include "utils/ucc_math.h"
+extern "C" {
+#include "core/ucc_team.h"
+}
 
 #include <array>
 
@@ -301,6 +304,171 @@ TYPED_TEST(test_allreduce_alg, sra_knomial_pipelined) {
     }
 }
 
+/* Knomial allreduce over the AM eager path: the messages of count 8 are
+   below AM_EAGER_THRESH, count 1024 goes over tagged send/recv. Two teams
+   run concurrently on a context with 2 workers, so the AM messages of both
+   teams share worker 0 and are matched by the queues of each team. */
+TYPED_TEST(test_allreduce_alg, knomial_am_eager) {
+    int                        n_procs = 7;
+    ucc_job_env_t              env     = {{"UCC_CL_BASIC_TUNE", "inf"},
+                                          {"UCC_TL_UCP_TUNE",
+                                           "allreduce:@knomial:inf"},
+                                          {"UCC_TL_UCP_N_WORKERS", "2"},
+                                          {"UCC_TL_UCP_AM_EAGER_THRESH",
+                                           "256"}};
+    UccJob                     job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+    std::vector<UccTeam_h>     teams = {job.create_team(n_procs),
+                                        job.create_team(n_procs)};
+    int                        repeat = 3;
+    std::vector<UccReq>        reqs;
+    std::vector<UccCollCtxVec> ctxs;
+
+    SET_MEM_TYPE(UCC_MEMORY_TYPE_HOST);
+    for (auto count : {8, 1024}) {
+        for (auto inplace : {TEST_NO_INPLACE, TEST_INPLACE}) {
+            this->set_inplace(inplace);
+            for (auto &team : teams) {
+                UccCollCtxVec ctx;
+
+                this->data_init(n_procs, TypeParam::dt, count, ctx, true);
+                reqs.push_back(UccReq(team, ctx));
+                ctxs.push_back(ctx);
+            }
+            for (auto i = 0; i < repeat; i++) {
+                UccReq::startall(reqs);
+                UccReq::waitall(reqs);
+                for (auto &ctx : ctxs) {
+                    EXPECT_EQ(true, this->data_validate(ctx));
+                    this->reset(ctx);
+                }
+            }
+            for (auto &ctx : ctxs) {
+                this->data_fini(ctx);
+            }
+            reqs.clear();
+            ctxs.clear();
+        }
+    }
+}
+
+/* CL/HIER rab allreduce over 2 fake nodes with 2 sockets each. With
+   NODE_SPLIT socket (numa) the reduction goes up SOCKET (NUMA), SOCKET
+   (NUMA) leaders and NODE_LEADERS levels and the result comes back down. */
+TYPED_TEST(test_allreduce_alg, hier_node_split) {
+    int           n_procs = 8;
+    int           repeat  = 3;
+    UccCollCtxVec ctxs;
+
+    for (auto split : {"none", "socket", "numa"}) {
+        ucc_job_env_t env = {{"UCC_CLS", "basic,hier"},
+                             {"UCC_CL_HIER_TUNE", "allreduce:@rab:inf"},
+                             {"UCC_CL_HIER_NODE_SPLIT", split}};
+        UccJob        job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+
+        job.set_fake_topo(4, 2);
+        UccTeam_h team = job.create_team(n_procs);
+        ASSERT_EQ((ucc_rank_t)2, ucc_topo_nnodes(team->procs[0].team->topo));
+        ASSERT_EQ(2, ucc_topo_n_sockets(team->procs[0].team->topo));
+
+        for (auto count : {8, 65536}) {
+            for (auto inplace : {TEST_NO_INPLACE, TEST_INPLACE}) {
+                SET_MEM_TYPE(UCC_MEMORY_TYPE_HOST);
+                this->set_inplace(inplace);
+                this->data_init(n_procs, TypeParam::dt, count, ctxs, true);
+                UccReq req(team, ctxs);
+
+                for (auto i = 0; i < repeat; i++) {
+                    req.start();
+                    req.wait();
+                    EXPECT_EQ(true, this->data_validate(ctxs));
+                    this->reset(ctxs);
+                }
+                this->data_fini(ctxs);
+            }
+        }
+    }
+}
+
+/* CL/HIER multi-leader allreduce over 2 fake nodes of 4 processes: the
+   buffer is split into slices reduced through the rails of different
+   leaders. 3 leaders do not divide 8 elements evenly. */
+TYPED_TEST(test_allreduce_alg, hier_multi_leader) {
+    int           n_procs = 8;
+    int           repeat  = 3;
+    UccCollCtxVec ctxs;
+
+    for (auto n_leaders : {"2", "3"}) {
+        for (auto rotate : {"n", "y"}) {
+            ucc_job_env_t env = {{"UCC_CLS", "basic,hier"},
+                                 {"UCC_CL_HIER_TUNE", "allreduce:@rab:inf"},
+                                 {"UCC_CL_HIER_N_LEADERS", n_leaders},
+                                 {"UCC_CL_HIER_LEADERS_ROTATE", rotate}};
+            UccJob        job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+
+            job.set_fake_topo(4);
+            UccTeam_h team = job.create_team(n_procs);
+
+            for (auto count : {1, 8, 65536}) {
+                for (auto inplace : {TEST_NO_INPLACE, TEST_INPLACE}) {
+                    SET_MEM_TYPE(UCC_MEMORY_TYPE_HOST);
+                    this->set_inplace(inplace);
+                    this->data_init(n_procs, TypeParam::dt, count, ctxs, true);
+                    UccReq req(team, ctxs);
+
+                    for (auto i = 0; i < repeat; i++) {
+                        req.start();
+                        req.wait();
+                        EXPECT_EQ(true, this->data_validate(ctxs));
+                        this->reset(ctxs);
+                    }
+                    this->data_fini(ctxs);
+                }
+            }
+        }
+    }
+}
+
+/* CL/HIER split_rail allreduce over 2 fake nodes of 4 processes with the
+   intra-node phases on the node shm segment. 65536 elements are split
+   into fragments of 16k bytes, more than the pipeline depth, so the shm
+   seq numbers of all the fragments are used on every start. */
+TYPED_TEST(test_allreduce_alg, hier_split_rail_node_shm) {
+    int           n_procs = 8;
+    int           repeat  = 3;
+    UccCollCtxVec ctxs;
+
+    for (auto order : {"ordered", "parallel"}) {
+        ucc_job_env_t env = {
+            {"UCC_CLS", "basic,hier"},
+            {"UCC_CL_HIER_TUNE", "allreduce:@split_rail:inf"},
+            {"UCC_CL_HIER_NODE_SHM_SIZE", "64k"},
+            {"UCC_CL_HIER_ALLREDUCE_SPLIT_RAIL_FRAG_THRESH", "16k"},
+            {"UCC_CL_HIER_ALLREDUCE_SPLIT_RAIL_FRAG_SIZE", "16k"},
+            {"UCC_CL_HIER_ALLREDUCE_SPLIT_RAIL_PIPELINE_ORDER", order}};
+        UccJob        job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+
+        job.set_fake_topo(4);
+        UccTeam_h team = job.create_team(n_procs);
+
+        for (auto count : {8, 65536}) {
+            for (auto inplace : {TEST_NO_INPLACE, TEST_INPLACE}) {
+                SET_MEM_TYPE(UCC_MEMORY_TYPE_HOST);
+                this->set_inplace(inplace);
+                this->data_init(n_procs, TypeParam::dt, count, ctxs, true);
+                UccReq req(team, ctxs);
+
+                for (auto i = 0; i < repeat; i++) {
+                    req.start();
+                    req.wait();
+                    EXPECT_EQ(true, this->data_validate(ctxs));
+                    this->reset(ctxs);
+                }
+                this->data_fini(ctxs);
+            }
+        }
+    }
+}
+
 template <typename T>
 class test_allreduce_avg_order : public test_allreduce<T> {
 };
@@ -347,3 +515,187 @@ TYPED_TEST(test_allreduce_avg_order, avg_post_op)
         }
     }
 }
+
+template <typename T>
+class test_allreduce_hier_avg : public test_allreduce<T> {
+};
+
+using test_allreduce_hier_avg_type =
+    ::testing::Types<TypeOpPair<UCC_DT_FLOAT32, avg>,
+                     TypeOpPair<UCC_DT_FLOAT64, avg>>;
+
+TYPED_TEST_CASE(test_allreduce_hier_avg, test_allreduce_hier_avg_type);
+
+/* CL/HIER computes AVG as SUM over the levels scaled once by 1/team_size.
+   12 processes on 3 or 2 fake nodes, so the scale task runs on every rank
+   with a non power of 2 divisor. */
+TYPED_TEST(test_allreduce_hier_avg, sum_and_scale)
+{
+    int           n_procs = 12;
+    int           repeat  = 3;
+    UccCollCtxVec ctxs;
+
+    for (auto alg : {"rab", "split_rail"}) {
+        for (auto ppn : {4, 6}) {
+            std::string   tune = std::string("allreduce:@") + alg + ":inf";
+            ucc_job_env_t env  = {{"UCC_CLS", "basic,hier"},
+                                  {"UCC_CL_HIER_TUNE", tune}};
+            UccJob        job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+
+            job.set_fake_topo(ppn);
+            UccTeam_h team = job.create_team(n_procs);
+            ASSERT_EQ((ucc_rank_t)(n_procs / ppn),
+                      ucc_topo_nnodes(team->procs[0].team->topo));
+
+            for (auto count : {8, 65536, 123567}) {
+                for (auto inplace : {TEST_NO_INPLACE, TEST_INPLACE}) {
+                    SET_MEM_TYPE(UCC_MEMORY_TYPE_HOST);
+                    this->set_inplace(inplace);
+                    this->data_init(n_procs, TypeParam::dt, count, ctxs, true);
+                    UccReq req(team, ctxs);
+
+                    for (auto i = 0; i < repeat; i++) {
+                        req.start();
+                        req.wait();
+                        EXPECT_EQ(true, this->data_validate(ctxs));
+                        this->reset(ctxs);
+                    }
+                    this->data_fini(ctxs);
+                }
+            }
+        }
+    }
+}
+
+template <typename T>
+class test_allreduce_shm : public test_allreduce<T> {
+};
+
+using test_allreduce_shm_type =
+    ::testing::Types<TypeOpPair<UCC_DT_INT32, sum>,
+                     TypeOpPair<UCC_DT_FLOAT32, avg>>;
+
+TYPED_TEST_CASE(test_allreduce_shm, test_allreduce_shm_type);
+
+/* TL/SHM handles small host allreduce on single node teams. Radix 2 gives
+   a binary tree, radix 16 a flat tree over 15 ranks. Repeated start of
+   the same request reuses the collective slot of the segment. */
+TYPED_TEST(test_allreduce_shm, tree_radix)
+{
+    int           n_procs = 15;
+    int           repeat  = 3;
+    UccCollCtxVec ctxs;
+
+    for (auto radix : {"2", "16"}) {
+        ucc_job_env_t env  = {{"UCC_TL_SHM_TREE_RADIX", radix}};
+        UccJob        job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+        UccTeam_h     team = job.create_team(n_procs);
+
+        for (auto count : {1, 8, 1000}) {
+            for (auto inplace : {TEST_NO_INPLACE, TEST_INPLACE}) {
+                SET_MEM_TYPE(UCC_MEMORY_TYPE_HOST);
+                this->set_inplace(inplace);
+                this->data_init(n_procs, TypeParam::dt, count, ctxs, true);
+                UccReq req(team, ctxs);
+
+                for (auto i = 0; i < repeat; i++) {
+                    req.start();
+                    req.wait();
+                    EXPECT_EQ(true, this->data_validate(ctxs));
+                    this->reset(ctxs);
+                }
+                this->data_fini(ctxs);
+            }
+        }
+    }
+}
+
+template <typename T>
+class test_allreduce_compress : public test_allreduce<T> {
+};
+
+using test_allreduce_compress_type =
+    ::testing::Types<TypeOpPair<UCC_DT_FLOAT32, sum>>;
+
+TYPED_TEST_CASE(test_allreduce_compress, test_allreduce_compress_type);
+
+/* SRA knomial allreduce with the 16 bit wire format. The init values are
+   small integers, the partial sums of 15 ranks are exactly representable
+   in both bf16 and fp16 so the result is compared exactly. */
+TYPED_TEST(test_allreduce_compress, sra_knomial_wire)
+{
+    int           n_procs = 15;
+    int           repeat  = 3;
+    UccCollCtxVec ctxs;
+
+    for (auto compress : {"bf16", "fp16"}) {
+        ucc_job_env_t env  = {{"UCC_CL_BASIC_TUNE", "inf"},
+                              {"UCC_TL_UCP_TUNE", "allreduce:@sra_knomial:inf"},
+                              {"UCC_TL_UCP_ALLREDUCE_SRA_KN_COMPRESS", compress},
+                              {"UCC_TL_UCP_ALLREDUCE_SRA_KN_FRAG_THRESH",
+                               "1024"},
+                              {"UCC_TL_UCP_ALLREDUCE_SRA_KN_N_FRAGS", "5"}};
+        UccJob        job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+        UccTeam_h     team = job.create_team(n_procs);
+
+        for (auto count : {8, 65536, 123567}) {
+            for (auto inplace : {TEST_NO_INPLACE, TEST_INPLACE}) {
+                SET_MEM_TYPE(UCC_MEMORY_TYPE_HOST);
+                this->set_inplace(inplace);
+                this->data_init(n_procs, TypeParam::dt, count, ctxs, true);
+                UccReq req(team, ctxs);
+
+                for (auto i = 0; i < repeat; i++) {
+                    req.start();
+                    req.wait();
+                    EXPECT_EQ(true, this->data_validate(ctxs));
+                    this->reset(ctxs);
+                }
+                this->data_fini(ctxs);
+            }
+        }
+    }
+}
+
+/* The knomial reduce-scatter is the first half of SRA knomial allreduce,
+   the chunk size splits the segments of every step into chunks whose
+   reduction overlaps with the transfer of the next one. Chunks of 1000
+   bytes do not divide the segments evenly. */
+class test_allreduce_rs_kn_chunk
+    : public ucc::test,
+      public ::testing::WithParamInterface<std::string> {
+};
+
+UCC_TEST_P(test_allreduce_rs_kn_chunk, sra_knomial)
+{
+    test_allreduce<TypeOpPair<UCC_DT_INT32, sum>> ar_test;
+    int                                           n_procs = 7;
+    std::string                                   chunk   = GetParam();
+    ucc_job_env_t env = {{"UCC_CL_BASIC_TUNE", "inf"},
+                         {"UCC_TL_UCP_TUNE", "allreduce:@sra_knomial:inf"},
+                         {"UCC_TL_UCP_REDUCE_SCATTER_KN_CHUNK_SIZE", chunk}};
+    UccJob        job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+    UccTeam_h     team   = job.create_team(n_procs);
+    int           repeat = 3;
+    UccCollCtxVec ctxs;
+
+    for (auto count : {100, 65536, 123567}) {
+        for (auto inplace : {TEST_NO_INPLACE, TEST_INPLACE}) {
+            ar_test.set_mem_type(UCC_MEMORY_TYPE_HOST);
+            ar_test.set_inplace(inplace);
+            ar_test.data_init(n_procs, UCC_DT_INT32, count, ctxs, true);
+            UccReq req(team, ctxs);
+
+            for (auto i = 0; i < repeat; i++) {
+                req.start();
+                req.wait();
+                EXPECT_EQ(true, ar_test.data_validate(ctxs));
+                ar_test.reset(ctxs);
+            }
+            ar_test.data_fini(ctxs);
+        }
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(, test_allreduce_rs_kn_chunk,
+                        ::testing::Values("64", "1000", "16k", "inf"));
@@ -5,6 +5,9 @@
 
 #include "common/test_ucc.h"
 #include "utils/ucc_math.h"
+extern "C" {
+#include "core/ucc_team.h"
+}
 
 using Param_0 = std::tuple<int, ucc_datatype_t, ucc_memory_type_t, gtest_ucc_inplace_t, int>;
 using Param_1 = std::tuple<ucc_datatype_t, ucc_memory_type_t, gtest_ucc_inplace_t, int>;
@@ -328,3 +331,113 @@ INSTANTIATE_TEST_CASE_P(
 #endif
         ::testing::Values(/*TEST_INPLACE,*/ TEST_NO_INPLACE),
         ::testing::Values(1,3,8192))); // count
+
+/* TL/UCP with several workers per context: the two teams use different
+   workers, and with count 4096 the pairwise messages are larger than
+   STRIPE_THRESH, so they are split across all the workers. */
+UCC_TEST_F(test_alltoall, tl_ucp_multiple_workers)
+{
+    int                        n_procs = 4;
+    ucc_job_env_t              env     = {{"UCC_TL_UCP_N_WORKERS", "3"},
+                                          {"UCC_TL_UCP_STRIPE_THRESH", "1k"}};
+    UccJob                     job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+    std::vector<UccTeam_h>     teams = {job.create_team(n_procs),
+                                        job.create_team(n_procs)};
+    std::vector<UccReq>        reqs;
+    std::vector<UccCollCtxVec> ctxs;
+
+    this->set_inplace(TEST_NO_INPLACE);
+    SET_MEM_TYPE(UCC_MEMORY_TYPE_HOST);
+    for (auto count : {8, 4096}) {
+        for (auto &team : teams) {
+            UccCollCtxVec ctx;
+
+            data_init(n_procs, UCC_DT_INT32, count, ctx, false);
+            reqs.push_back(UccReq(team, ctx));
+            ctxs.push_back(ctx);
+        }
+        UccReq::startall(reqs);
+        UccReq::waitall(reqs);
+        for (auto ctx : ctxs) {
+            EXPECT_EQ(true, data_validate(ctx));
+            data_fini(ctx);
+        }
+        reqs.clear();
+        ctxs.clear();
+    }
+}
+
+/* CL/HIER node_split alltoall over 3 fake nodes of 4 processes. The
+   alltoallv counts kept on the team are rebuilt in place when the count
+   changes, including while a request initialized with the previous count
+   is still outstanding. */
+UCC_TEST_F(test_alltoall, hier_node_split_counts)
+{
+    int                        n_procs = 12;
+    ucc_job_env_t              env     = {
+        {"UCC_CLS", "basic,hier"},
+        {"UCC_CL_HIER_TUNE", "alltoall:@node_split:inf"}};
+    UccJob                     job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+    std::vector<UccReq>        reqs;
+    std::vector<UccCollCtxVec> ctxs;
+
+    this->set_inplace(TEST_NO_INPLACE);
+    SET_MEM_TYPE(UCC_MEMORY_TYPE_HOST);
+    job.set_fake_topo(4);
+    UccTeam_h team = job.create_team(n_procs);
+    ASSERT_EQ((ucc_rank_t)3, ucc_topo_nnodes(team->procs[0].team->topo));
+
+    for (auto count : {1, 3, 3, 1, 8}) {
+        UccCollCtxVec ctx;
+
+        data_init(n_procs, UCC_DT_INT32, count, ctx, false);
+        UccReq req(team, ctx);
+        req.start();
+        req.wait();
+        EXPECT_EQ(true, data_validate(ctx));
+        data_fini(ctx);
+    }
+
+    for (auto count : {2, 5, 2, 7}) {
+        UccCollCtxVec ctx;
+
+        data_init(n_procs, UCC_DT_INT32, count, ctx, false);
+        reqs.push_back(UccReq(team, ctx));
+        ctxs.push_back(ctx);
+    }
+    UccReq::startall(reqs);
+    UccReq::waitall(reqs);
+    for (auto ctx : ctxs) {
+        EXPECT_EQ(true, data_validate(ctx));
+        data_fini(ctx);
+    }
+}
+
+/* Pairwise alltoall with the adaptive window and each peer schedule:
+   the random schedule picks a new order of the steps on every call. */
+UCC_TEST_F(test_alltoall, tl_ucp_pairwise_schedule)
+{
+    int n_procs = 7;
+
+    for (auto schedule : {"rotated", "random", "node"}) {
+        ucc_job_env_t env = {{"UCC_TL_UCP_ALLTOALL_PAIRWISE_ADAPTIVE", "y"},
+                             {"UCC_TL_UCP_ALLTOALL_PAIRWISE_NUM_POSTS", "2"},
+                             {"UCC_TL_UCP_ALLTOALL_PAIRWISE_SCHEDULE",
+                              schedule}};
+        UccJob        job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+        UccTeam_h     team = job.create_team(n_procs);
+
+        this->set_inplace(TEST_NO_INPLACE);
+        SET_MEM_TYPE(UCC_MEMORY_TYPE_HOST);
+        for (auto i = 0; i < 3; i++) {
+            UccCollCtxVec ctxs;
+
+            data_init(n_procs, UCC_DT_INT32, 16, ctxs, false);
+            UccReq req(team, ctxs);
+            req.start();
+            req.wait();
+            EXPECT_EQ(true, data_validate(ctxs));
+            data_fini(ctxs);
+        }
+    }
+}
@@ -5,6 +5,9 @@
 
 #include "common/test_ucc.h"
 #include "utils/ucc_math.h"
+extern "C" {
+#include "core/ucc_team.h"
+}
 
 using Param_0 = std::tuple<int, ucc_memory_type_t, gtest_ucc_inplace_t, ucc_datatype_t>;
 using Param_1 = std::tuple<ucc_memory_type_t, gtest_ucc_inplace_t, ucc_datatype_t>;
@@ -348,3 +351,327 @@ INSTANTIATE_TEST_CASE_P(
 #endif
             ::testing::Values(/*TEST_INPLACE,*/ TEST_NO_INPLACE),
             PREDEFINED_DTYPES)); // dtype
+
+class test_alltoallv_hier : public test_alltoallv<uint64_t> {
+public:
+    /* Exchanges the content of the count and displacement arrays of a and
+       b together with their buffers: the arrays keep their addresses, but
+       each of them describes the data of the other one afterwards. */
+    void swap_data(UccCollCtxVec a, UccCollCtxVec b)
+    {
+        size_t len = sizeof(uint64_t) * a.size();
+
+        for (auto r = 0; r < a.size(); r++) {
+            ucc_coll_args_t     *ca = a[r]->args;
+            ucc_coll_args_t     *cb = b[r]->args;
+            std::vector<uint8_t> tmp(len);
+            void *arrays[2][4] = {
+                {ca->src.info_v.counts, ca->src.info_v.displacements,
+                 ca->dst.info_v.counts, ca->dst.info_v.displacements},
+                {cb->src.info_v.counts, cb->src.info_v.displacements,
+                 cb->dst.info_v.counts, cb->dst.info_v.displacements}};
+
+            for (auto i = 0; i < 4; i++) {
+                memcpy(tmp.data(), arrays[0][i], len);
+                memcpy(arrays[0][i], arrays[1][i], len);
+                memcpy(arrays[1][i], tmp.data(), len);
+            }
+            std::swap(ca->src.info_v.buffer, cb->src.info_v.buffer);
+            std::swap(ca->dst.info_v.buffer, cb->dst.info_v.buffer);
+            std::swap(a[r]->src_mc_header, b[r]->src_mc_header);
+            std::swap(a[r]->dst_mc_header, b[r]->dst_mc_header);
+            std::swap(a[r]->init_buf, b[r]->init_buf);
+            std::swap(a[r]->rbuf_size, b[r]->rbuf_size);
+        }
+    }
+};
+
+/* CL/HIER node_aggr alltoallv over 3 fake nodes of 4 processes. With 2
+   leaders each leader serves a different set of node pairs. Two requests
+   are initialized before they are started, the leader exchanges are set
+   up on the first start of each one. */
+UCC_TEST_F(test_alltoallv_hier, node_aggr)
+{
+    int n_procs = 12;
+
+    coll_mask  = UCC_COLL_ARGS_FIELD_FLAGS;
+    coll_flags = UCC_COLL_ARGS_FLAG_COUNT_64BIT |
+                 UCC_COLL_ARGS_FLAG_DISPLACEMENTS_64BIT;
+    set_inplace(TEST_NO_INPLACE);
+    SET_MEM_TYPE(UCC_MEMORY_TYPE_HOST);
+
+    for (auto n_leaders : {"1", "2"}) {
+        ucc_job_env_t env = {
+            {"UCC_CLS", "basic,hier"},
+            {"UCC_CL_HIER_TUNE", "alltoallv:@node_aggr:inf"},
+            {"UCC_CL_HIER_ALLTOALLV_NODE_AGGR_N_LEADERS", n_leaders}};
+        UccJob        job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+        UccCollCtxVec ctxs[2];
+
+        job.set_fake_topo(4);
+        UccTeam_h team = job.create_team(n_procs);
+        ASSERT_EQ((ucc_rank_t)3, ucc_topo_nnodes(team->procs[0].team->topo));
+
+        data_init(n_procs, UCC_DT_INT32, 1, ctxs[0], true);
+        data_init(n_procs, UCC_DT_INT32, 3, ctxs[1], true);
+        std::vector<UccReq> reqs = {UccReq(team, ctxs[0]),
+                                    UccReq(team, ctxs[1])};
+
+        for (auto i = 0; i < 2; i++) {
+            for (auto &req : reqs) {
+                req.start();
+                req.wait();
+            }
+            for (auto &ctx : ctxs) {
+                EXPECT_EQ(true, data_validate(ctx));
+                reset(ctx);
+            }
+        }
+        for (auto &ctx : ctxs) {
+            data_fini(ctx);
+        }
+    }
+}
+
+/* CL/HIER node_split alltoallv over 3 fake nodes of 4 processes, the
+   NODE/FULL split of the counts is cached on the team:
+   - the same count arrays are used again: the cached split is reused;
+   - the arrays are changed in place: the address matches a cached entry
+     but the content does not, the split is computed again;
+   - more requests with different counts are outstanding than there are
+     cache entries: the last ones use their own copy of the split. */
+UCC_TEST_F(test_alltoallv_hier, node_split_counts_cache)
+{
+    int                        n_procs = 12;
+    int                        n_reqs  = 6;
+    ucc_job_env_t              env     = {
+        {"UCC_CLS", "basic,hier"},
+        {"UCC_CL_HIER_TUNE", "alltoallv:@node_split:inf"}};
+    UccJob                     job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+    UccCollCtxVec              ctxs[2];
+    std::vector<UccCollCtxVec> busy(n_reqs);
+    std::vector<UccReq>        reqs;
+
+    coll_mask  = UCC_COLL_ARGS_FIELD_FLAGS;
+    coll_flags = UCC_COLL_ARGS_FLAG_COUNT_64BIT |
+                 UCC_COLL_ARGS_FLAG_DISPLACEMENTS_64BIT;
+    set_inplace(TEST_NO_INPLACE);
+    SET_MEM_TYPE(UCC_MEMORY_TYPE_HOST);
+
+    job.set_fake_topo(4);
+    UccTeam_h team = job.create_team(n_procs);
+    ASSERT_EQ((ucc_rank_t)3, ucc_topo_nnodes(team->procs[0].team->topo));
+
+    data_init(n_procs, UCC_DT_INT32, 1, ctxs[0]);
+    data_init(n_procs, UCC_DT_INT32, 2, ctxs[1]);
+    for (auto i = 0; i < 3; i++) {
+        UccReq req(team, ctxs[0]);
+        req.start();
+        req.wait();
+        EXPECT_EQ(true, data_validate(ctxs[0]));
+        reset(ctxs[0]);
+    }
+
+    for (auto i = 0; i < 2; i++) {
+        swap_data(ctxs[0], ctxs[1]);
+        for (auto &ctx : ctxs) {
+            UccReq req(team, ctx);
+            req.start();
+            req.wait();
+            EXPECT_EQ(true, data_validate(ctx));
+            reset(ctx);
+        }
+    }
+
+    for (auto i = 0; i < n_reqs; i++) {
+        data_init(n_procs, UCC_DT_INT32, i + 1, busy[i], true);
+        reqs.push_back(UccReq(team, busy[i]));
+    }
+    for (auto i = 0; i < 2; i++) {
+        UccReq::startall(reqs);
+        UccReq::waitall(reqs);
+        for (auto &ctx : busy) {
+            EXPECT_EQ(true, data_validate(ctx));
+            reset(ctx);
+        }
+    }
+    reqs.clear();
+    for (auto &ctx : busy) {
+        data_fini(ctx);
+    }
+    for (auto &ctx : ctxs) {
+        data_fini(ctx);
+    }
+}
+
+class test_alltoallv_pairwise : public test_alltoallv<uint64_t> {};
+
+/* Persistent pairwise alltoallv with the adaptive window: the random
+   schedule changes the order of the steps on every start. */
+UCC_TEST_F(test_alltoallv_pairwise, schedule)
+{
+    int n_procs = 7;
+
+    coll_mask  = UCC_COLL_ARGS_FIELD_FLAGS;
+    coll_flags = UCC_COLL_ARGS_FLAG_COUNT_64BIT |
+                 UCC_COLL_ARGS_FLAG_DISPLACEMENTS_64BIT;
+    set_inplace(TEST_NO_INPLACE);
+    SET_MEM_TYPE(UCC_MEMORY_TYPE_HOST);
+
+    for (auto schedule : {"rotated", "random", "node"}) {
+        ucc_job_env_t env = {{"UCC_TL_UCP_ALLTOALLV_PAIRWISE_ADAPTIVE", "y"},
+                             {"UCC_TL_UCP_ALLTOALLV_PAIRWISE_SCHEDULE",
+                              schedule}};
+        UccJob        job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+        UccTeam_h     team = job.create_team(n_procs);
+        UccCollCtxVec ctxs;
+
+        data_init(n_procs, UCC_DT_INT32, 3, ctxs, true);
+        UccReq req(team, ctxs);
+
+        for (auto i = 0; i < 3; i++) {
+            req.start();
+            req.wait();
+            EXPECT_EQ(true, data_validate(ctxs));
+            reset(ctxs);
+        }
+        data_fini(ctxs);
+    }
+}
+
+class test_alltoallv_sparse : public test_alltoallv<uint64_t> {
+  public:
+    /* keeps the transfers between ranks r and i only when (r + i) is a
+       multiple of stride, on both the send and the receive side */
+    void sparsify(UccCollCtxVec &ctxs, int stride)
+    {
+        for (auto r = 0; r < ctxs.size(); r++) {
+            ucc_coll_args_t *coll = ctxs[r]->args;
+
+            for (auto i = 0; i < ctxs.size(); i++) {
+                if ((r + i) % stride) {
+                    ((uint64_t *)coll->src.info_v.counts)[i] = 0;
+                    ((uint64_t *)coll->dst.info_v.counts)[i] = 0;
+                }
+            }
+        }
+    }
+};
+
+/* The sparse algorithm is selected explicitly and through the default
+   selection, which takes it when at most 30% of the peers have data */
+UCC_TEST_F(test_alltoallv_sparse, zero_count_peers)
+{
+    int n_procs = 8;
+
+    coll_mask  = UCC_COLL_ARGS_FIELD_FLAGS;
+    coll_flags = UCC_COLL_ARGS_FLAG_COUNT_64BIT |
+                 UCC_COLL_ARGS_FLAG_DISPLACEMENTS_64BIT;
+    set_inplace(TEST_NO_INPLACE);
+    SET_MEM_TYPE(UCC_MEMORY_TYPE_HOST);
+
+    for (auto tune : {"alltoallv:@sparse:inf", ""}) {
+        ucc_job_env_t env = {{"UCC_TL_UCP_TUNE", tune},
+                             {"UCC_TL_UCP_ALLTOALLV_SPARSE_THRESH", "30"}};
+        UccJob        job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+        UccTeam_h     team = job.create_team(n_procs);
+
+        for (auto stride : {1, 4, 8}) {
+            UccCollCtxVec ctxs;
+
+            data_init(n_procs, UCC_DT_INT32, 2, ctxs, true);
+            sparsify(ctxs, stride);
+            UccReq req(team, ctxs);
+
+            for (auto i = 0; i < 2; i++) {
+                req.start();
+                req.wait();
+                EXPECT_EQ(true, data_validate(ctxs));
+                reset(ctxs);
+            }
+            data_fini(ctxs);
+        }
+    }
+}
+
+class test_alltoallv_onesided : public test_alltoallv<uint64_t> {
+  public:
+    std::vector<std::vector<uint64_t>> local_displs;
+
+    /* moves the buffers to the mapped segments of the team processes.
+       The onesided algorithm takes the dst displacement of a peer as the
+       offset in the dst buffer of that peer, the local ones are kept for
+       the validation. */
+    void data_init_onesided(UccTeam_h team, ucc_datatype_t dtype,
+                            size_t count, UccCollCtxVec &ctxs)
+    {
+        int nprocs = team->n_procs;
+
+        data_init(nprocs, dtype, count, ctxs, false);
+        local_displs.resize(nprocs);
+        for (auto r = 0; r < nprocs; r++) {
+            ucc_coll_args_t *coll = ctxs[r]->args;
+            uint64_t        *src_counts = (uint64_t *)coll->src.info_v.counts;
+            size_t           src_size   = 0;
+
+            local_displs[r].assign(
+                (uint64_t *)coll->dst.info_v.displacements,
+                (uint64_t *)coll->dst.info_v.displacements + nprocs);
+            for (auto i = 0; i < nprocs; i++) {
+                src_size += src_counts[i] * ucc_dt_size(dtype);
+            }
+            ASSERT_LE(src_size, (size_t)UCC_TEST_MEM_SEGMENT_SIZE);
+            ASSERT_LE(ctxs[r]->rbuf_size, (size_t)UCC_TEST_MEM_SEGMENT_SIZE);
+            memcpy(team->procs[r].p->onesided_buf[0], ctxs[r]->init_buf,
+                   src_size);
+            coll->mask |= UCC_COLL_ARGS_FIELD_FLAGS |
+                          UCC_COLL_ARGS_FIELD_GLOBAL_WORK_BUFFER;
+            coll->flags |= UCC_COLL_ARGS_FLAG_MEM_MAPPED_BUFFERS;
+            coll->src.info_v.buffer  = team->procs[r].p->onesided_buf[0];
+            coll->dst.info_v.buffer  = team->procs[r].p->onesided_buf[1];
+            coll->global_work_buffer = team->procs[r].p->onesided_buf[2];
+        }
+        for (auto r = 0; r < nprocs; r++) {
+            for (auto i = 0; i < nprocs; i++) {
+                ((uint64_t *)ctxs[r]->args->dst.info_v.displacements)[i] =
+                    local_displs[i][r];
+            }
+        }
+    }
+
+    void restore_displs(UccCollCtxVec &ctxs)
+    {
+        for (auto r = 0; r < ctxs.size(); r++) {
+            memcpy(ctxs[r]->args->dst.info_v.displacements,
+                   local_displs[r].data(), ctxs.size() * sizeof(uint64_t));
+        }
+    }
+};
+
+UCC_TEST_F(test_alltoallv_onesided, remote_displacements)
+{
+    SET_MEM_TYPE(UCC_MEMORY_TYPE_HOST);
+    set_inplace(TEST_NO_INPLACE);
+    coll_mask  = UCC_COLL_ARGS_FIELD_FLAGS;
+    coll_flags = UCC_COLL_ARGS_FLAG_COUNT_64BIT |
+                 UCC_COLL_ARGS_FLAG_DISPLACEMENTS_64BIT;
+
+    for (auto n_procs : {2, 7}) {
+        ucc_job_env_t env = {{"UCC_TL_UCP_TUNE", "alltoallv:0-inf:@onesided"},
+                             {"UCC_TL_UCP_ALLTOALLV_ONESIDED_NUM_POSTS", "2"}};
+        UccJob        job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL_ONESIDED, env);
+        UccTeam_h     team = job.create_team(n_procs, true, true, true);
+
+        for (auto dtype : {UCC_DT_INT8, UCC_DT_FLOAT64_COMPLEX}) {
+            UccCollCtxVec ctxs;
+
+            data_init_onesided(team, dtype, 3, ctxs);
+            UccReq req(team, ctxs);
+            req.start();
+            req.wait();
+            restore_displs(ctxs);
+            EXPECT_EQ(true, data_validate(ctxs));
+            data_fini(ctxs);
+        }
+    }
+}
@@ -41,3 +41,36 @@ UCC_TEST_F(test_barrier, multiple)
     UccReq::startall(reqs);
     UccReq::waitall(reqs);
 }
+
+UCC_TEST_F(test_barrier, persistent)
+{
+    coll.mask  = UCC_COLL_ARGS_FIELD_FLAGS;
+    coll.flags = UCC_COLL_ARGS_FLAG_PERSISTENT;
+    for (auto &team : UccJob::getStaticTeams()) {
+        UccReq req(team, &coll);
+        for (int i = 0; i < 3; i++) {
+            req.start();
+            req.wait();
+        }
+    }
+}
+
+/* CL/HIER barrier over 2 fake nodes with 2 sockets each: fanin up the
+   SOCKET (NUMA) levels, barrier of the node leaders, fanout back down. */
+UCC_TEST_F(test_barrier, hier_node_split)
+{
+    int n_procs = 8;
+
+    for (auto split : {"none", "socket", "numa"}) {
+        ucc_job_env_t env = {{"UCC_CLS", "basic,hier"},
+                             {"UCC_CL_HIER_TUNE", "barrier:inf"},
+                             {"UCC_CL_HIER_NODE_SPLIT", split}};
+        UccJob        job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+
+        job.set_fake_topo(4, 2);
+        UccTeam_h team = job.create_team(n_procs);
+        UccReq    req(team, &coll);
+        req.start();
+        req.wait();
+    }
+}
@@ -15,8 +15,10 @@ private:
     int root;
 public:
     void data_init(int nprocs, ucc_datatype_t dtype, size_t count,
-                   UccCollCtxVec &ctxs, bool persistent)
+                   UccCollCtxVec &ctxs, UccTeam_h team, bool persistent)
     {
+        bool is_onesided = (NULL != team);
+
         ctxs.resize(nprocs);
         for (auto r = 0; r < nprocs; r++) {
             ucc_coll_args_t *coll = (ucc_coll_args_t*)
@@ -34,9 +36,17 @@ public:
 
             ctxs[r]->rbuf_size = ucc_dt_size(dtype) * count;
 
-            UCC_CHECK(ucc_mc_alloc(&ctxs[r]->src_mc_header, ctxs[r]->rbuf_size,
-                                   mem_type));
-            coll->src.info.buffer = ctxs[r]->src_mc_header->addr;
+            if (is_onesided) {
+                coll->mask  = UCC_COLL_ARGS_FIELD_FLAGS |
+                             UCC_COLL_ARGS_FIELD_GLOBAL_WORK_BUFFER;
+                coll->flags = UCC_COLL_ARGS_FLAG_MEM_MAPPED_BUFFERS;
+                coll->src.info.buffer    = team->procs[r].p->onesided_buf[0];
+                coll->global_work_buffer = team->procs[r].p->onesided_buf[2];
+            } else {
+                UCC_CHECK(ucc_mc_alloc(&ctxs[r]->src_mc_header,
+                                       ctxs[r]->rbuf_size, mem_type));
+                coll->src.info.buffer = ctxs[r]->src_mc_header->addr;
+            }
             if (r == root) {
                 ctxs[r]->init_buf = ucc_malloc(ctxs[r]->rbuf_size, "init buf");
                 EXPECT_NE(ctxs[r]->init_buf, nullptr);
@@ -54,14 +64,19 @@ public:
             }
         }
     }
+    void data_init(int nprocs, ucc_datatype_t dtype, size_t count,
+                   UccCollCtxVec &ctxs, bool persistent)
+    {
+        data_init(nprocs, dtype, count, ctxs, NULL, persistent);
+    }
     void reset(UccCollCtxVec ctxs)
     {
         for (auto r = 0; r < ctxs.size(); r++) {
-            ucc_coll_args_t *coll  = ctxs[r]->args;
-            size_t           count = coll->dst.info.count;
-            ucc_datatype_t   dtype = coll->dst.info.datatype;
-            clear_buffer(coll->dst.info.buffer, count * ucc_dt_size(dtype),
-                         mem_type, 0);
+            ucc_coll_args_t *coll = ctxs[r]->args;
+            if (r != coll->root) {
+                clear_buffer(coll->src.info.buffer, ctxs[r]->rbuf_size,
+                             mem_type, 0);
+            }
         }
     }
 
@@ -79,35 +94,46 @@ public:
         }
         ctxs.clear();
     }
+    void data_fini_onesided(UccCollCtxVec ctxs)
+    {
+        for (auto r = 0; r < ctxs.size(); r++) {
+            gtest_ucc_coll_ctx_t *ctx = ctxs[r];
+            if (r == ctx->args->root) {
+                ucc_free(ctx->init_buf);
+            }
+            free(ctx->args);
+            free(ctx);
+        }
+        ctxs.clear();
+    }
     bool data_validate(UccCollCtxVec ctxs)
     {
-        bool     ret  = true;
-        int      root = ctxs[0]->args->root;
+        bool     ret = true;
         uint8_t *dsts;
 
-        if (UCC_MEMORY_TYPE_HOST != mem_type) {
-                dsts = (uint8_t*) ucc_malloc(ctxs[root]->rbuf_size, "dsts buf");
-                EXPECT_NE(dsts, nullptr);
-                UCC_CHECK(ucc_mc_memcpy(dsts, ctxs[root]->args->src.info.buffer,
-                                        ctxs[root]->rbuf_size,
-                                        UCC_MEMORY_TYPE_HOST, mem_type));
-        } else {
-            dsts = (uint8_t*)ctxs[root]->args->src.info.buffer;
-        }
-        for (int r = 0; r < ctxs.size(); r++) {
+        for (int r = 0; r < ctxs.size() && ret; r++) {
             ucc_coll_args_t* coll = ctxs[r]->args;
             if (coll->root == r) {
                 continue;
             }
+            if (UCC_MEMORY_TYPE_HOST != mem_type) {
+                dsts = (uint8_t*) ucc_malloc(ctxs[r]->rbuf_size, "dsts buf");
+                EXPECT_NE(dsts, nullptr);
+                UCC_CHECK(ucc_mc_memcpy(dsts, coll->src.info.buffer,
+                                        ctxs[r]->rbuf_size,
+                                        UCC_MEMORY_TYPE_HOST, mem_type));
+            } else {
+                dsts = (uint8_t*)coll->src.info.buffer;
+            }
             for (int i = 0; i < ctxs[r]->rbuf_size; i++) {
                 if ((uint8_t)i != dsts[i]) {
                     ret = false;
                     break;
                 }
             }
-        }
-        if (UCC_MEMORY_TYPE_HOST != mem_type) {
-            ucc_free(dsts);
+            if (UCC_MEMORY_TYPE_HOST != mem_type) {
+                ucc_free(dsts);
+            }
         }
         return ret;
     }
@@ -170,6 +196,47 @@ UCC_TEST_P(test_bcast_0, single_persistent)
     data_fini(ctxs);
 }
 
+UCC_TEST_P(test_bcast_0, single_onesided)
+{
+    const int               team_id  = std::get<0>(GetParam());
+    const ucc_datatype_t    dtype    = std::get<1>(GetParam());
+    const ucc_memory_type_t mem_type = std::get<2>(GetParam());
+    const int               count    = std::get<3>(GetParam());
+    const int               root     = std::get<4>(GetParam());
+    UccTeam_h        reference_team  = UccJob::getStaticTeams()[team_id];
+    int              size            = reference_team->procs.size();
+    ucc_job_env_t    env = {{"UCC_TL_UCP_TUNE", "bcast:0-inf:@onesided"}};
+    bool             is_contig = true;
+    UccJob           job(size, UccJob::UCC_JOB_CTX_GLOBAL_ONESIDED, env);
+    UccTeam_h        team;
+    std::vector<int> reference_ranks;
+    UccCollCtxVec    ctxs;
+
+    if (UCC_MEMORY_TYPE_HOST != mem_type ||
+        ucc_dt_size(dtype) * count > UCC_TEST_MEM_SEGMENT_SIZE) {
+        GTEST_SKIP();
+    }
+    for (auto i = 0; i < reference_team->n_procs; i++) {
+        int rank = reference_team->procs[i].p->job_rank;
+        reference_ranks.push_back(rank);
+        if (is_contig && i > 0 &&
+            (rank - reference_ranks[i - 1] > 1 ||
+             reference_ranks[i - 1] - rank > 1)) {
+            is_contig = false;
+        }
+    }
+    team = job.create_team(reference_ranks, true, is_contig, true);
+    SET_MEM_TYPE(mem_type);
+    set_root(root);
+
+    data_init(size, dtype, count, ctxs, team, false);
+    UccReq req(team, ctxs);
+    req.start();
+    req.wait();
+    EXPECT_EQ(true, data_validate(ctxs));
+    data_fini_onesided(ctxs);
+}
+
 INSTANTIATE_TEST_CASE_P(
     , test_bcast_0,
     ::testing::Combine(
@@ -232,3 +299,124 @@ INSTANTIATE_TEST_CASE_P(
 #endif
         ::testing::Values(1,3,65536), // count
         ::testing::Values(0,1))); // root
+
+/* Knomial bcast pipelined through fragments of BCAST_KN_FRAG_SIZE, with a
+   non-zero root. Fragments of 1000 bytes do not divide the message evenly,
+   the last fragment is smaller. */
+class test_bcast_kn_frag : public test_bcast,
+                           public ::testing::WithParamInterface<int> {
+};
+
+UCC_TEST_P(test_bcast_kn_frag, pipelined)
+{
+    int           n_procs = 7;
+    int           root    = GetParam();
+    ucc_job_env_t env     = {{"UCC_CL_BASIC_TUNE", "inf"},
+                             {"UCC_TL_UCP_TUNE", "bcast:@knomial:inf"},
+                             {"UCC_TL_UCP_BCAST_KN_FRAG_SIZE", "1000"},
+                             {"UCC_TL_UCP_BCAST_KN_PIPELINE_DEPTH", "3"}};
+    UccJob        job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+    UccTeam_h     team   = job.create_team(n_procs);
+    int           repeat = 3;
+    UccCollCtxVec ctxs;
+
+    SET_MEM_TYPE(UCC_MEMORY_TYPE_HOST);
+    set_root(root);
+    for (auto count : {100, 4099, 65536}) {
+        data_init(n_procs, UCC_DT_INT32, count, ctxs, true);
+        UccReq req(team, ctxs);
+
+        for (auto i = 0; i < repeat; i++) {
+            req.start();
+            req.wait();
+            EXPECT_EQ(true, data_validate(ctxs));
+            reset(ctxs);
+        }
+        data_fini(ctxs);
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(, test_bcast_kn_frag, ::testing::Values(0, 3));
+
+/* CL/HIER 2step bcast over 2 fake nodes with 2 sockets each. Root 5 is
+   neither a node nor a socket leader, so the data first moves up through
+   the sbgps containing the root. 1000 byte fragments pipeline the levels. */
+class test_bcast_hier_2step : public test_bcast,
+                              public ::testing::WithParamInterface<int> {
+};
+
+UCC_TEST_P(test_bcast_hier_2step, node_split)
+{
+    int           n_procs = 8;
+    int           root    = GetParam();
+    int           repeat  = 3;
+    UccCollCtxVec ctxs;
+
+    for (auto split : {"none", "socket"}) {
+        for (auto frag : {"inf", "1000"}) {
+            ucc_job_env_t env = {{"UCC_CLS", "basic,hier"},
+                                 {"UCC_CL_HIER_TUNE", "bcast:@2step:inf"},
+                                 {"UCC_CL_HIER_NODE_SPLIT", split},
+                                 {"UCC_CL_HIER_BCAST_2STEP_FRAG_SIZE", frag}};
+            UccJob        job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+
+            job.set_fake_topo(4, 2);
+            UccTeam_h team = job.create_team(n_procs);
+
+            SET_MEM_TYPE(UCC_MEMORY_TYPE_HOST);
+            set_root(root);
+            for (auto count : {8, 4099}) {
+                data_init(n_procs, UCC_DT_INT32, count, ctxs, true);
+                UccReq req(team, ctxs);
+
+                for (auto i = 0; i < repeat; i++) {
+                    req.start();
+                    req.wait();
+                    EXPECT_EQ(true, data_validate(ctxs));
+                    reset(ctxs);
+                }
+                data_fini(ctxs);
+            }
+        }
+    }
+}
+
+/* CL/HIER multi-leader bcast over 2 fake nodes of 4 processes, the slices
+   go over the rails of different leaders */
+UCC_TEST_P(test_bcast_hier_2step, multi_leader)
+{
+    int           n_procs = 8;
+    int           root    = GetParam();
+    int           repeat  = 3;
+    UccCollCtxVec ctxs;
+
+    for (auto n_leaders : {"2", "3"}) {
+        for (auto rotate : {"n", "y"}) {
+            ucc_job_env_t env = {{"UCC_CLS", "basic,hier"},
+                                 {"UCC_CL_HIER_TUNE", "bcast:@2step:inf"},
+                                 {"UCC_CL_HIER_N_LEADERS", n_leaders},
+                                 {"UCC_CL_HIER_LEADERS_ROTATE", rotate}};
+            UccJob        job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+
+            job.set_fake_topo(4);
+            UccTeam_h team = job.create_team(n_procs);
+
+            SET_MEM_TYPE(UCC_MEMORY_TYPE_HOST);
+            set_root(root);
+            for (auto count : {1, 4099}) {
+                data_init(n_procs, UCC_DT_INT32, count, ctxs, true);
+                UccReq req(team, ctxs);
+
+                for (auto i = 0; i < repeat; i++) {
+                    req.start();
+                    req.wait();
+                    EXPECT_EQ(true, data_validate(ctxs));
+                    reset(ctxs);
+                }
+                data_fini(ctxs);
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(, test_bcast_hier_2step, ::testing::Values(0, 5));
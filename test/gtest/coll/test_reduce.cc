@@ -145,6 +145,10 @@ class test_reduce : public UccCollArgs, public testing::Test {
         }
         return true;
     }
+    void set_root(int _root)
+    {
+        root = _root;
+    }
 };
 
 template<typename T>
@@ -299,3 +303,181 @@ TYPED_TEST(test_reduce_avg_order, avg_post_op)
         }
     }
 }
+
+/* Knomial reduce pipelined through fragments of REDUCE_KN_FRAG_SIZE, with
+   a non-zero root and in-place root. Fragments of 1000 bytes do not divide
+   the message evenly, the last fragment is smaller. */
+class test_reduce_kn_frag : public ucc::test,
+                            public ::testing::WithParamInterface<int> {
+};
+
+UCC_TEST_P(test_reduce_kn_frag, pipelined)
+{
+    test_reduce<TypeOpPair<UCC_DT_INT32, sum>> reduce_test;
+    int                                        n_procs = 7;
+    int                                        root    = GetParam();
+    ucc_job_env_t env = {{"UCC_CL_BASIC_TUNE", "inf"},
+                         {"UCC_TL_UCP_TUNE", "reduce:@knomial:inf"},
+                         {"UCC_TL_UCP_REDUCE_KN_FRAG_SIZE", "1000"},
+                         {"UCC_TL_UCP_REDUCE_KN_PIPELINE_DEPTH", "3"}};
+    UccJob        job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+    UccTeam_h     team   = job.create_team(n_procs);
+    int           repeat = 3;
+    UccCollCtxVec ctxs;
+
+    reduce_test.set_root(root);
+    for (auto count : {100, 4099, 65536}) {
+        for (auto inplace : {TEST_NO_INPLACE, TEST_INPLACE}) {
+            reduce_test.set_mem_type(UCC_MEMORY_TYPE_HOST);
+            reduce_test.set_inplace(inplace);
+            reduce_test.data_init(n_procs, UCC_DT_INT32, count, ctxs, true);
+            UccReq req(team, ctxs);
+
+            for (auto i = 0; i < repeat; i++) {
+                req.start();
+                req.wait();
+                EXPECT_EQ(true, reduce_test.data_validate(ctxs));
+                reduce_test.reset(ctxs);
+            }
+            reduce_test.data_fini(ctxs);
+        }
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(, test_reduce_kn_frag, ::testing::Values(0, 3));
+
+/* CL/HIER 2step reduce over 2 fake nodes with 2 sockets each. Root 5 is
+   neither a node nor a socket leader: the sbgps not containing the root
+   reduce to their leaders, then the result moves down to the root. */
+class test_reduce_hier_2step : public ucc::test,
+                               public ::testing::WithParamInterface<int> {
+};
+
+UCC_TEST_P(test_reduce_hier_2step, node_split)
+{
+    test_reduce<TypeOpPair<UCC_DT_INT32, sum>> reduce_test;
+    int                                        n_procs = 8;
+    int                                        root    = GetParam();
+    int                                        repeat  = 3;
+    UccCollCtxVec                              ctxs;
+
+    reduce_test.set_root(root);
+    for (auto split : {"none", "socket"}) {
+        for (auto frag : {"inf", "1000"}) {
+            ucc_job_env_t env = {{"UCC_CLS", "basic,hier"},
+                                 {"UCC_CL_HIER_TUNE", "reduce:@2step:inf"},
+                                 {"UCC_CL_HIER_NODE_SPLIT", split},
+                                 {"UCC_CL_HIER_REDUCE_2STEP_FRAG_SIZE", frag}};
+            UccJob        job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+
+            job.set_fake_topo(4, 2);
+            UccTeam_h team = job.create_team(n_procs);
+
+            for (auto count : {8, 4099}) {
+                for (auto inplace : {TEST_NO_INPLACE, TEST_INPLACE}) {
+                    reduce_test.set_mem_type(UCC_MEMORY_TYPE_HOST);
+                    reduce_test.set_inplace(inplace);
+                    reduce_test.data_init(n_procs, UCC_DT_INT32, count, ctxs,
+                                          true);
+                    UccReq req(team, ctxs);
+
+                    for (auto i = 0; i < repeat; i++) {
+                        req.start();
+                        req.wait();
+                        EXPECT_EQ(true, reduce_test.data_validate(ctxs));
+                        reduce_test.reset(ctxs);
+                    }
+                    reduce_test.data_fini(ctxs);
+                }
+            }
+        }
+    }
+}
+
+/* CL/HIER multi-leader reduce over 2 fake nodes of 4 processes. With root
+   5 the slices reduced to the other leaders of the root node are sent to
+   the root. */
+UCC_TEST_P(test_reduce_hier_2step, multi_leader)
+{
+    test_reduce<TypeOpPair<UCC_DT_INT32, sum>> reduce_test;
+    int                                        n_procs = 8;
+    int                                        root    = GetParam();
+    int                                        repeat  = 3;
+    UccCollCtxVec                              ctxs;
+
+    reduce_test.set_root(root);
+    for (auto n_leaders : {"2", "3"}) {
+        for (auto rotate : {"n", "y"}) {
+            ucc_job_env_t env = {{"UCC_CLS", "basic,hier"},
+                                 {"UCC_CL_HIER_TUNE", "reduce:@2step:inf"},
+                                 {"UCC_CL_HIER_N_LEADERS", n_leaders},
+                                 {"UCC_CL_HIER_LEADERS_ROTATE", rotate}};
+            UccJob        job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+
+            job.set_fake_topo(4);
+            UccTeam_h team = job.create_team(n_procs);
+
+            for (auto count : {1, 4099}) {
+                for (auto inplace : {TEST_NO_INPLACE, TEST_INPLACE}) {
+                    reduce_test.set_mem_type(UCC_MEMORY_TYPE_HOST);
+                    reduce_test.set_inplace(inplace);
+                    reduce_test.data_init(n_procs, UCC_DT_INT32, count, ctxs,
+                                          true);
+                    UccReq req(team, ctxs);
+
+                    for (auto i = 0; i < repeat; i++) {
+                        req.start();
+                        req.wait();
+                        EXPECT_EQ(true, reduce_test.data_validate(ctxs));
+                        reduce_test.reset(ctxs);
+                    }
+                    reduce_test.data_fini(ctxs);
+                }
+            }
+        }
+    }
+}
+
+/* Two multi-leader reduces with different results outstanding at once on
+   the same team: the slice results of the same leader and root pair must
+   not be delivered to the other reduce. */
+UCC_TEST_P(test_reduce_hier_2step, multi_leader_concurrent)
+{
+    test_reduce<TypeOpPair<UCC_DT_INT32, sum>> sum_test;
+    test_reduce<TypeOpPair<UCC_DT_INT32, max>> max_test;
+    int                                        n_procs = 8;
+    int                                        root    = GetParam();
+    int                                        repeat  = 3;
+    ucc_job_env_t env = {{"UCC_CLS", "basic,hier"},
+                         {"UCC_CL_HIER_TUNE", "reduce:@2step:inf"},
+                         {"UCC_CL_HIER_N_LEADERS", "2"},
+                         {"UCC_CL_HIER_LEADERS_ROTATE", "n"}};
+    UccJob        job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+
+    job.set_fake_topo(4);
+    UccTeam_h team = job.create_team(n_procs);
+
+    sum_test.set_root(root);
+    max_test.set_root(root);
+    for (auto count : {1, 4099}) {
+        for (auto i = 0; i < repeat; i++) {
+            std::vector<UccReq> reqs;
+            UccCollCtxVec       sum_ctxs, max_ctxs;
+
+            sum_test.set_mem_type(UCC_MEMORY_TYPE_HOST);
+            max_test.set_mem_type(UCC_MEMORY_TYPE_HOST);
+            sum_test.data_init(n_procs, UCC_DT_INT32, count, sum_ctxs, false);
+            max_test.data_init(n_procs, UCC_DT_INT32, count, max_ctxs, false);
+            reqs.push_back(UccReq(team, sum_ctxs));
+            reqs.push_back(UccReq(team, max_ctxs));
+            UccReq::startall(reqs);
+            UccReq::waitall(reqs);
+            EXPECT_EQ(true, sum_test.data_validate(sum_ctxs));
+            EXPECT_EQ(true, max_test.data_validate(max_ctxs));
+            sum_test.data_fini(sum_ctxs);
+            max_test.data_fini(max_ctxs);
+        }
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(, test_reduce_hier_2step, ::testing::Values(0, 5));
@@ -332,3 +332,104 @@ UCC_TEST_P(test_reduce_scatter_alg, ring)
 }
 INSTANTIATE_TEST_CASE_P(, test_reduce_scatter_alg,
                         ::testing::Values("bidirectional", "unidirectional"));
+
+/* CL/HIER split_rail reduce-scatter over 2 fake nodes of 4 processes */
+UCC_TEST_F(test_reduce_scatter_alg, hier_split_rail)
+{
+    test_reduce_scatter<TypeOpPair<UCC_DT_INT32, sum>> rs_test;
+    int                                                n_procs = 8;
+    ucc_job_env_t env = {{"UCC_CLS", "basic,hier"},
+                         {"UCC_CL_HIER_TUNE", "reduce_scatter:@split_rail:inf"}};
+    UccJob        job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+    UccCollCtxVec ctxs;
+
+    job.set_fake_topo(4);
+    UccTeam_h team = job.create_team(n_procs);
+
+    for (auto count : {8, 65536}) {
+        for (auto inplace : {TEST_NO_INPLACE, TEST_INPLACE}) {
+            rs_test.set_mem_type(UCC_MEMORY_TYPE_HOST);
+            rs_test.set_inplace(inplace);
+            rs_test.data_init(n_procs, UCC_DT_INT32, count, ctxs, false);
+            UccReq req(team, ctxs);
+            req.start();
+            req.wait();
+            EXPECT_EQ(true, rs_test.data_validate(ctxs));
+            rs_test.data_fini(ctxs);
+        }
+    }
+}
+
+/* TL/UCP ring reduce-scatter over a team whose ranks alternate between 2
+   fake nodes, so the topology aware ring differs from the team order.
+   Runs with RING_TOPO_ORDER forced on and off and both ring directions. */
+UCC_TEST_F(test_reduce_scatter_alg, ring_topo_order)
+{
+    test_reduce_scatter<TypeOpPair<UCC_DT_INT32, sum>> rs_test;
+    int                                                n_procs = 8;
+    std::vector<int> ranks = {0, 4, 1, 5, 2, 6, 3, 7};
+    UccCollCtxVec    ctxs;
+
+    for (auto topo_order : {"y", "n"}) {
+        for (auto bidir : {"y", "n"}) {
+            ucc_job_env_t env = {
+                {"UCC_CLS", "basic,hier"},
+                {"UCC_CL_BASIC_TUNE", "inf"},
+                {"UCC_TL_UCP_TUNE", "reduce_scatter:@ring:inf"},
+                {"UCC_TL_UCP_RING_TOPO_ORDER", topo_order},
+                {"UCC_TL_UCP_REDUCE_SCATTER_RING_BIDIRECTIONAL", bidir}};
+            UccJob job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+
+            job.set_fake_topo(4);
+            UccTeam_h team = job.create_team(ranks);
+
+            for (auto count : {8, 65536}) {
+                for (auto inplace : {TEST_NO_INPLACE, TEST_INPLACE}) {
+                    rs_test.set_mem_type(UCC_MEMORY_TYPE_HOST);
+                    rs_test.set_inplace(inplace);
+                    rs_test.data_init(n_procs, UCC_DT_INT32, count, ctxs,
+                                      false);
+                    UccReq req(team, ctxs);
+                    req.start();
+                    req.wait();
+                    EXPECT_EQ(true, rs_test.data_validate(ctxs));
+                    rs_test.data_fini(ctxs);
+                }
+            }
+        }
+    }
+}
+
+/* TL/UCP ring reduce-scatter with several UCP workers and a low stripe
+   threshold: the ring sends and receives of large fragments are striped
+   across the workers. */
+UCC_TEST_F(test_reduce_scatter_alg, tl_ucp_multiple_workers)
+{
+    test_reduce_scatter<TypeOpPair<UCC_DT_INT32, sum>> rs_test;
+    int                                                n_procs = 4;
+    UccCollCtxVec                                      ctxs;
+
+    for (auto bidir : {"y", "n"}) {
+        ucc_job_env_t env = {
+            {"UCC_CL_BASIC_TUNE", "inf"},
+            {"UCC_TL_UCP_TUNE", "reduce_scatter:@ring:inf"},
+            {"UCC_TL_UCP_REDUCE_SCATTER_RING_BIDIRECTIONAL", bidir},
+            {"UCC_TL_UCP_N_WORKERS", "3"},
+            {"UCC_TL_UCP_STRIPE_THRESH", "1k"}};
+        UccJob    job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+        UccTeam_h team = job.create_team(n_procs);
+
+        for (auto count : {8, 65536}) {
+            for (auto inplace : {TEST_NO_INPLACE, TEST_INPLACE}) {
+                rs_test.set_mem_type(UCC_MEMORY_TYPE_HOST);
+                rs_test.set_inplace(inplace);
+                rs_test.data_init(n_procs, UCC_DT_INT32, count, ctxs, false);
+                UccReq req(team, ctxs);
+                req.start();
+                req.wait();
+                EXPECT_EQ(true, rs_test.data_validate(ctxs));
+                rs_test.data_fini(ctxs);
+            }
+        }
+    }
+}
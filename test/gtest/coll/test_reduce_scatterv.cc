@@ -379,5 +379,41 @@ UCC_TEST_P(test_reduce_scatterv_alg, ring)
         }
     }
 }
+/* Ring reduce-scatterv with several UCP workers and a low stripe threshold,
+   so that the ring sends and receives of large fragments are striped. */
+UCC_TEST_P(test_reduce_scatterv_alg, tl_ucp_multiple_workers)
+{
+    test_reduce_scatterv<TypeOpPair<UCC_DT_INT32, sum>> rsv_test;
+    int                                                 n_procs = 4;
+    std::string                                         bidir   = GetParam();
+    ucc_job_env_t env = {{"UCC_CL_BASIC_TUNE", "inf"},
+                         {"UCC_TL_UCP_TUNE", "reduce_scatterv:@ring:inf"},
+                         {"UCC_TL_UCP_REDUCE_SCATTERV_RING_BIDIRECTIONAL",
+                          bidir == "bidirectional" ? "y" : "n"},
+                         {"UCC_TL_UCP_N_WORKERS", "3"},
+                         {"UCC_TL_UCP_STRIPE_THRESH", "1k"}};
+    UccJob        job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL, env);
+    UccTeam_h     team   = job.create_team(n_procs);
+    int           repeat = 2;
+    UccCollCtxVec ctxs;
+
+    for (auto count : {8, 65536}) {
+        for (auto inplace : {TEST_NO_INPLACE, TEST_INPLACE}) {
+            rsv_test.set_mem_type(UCC_MEMORY_TYPE_HOST);
+            rsv_test.set_inplace(inplace);
+            rsv_test.data_init(n_procs, UCC_DT_INT32, count, ctxs, true);
+            UccReq req(team, ctxs);
+
+            for (auto i = 0; i < repeat; i++) {
+                req.start();
+                req.wait();
+                EXPECT_EQ(true, rsv_test.data_validate(ctxs));
+                rsv_test.reset(ctxs);
+            }
+            rsv_test.data_fini(ctxs);
+        }
+    }
+}
+
 INSTANTIATE_TEST_CASE_P(, test_reduce_scatterv_alg,
                         ::testing::Values("bidirectional", "unidirectional"));
@@ -529,6 +529,32 @@ void UccJob::cleanup()
     }
 }
 
+void UccJob::set_fake_topo(int ppn, int n_sockets)
+{
+    for (auto &p : procs) {
+        ucc_context_t             *ctx     = p->ctx_h;
+        ucc_addr_storage_t        *storage = &ctx->addr_storage;
+        ucc_context_addr_header_t *h;
+        ucc_host_id_t              base;
+
+        if (!ctx->topo) {
+            /* no CL requires topo */
+            continue;
+        }
+        h    = UCC_ADDR_STORAGE_RANK_HEADER(storage, 0);
+        base = h->ctx_id.pi.host_hash;
+        for (int i = 0; i < storage->size; i++) {
+            h = UCC_ADDR_STORAGE_RANK_HEADER(storage, i);
+            h->ctx_id.pi.host_hash = base + i / ppn;
+            h->ctx_id.pi.socket_id = (i % ppn) * n_sockets / ppn;
+            h->ctx_id.pi.numa_id   = h->ctx_id.pi.socket_id;
+        }
+        ucc_context_topo_cleanup(ctx->topo);
+        ctx->topo = NULL;
+        ASSERT_EQ(UCC_OK, ucc_context_topo_init(storage, &ctx->topo));
+    }
+}
+
 UccTeam_h UccJob::create_team(int _n_procs, bool use_team_ep_map,
                               bool use_ep_range, bool is_onesided)
 {
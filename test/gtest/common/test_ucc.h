@@ -213,6 +213,12 @@ public:
            ucc_job_env_t vars = ucc_job_env_t());
     ~UccJob();
     std::vector<UccProcess_h> procs;
+    /* Rewrites the proc info the contexts hold for job rank i: host
+       i / ppn, socket and numa (i % ppn) * n_sockets / ppn, and rebuilds
+       the context topo. Lets a single host run the multi-node and
+       multi-socket paths of the hierarchical algorithms. Must be called
+       before the teams are created. */
+    void set_fake_topo(int ppn, int n_sockets = 1);
     UccTeam_h create_team(int n_procs, bool use_team_ep_map = false,
                           bool use_ep_range = true, bool is_onesided = false);
     UccTeam_h create_team(std::vector<int> &ranks, bool use_team_ep_map = false,
@@ -0,0 +1,150 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * See file LICENSE for terms.
+ */
+
+#include "common/test_ucc.h"
+
+class test_coll_group : public ucc::test
+{
+public:
+    int                                        n_procs;
+    std::vector<std::vector<ucc_coll_args_t>>  args;
+    std::vector<std::vector<std::vector<int>>> src, dst;
+    std::vector<ucc_coll_req_h>                reqs;
+
+    /* Every rank gets a group of allreduces of "counts" sizes followed by
+       a bcast from the last rank and a barrier */
+    void init(UccTeam_h team, std::vector<size_t> counts, bool persistent)
+    {
+        int n_ops = counts.size();
+
+        n_procs = team->n_procs;
+        args.resize(n_procs);
+        src.resize(n_procs);
+        dst.resize(n_procs);
+        reqs.resize(n_procs);
+        for (int r = 0; r < n_procs; r++) {
+            args[r].resize(n_ops + 2);
+            src[r].resize(n_ops + 1);
+            dst[r].resize(n_ops);
+            for (int i = 0; i < n_ops + 2; i++) {
+                ucc_coll_args_t *a = &args[r][i];
+
+                memset(a, 0, sizeof(*a));
+                if (persistent) {
+                    a->mask  = UCC_COLL_ARGS_FIELD_FLAGS;
+                    a->flags = UCC_COLL_ARGS_FLAG_PERSISTENT;
+                }
+                if (i < n_ops) {
+                    src[r][i].assign(counts[i], r + i);
+                    dst[r][i].assign(counts[i], -1);
+                    a->coll_type         = UCC_COLL_TYPE_ALLREDUCE;
+                    a->op                = UCC_OP_SUM;
+                    a->src.info.buffer   = src[r][i].data();
+                    a->src.info.count    = counts[i];
+                    a->src.info.datatype = UCC_DT_INT32;
+                    a->src.info.mem_type = UCC_MEMORY_TYPE_HOST;
+                    a->dst.info.buffer   = dst[r][i].data();
+                    a->dst.info.count    = counts[i];
+                    a->dst.info.datatype = UCC_DT_INT32;
+                    a->dst.info.mem_type = UCC_MEMORY_TYPE_HOST;
+                } else if (i == n_ops) {
+                    src[r][i].assign(256, r);
+                    a->coll_type         = UCC_COLL_TYPE_BCAST;
+                    a->root              = n_procs - 1;
+                    a->src.info.buffer   = src[r][i].data();
+                    a->src.info.count    = 256;
+                    a->src.info.datatype = UCC_DT_INT32;
+                    a->src.info.mem_type = UCC_MEMORY_TYPE_HOST;
+                } else {
+                    a->coll_type = UCC_COLL_TYPE_BARRIER;
+                }
+            }
+            ASSERT_EQ(UCC_OK,
+                      ucc_collective_group_init(args[r].data(), n_ops + 2,
+                                                &reqs[r],
+                                                team->procs[r].team));
+        }
+    }
+
+    void run(UccTeam_h team)
+    {
+        ucc_status_t status;
+        bool         done;
+
+        for (int r = 0; r < n_procs; r++) {
+            ASSERT_EQ(UCC_OK, ucc_collective_post(reqs[r]));
+        }
+        do {
+            done = true;
+            for (int r = 0; r < n_procs; r++) {
+                status = ucc_collective_test(reqs[r]);
+                ASSERT_GE(status, 0);
+                if (UCC_OK != status) {
+                    done = false;
+                }
+            }
+            team->progress();
+        } while (!done);
+    }
+
+    void validate()
+    {
+        int n_ops = dst[0].size();
+
+        for (int r = 0; r < n_procs; r++) {
+            for (int i = 0; i < n_ops; i++) {
+                for (auto v : dst[r][i]) {
+                    EXPECT_EQ(n_procs * i + n_procs * (n_procs - 1) / 2, v);
+                }
+                dst[r][i].assign(dst[r][i].size(), -1);
+            }
+            for (auto v : src[r][n_ops]) {
+                EXPECT_EQ(n_procs - 1, v);
+            }
+            src[r][n_ops].assign(src[r][n_ops].size(), r);
+        }
+    }
+
+    void fini()
+    {
+        for (auto req : reqs) {
+            EXPECT_EQ(UCC_OK, ucc_collective_finalize(req));
+        }
+    }
+};
+
+UCC_TEST_F(test_coll_group, mixed)
+{
+    UccJob    job(6, UccJob::UCC_JOB_CTX_GLOBAL);
+    UccTeam_h team = job.create_team(6);
+
+    init(team, {1, 16, 1024, 100000, 3}, false);
+    run(team);
+    validate();
+    fini();
+}
+
+UCC_TEST_F(test_coll_group, persistent)
+{
+    UccJob    job(4, UccJob::UCC_JOB_CTX_GLOBAL);
+    UccTeam_h team = job.create_team(4);
+
+    init(team, std::vector<size_t>(20, 64), true);
+    for (int i = 0; i < 3; i++) {
+        run(team);
+        validate();
+    }
+    fini();
+}
+
+UCC_TEST_F(test_coll_group, empty)
+{
+    UccJob         job(2, UccJob::UCC_JOB_CTX_GLOBAL);
+    UccTeam_h      team = job.create_team(2);
+    ucc_coll_req_h req;
+
+    EXPECT_EQ(UCC_ERR_INVALID_PARAM,
+              ucc_collective_group_init(NULL, 0, &req, team->procs[0].team));
+}
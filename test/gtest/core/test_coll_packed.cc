@@ -0,0 +1,297 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * See file LICENSE for terms.
+ */
+
+#include "common/test_ucc.h"
+
+/* Generic datatype of one int taking every other int of the buffer: the
+   gaps must be left untouched by the collectives */
+typedef struct strided_state {
+    int   *buffer;
+    size_t count;
+} strided_state_t;
+
+static void *strided_start(void *context, const void *buffer, size_t count)
+{
+    strided_state_t *state = new strided_state_t;
+
+    state->buffer = (int *)buffer;
+    state->count  = count;
+    return state;
+}
+
+static void *strided_start_unpack(void *context, void *buffer, size_t count)
+{
+    return strided_start(context, buffer, count);
+}
+
+static size_t strided_packed_size(void *state)
+{
+    return ((strided_state_t *)state)->count * sizeof(int);
+}
+
+/* offsets of the packed stream are not aligned to the int size */
+static size_t strided_pack(void *state, size_t offset, void *dest,
+                           size_t max_length)
+{
+    strided_state_t *s = (strided_state_t *)state;
+
+    for (size_t i = 0; i < max_length; i++) {
+        size_t pos = offset + i;
+        ((char *)dest)[i] =
+            ((char *)&s->buffer[2 * (pos / sizeof(int))])[pos % sizeof(int)];
+    }
+    return max_length;
+}
+
+static ucc_status_t strided_unpack(void *state, size_t offset,
+                                   const void *src, size_t length)
+{
+    strided_state_t *s = (strided_state_t *)state;
+
+    for (size_t i = 0; i < length; i++) {
+        size_t pos = offset + i;
+        ((char *)&s->buffer[2 * (pos / sizeof(int))])[pos % sizeof(int)] =
+            ((const char *)src)[i];
+    }
+    return UCC_OK;
+}
+
+static void strided_finish(void *state)
+{
+    delete (strided_state_t *)state;
+}
+
+class test_coll_packed : public ucc::test
+{
+public:
+    static const int GAP = -7;
+    ucc_datatype_t   dt;
+
+    test_coll_packed()
+    {
+        ucc_generic_dt_ops_t ops;
+
+        memset(&ops, 0, sizeof(ops));
+        ops.start_pack   = strided_start;
+        ops.start_unpack = strided_start_unpack;
+        ops.packed_size  = strided_packed_size;
+        ops.pack         = strided_pack;
+        ops.unpack       = strided_unpack;
+        ops.finish       = strided_finish;
+        EXPECT_EQ(UCC_OK, ucc_dt_create_generic(&ops, NULL, &dt));
+    }
+
+    ~test_coll_packed()
+    {
+        ucc_dt_destroy(dt);
+    }
+
+    /* strided buffer of count elements, element i is value + i */
+    static std::vector<int> buf(size_t count, int value)
+    {
+        std::vector<int> b(2 * count, GAP);
+
+        for (size_t i = 0; i < count; i++) {
+            b[2 * i] = (value < 0) ? value : value + (int)i;
+        }
+        return b;
+    }
+
+    static bool check(std::vector<int> &b, size_t first, size_t count,
+                      int value)
+    {
+        for (size_t i = 0; i < count; i++) {
+            if (b[2 * (first + i)] != value + (int)i ||
+                b[2 * (first + i) + 1] != GAP) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void run(UccTeam_h team, std::vector<ucc_coll_args_t> &args)
+    {
+        int                         n_procs = team->n_procs;
+        std::vector<ucc_coll_req_h> reqs(n_procs);
+        bool                        done;
+
+        for (int r = 0; r < n_procs; r++) {
+            ASSERT_EQ(UCC_OK, ucc_collective_init(&args[r], &reqs[r],
+                                                  team->procs[r].team));
+        }
+        for (int r = 0; r < n_procs; r++) {
+            ASSERT_EQ(UCC_OK, ucc_collective_post(reqs[r]));
+        }
+        do {
+            done = true;
+            for (int r = 0; r < n_procs; r++) {
+                ASSERT_GE(ucc_collective_test(reqs[r]), 0);
+                if (UCC_OK != ucc_collective_test(reqs[r])) {
+                    done = false;
+                }
+            }
+            team->progress();
+        } while (!done);
+        for (auto req : reqs) {
+            EXPECT_EQ(UCC_OK, ucc_collective_finalize(req));
+        }
+    }
+
+    void set_info(ucc_coll_buffer_info_t *info, std::vector<int> &b,
+                  size_t count)
+    {
+        info->buffer   = b.data();
+        info->count    = count;
+        info->datatype = dt;
+        info->mem_type = UCC_MEMORY_TYPE_HOST;
+    }
+};
+
+/* large enough for several fragments of the default 256k */
+#define COUNT 100003
+
+UCC_TEST_F(test_coll_packed, bcast)
+{
+    UccJob                        job(4, UccJob::UCC_JOB_CTX_GLOBAL);
+    UccTeam_h                     team = job.create_team(4);
+    int                           root = 1;
+    std::vector<std::vector<int>> bufs(4);
+    std::vector<ucc_coll_args_t>  args(4);
+
+    for (int r = 0; r < 4; r++) {
+        bufs[r] = buf(3 * COUNT, (r == root) ? 100 : -1);
+        memset(&args[r], 0, sizeof(args[r]));
+        args[r].coll_type = UCC_COLL_TYPE_BCAST;
+        args[r].root      = root;
+        set_info(&args[r].src.info, bufs[r], 3 * COUNT);
+    }
+    run(team, args);
+    for (int r = 0; r < 4; r++) {
+        EXPECT_TRUE(check(bufs[r], 0, 3 * COUNT, 100));
+    }
+}
+
+UCC_TEST_F(test_coll_packed, allgather)
+{
+    UccJob                        job(4, UccJob::UCC_JOB_CTX_GLOBAL);
+    UccTeam_h                     team = job.create_team(4);
+    std::vector<std::vector<int>> src(4), dst(4);
+    std::vector<ucc_coll_args_t>  args(4);
+
+    for (int r = 0; r < 4; r++) {
+        src[r] = buf(COUNT, r * 1000);
+        dst[r] = buf(4 * COUNT, -1);
+        memset(&args[r], 0, sizeof(args[r]));
+        args[r].coll_type = UCC_COLL_TYPE_ALLGATHER;
+        set_info(&args[r].src.info, src[r], COUNT);
+        set_info(&args[r].dst.info, dst[r], 4 * COUNT);
+    }
+    run(team, args);
+    for (int r = 0; r < 4; r++) {
+        for (int p = 0; p < 4; p++) {
+            EXPECT_TRUE(check(dst[r], p * COUNT, COUNT, p * 1000));
+        }
+    }
+}
+
+UCC_TEST_F(test_coll_packed, alltoall_inplace)
+{
+    UccJob                        job(3, UccJob::UCC_JOB_CTX_GLOBAL);
+    UccTeam_h                     team = job.create_team(3);
+    std::vector<std::vector<int>> dst(3);
+    std::vector<ucc_coll_args_t>  args(3);
+
+    for (int r = 0; r < 3; r++) {
+        /* block p of rank r holds r * 10 + p */
+        dst[r] = buf(3 * COUNT, -1);
+        for (int p = 0; p < 3; p++) {
+            for (size_t i = 0; i < COUNT; i++) {
+                dst[r][2 * (p * COUNT + i)] = r * 10 + p + (int)i;
+            }
+        }
+        memset(&args[r], 0, sizeof(args[r]));
+        args[r].mask      = UCC_COLL_ARGS_FIELD_FLAGS;
+        args[r].flags     = UCC_COLL_ARGS_FLAG_IN_PLACE;
+        args[r].coll_type = UCC_COLL_TYPE_ALLTOALL;
+        set_info(&args[r].dst.info, dst[r], 3 * COUNT);
+    }
+    run(team, args);
+    for (int r = 0; r < 3; r++) {
+        for (int p = 0; p < 3; p++) {
+            EXPECT_TRUE(check(dst[r], p * COUNT, COUNT, p * 10 + r));
+        }
+    }
+}
+
+UCC_TEST_F(test_coll_packed, gather_contig_dst)
+{
+    UccJob                        job(4, UccJob::UCC_JOB_CTX_GLOBAL);
+    UccTeam_h                     team = job.create_team(4);
+    int                           root = 2;
+    std::vector<std::vector<int>> src(4);
+    std::vector<int>              dst(4 * COUNT, -1);
+    std::vector<ucc_coll_args_t>  args(4);
+
+    for (int r = 0; r < 4; r++) {
+        src[r] = buf(COUNT, r * 1000);
+        memset(&args[r], 0, sizeof(args[r]));
+        args[r].coll_type = UCC_COLL_TYPE_GATHER;
+        args[r].root      = root;
+        set_info(&args[r].src.info, src[r], COUNT);
+    }
+    /* the root receives to a contiguous buffer */
+    args[root].dst.info.buffer   = dst.data();
+    args[root].dst.info.count    = 4 * COUNT;
+    args[root].dst.info.datatype = UCC_DT_INT32;
+    args[root].dst.info.mem_type = UCC_MEMORY_TYPE_HOST;
+    run(team, args);
+    for (int p = 0; p < 4; p++) {
+        for (size_t i = 0; i < COUNT; i++) {
+            EXPECT_EQ(p * 1000 + (int)i, dst[p * COUNT + i]);
+        }
+    }
+}
+
+UCC_TEST_F(test_coll_packed, scatter)
+{
+    UccJob                        job(4, UccJob::UCC_JOB_CTX_GLOBAL);
+    UccTeam_h                     team = job.create_team(4);
+    int                           root = 0;
+    std::vector<std::vector<int>> src(4), dst(4);
+    std::vector<ucc_coll_args_t>  args(4);
+
+    for (int r = 0; r < 4; r++) {
+        dst[r] = buf(COUNT, -1);
+        memset(&args[r], 0, sizeof(args[r]));
+        args[r].coll_type = UCC_COLL_TYPE_SCATTER;
+        args[r].root      = root;
+        set_info(&args[r].dst.info, dst[r], COUNT);
+        if (r == root) {
+            src[r] = buf(4 * COUNT, 0);
+            set_info(&args[r].src.info, src[r], 4 * COUNT);
+        }
+    }
+    run(team, args);
+    for (int r = 0; r < 4; r++) {
+        EXPECT_TRUE(check(dst[r], 0, COUNT, r * COUNT));
+    }
+}
+
+UCC_TEST_F(test_coll_packed, allreduce_not_supported)
+{
+    UccJob            job(2, UccJob::UCC_JOB_CTX_GLOBAL);
+    UccTeam_h         team = job.create_team(2);
+    std::vector<int>  src  = buf(16, 0), dst = buf(16, -1);
+    ucc_coll_args_t   args;
+    ucc_coll_req_h    req;
+
+    memset(&args, 0, sizeof(args));
+    args.coll_type = UCC_COLL_TYPE_ALLREDUCE;
+    args.op        = UCC_OP_SUM;
+    set_info(&args.src.info, src, 16);
+    set_info(&args.dst.info, dst, 16);
+    EXPECT_EQ(UCC_ERR_NOT_SUPPORTED,
+              ucc_collective_init(&args, &req, team->procs[0].team));
+}
@@ -0,0 +1,145 @@
+/**
+ * Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * See file LICENSE for terms.
+ */
+
+#include "common/test_ucc.h"
+
+class test_fusion : public ucc::test
+{
+public:
+    /* Adds n_ops int32 sum allreduces of "counts" sizes on every rank and
+       checks that each request completes with the sum over the ranks */
+    void run(UccTeam_h team, size_t size_thresh,
+             std::vector<size_t> counts, bool inplace)
+    {
+        int                                        n_procs = team->n_procs;
+        int                                        n_ops   = counts.size();
+        std::vector<ucc_fusion_h>                  fusions(n_procs);
+        std::vector<std::vector<ucc_coll_req_h>>   reqs(n_procs);
+        std::vector<std::vector<std::vector<int>>> src(n_procs),
+                                                   dst(n_procs);
+        ucc_fusion_params_t                        params;
+        ucc_coll_args_t                            args;
+        bool                                       done;
+
+        params.mask        = UCC_FUSION_PARAM_FIELD_SIZE_THRESH;
+        params.datatype    = UCC_DT_INT32;
+        params.op          = UCC_OP_SUM;
+        params.size_thresh = size_thresh;
+        for (int r = 0; r < n_procs; r++) {
+            ASSERT_EQ(UCC_OK, ucc_fusion_create(team->procs[r].team, &params,
+                                                &fusions[r]));
+            reqs[r].resize(n_ops);
+            src[r].resize(n_ops);
+            dst[r].resize(n_ops);
+            for (int i = 0; i < n_ops; i++) {
+                src[r][i].resize(counts[i]);
+                dst[r][i].resize(counts[i]);
+                for (size_t j = 0; j < counts[i]; j++) {
+                    src[r][i][j] = r + i + j;
+                    dst[r][i][j] = inplace ? src[r][i][j] : -1;
+                }
+                memset(&args, 0, sizeof(args));
+                args.coll_type         = UCC_COLL_TYPE_ALLREDUCE;
+                args.op                = UCC_OP_SUM;
+                args.dst.info.buffer   = dst[r][i].data();
+                args.dst.info.count    = counts[i];
+                args.dst.info.datatype = UCC_DT_INT32;
+                args.dst.info.mem_type = UCC_MEMORY_TYPE_HOST;
+                if (inplace) {
+                    args.mask  = UCC_COLL_ARGS_FIELD_FLAGS;
+                    args.flags = UCC_COLL_ARGS_FLAG_IN_PLACE;
+                } else {
+                    args.src.info.buffer   = src[r][i].data();
+                    args.src.info.count    = counts[i];
+                    args.src.info.datatype = UCC_DT_INT32;
+                    args.src.info.mem_type = UCC_MEMORY_TYPE_HOST;
+                }
+                ASSERT_EQ(UCC_OK,
+                          ucc_fusion_add(fusions[r], &args, &reqs[r][i]));
+            }
+            ASSERT_EQ(UCC_OK, ucc_fusion_flush(fusions[r]));
+        }
+
+        do {
+            done = true;
+            for (int r = 0; r < n_procs; r++) {
+                for (auto req : reqs[r]) {
+                    ASSERT_GE(ucc_collective_test(req), 0);
+                    if (UCC_OK != ucc_collective_test(req)) {
+                        done = false;
+                    }
+                }
+            }
+            team->progress();
+        } while (!done);
+
+        for (int r = 0; r < n_procs; r++) {
+            for (int i = 0; i < n_ops; i++) {
+                for (size_t j = 0; j < counts[i]; j++) {
+                    EXPECT_EQ(n_procs * (i + j) + n_procs * (n_procs - 1) / 2,
+                              dst[r][i][j]);
+                }
+                EXPECT_EQ(UCC_OK, ucc_collective_finalize(reqs[r][i]));
+            }
+            EXPECT_EQ(UCC_OK, ucc_fusion_destroy(fusions[r]));
+        }
+    }
+};
+
+UCC_TEST_F(test_fusion, many_small)
+{
+    int       n_procs = 8;
+    UccJob    job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL);
+    UccTeam_h team    = job.create_team(n_procs);
+
+    for (auto inplace : {false, true}) {
+        /* 100 x 4KB ops over 64KB buckets */
+        run(team, 65536, std::vector<size_t>(100, 1024), inplace);
+    }
+}
+
+UCC_TEST_F(test_fusion, mixed_sizes)
+{
+    int       n_procs = 5;
+    UccJob    job(n_procs, UccJob::UCC_JOB_CTX_GLOBAL);
+    UccTeam_h team    = job.create_team(n_procs);
+
+    /* zero count, ops crossing the bucket boundary and one larger than
+       the bucket */
+    run(team, 4096, {1, 0, 700, 500, 3000, 7, 0, 1000, 1}, false);
+}
+
+UCC_TEST_F(test_fusion, invalid_args)
+{
+    UccJob              job(2, UccJob::UCC_JOB_CTX_GLOBAL);
+    UccTeam_h           team = job.create_team(2);
+    ucc_fusion_params_t params;
+    ucc_fusion_h        fusion;
+    ucc_coll_args_t     args;
+    ucc_coll_req_h      req;
+    float               buf[4];
+
+    params.mask     = 0;
+    params.datatype = UCC_DT_FLOAT32;
+    params.op       = UCC_OP_SUM;
+    ASSERT_EQ(UCC_OK, ucc_fusion_create(team->procs[0].team, &params,
+                                        &fusion));
+
+    memset(&args, 0, sizeof(args));
+    args.mask              = UCC_COLL_ARGS_FIELD_FLAGS;
+    args.flags             = UCC_COLL_ARGS_FLAG_IN_PLACE;
+    args.coll_type         = UCC_COLL_TYPE_ALLREDUCE;
+    args.op                = UCC_OP_MAX;
+    args.dst.info.buffer   = buf;
+    args.dst.info.count    = 4;
+    args.dst.info.datatype = UCC_DT_FLOAT32;
+    args.dst.info.mem_type = UCC_MEMORY_TYPE_HOST;
+    EXPECT_EQ(UCC_ERR_INVALID_PARAM, ucc_fusion_add(fusion, &args, &req));
+
+    args.op        = UCC_OP_SUM;
+    args.coll_type = UCC_COLL_TYPE_BCAST;
+    EXPECT_EQ(UCC_ERR_INVALID_PARAM, ucc_fusion_add(fusion, &args, &req));
+    EXPECT_EQ(UCC_OK, ucc_fusion_destroy(fusion));
+}
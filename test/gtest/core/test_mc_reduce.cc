@@ -6,7 +6,10 @@
 #include "test_mc_reduce.h"
 extern "C" {
 #include "components/ec/ucc_ec.h"
+#include "components/ec/cpu/ec_cpu.h"
+#include "core/ucc_global_opts.h"
 }
+#include <vector>
 
 template<typename T>
 class test_mc_reduce : public testing::Test {
@@ -386,3 +389,156 @@ DECLARE_REDUCE_MULTI_TEST(float, CUDA);
 
 DECLARE_REDUCE_MULTI_ALPHA_TEST(float, CUDA);
 #endif
+
+/* Sum of pairs of doubles: the executor must give all the sources to the
+   callback in one call, possibly split in chunks of elements */
+typedef struct dpair {
+    double a;
+    double b;
+} dpair_t;
+
+typedef struct userdefined_stats {
+    int    n_calls;
+    size_t count;
+    size_t n_vectors;
+} userdefined_stats_t;
+
+static ucc_status_t dpair_sum(const ucc_reduce_cb_params_t *params)
+{
+    userdefined_stats_t *stats = (userdefined_stats_t *)params->cb_ctx;
+    const dpair_t       *s1    = (const dpair_t *)params->src1;
+    dpair_t             *d     = (dpair_t *)params->dst;
+
+    stats->n_calls++;
+    stats->count     += params->count;
+    stats->n_vectors  = params->n_vectors;
+    for (size_t i = 0; i < params->count; i++) {
+        dpair_t r = s1[i];
+        for (size_t j = 0; j < params->n_vectors; j++) {
+            const dpair_t *v = (const dpair_t *)((const char *)params->src2 +
+                                                 j * params->stride);
+            r.a += v[i].a;
+            r.b += v[i].b;
+        }
+        d[i] = r;
+    }
+    return UCC_OK;
+}
+
+class test_ec_reduce_userdefined : public testing::Test {
+  protected:
+    ucc_ee_executor_t   *executor;
+    ucc_datatype_t       dt;
+    userdefined_stats_t  stats;
+    ucc_ec_cpu_config_t *cpu_cfg;
+
+    virtual void SetUp() override
+    {
+        ucc_ec_params_t          ec_params = {
+            .thread_mode = UCC_THREAD_SINGLE,
+        };
+        ucc_ee_executor_params_t params;
+        ucc_generic_dt_ops_t     ops;
+        ucc_ec_base_t           *ec;
+
+        ucc_constructor();
+        ucc_ec_init(&ec_params);
+        params.mask    = UCC_EE_EXECUTOR_PARAM_FIELD_TYPE;
+        params.ee_type = UCC_EE_CPU_THREAD;
+        ASSERT_EQ(UCC_OK, ucc_ee_executor_init(&params, &executor));
+        ASSERT_EQ(UCC_OK, ucc_ee_executor_start(executor, NULL));
+
+        /* the chunk is read from the CPU EC config on every reduction */
+        cpu_cfg = NULL;
+        for (int i = 0; i < ucc_global_config.ec_framework.n_components;
+             i++) {
+            ec = ucc_derived_of(ucc_global_config.ec_framework.components[i],
+                                ucc_ec_base_t);
+            if (ec->type == UCC_EE_CPU_THREAD) {
+                cpu_cfg = ucc_derived_of(ec->config, ucc_ec_cpu_config_t);
+            }
+        }
+        ASSERT_NE(nullptr, cpu_cfg);
+
+        memset(&ops, 0, sizeof(ops));
+        memset(&stats, 0, sizeof(stats));
+        ops.flags         = UCC_GENERIC_DT_OPS_FLAG_CONTIG |
+                            UCC_GENERIC_DT_OPS_FLAG_REDUCE;
+        ops.contig_size   = sizeof(dpair_t);
+        ops.reduce.cb     = dpair_sum;
+        ops.reduce.cb_ctx = &stats;
+        ASSERT_EQ(UCC_OK, ucc_dt_create_generic(&ops, NULL, &dt));
+    }
+
+    virtual void TearDown() override
+    {
+        ucc_dt_destroy(dt);
+        ucc_ee_executor_stop(executor);
+        ucc_ee_executor_finalize(executor);
+    }
+
+    void reduce(size_t count, int num_vec)
+    {
+        std::vector<dpair_t>        src1(count), src2(count * num_vec);
+        std::vector<dpair_t>        dst(count);
+        ucc_ee_executor_task_args_t eargs;
+        ucc_ee_executor_task_t     *task;
+        ucc_status_t                status;
+
+        for (size_t i = 0; i < count; i++) {
+            src1[i].a = i;
+            src1[i].b = -1.0 * i;
+            for (int j = 0; j < num_vec; j++) {
+                src2[i + j * count].a = j + 1;
+                src2[i + j * count].b = 2.0 * (j + 1);
+            }
+        }
+        eargs.flags                 = 0;
+        eargs.task_type             = UCC_EE_EXECUTOR_TASK_REDUCE_STRIDED;
+        eargs.reduce_strided.count  = count;
+        eargs.reduce_strided.dt     = dt;
+        eargs.reduce_strided.op     = UCC_OP_SUM;
+        eargs.reduce_strided.n_src2 = num_vec;
+        eargs.reduce_strided.dst    = dst.data();
+        eargs.reduce_strided.src1   = src1.data();
+        eargs.reduce_strided.src2   = src2.data();
+        eargs.reduce_strided.stride = count * sizeof(dpair_t);
+        eargs.reduce_strided.alpha  = 0;
+
+        ASSERT_EQ(UCC_OK, ucc_ee_executor_task_post(executor, &eargs, &task));
+        while (0 < (status = ucc_ee_executor_task_test(task))) {
+            ;
+        }
+        ucc_ee_executor_task_finalize(task);
+        ASSERT_EQ(UCC_OK, status);
+
+        /* every call reduces all the sources */
+        EXPECT_EQ((size_t)num_vec, stats.n_vectors);
+        EXPECT_EQ(count, stats.count);
+        for (size_t i = 0; i < count; i++) {
+            EXPECT_EQ(i + num_vec * (num_vec + 1) / 2.0, dst[i].a);
+            EXPECT_EQ(-1.0 * i + num_vec * (num_vec + 1), dst[i].b);
+        }
+    }
+};
+
+UCC_TEST_F(test_ec_reduce_userdefined, multi_host)
+{
+    const size_t count = 100000;
+
+    ASSERT_EQ((size_t)32768, cpu_cfg->reduce_userdefined_chunk);
+    reduce(count, 7);
+    /* 32k chunks hold 2048 pairs of doubles */
+    EXPECT_EQ((int)((count + 2047) / 2048), stats.n_calls);
+}
+
+UCC_TEST_F(test_ec_reduce_userdefined, multi_host_no_chunk)
+{
+    size_t chunk = cpu_cfg->reduce_userdefined_chunk;
+
+    cpu_cfg->reduce_userdefined_chunk = 0;
+    reduce(100000, 7);
+    cpu_cfg->reduce_userdefined_chunk = chunk;
+    /* the whole vectors in one call */
+    EXPECT_EQ(1, stats.n_calls);
+}
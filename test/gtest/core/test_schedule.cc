@@ -109,3 +109,29 @@ UCC_TEST_F(test_schedule, multiple)
                   (std::get<1>(rst[i]) == ((i % 2) + 1)));
     }
 }
+
+/* Schedule with more tasks than fit into its inline task array */
+UCC_TEST_F(test_schedule, many_tasks)
+{
+    const int                   n_tasks = 4 * UCC_SCHEDULE_N_TASKS_INLINE;
+    std::vector<test_coll_task> tasks(n_tasks);
+    ucc_base_context_t          ctx  = {};
+    ucc_base_team_t             team = {};
+    ucc_schedule_t              schedule;
+
+    team.context = &ctx;
+    ucc_coll_task_construct(&schedule.super);
+    EXPECT_EQ(UCC_OK, ucc_schedule_init(&schedule, NULL, &team));
+    for (int i = 0; i < n_tasks; i++) {
+        tasks[i].finalize = NULL;
+        EXPECT_EQ(UCC_OK, ucc_schedule_add_task(&schedule, &tasks[i]));
+    }
+    EXPECT_EQ(n_tasks, schedule.n_tasks);
+    for (int i = 0; i < n_tasks; i++) {
+        EXPECT_EQ(&tasks[i], schedule.tasks[i]);
+        EXPECT_EQ(&schedule, tasks[i].schedule);
+    }
+    EXPECT_EQ(UCC_OK, ucc_schedule_finalize(&schedule.super));
+    EXPECT_EQ(schedule.tasks_inline, schedule.tasks);
+    ucc_coll_task_destruct(&schedule.super);
+}
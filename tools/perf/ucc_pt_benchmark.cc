@@ -74,7 +74,7 @@ ucc_status_t ucc_pt_benchmark::run_bench() noexcept
     size_t max_count = coll->has_range() ? config.max_count : 1;
     ucc_status_t       st;
     ucc_pt_test_args_t args;
-    double             time;
+    double             time, repost_time;
 
     print_header();
     for (size_t cnt = min_count; cnt <= max_count; cnt *= 2) {
@@ -86,15 +86,22 @@ ucc_status_t ucc_pt_benchmark::run_bench() noexcept
             warmup = config.n_warmup_large;
         }
         UCCCHECK_GOTO(coll->init_args(cnt, args), exit_err, st);
+        repost_time = 0;
         if ((uint64_t)config.op_type < (uint64_t)UCC_COLL_TYPE_LAST) {
             UCCCHECK_GOTO(run_single_coll_test(args.coll_args, warmup, iter, time),
                           free_coll, st);
+            if (config.persistent) {
+                UCCCHECK_GOTO(run_single_coll_repost_test(args.coll_args,
+                                                          warmup, iter,
+                                                          repost_time),
+                              free_coll, st);
+            }
         } else {
             UCCCHECK_GOTO(run_single_executor_test(args.executor_args,
                                                    warmup, iter, time),
                           free_coll, st);
         }
-        print_time(cnt, args, time);
+        print_time(cnt, args, time, repost_time);
         coll->free_args(args);
     }
 
@@ -180,6 +187,56 @@ exit_err:
     return st;
 }
 
+/* Initializes the collective once as persistent and times only the
+   post-to-completion of every repost */
+ucc_status_t ucc_pt_benchmark::run_single_coll_repost_test(ucc_coll_args_t args,
+                                                           int nwarmup,
+                                                           int niter,
+                                                           double &time)
+                                                           noexcept
+{
+    ucc_team_h     team = comm->get_team();
+    ucc_context_h  ctx  = comm->get_context();
+    ucc_status_t   st   = UCC_OK;
+    ucc_coll_req_h req;
+
+    if (!(args.mask & UCC_COLL_ARGS_FIELD_FLAGS)) {
+        args.mask  |= UCC_COLL_ARGS_FIELD_FLAGS;
+        args.flags  = 0;
+    }
+    args.flags |= UCC_COLL_ARGS_FLAG_PERSISTENT;
+    time        = 0;
+
+    UCCCHECK_GOTO(ucc_collective_init(&args, &req, team), exit_err, st);
+    UCCCHECK_GOTO(comm->barrier(), free_req, st);
+    for (int i = 0; i < nwarmup + niter; i++) {
+        double s = get_time_us();
+        UCCCHECK_GOTO(ucc_collective_post(req), free_req, st);
+        st = ucc_collective_test(req);
+        while (st > 0) {
+            UCCCHECK_GOTO(ucc_context_progress(ctx), free_req, st);
+            st = ucc_collective_test(req);
+        }
+        double f = get_time_us();
+        if (st != UCC_OK) {
+            goto free_req;
+        }
+        if (i >= nwarmup) {
+            time += f - s;
+        }
+        UCCCHECK_GOTO(comm->barrier(), free_req, st);
+    }
+    UCCCHECK_GOTO(ucc_collective_finalize(req), exit_err, st);
+    if (niter != 0) {
+        time /= niter;
+    }
+    return UCC_OK;
+free_req:
+    ucc_collective_finalize(req);
+exit_err:
+    return st;
+}
+
 ucc_status_t
 ucc_pt_benchmark::run_single_executor_test(ucc_ee_executor_task_args_t args,
                                            int nwarmup, int niter,
@@ -262,6 +319,9 @@ void ucc_pt_benchmark::print_header()
                         std::to_string(config.inplace):
                         "N/A")
                   << std::endl;
+        std::cout << std::left << std::setw(24)
+                  << "Persistent repost: " << config.persistent
+                  << std::endl;
         std::cout << std::left << std::setw(24)
                   << "Warmup:" << std::endl
                   << std::left << std::setw(24)
@@ -279,6 +339,9 @@ void ucc_pt_benchmark::print_header()
         std::cout << std::setw(12) << "Count"
                   << std::setw(12) << "Size"
                   << std::setw(24) << "Time, us";
+        if (config.persistent) {
+            std::cout << std::setw(36) << "Repost time, us";
+        }
         if (config.full_print) {
             std::cout << std::setw(42) << "Bandwidth, GB/s";
         }
@@ -286,6 +349,11 @@ void ucc_pt_benchmark::print_header()
         std::cout << std::setw(36) << "avg"
                   << std::setw(12) << "min"
                   << std::setw(12) << "max";
+        if (config.persistent) {
+            std::cout << std::setw(12) << "avg"
+                      << std::setw(12) << "min"
+                      << std::setw(12) << "max";
+        }
         if (config.full_print) {
             std::cout << std::setw(12) << "avg"
                       << std::setw(12) << "max"
@@ -296,17 +364,24 @@ void ucc_pt_benchmark::print_header()
 }
 
 void ucc_pt_benchmark::print_time(size_t count, ucc_pt_test_args_t args,
-                                  double time)
+                                  double time, double repost_time)
 {
     double time_us = time;
     size_t size    = count * ucc_dt_size(config.dt);
     int    gsize   = comm->get_size();
     double time_avg, time_min, time_max;
+    double repost_avg, repost_min, repost_max;
 
     comm->allreduce(&time_us, &time_min, 1, UCC_OP_MIN);
     comm->allreduce(&time_us, &time_max, 1, UCC_OP_MAX);
     comm->allreduce(&time_us, &time_avg, 1, UCC_OP_SUM);
     time_avg /= gsize;
+    if (config.persistent) {
+        comm->allreduce(&repost_time, &repost_min, 1, UCC_OP_MIN);
+        comm->allreduce(&repost_time, &repost_max, 1, UCC_OP_MAX);
+        comm->allreduce(&repost_time, &repost_avg, 1, UCC_OP_SUM);
+        repost_avg /= gsize;
+    }
 
     if (comm->get_rank() == 0) {
         std::ios iostate(nullptr);
@@ -321,6 +396,17 @@ void ucc_pt_benchmark::print_time(size_t count, ucc_pt_test_args_t args,
                   << std::setw(12) << time_avg
                   << std::setw(12) << time_min
                   << std::setw(12) << time_max;
+        if (config.persistent) {
+            if ((uint64_t)config.op_type < (uint64_t)UCC_COLL_TYPE_LAST) {
+                std::cout << std::setw(12) << repost_avg
+                          << std::setw(12) << repost_min
+                          << std::setw(12) << repost_max;
+            } else {
+                std::cout << std::setw(12) << "N/A"
+                          << std::setw(12) << "N/A"
+                          << std::setw(12) << "N/A";
+            }
+        }
 
         if (config.full_print) {
             if (!coll->has_bw()) {
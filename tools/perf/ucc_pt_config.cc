@@ -13,6 +13,7 @@ ucc_pt_config::ucc_pt_config() {
     bench.op             = UCC_OP_SUM;
     bench.inplace        = false;
     bench.triggered      = false;
+    bench.persistent     = false;
     bench.n_iter_small   = 1000;
     bench.n_warmup_small = 100;
     bench.n_iter_large   = 200;
@@ -74,7 +75,7 @@ ucc_status_t ucc_pt_config::process_args(int argc, char *argv[])
     int c;
     ucc_status_t st;
 
-    while ((c = getopt(argc, argv, "c:b:e:d:m:n:w:o:N:ihFT")) != -1) {
+    while ((c = getopt(argc, argv, "c:b:e:d:m:n:w:o:N:ihFTp")) != -1) {
         switch (c) {
             case 'c':
                 if (ucc_pt_op_map.count(optarg) == 0) {
@@ -136,6 +137,9 @@ ucc_status_t ucc_pt_config::process_args(int argc, char *argv[])
             case 'T':
                 bench.triggered = true;
                 break;
+            case 'p':
+                bench.persistent = true;
+                break;
             case 'F':
                 bench.full_print = true;
                 break;
@@ -145,6 +149,11 @@ ucc_status_t ucc_pt_config::process_args(int argc, char *argv[])
                 std::exit(0);
         }
     }
+    if (bench.persistent && bench.triggered) {
+        std::cerr << "persistent repost is not supported with triggered "
+                     "collectives" << std::endl;
+        return UCC_ERR_INVALID_PARAM;
+    }
     return UCC_OK;
 }
 
@@ -162,6 +171,7 @@ void ucc_pt_config::print_help()
     std::cout << "  -w <number>: number of warmup iterations"<<std::endl;
     std::cout << "  -N <number>: number of buffers"<<std::endl;
     std::cout << "  -T: triggered collective"<<std::endl;
+    std::cout << "  -p: persistent collective repost time"<<std::endl;
     std::cout << "  -F: enable full print"<<std::endl;
     std::cout << "  -h: show this help message"<<std::endl;
     std::cout << std::endl;
@@ -78,6 +78,7 @@ struct ucc_pt_benchmark_config {
     ucc_reduction_op_t op;
     bool               inplace;
     bool               triggered;
+    bool               persistent;
     size_t             large_thresh;
     int                n_iter_small;
     int                n_warmup_small;